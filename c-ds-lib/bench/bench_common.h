@@ -0,0 +1,264 @@
+/**
+ * @file bench_common.h
+ * @brief Shared timing, isolation and reporting helpers for the benchmarks
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * Every benchmark program measures a set of configurations and reports one
+ * row per (structure, operation, distribution, size, threads) with the mean
+ * cost in ns/op, the throughput in ops/sec and the peak resident set size.
+ * Each configuration runs in a forked child process, so the peak RSS of a
+ * row belongs to that configuration alone.
+ * 
+ * Programs accept:
+ * - --format=csv|json  Output format (default csv; json is one array)
+ * - --max-n=N          Largest element count to run (default 1000000)
+ * - --min-n=N          Smallest element count to run (default 1000)
+ * 
+ * The row layout is stable so that outputs of two releases can be diffed.
+ */
+
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#define BENCH_MAX_RESULTS 64
+#define BENCH_NAME_LEN 24
+
+/**
+ * @brief One measured row
+ */
+struct bench_result {
+    char structure[BENCH_NAME_LEN];    /**< Structure and mode, e.g. "tree_avl" */
+    char op[BENCH_NAME_LEN];           /**< Operation, e.g. "insert" */
+    char dist[BENCH_NAME_LEN];         /**< Key distribution, or "none" */
+    size_t n;                          /**< Element count of the configuration */
+    int threads;                       /**< Number of threads */
+    double ns_per_op;                  /**< Mean wall time per operation */
+    double ops_per_sec;                /**< Throughput */
+    long peak_rss_kb;                  /**< Peak resident set size of the run */
+};
+
+/**
+ * @brief Rows produced by one configuration
+ * 
+ * structure, dist, n and threads are filled in by the caller before the
+ * configuration runs and copied into every recorded row.
+ */
+struct bench_batch {
+    const char *structure;             /**< Structure name for new rows */
+    const char *dist;                  /**< Distribution name for new rows */
+    size_t n;                          /**< Element count for new rows */
+    int threads;                       /**< Thread count for new rows */
+    size_t count;                      /**< Number of recorded rows */
+    struct bench_result results[BENCH_MAX_RESULTS];
+};
+
+/**
+ * @brief Command line options shared by all benchmark programs
+ */
+struct bench_opts {
+    int json;                          /**< Non-zero for JSON output */
+    size_t min_n;                      /**< Smallest element count */
+    size_t max_n;                      /**< Largest element count */
+    size_t emitted;                    /**< Rows printed so far */
+};
+
+/**
+ * @brief Parse the shared command line options
+ * 
+ * @param o Options to fill in
+ * @param argc Argument count from main
+ * @param argv Argument vector from main
+ * @return 0 on success, -1 on an unknown argument (usage is printed)
+ */
+static inline int bench_parse_opts(struct bench_opts *o, int argc, char **argv) {
+    int i;
+    
+    o->json = 0;
+    o->min_n = 1000;
+    o->max_n = 1000000;
+    o->emitted = 0;
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--format=json") == 0) {
+            o->json = 1;
+        } else if (strcmp(argv[i], "--format=csv") == 0) {
+            o->json = 0;
+        } else if (strncmp(argv[i], "--max-n=", 8) == 0) {
+            o->max_n = (size_t)strtod(argv[i] + 8, NULL);
+        } else if (strncmp(argv[i], "--min-n=", 8) == 0) {
+            o->min_n = (size_t)strtod(argv[i] + 8, NULL);
+        } else {
+            fprintf(stderr, "usage: %s [--format=csv|json] [--min-n=N] [--max-n=N]\n", argv[0]);
+            return -1;
+        }
+    }
+    if (o->min_n == 0) {
+        o->min_n = 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Monotonic wall clock in seconds
+ */
+static inline double bench_now(void) {
+    struct timespec ts;
+    
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Peak resident set size of the calling process in KiB
+ */
+static inline long bench_peak_rss_kb(void) {
+    struct rusage ru;
+    
+    if (getrusage(RUSAGE_SELF, &ru) != 0) {
+        return -1;
+    }
+    return ru.ru_maxrss;
+}
+
+/**
+ * @brief Record a measured row in a batch
+ * 
+ * @param b Batch for the running configuration
+ * @param op Operation name
+ * @param ops Number of operations timed
+ * @param seconds Elapsed wall time for all ops
+ */
+static inline void bench_record(struct bench_batch *b, const char *op, size_t ops, double seconds) {
+    struct bench_result *r;
+    
+    if (b->count == BENCH_MAX_RESULTS || ops == 0) {
+        return;
+    }
+    
+    r = &b->results[b->count++];
+    snprintf(r->structure, sizeof(r->structure), "%s", b->structure);
+    snprintf(r->op, sizeof(r->op), "%s", op);
+    snprintf(r->dist, sizeof(r->dist), "%s", b->dist);
+    r->n = b->n;
+    r->threads = b->threads;
+    r->ns_per_op = seconds * 1e9 / (double)ops;
+    r->ops_per_sec = (seconds > 0) ? (double)ops / seconds : 0;
+    r->peak_rss_kb = 0;
+}
+
+/**
+ * @brief Print the document header
+ */
+static inline void bench_begin(struct bench_opts *o) {
+    if (o->json) {
+        printf("[");
+    } else {
+        printf("structure,op,dist,n,threads,ns_per_op,ops_per_sec,peak_rss_kb\n");
+    }
+}
+
+/**
+ * @brief Print one row
+ */
+static inline void bench_emit(struct bench_opts *o, const struct bench_result *r) {
+    if (o->json) {
+        printf("%s\n  {\"structure\": \"%s\", \"op\": \"%s\", \"dist\": \"%s\", \"n\": %lu, "
+               "\"threads\": %d, \"ns_per_op\": %.2f, \"ops_per_sec\": %.0f, \"peak_rss_kb\": %ld}",
+               o->emitted ? "," : "", r->structure, r->op, r->dist, (unsigned long)r->n,
+               r->threads, r->ns_per_op, r->ops_per_sec, r->peak_rss_kb);
+    } else {
+        printf("%s,%s,%s,%lu,%d,%.2f,%.0f,%ld\n", r->structure, r->op, r->dist,
+               (unsigned long)r->n, r->threads, r->ns_per_op, r->ops_per_sec, r->peak_rss_kb);
+    }
+    o->emitted++;
+    fflush(stdout);
+}
+
+/**
+ * @brief Print the document trailer
+ */
+static inline void bench_end(struct bench_opts *o) {
+    if (o->json) {
+        printf("\n]\n");
+    }
+}
+
+/**
+ * @brief Run one configuration in a child process and print its rows
+ * 
+ * The child measures into a batch and ships it back over a pipe together
+ * with its peak RSS. A configuration that crashes or runs out of memory
+ * produces no rows. Falls back to running in-process if fork fails.
+ * 
+ * @param o Output options
+ * @param b Batch with structure/dist/n/threads filled in
+ * @param run Configuration to measure
+ * @param arg Argument passed to run
+ * @return 0 on success, -1 if the child failed
+ */
+static inline int bench_isolated(struct bench_opts *o, struct bench_batch *b,
+                                 void (*run)(struct bench_batch *b, void *arg), void *arg) {
+    int fds[2], status;
+    size_t i;
+    long rss;
+    pid_t pid;
+    ssize_t got;
+    
+    b->count = 0;
+    fflush(stdout);
+    if (pipe(fds) != 0 || (pid = fork()) < 0) {
+        run(b, arg);
+        rss = bench_peak_rss_kb();
+        for (i = 0; i < b->count; i++) {
+            b->results[i].peak_rss_kb = rss;
+            bench_emit(o, &b->results[i]);
+        }
+        return 0;
+    }
+    
+    if (pid == 0) {
+        close(fds[0]);
+        run(b, arg);
+        rss = bench_peak_rss_kb();
+        for (i = 0; i < b->count; i++) {
+            b->results[i].peak_rss_kb = rss;
+        }
+        got = write(fds[1], b, sizeof(*b));
+        _exit(got == (ssize_t)sizeof(*b) ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+    
+    // Parent: read the whole batch back, then reap the child
+    close(fds[1]);
+    got = 0;
+    while (got < (ssize_t)sizeof(*b)) {
+        ssize_t r = read(fds[0], (char *)b + got, sizeof(*b) - (size_t)got);
+        
+        if (r <= 0) {
+            break;
+        }
+        got += r;
+    }
+    close(fds[0]);
+    waitpid(pid, &status, 0);
+    
+    if (got != (ssize_t)sizeof(*b) || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+        fprintf(stderr, "bench: %s/%s n=%lu failed\n", b->structure, b->dist, (unsigned long)b->n);
+        return -1;
+    }
+    for (i = 0; i < b->count; i++) {
+        bench_emit(o, &b->results[i]);
+    }
+    return 0;
+}
+
+#endif /* BENCH_COMMON_H */
@@ -0,0 +1,132 @@
+/**
+ * @file bench_cstack.c
+ * @brief Scaling benchmark: ds_cstack_t versus a mutex-wrapped ds_stack_t
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * Every thread repeatedly pushes an item and pops one from a single
+ * shared stack, the access pattern of a shared free list. The run is
+ * repeated for 1 to 64 threads; n is the total number of operations.
+ * 
+ * Requires the library to be built with `make CONCURRENT=1`.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ds.h"
+#include "bench_common.h"
+
+#ifdef DS_ENABLE_CONCURRENT
+
+#include "ds_stack.h"
+#include "ds_cstack.h"
+#include <pthread.h>
+
+#define BENCH_OPS_TOTAL 2000000
+#define BENCH_MAX_THREADS 64
+
+enum bench_impl {
+    BENCH_CSTACK,
+    BENCH_LOCKED
+};
+
+struct bench_shared {
+    enum bench_impl impl;
+    ds_cstack_t *cstack;
+    ds_stack_t *stack;
+    pthread_mutex_t lock;
+    pthread_barrier_t start;
+    long ops_per_thread;
+};
+
+static int item = 1;
+
+static void *bench_worker(void *arg) {
+    struct bench_shared *sh = (struct bench_shared *)arg;
+    void *data;
+    long i;
+    
+    pthread_barrier_wait(&sh->start);
+    for (i = 0; i < sh->ops_per_thread; i++) {
+        if (sh->impl == BENCH_CSTACK) {
+            ds_cstack_push(sh->cstack, &item);
+            ds_cstack_pop(sh->cstack, &data);
+        } else {
+            pthread_mutex_lock(&sh->lock);
+            ds_stack_push(sh->stack, &item);
+            pthread_mutex_unlock(&sh->lock);
+            pthread_mutex_lock(&sh->lock);
+            data = ds_stack_pop(sh->stack);
+            pthread_mutex_unlock(&sh->lock);
+        }
+    }
+    (void)data;
+    return NULL;
+}
+
+/* Runs in the child: time push/pop pairs from b->threads threads */
+static void bench_run(struct bench_batch *b, void *arg) {
+    pthread_t threads[BENCH_MAX_THREADS];
+    struct bench_shared sh;
+    double t0, t1;
+    int i;
+    
+    sh.impl = *(const enum bench_impl *)arg;
+    sh.cstack = ds_cstack_create();
+    sh.stack = ds_stack_create();
+    sh.ops_per_thread = (long)(b->n / 2 / (size_t)b->threads);
+    pthread_mutex_init(&sh.lock, NULL);
+    pthread_barrier_init(&sh.start, NULL, (unsigned)b->threads + 1);
+    
+    for (i = 0; i < b->threads; i++) {
+        pthread_create(&threads[i], NULL, bench_worker, &sh);
+    }
+    pthread_barrier_wait(&sh.start);
+    t0 = bench_now();
+    for (i = 0; i < b->threads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    t1 = bench_now();
+    bench_record(b, "push_pop", 2 * (size_t)sh.ops_per_thread * (size_t)b->threads, t1 - t0);
+    
+    pthread_barrier_destroy(&sh.start);
+    pthread_mutex_destroy(&sh.lock);
+    ds_cstack_free(sh.cstack, NULL);
+    ds_stack_free(sh.stack, NULL);
+}
+
+int main(int argc, char **argv) {
+    static const char *const names[] = {"cstack", "stack_mutex"};
+    struct bench_opts opts;
+    struct bench_batch batch;
+    enum bench_impl impl;
+    int nthreads, failed = 0;
+    
+    if (bench_parse_opts(&opts, argc, argv) != 0) {
+        return EXIT_FAILURE;
+    }
+    
+    bench_begin(&opts);
+    for (nthreads = 1; nthreads <= BENCH_MAX_THREADS; nthreads *= 2) {
+        for (impl = BENCH_CSTACK; impl <= BENCH_LOCKED; impl++) {
+            batch.structure = names[impl];
+            batch.dist = "none";
+            batch.n = BENCH_OPS_TOTAL;
+            batch.threads = nthreads;
+            failed |= bench_isolated(&opts, &batch, bench_run, &impl);
+        }
+    }
+    bench_end(&opts);
+    
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+#else
+
+int main(void) {
+    fprintf(stderr, "bench_cstack: skipped, rebuild with make CONCURRENT=1\n");
+    return EXIT_SUCCESS;
+}
+
+#endif
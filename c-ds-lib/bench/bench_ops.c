@@ -0,0 +1,684 @@
+/**
+ * @file bench_ops.c
+ * @brief Single-threaded operation benchmarks for every container
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * Times the core operations of each container and mode for element counts
+ * from --min-n to --max-n in powers of ten. Ordered containers are run
+ * with random, sorted and reverse-sorted insertion orders; lookups and
+ * removals always use a random order. Structures whose lookups are linear
+ * (the list) or degenerate on sorted input (the unbalanced tree) are
+ * capped so a full run finishes in reasonable time.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ds.h"
+#include "ds_list.h"
+#include "ds_queue.h"
+#include "ds_deque.h"
+#include "ds_pqueue.h"
+#include "ds_stack.h"
+#include "ds_tree.h"
+#include "ds_btree.h"
+#include "ds_skiplist.h"
+#include "ds_hashmap.h"
+#include "ds_typed.h"
+#include "bench_common.h"
+
+/* Largest n for linear-time lookups and for degenerate tree shapes */
+#define BENCH_LINEAR_MAX_N 100000
+#define BENCH_DEGENERATE_MAX_N 10000
+
+/* Number of lookups/removals timed on containers with linear search */
+#define BENCH_LINEAR_PROBES 1000
+
+/* Group size for the batched lookups */
+#define BENCH_BATCH 256
+
+/* By-value instantiations compared against the void* containers */
+DS_DEFINE_TREE(bench_itree, int, (a > b) - (a < b))
+DS_DEFINE_QUEUE(bench_iqueue, int)
+DS_DEFINE_STACK(bench_istack, int)
+
+/**
+ * @brief Keys and lookup order for one configuration
+ */
+struct bench_keys {
+    size_t n;                      /**< Number of keys */
+    int *keys;                     /**< Keys in insertion order */
+    int *probe;                    /**< Same keys in random order */
+};
+
+/**
+ * @brief Benchmark case for one container mode
+ */
+struct bench_case {
+    const char *structure;                         /**< Reported structure name */
+    void (*run)(struct bench_batch *b, const struct bench_keys *k);
+    int keyed;                                     /**< Non-zero if insertion order matters */
+    size_t degenerate_max_n;                       /**< Cap for sorted/reverse runs (0 = none) */
+};
+
+static unsigned long long rng_state = 88172645463325252ULL;
+
+static unsigned long long rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static void shuffle(int *a, size_t n) {
+    size_t i, j;
+    int t;
+    
+    for (i = n; i > 1; i--) {
+        j = (size_t)(rng_next() % i);
+        t = a[i - 1];
+        a[i - 1] = a[j];
+        a[j] = t;
+    }
+}
+
+static int int_cmp(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    
+    return (x > y) - (x < y);
+}
+
+static void run_list(struct bench_batch *b, const struct bench_keys *k, ds_list_t *L) {
+    size_t i, probes = (k->n < BENCH_LINEAR_PROBES) ? k->n : BENCH_LINEAR_PROBES;
+    double t;
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        ds_list_push_back(L, &k->keys[i]);
+    }
+    bench_record(b, "push_back", k->n, bench_now() - t);
+    
+    if (k->n <= BENCH_LINEAR_MAX_N) {
+        t = bench_now();
+        for (i = 0; i < probes; i++) {
+            ds_list_find(L, &k->probe[i], int_cmp);
+        }
+        bench_record(b, "find", probes, bench_now() - t);
+        
+        t = bench_now();
+        for (i = 0; i < probes; i++) {
+            ds_list_remove(L, &k->probe[i], int_cmp);
+        }
+        bench_record(b, "remove", probes, bench_now() - t);
+    }
+    
+    t = bench_now();
+    ds_list_sort(L, int_cmp);
+    bench_record(b, "sort", ds_list_size(L), bench_now() - t);
+    
+    t = bench_now();
+    i = 0;
+    while (ds_list_pop_front(L) != NULL) {
+        i++;
+    }
+    bench_record(b, "pop_front", i, bench_now() - t);
+    
+    ds_list_free(L, NULL);
+}
+
+static void run_list_linked(struct bench_batch *b, const struct bench_keys *k) {
+    run_list(b, k, ds_list_create());
+}
+
+static void run_list_pooled(struct bench_batch *b, const struct bench_keys *k) {
+    run_list(b, k, ds_list_create_pooled());
+}
+
+static void run_list_unrolled(struct bench_batch *b, const struct bench_keys *k) {
+    run_list(b, k, ds_list_create_unrolled());
+}
+
+static void run_queue(struct bench_batch *b, const struct bench_keys *k, ds_queue_t *Q) {
+    size_t i;
+    double t;
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        ds_queue_enqueue(Q, &k->keys[i]);
+    }
+    bench_record(b, "enqueue", k->n, bench_now() - t);
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        ds_queue_dequeue(Q);
+    }
+    bench_record(b, "dequeue", k->n, bench_now() - t);
+    
+    ds_queue_free(Q, NULL);
+}
+
+static void run_queue_linked(struct bench_batch *b, const struct bench_keys *k) {
+    run_queue(b, k, ds_queue_create());
+}
+
+static void run_queue_pooled(struct bench_batch *b, const struct bench_keys *k) {
+    run_queue(b, k, ds_queue_create_pooled());
+}
+
+static void run_queue_ring(struct bench_batch *b, const struct bench_keys *k) {
+    run_queue(b, k, ds_queue_create_ring(0));
+}
+
+/* Hands a full queue to a second one element by element, then by splicing */
+static void run_queue_handoff(struct bench_batch *b, const struct bench_keys *k) {
+    ds_queue_t *Q = ds_queue_create();
+    ds_queue_t *R = ds_queue_create();
+    size_t i;
+    double t;
+    
+    for (i = 0; i < k->n; i++) {
+        ds_queue_enqueue(Q, &k->keys[i]);
+    }
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        ds_queue_enqueue(R, ds_queue_dequeue(Q));
+    }
+    bench_record(b, "handoff_copy", k->n, bench_now() - t);
+    
+    t = bench_now();
+    ds_queue_splice(Q, R);
+    bench_record(b, "handoff_splice", k->n, bench_now() - t);
+    
+    ds_queue_free(Q, NULL);
+    ds_queue_free(R, NULL);
+}
+
+static void run_deque(struct bench_batch *b, const struct bench_keys *k) {
+    ds_deque_t *D = ds_deque_create();
+    size_t i;
+    double t;
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        ds_deque_push_back(D, &k->keys[i]);
+    }
+    bench_record(b, "enqueue", k->n, bench_now() - t);
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        ds_deque_pop_front(D);
+    }
+    bench_record(b, "dequeue", k->n, bench_now() - t);
+    
+    ds_deque_free(D, NULL);
+}
+
+static void run_pqueue(struct bench_batch *b, const struct bench_keys *k) {
+    ds_pqueue_t *P = ds_pqueue_create(int_cmp, 0);
+    size_t i;
+    double t;
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        ds_pqueue_push(P, &k->keys[i]);
+    }
+    bench_record(b, "push", k->n, bench_now() - t);
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        ds_pqueue_pop(P);
+    }
+    bench_record(b, "pop", k->n, bench_now() - t);
+    
+    ds_pqueue_free(P, NULL);
+}
+
+static void run_stack(struct bench_batch *b, const struct bench_keys *k, ds_stack_t *S) {
+    size_t i;
+    double t;
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        ds_stack_push(S, &k->keys[i]);
+    }
+    bench_record(b, "push", k->n, bench_now() - t);
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        ds_stack_pop(S);
+    }
+    bench_record(b, "pop", k->n, bench_now() - t);
+    
+    ds_stack_free(S, NULL);
+}
+
+static void run_stack_linked(struct bench_batch *b, const struct bench_keys *k) {
+    run_stack(b, k, ds_stack_create());
+}
+
+static void run_stack_pooled(struct bench_batch *b, const struct bench_keys *k) {
+    run_stack(b, k, ds_stack_create_pooled());
+}
+
+static void run_stack_array(struct bench_batch *b, const struct bench_keys *k) {
+    run_stack(b, k, ds_stack_create_array(0));
+}
+
+static void run_tree(struct bench_batch *b, const struct bench_keys *k, ds_tree_t *T) {
+    void *batch_keys[BENCH_BATCH], *batch_out[BENCH_BATCH];
+    size_t i;
+    double t;
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        ds_tree_insert(T, &k->keys[i], int_cmp);
+    }
+    bench_record(b, "insert", k->n, bench_now() - t);
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        ds_tree_find(T, &k->probe[i], int_cmp);
+    }
+    bench_record(b, "find", k->n, bench_now() - t);
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i += BENCH_BATCH) {
+        size_t j, m = (k->n - i < BENCH_BATCH) ? k->n - i : BENCH_BATCH;
+        
+        for (j = 0; j < m; j++) {
+            batch_keys[j] = &k->probe[i + j];
+        }
+        ds_tree_find_batch(T, batch_keys, m, batch_out, int_cmp);
+    }
+    bench_record(b, "find_batch", k->n, bench_now() - t);
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        ds_tree_remove(T, &k->probe[i], int_cmp);
+    }
+    bench_record(b, "remove", k->n, bench_now() - t);
+    
+    // Lazy trees pay for their removes in one sweep
+    if (ds_tree_tombstones(T) > 0) {
+        t = bench_now();
+        ds_tree_compact(T);
+        bench_record(b, "compact", k->n, bench_now() - t);
+    }
+    
+    ds_tree_free(T, NULL);
+}
+
+static void run_tree_built(struct bench_batch *b, const struct bench_keys *k) {
+    void **items = (void **)malloc(k->n * sizeof(void *));
+    int *sorted = (int *)malloc(k->n * sizeof(int));
+    ds_tree_t *T;
+    size_t i;
+    double t;
+    
+    if (items == NULL || sorted == NULL) {
+        free(items);
+        free(sorted);
+        return;
+    }
+    
+    // Build from the keys in ascending order; only the build is timed
+    for (i = 0; i < k->n; i++) {
+        sorted[i] = (int)i;
+        items[i] = &sorted[i];
+    }
+    t = bench_now();
+    T = ds_tree_build_sorted(items, k->n);
+    bench_record(b, "build_sorted", k->n, bench_now() - t);
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        ds_tree_find(T, &k->probe[i], int_cmp);
+    }
+    bench_record(b, "find", k->n, bench_now() - t);
+    
+    ds_tree_free(T, NULL);
+    free(items);
+    free(sorted);
+}
+
+static void run_tree_plain(struct bench_batch *b, const struct bench_keys *k) {
+    run_tree(b, k, ds_tree_create());
+}
+
+static void run_tree_pooled(struct bench_batch *b, const struct bench_keys *k) {
+    run_tree(b, k, ds_tree_create_pooled());
+}
+
+static void run_tree_avl(struct bench_batch *b, const struct bench_keys *k) {
+    run_tree(b, k, ds_tree_create_balanced());
+}
+
+static void run_tree_compact(struct bench_batch *b, const struct bench_keys *k) {
+    run_tree(b, k, ds_tree_create_compact(0));
+}
+
+static void run_tree_lazy(struct bench_batch *b, const struct bench_keys *k) {
+    ds_tree_t *T = ds_tree_create_balanced();
+    
+    ds_tree_set_lazy_remove(T, 1.0, NULL);
+    run_tree(b, k, T);
+}
+
+/* Per-request scratch pattern: fill a list, queue, stack and tree, then tear all four down */
+static void run_scratch(struct bench_batch *b, const struct bench_keys *k, ds_arena_t *A) {
+    ds_allocator_t a = (A != NULL) ? ds_arena_allocator(A) : *ds_get_allocator();
+    ds_list_t *L = ds_list_create_with_allocator(&a);
+    ds_queue_t *Q = ds_queue_create_with_allocator(&a);
+    ds_stack_t *S = ds_stack_create_with_allocator(&a);
+    ds_tree_t *T = ds_tree_create_with_allocator(&a);
+    size_t i;
+    double t;
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        ds_list_push_back(L, &k->keys[i]);
+        ds_queue_enqueue(Q, &k->keys[i]);
+        ds_stack_push(S, &k->keys[i]);
+        ds_tree_insert(T, &k->keys[i], int_cmp);
+    }
+    bench_record(b, "build", k->n, bench_now() - t);
+    
+    t = bench_now();
+    ds_list_free(L, NULL);
+    ds_queue_free(Q, NULL);
+    ds_stack_free(S, NULL);
+    ds_tree_free(T, NULL);
+    if (A != NULL) {
+        ds_arena_reset(A);
+    }
+    bench_record(b, "teardown", k->n, bench_now() - t);
+}
+
+static void run_scratch_malloc(struct bench_batch *b, const struct bench_keys *k) {
+    run_scratch(b, k, NULL);
+}
+
+static void run_scratch_arena(struct bench_batch *b, const struct bench_keys *k) {
+    ds_arena_t *A = ds_arena_create(0);
+    
+    run_scratch(b, k, A);
+    ds_arena_free(A);
+}
+
+static void run_btree(struct bench_batch *b, const struct bench_keys *k) {
+    ds_btree_t *B = ds_btree_create();
+    size_t i;
+    double t;
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        ds_btree_insert(B, &k->keys[i], int_cmp);
+    }
+    bench_record(b, "insert", k->n, bench_now() - t);
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        ds_btree_find(B, &k->probe[i], int_cmp);
+    }
+    bench_record(b, "find", k->n, bench_now() - t);
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        ds_btree_remove(B, &k->probe[i], int_cmp);
+    }
+    bench_record(b, "remove", k->n, bench_now() - t);
+    
+    ds_btree_free(B, NULL);
+}
+
+static void run_skiplist(struct bench_batch *b, const struct bench_keys *k) {
+    ds_skiplist_t *S = ds_skiplist_create();
+    size_t i;
+    double t;
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        ds_skiplist_insert(S, &k->keys[i], int_cmp);
+    }
+    bench_record(b, "insert", k->n, bench_now() - t);
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        ds_skiplist_find(S, &k->probe[i], int_cmp);
+    }
+    bench_record(b, "find", k->n, bench_now() - t);
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        ds_skiplist_remove(S, &k->probe[i], int_cmp);
+    }
+    bench_record(b, "remove", k->n, bench_now() - t);
+    
+    ds_skiplist_free(S, NULL);
+}
+
+static void run_tree_typed(struct bench_batch *b, const struct bench_keys *k) {
+    bench_itree *t = bench_itree_create();
+    size_t i;
+    double t0;
+    
+    t0 = bench_now();
+    for (i = 0; i < k->n; i++) {
+        bench_itree_insert(t, k->keys[i]);
+    }
+    bench_record(b, "insert", k->n, bench_now() - t0);
+    
+    t0 = bench_now();
+    for (i = 0; i < k->n; i++) {
+        bench_itree_find(t, k->probe[i]);
+    }
+    bench_record(b, "find", k->n, bench_now() - t0);
+    
+    t0 = bench_now();
+    for (i = 0; i < k->n; i++) {
+        bench_itree_remove(t, k->probe[i]);
+    }
+    bench_record(b, "remove", k->n, bench_now() - t0);
+    
+    bench_itree_free(t);
+}
+
+static void run_queue_typed(struct bench_batch *b, const struct bench_keys *k) {
+    bench_iqueue *q = bench_iqueue_create(0);
+    size_t i;
+    int v;
+    double t;
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        bench_iqueue_enqueue(q, k->keys[i]);
+    }
+    bench_record(b, "enqueue", k->n, bench_now() - t);
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        bench_iqueue_dequeue(q, &v);
+    }
+    bench_record(b, "dequeue", k->n, bench_now() - t);
+    
+    bench_iqueue_free(q);
+}
+
+static void run_stack_typed(struct bench_batch *b, const struct bench_keys *k) {
+    bench_istack *s = bench_istack_create(0);
+    size_t i;
+    int v;
+    double t;
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        bench_istack_push(s, k->keys[i]);
+    }
+    bench_record(b, "push", k->n, bench_now() - t);
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        bench_istack_pop(s, &v);
+    }
+    bench_record(b, "pop", k->n, bench_now() - t);
+    
+    bench_istack_free(s);
+}
+
+static size_t int_hash(const void *key) {
+    return (size_t)*(const int *)key;
+}
+
+static int int_eq(const void *a, const void *b) {
+    return *(const int *)a == *(const int *)b;
+}
+
+static void run_hashmap(struct bench_batch *b, const struct bench_keys *k) {
+    ds_hashmap_t *H = ds_hashmap_create(int_hash, int_eq);
+    const void *batch_keys[BENCH_BATCH];
+    void *batch_out[BENCH_BATCH];
+    size_t i;
+    double t;
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        ds_hashmap_insert(H, &k->keys[i], &k->keys[i], NULL, NULL);
+    }
+    bench_record(b, "insert", k->n, bench_now() - t);
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        ds_hashmap_find(H, &k->probe[i]);
+    }
+    bench_record(b, "find", k->n, bench_now() - t);
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i += BENCH_BATCH) {
+        size_t j, m = (k->n - i < BENCH_BATCH) ? k->n - i : BENCH_BATCH;
+        
+        for (j = 0; j < m; j++) {
+            batch_keys[j] = &k->probe[i + j];
+        }
+        ds_hashmap_find_batch(H, batch_keys, m, batch_out);
+    }
+    bench_record(b, "find_batch", k->n, bench_now() - t);
+    
+    t = bench_now();
+    for (i = 0; i < k->n; i++) {
+        ds_hashmap_remove(H, &k->probe[i], NULL, NULL);
+    }
+    bench_record(b, "remove", k->n, bench_now() - t);
+    
+    ds_hashmap_free(H, NULL, NULL);
+}
+
+static const struct bench_case cases[] = {
+    {"list", run_list_linked, 0, 0},
+    {"list_pooled", run_list_pooled, 0, 0},
+    {"list_unrolled", run_list_unrolled, 0, 0},
+    {"queue", run_queue_linked, 0, 0},
+    {"queue_pooled", run_queue_pooled, 0, 0},
+    {"queue_ring", run_queue_ring, 0, 0},
+    {"queue_handoff", run_queue_handoff, 0, 0},
+    {"queue_typed", run_queue_typed, 0, 0},
+    {"deque", run_deque, 0, 0},
+    {"pqueue", run_pqueue, 1, 0},
+    {"stack", run_stack_linked, 0, 0},
+    {"stack_pooled", run_stack_pooled, 0, 0},
+    {"stack_array", run_stack_array, 0, 0},
+    {"stack_typed", run_stack_typed, 0, 0},
+    {"tree", run_tree_plain, 1, BENCH_DEGENERATE_MAX_N},
+    {"tree_pooled", run_tree_pooled, 1, BENCH_DEGENERATE_MAX_N},
+    {"tree_avl", run_tree_avl, 1, 0},
+    {"tree_compact", run_tree_compact, 1, 0},
+    {"tree_lazy", run_tree_lazy, 1, 0},
+    {"tree_built", run_tree_built, 0, 0},
+    {"tree_typed", run_tree_typed, 1, 0},
+    {"scratch", run_scratch_malloc, 1, BENCH_DEGENERATE_MAX_N},
+    {"scratch_arena", run_scratch_arena, 1, BENCH_DEGENERATE_MAX_N},
+    {"btree", run_btree, 1, 0},
+    {"skiplist", run_skiplist, 1, 0},
+    {"hashmap", run_hashmap, 1, 0}
+};
+
+static const char *const dists[] = {"random", "sorted", "reverse"};
+
+/**
+ * @brief Argument for one isolated configuration
+ */
+struct bench_config {
+    const struct bench_case *c;    /**< Case to run */
+    int dist;                      /**< Index into dists */
+};
+
+/* Runs in the child: build keys for the configuration, then measure */
+static void run_config(struct bench_batch *b, void *arg) {
+    const struct bench_config *cfg = (const struct bench_config *)arg;
+    struct bench_keys k;
+    size_t i;
+    
+    k.n = b->n;
+    k.keys = (int *)malloc(k.n * sizeof(int));
+    k.probe = (int *)malloc(k.n * sizeof(int));
+    if (k.keys == NULL || k.probe == NULL) {
+        free(k.keys);
+        free(k.probe);
+        return;
+    }
+    
+    for (i = 0; i < k.n; i++) {
+        k.keys[i] = (int)i;
+        k.probe[i] = (int)i;
+    }
+    shuffle(k.probe, k.n);
+    if (cfg->dist == 0) {
+        memcpy(k.keys, k.probe, k.n * sizeof(int));
+        shuffle(k.keys, k.n);
+    } else if (cfg->dist == 2) {
+        for (i = 0; i < k.n; i++) {
+            k.keys[i] = (int)(k.n - 1 - i);
+        }
+    }
+    
+    cfg->c->run(b, &k);
+    
+    free(k.keys);
+    free(k.probe);
+}
+
+int main(int argc, char **argv) {
+    struct bench_opts opts;
+    struct bench_batch batch;
+    struct bench_config cfg;
+    size_t ci, n;
+    int d, ndists, failed = 0;
+    
+    if (bench_parse_opts(&opts, argc, argv) != 0) {
+        return EXIT_FAILURE;
+    }
+    
+    bench_begin(&opts);
+    for (ci = 0; ci < sizeof(cases) / sizeof(cases[0]); ci++) {
+        cfg.c = &cases[ci];
+        ndists = cases[ci].keyed ? 3 : 1;
+        for (d = 0; d < ndists; d++) {
+            for (n = opts.min_n; n <= opts.max_n; n *= 10) {
+                if (d != 0 && cases[ci].degenerate_max_n != 0 && n > cases[ci].degenerate_max_n) {
+                    break;
+                }
+                
+                cfg.dist = d;
+                batch.structure = cases[ci].structure;
+                batch.dist = cases[ci].keyed ? dists[d] : "none";
+                batch.n = n;
+                batch.threads = 1;
+                failed |= bench_isolated(&opts, &batch, run_config, &cfg);
+            }
+        }
+    }
+    bench_end(&opts);
+    
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
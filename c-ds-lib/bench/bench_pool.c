@@ -0,0 +1,125 @@
+/**
+ * @file bench_pool.c
+ * @brief Scaling benchmark: parallel tree build and reduction on ds_pool_t
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * Builds a tree from shuffled keys with ds_tree_build_parallel and sums
+ * it with ds_tree_reduce_parallel, using pools of 1 to 64 workers. The
+ * one-worker rows are the baseline; n is the number of keys.
+ * 
+ * Requires the library to be built with `make CONCURRENT=1`.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ds.h"
+#include "bench_common.h"
+
+#ifdef DS_ENABLE_CONCURRENT
+
+#include "ds_tree.h"
+#include "ds_pool.h"
+
+#define BENCH_KEYS 1000000
+#define BENCH_MAX_THREADS 64
+
+static int int_cmp(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    
+    return (x > y) - (x < y);
+}
+
+static void sum_step(void *acc, void *data, void *ctx) {
+    (void)ctx;
+    *(long long *)acc += *(int *)data;
+}
+
+static void sum_merge(void *acc, const void *part, void *ctx) {
+    (void)ctx;
+    *(long long *)acc += *(const long long *)part;
+}
+
+/* Runs in the child: time a build and a full reduction with b->threads workers */
+static void bench_run(struct bench_batch *b, void *arg) {
+    unsigned long long rng = 88172645463325252ULL;
+    ds_pool_t *P = ds_pool_create((size_t)b->threads);
+    int *keys = (int *)malloc(b->n * sizeof(int));
+    void **items = (void **)malloc(b->n * sizeof(void *));
+    ds_tree_t *T;
+    long long sum = 0;
+    size_t i;
+    double t;
+    
+    (void)arg;
+    if (P == NULL || keys == NULL || items == NULL) {
+        ds_pool_free(P);
+        free(keys);
+        free(items);
+        return;
+    }
+    
+    for (i = 0; i < b->n; i++) {
+        keys[i] = (int)i;
+    }
+    for (i = b->n - 1; i > 0; i--) {
+        size_t j;
+        int tmp;
+        
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        j = (size_t)(rng % (i + 1));
+        tmp = keys[i];
+        keys[i] = keys[j];
+        keys[j] = tmp;
+    }
+    for (i = 0; i < b->n; i++) {
+        items[i] = &keys[i];
+    }
+    
+    t = bench_now();
+    T = ds_tree_build_parallel(P, items, b->n, int_cmp);
+    bench_record(b, "build", b->n, bench_now() - t);
+    
+    t = bench_now();
+    ds_tree_reduce_parallel(T, P, NULL, NULL, NULL, &sum, sizeof(sum), sum_step, sum_merge, NULL);
+    bench_record(b, "reduce", b->n, bench_now() - t);
+    
+    ds_tree_free(T, NULL);
+    ds_pool_free(P);
+    free(items);
+    free(keys);
+}
+
+int main(int argc, char **argv) {
+    struct bench_opts opts;
+    struct bench_batch batch;
+    int nthreads, failed = 0;
+    
+    if (bench_parse_opts(&opts, argc, argv) != 0) {
+        return EXIT_FAILURE;
+    }
+    
+    bench_begin(&opts);
+    for (nthreads = 1; nthreads <= BENCH_MAX_THREADS; nthreads *= 2) {
+        batch.structure = "tree_parallel";
+        batch.dist = "random";
+        batch.n = BENCH_KEYS;
+        batch.threads = nthreads;
+        failed |= bench_isolated(&opts, &batch, bench_run, NULL);
+    }
+    bench_end(&opts);
+    
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+#else
+
+int main(void) {
+    fprintf(stderr, "bench_pool: skipped, rebuild with make CONCURRENT=1\n");
+    return EXIT_SUCCESS;
+}
+
+#endif
@@ -0,0 +1,181 @@
+/**
+ * @file bench_spsc.c
+ * @brief Handoff benchmark: ds_spsc_ring_t versus ds_mpmc_queue_t and a mutex-wrapped ds_queue_t
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * One producer thread passes n items to one consumer thread through a
+ * 1024-slot channel, the stage-to-stage pattern of a pipeline. The ring
+ * is measured with single and with 32-element batch operations.
+ * 
+ * Requires the library to be built with `make CONCURRENT=1`.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ds.h"
+#include "bench_common.h"
+
+#ifdef DS_ENABLE_CONCURRENT
+
+#include "ds_queue.h"
+#include "ds_mpmc.h"
+#include "ds_spsc.h"
+#include <pthread.h>
+#include <sched.h>
+
+#define BENCH_ITEMS 4000000
+#define BENCH_CAPACITY 1024
+#define BENCH_BATCH 32
+
+enum bench_impl {
+    BENCH_SPSC,
+    BENCH_SPSC_BATCH,
+    BENCH_MPMC,
+    BENCH_LOCKED
+};
+
+struct bench_shared {
+    enum bench_impl impl;
+    ds_spsc_ring_t *ring;
+    ds_mpmc_queue_t *mpmc;
+    ds_queue_t *queue;
+    pthread_mutex_t lock;
+    size_t items;
+};
+
+static int item = 1;
+
+static void *bench_producer(void *arg) {
+    struct bench_shared *sh = (struct bench_shared *)arg;
+    void *batch[BENCH_BATCH];
+    size_t i, j;
+    
+    for (j = 0; j < BENCH_BATCH; j++) {
+        batch[j] = &item;
+    }
+    for (i = 0; i < sh->items; ) {
+        switch (sh->impl) {
+        case BENCH_SPSC:
+            ds_spsc_ring_enqueue(sh->ring, &item);
+            i++;
+            break;
+        case BENCH_SPSC_BATCH:
+            j = ds_spsc_ring_enqueue_n(sh->ring, batch, (sh->items - i < BENCH_BATCH) ? sh->items - i : BENCH_BATCH);
+            if (j == 0) {
+                sched_yield();
+            }
+            i += j;
+            break;
+        case BENCH_MPMC:
+            ds_mpmc_queue_enqueue(sh->mpmc, &item);
+            i++;
+            break;
+        default:
+            // The mutex-wrapped queue is unbounded, so cap it like the others
+            pthread_mutex_lock(&sh->lock);
+            if (ds_queue_size(sh->queue) < BENCH_CAPACITY) {
+                ds_queue_enqueue(sh->queue, &item);
+                i++;
+            }
+            pthread_mutex_unlock(&sh->lock);
+            break;
+        }
+    }
+    return NULL;
+}
+
+static void bench_consumer(struct bench_shared *sh) {
+    void *batch[BENCH_BATCH];
+    void *data = NULL;
+    size_t i, got;
+    
+    for (i = 0; i < sh->items; ) {
+        switch (sh->impl) {
+        case BENCH_SPSC:
+            data = ds_spsc_ring_dequeue(sh->ring);
+            i++;
+            break;
+        case BENCH_SPSC_BATCH:
+            got = ds_spsc_ring_dequeue_n(sh->ring, batch, BENCH_BATCH);
+            if (got == 0) {
+                sched_yield();
+            }
+            i += got;
+            break;
+        case BENCH_MPMC:
+            data = ds_mpmc_queue_dequeue(sh->mpmc);
+            i++;
+            break;
+        default:
+            pthread_mutex_lock(&sh->lock);
+            if (!ds_queue_is_empty(sh->queue)) {
+                data = ds_queue_dequeue(sh->queue);
+                i++;
+            }
+            pthread_mutex_unlock(&sh->lock);
+            break;
+        }
+    }
+    (void)data;
+}
+
+/* Runs in the child: time the handoff of b->n items */
+static void bench_run(struct bench_batch *b, void *arg) {
+    struct bench_shared sh;
+    pthread_t producer;
+    double t0, t1;
+    
+    sh.impl = *(const enum bench_impl *)arg;
+    sh.ring = ds_spsc_ring_create(BENCH_CAPACITY);
+    sh.mpmc = ds_mpmc_queue_create(BENCH_CAPACITY);
+    sh.queue = ds_queue_create();
+    sh.items = b->n;
+    pthread_mutex_init(&sh.lock, NULL);
+    
+    t0 = bench_now();
+    pthread_create(&producer, NULL, bench_producer, &sh);
+    bench_consumer(&sh);
+    pthread_join(producer, NULL);
+    t1 = bench_now();
+    bench_record(b, "handoff", sh.items, t1 - t0);
+    
+    pthread_mutex_destroy(&sh.lock);
+    ds_spsc_ring_free(sh.ring, NULL);
+    ds_mpmc_queue_free(sh.mpmc, NULL);
+    ds_queue_free(sh.queue, NULL);
+}
+
+int main(int argc, char **argv) {
+    static const char *const names[] = {"spsc_ring", "spsc_ring_batch", "mpmc", "queue_mutex"};
+    struct bench_opts opts;
+    struct bench_batch batch;
+    enum bench_impl impl;
+    int failed = 0;
+    
+    if (bench_parse_opts(&opts, argc, argv) != 0) {
+        return EXIT_FAILURE;
+    }
+    
+    bench_begin(&opts);
+    for (impl = BENCH_SPSC; impl <= BENCH_LOCKED; impl++) {
+        batch.structure = names[impl];
+        batch.dist = "none";
+        batch.n = BENCH_ITEMS;
+        batch.threads = 2;
+        failed |= bench_isolated(&opts, &batch, bench_run, &impl);
+    }
+    bench_end(&opts);
+    
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+#else
+
+int main(void) {
+    fprintf(stderr, "bench_spsc: skipped, rebuild with make CONCURRENT=1\n");
+    return EXIT_SUCCESS;
+}
+
+#endif
@@ -0,0 +1,109 @@
+/**
+ * @file bench_trace.c
+ * @brief Tracing overhead benchmark: hot operations with sampling off, 1-in-64 and every call
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * Times ds_tree_find on a balanced tree and a ds_queue_enqueue /
+ * ds_queue_dequeue round trip under each sampling period, so the rows
+ * show what the compiled-in tracing layer costs when it is idle, when it
+ * samples and when it times every call.
+ * 
+ * Requires the library to be built with `make TRACE=1`.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ds.h"
+#include "bench_common.h"
+
+#ifdef DS_ENABLE_TRACE
+
+#include "ds_queue.h"
+#include "ds_tree.h"
+#include "ds_trace.h"
+
+static int int_cmp(const void *a, const void *b) {
+    int x = *(const int *)a;
+    int y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+/* Runs in the child: time both workloads under the period in arg */
+static void bench_run(struct bench_batch *b, void *arg) {
+    int *keys = (int *)malloc(b->n * sizeof(int));
+    void **items = (void **)malloc(b->n * sizeof(void *));
+    ds_tree_t *T;
+    ds_queue_t *Q = ds_queue_create();
+    size_t i;
+    double t;
+    
+    if (keys == NULL || items == NULL || Q == NULL) {
+        free(keys);
+        free(items);
+        ds_queue_free(Q, NULL);
+        return;
+    }
+    for (i = 0; i < b->n; i++) {
+        keys[i] = (int)i;
+        items[i] = &keys[i];
+    }
+    T = ds_tree_build_sorted(items, b->n);
+    ds_trace_set_sampling(*(const unsigned *)arg);
+    
+    t = bench_now();
+    for (i = 0; i < b->n; i++) {
+        ds_tree_find(T, &keys[(i * 7919) % b->n], int_cmp);
+    }
+    bench_record(b, "tree_find", b->n, bench_now() - t);
+    
+    t = bench_now();
+    for (i = 0; i < b->n; i++) {
+        ds_queue_enqueue(Q, &keys[i]);
+        ds_queue_dequeue(Q);
+    }
+    bench_record(b, "queue_round_trip", b->n, bench_now() - t);
+    
+    ds_trace_set_sampling(0);
+    ds_tree_free(T, NULL);
+    ds_queue_free(Q, NULL);
+    free(items);
+    free(keys);
+}
+
+int main(int argc, char **argv) {
+    static const char *const names[] = {"trace_off", "trace_1in64", "trace_every"};
+    static const unsigned periods[] = {0, 64, 1};
+    struct bench_opts opts;
+    struct bench_batch batch;
+    size_t n;
+    int failed = 0;
+    
+    if (bench_parse_opts(&opts, argc, argv) != 0) {
+        return EXIT_FAILURE;
+    }
+    
+    bench_begin(&opts);
+    for (n = opts.min_n; n <= opts.max_n; n *= 10) {
+        for (size_t p = 0; p < sizeof(periods) / sizeof(periods[0]); p++) {
+            batch.structure = names[p];
+            batch.dist = "none";
+            batch.n = n;
+            batch.threads = 1;
+            failed |= bench_isolated(&opts, &batch, bench_run, (void *)&periods[p]);
+        }
+    }
+    bench_end(&opts);
+    
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+#else
+
+int main(void) {
+    fprintf(stderr, "bench_trace: skipped, rebuild with make TRACE=1\n");
+    return EXIT_SUCCESS;
+}
+
+#endif
@@ -25,7 +25,10 @@ typedef enum ds_error {
     DS_ERR_OOM,       /**< Out of memory error */
     DS_ERR_INVALID,   /**< Invalid argument or operation */
     DS_ERR_NOTFOUND,  /**< Element not found */
-    DS_ERR_NULLARG    /**< Null argument provided */
+    DS_ERR_NULLARG,   /**< Null argument provided */
+    DS_ERR_FULL,      /**< Bounded container has no free slot */
+    DS_ERR_EMPTY,     /**< Container has no element to remove */
+    DS_ERR_IO         /**< File or descriptor operation failed (see errno) */
 } ds_error_t;
 
 /**
@@ -52,6 +55,22 @@ typedef struct ds_stack ds_stack_t;
  */
 typedef struct ds_queue ds_queue_t;
 
+/**
+ * @brief Opaque type for double-ended queue data structure
+ * 
+ * The actual structure definition is hidden from users.
+ * All operations are performed through the public API functions.
+ */
+typedef struct ds_deque ds_deque_t;
+
+/**
+ * @brief Opaque type for priority queue data structure
+ * 
+ * The actual structure definition is hidden from users.
+ * All operations are performed through the public API functions.
+ */
+typedef struct ds_pqueue ds_pqueue_t;
+
 /**
  * @brief Opaque type for tree data structure
  * 
@@ -60,6 +79,156 @@ typedef struct ds_queue ds_queue_t;
  */
 typedef struct ds_tree ds_tree_t;
 
+/**
+ * @brief Opaque type for B-tree ordered container
+ * 
+ * The actual structure definition is hidden from users.
+ * All operations are performed through the public API functions.
+ */
+typedef struct ds_btree ds_btree_t;
+
+/**
+ * @brief Opaque type for skip list ordered container
+ * 
+ * The actual structure definition is hidden from users.
+ * All operations are performed through the public API functions.
+ */
+typedef struct ds_skiplist ds_skiplist_t;
+
+/**
+ * @brief Opaque type for open-addressing hash map
+ * 
+ * The actual structure definition is hidden from users.
+ * All operations are performed through the public API functions.
+ */
+typedef struct ds_hashmap ds_hashmap_t;
+
+/**
+ * @brief Opaque type for a read-only memory-mapped snapshot
+ * 
+ * Written by ds_tree_save or ds_list_save and opened with
+ * ds_tree_open_mapped or ds_list_open_mapped. See ds_snapshot.h.
+ */
+typedef struct ds_snapshot ds_snapshot_t;
+
+/**
+ * @brief Opaque type for bounded lock-free MPMC queue
+ * 
+ * Only available when the library is built with CONCURRENT=1.
+ */
+typedef struct ds_mpmc_queue ds_mpmc_queue_t;
+
+/**
+ * @brief Opaque type for bounded single-producer/single-consumer ring
+ * 
+ * Only available when the library is built with CONCURRENT=1.
+ */
+typedef struct ds_spsc_ring ds_spsc_ring_t;
+
+/**
+ * @brief Opaque type for lock-free concurrent stack
+ * 
+ * Only available when the library is built with CONCURRENT=1.
+ */
+typedef struct ds_cstack ds_cstack_t;
+
+/**
+ * @brief Opaque type for work-stealing thread pool
+ * 
+ * Only available when the library is built with CONCURRENT=1.
+ */
+typedef struct ds_pool ds_pool_t;
+
+/**
+ * @brief Opaque types for intrusive list, queue and stack
+ * 
+ * Intrusive containers link ds_link_t hooks embedded in user structures
+ * instead of allocating their own nodes. See ds_intrusive.h.
+ */
+typedef struct ds_ilist ds_ilist_t;
+typedef struct ds_iqueue ds_iqueue_t;
+typedef struct ds_istack ds_istack_t;
+
+/**
+ * @brief Opaque type for fixed-size slab pool
+ * 
+ * A slab pool hands out equally sized objects from large contiguous
+ * slabs, recycling released objects through an internal free list.
+ */
+typedef struct ds_slab ds_slab_t;
+
+/**
+ * @brief Opaque type for arena (region) allocator
+ * 
+ * An arena bump-allocates objects of any size from large blocks and
+ * releases all of them at once when it is reset.
+ */
+typedef struct ds_arena ds_arena_t;
+
+/**
+ * @brief Pluggable allocator interface
+ * 
+ * Bundles an allocation callback, the matching deallocation callback
+ * and an opaque context pointer that is passed back to both. Allocators
+ * can be installed library-wide with ds_set_allocator() or handed to
+ * the *_create_with_allocator() constructors for node storage.
+ * 
+ * An allocator for node storage may leave free NULL. Such a bulk
+ * allocator (see ds_arena_allocator()) reclaims memory by itself, so
+ * containers never release its nodes individually and their *_free()
+ * functions only visit the nodes when a free_data callback is given.
+ */
+typedef struct ds_allocator {
+    void *(*alloc)(void *ctx, size_t n);  /**< Allocate n bytes, NULL on failure */
+    void (*free)(void *ctx, void *p);     /**< Release memory obtained from alloc */
+    void *ctx;                            /**< User context passed to alloc/free */
+} ds_allocator_t;
+
+/**
+ * @brief Snapshot of runtime counters
+ * 
+ * Every container keeps these counters for itself, and the library keeps
+ * a second, library-wide set that sums all containers. The counters are
+ * plain integers updated in line with each operation, so reading them
+ * costs nothing until a snapshot is taken. In builds with
+ * DS_ENABLE_CONCURRENT the library-wide set is updated with relaxed
+ * atomic adds, so separate containers may be used from different threads
+ * at once; otherwise it is not synchronized. The lock-free containers
+ * are not counted.
+ */
+typedef struct ds_stats {
+    size_t allocs;        /**< Storage allocations (nodes, rings, tables) */
+    size_t frees;         /**< Storage releases */
+    size_t bytes_live;    /**< Bytes currently allocated for storage */
+    size_t bytes_peak;    /**< High-water mark of bytes_live */
+    size_t size;          /**< Elements currently stored */
+    size_t peak_size;     /**< High-water mark of size */
+    size_t finds;         /**< Lookups performed (find and batch finds) */
+    size_t find_depth;    /**< Nodes or slots visited by all lookups */
+    size_t compares;      /**< Comparator or equality callback invocations */
+} ds_stats_t;
+
+/**
+ * @brief Install the library-level allocator
+ * 
+ * Replaces the allocator used by ds_alloc/ds_free and by every container
+ * created afterwards without an explicit allocator. The allocator is
+ * copied, but its context must outlive all memory obtained from it.
+ * 
+ * @param a Allocator to install, or NULL to restore the malloc/free default
+ * @return DS_OK on success, DS_ERR_INVALID if a is missing its callbacks
+ * 
+ * @note Set this once at startup, before any container is created
+ */
+ds_error_t ds_set_allocator(const ds_allocator_t *a);
+
+/**
+ * @brief Get the library-level allocator
+ * 
+ * @return Pointer to the allocator currently used by ds_alloc/ds_free
+ */
+const ds_allocator_t *ds_get_allocator(void);
+
 /**
  * @brief Memory allocation wrapper
  * 
@@ -70,7 +239,7 @@ typedef struct ds_tree ds_tree_t;
  * @param n Number of bytes to allocate
  * @return Pointer to allocated memory, or NULL on failure
  * 
- * @note This function may be overridden for custom memory management
+ * @note Routed through the allocator installed with ds_set_allocator()
  */
 void *ds_alloc(size_t n);
 
@@ -87,6 +256,103 @@ void *ds_alloc(size_t n);
  */
 void ds_free(void *p);
 
+/**
+ * @brief Create a new fixed-size slab pool
+ * 
+ * Objects are carved out of slabs of objs_per_slab objects each, which
+ * are obtained from the library-level allocator on demand. Released
+ * objects are recycled and slabs are only returned by ds_slab_free().
+ * 
+ * @param obj_size Size in bytes of each object
+ * @param objs_per_slab Number of objects per slab (0 selects a default)
+ * @return Pointer to new pool on success, NULL if obj_size is 0, a slab of
+ *         objs_per_slab objects would not fit in a size_t, or on memory failure
+ */
+ds_slab_t *ds_slab_create(size_t obj_size, size_t objs_per_slab);
+
+/**
+ * @brief Free a slab pool and every object it handed out
+ * 
+ * @param P Pointer to pool to free
+ * @return DS_OK on success, DS_ERR_NULLARG if P is NULL
+ */
+ds_error_t ds_slab_free(ds_slab_t *P);
+
+/**
+ * @brief Get the number of bytes a slab pool holds
+ * 
+ * Counts the pool structure and every slab it has allocated, whether
+ * or not their objects are in use.
+ * 
+ * @param P Pointer to pool
+ * @return Bytes held, 0 if P is NULL
+ */
+size_t ds_slab_bytes(const ds_slab_t *P);
+
+/**
+ * @brief Get an allocator that draws from a slab pool
+ * 
+ * Requests larger than the pool's object size fail with NULL.
+ * 
+ * @param P Pointer to pool
+ * @return Allocator bound to P (callbacks are NULL if P is NULL)
+ */
+ds_allocator_t ds_slab_allocator(ds_slab_t *P);
+
+/**
+ * @brief Create a new arena
+ * 
+ * Memory is bump-allocated from blocks of block_size bytes, which are
+ * obtained from the library-level allocator on demand. Larger requests
+ * get a block of their own.
+ * 
+ * @param block_size Usable bytes per block (0 selects a default)
+ * @return Pointer to new arena on success, NULL on memory failure
+ */
+ds_arena_t *ds_arena_create(size_t block_size);
+
+/**
+ * @brief Release everything allocated from an arena at once
+ * 
+ * Runs in O(1): the blocks are kept and reused by later allocations.
+ * Every container whose nodes came from the arena must have been freed
+ * (or must not be used again) before the reset.
+ * 
+ * @param A Pointer to arena
+ * @return DS_OK on success, DS_ERR_NULLARG if A is NULL
+ */
+ds_error_t ds_arena_reset(ds_arena_t *A);
+
+/**
+ * @brief Free an arena and every object it handed out
+ * 
+ * @param A Pointer to arena to free
+ * @return DS_OK on success, DS_ERR_NULLARG if A is NULL
+ */
+ds_error_t ds_arena_free(ds_arena_t *A);
+
+/**
+ * @brief Get the number of bytes handed out since the last reset
+ * 
+ * @param A Pointer to arena
+ * @return Bytes in use, including alignment padding, or 0 if A is NULL
+ */
+size_t ds_arena_used(const ds_arena_t *A);
+
+/**
+ * @brief Get a bulk allocator that draws from an arena
+ * 
+ * Pass it to a *_create_with_allocator() constructor to place every
+ * node of the container in the arena. The allocator has no free
+ * callback: removed nodes stay allocated until the arena is reset, and
+ * freeing the container without free_data does not visit its nodes.
+ * The allocator cannot be installed with ds_set_allocator().
+ * 
+ * @param A Pointer to arena
+ * @return Allocator bound to A (alloc is NULL if A is NULL)
+ */
+ds_allocator_t ds_arena_allocator(ds_arena_t *A);
+
 /**
  * @brief Enable or disable learning mode
  * 
@@ -103,14 +369,43 @@ void ds_enable_learning_mode(int enable);
 /**
  * @brief Dump current state of all data structures
  * 
- * This function prints the current state of all active data structures
- * to stdout. Useful for debugging and learning purposes.
- * 
- * @note Only works when learning mode is enabled
- * @note The output format is implementation-defined
+ * Prints the library-wide counters (see ds_stats_get) to stdout as one
+ * line of JSON. Useful for debugging and learning purposes.
  */
 void ds_dump_state(void);
 
+/**
+ * @brief Take a snapshot of the library-wide counters
+ * 
+ * The average lookup depth is find_depth / finds.
+ * 
+ * @param out Receives the counters
+ * @return DS_OK on success, DS_ERR_NULLARG if out is NULL
+ */
+ds_error_t ds_stats_get(ds_stats_t *out);
+
+/**
+ * @brief Reset the library-wide operation counters
+ * 
+ * Clears allocs, frees, finds, find_depth and compares, and lowers the
+ * peaks to the current values. Live byte and element counts are kept,
+ * since the storage they describe still exists.
+ */
+void ds_stats_reset(void);
+
+/**
+ * @brief Format a counter snapshot as a JSON object
+ * 
+ * Behaves like snprintf: at most len bytes including the terminator are
+ * written, and the full length is returned so callers can size buf.
+ * 
+ * @param s Counters to format
+ * @param buf Output buffer (may be NULL if len is 0)
+ * @param len Size of buf in bytes
+ * @return Length of the complete JSON text, excluding the terminator, or 0 if s is NULL
+ */
+size_t ds_stats_to_json(const ds_stats_t *s, char *buf, size_t len);
+
 /**
  * @mainpage Data Structures Library
  * 
@@ -127,17 +422,30 @@ void ds_dump_state(void);
  *   The library only stores pointers to this data and does not manage
  *   its lifetime.
  * 
+ * - **Intrusive containers** (ds_ilist_t, ds_iqueue_t, ds_istack_t) are
+ *   the exception: the links live inside caller-owned structures, so
+ *   the library never allocates or frees per-element memory for them.
+ * 
  * @section memory Memory Management
  * 
  * The library uses custom allocator wrappers (ds_alloc/ds_free) to
- * provide consistent memory management. Users can override these
- * functions for custom memory management if needed.
+ * provide consistent memory management. A custom ds_allocator_t can be
+ * installed library-wide with ds_set_allocator(), or passed to the
+ * *_create_with_allocator() constructors to control node storage of a
+ * single container. The *_create_pooled() constructors give a container
+ * its own slab pool so that nodes are not allocated one by one.
  * 
  * @section errors Error Handling
  * 
  * All functions return ds_error_t codes to indicate success or failure.
  * Always check return values before using results.
  * 
+ * @section stats Runtime Statistics
+ * 
+ * Each container exposes its counters through ds_<container>_stats(),
+ * and ds_stats_get() returns the library-wide totals. Snapshots can be
+ * exported with ds_stats_to_json().
+ * 
  * @section learning Learning Mode
  * 
  * Enable learning mode with ds_enable_learning_mode(1) to get
@@ -0,0 +1,142 @@
+/**
+ * @file ds_btree.h
+ * @brief B-tree ordered container interface
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * This header provides the interface for the B-tree ordered container.
+ * Each node stores many keys contiguously, so a lookup touches far fewer
+ * cache lines than a binary tree of the same size. Keys are compared with
+ * the same comparator convention as ds_tree_insert/ds_tree_find.
+ */
+
+#ifndef DS_BTREE_H
+#define DS_BTREE_H
+
+#include "ds.h"
+#include <stdio.h>  /* for FILE */
+
+/**
+ * @brief Create a new empty B-tree
+ * 
+ * Allocates and initializes a new B-tree structure.
+ * 
+ * @return Pointer to new B-tree on success, NULL on memory allocation failure
+ */
+ds_btree_t *ds_btree_create(void);
+
+/**
+ * @brief Free a B-tree and optionally its data
+ * 
+ * Deallocates all nodes in the B-tree. If free_data is provided,
+ * it will be called for each stored data pointer.
+ * 
+ * @param B Pointer to B-tree to free
+ * @param free_data Optional function to free element data (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if B is NULL
+ */
+ds_error_t ds_btree_free(ds_btree_t *B, void (*free_data)(void *));
+
+/**
+ * @brief Insert element into the B-tree
+ * 
+ * Inserts a new element using the comparison function to determine its
+ * position. Inserting an element equal to an existing one is a no-op.
+ * 
+ * @param B Pointer to B-tree
+ * @param data Pointer to data to insert
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return DS_OK on success, DS_ERR_NULLARG if B, data, or cmp is NULL, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_btree_insert(ds_btree_t *B, void *data, int (*cmp)(const void *, const void *));
+
+/**
+ * @brief Find element in the B-tree
+ * 
+ * @param B Pointer to B-tree
+ * @param target Pointer to data to find
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return Pointer to matching data, or NULL if not found or B/cmp/target is NULL
+ */
+void *ds_btree_find(ds_btree_t *B, void *target, int (*cmp)(const void *, const void *));
+
+/**
+ * @brief Remove element from the B-tree
+ * 
+ * @param B Pointer to B-tree
+ * @param target Pointer to data to remove
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return DS_OK on success, DS_ERR_NULLARG if B, target, or cmp is NULL, DS_ERR_NOTFOUND if not found
+ */
+ds_error_t ds_btree_remove(ds_btree_t *B, void *target, int (*cmp)(const void *, const void *));
+
+/**
+ * @brief Visit all elements in the closed range [lo, hi] in order
+ * 
+ * Calls cb for every element e with cmp(lo, e) <= 0 and cmp(e, hi) <= 0,
+ * in ascending order. A NULL bound leaves that side of the range open.
+ * Iteration stops early when cb returns non-zero.
+ * 
+ * @param B Pointer to B-tree
+ * @param lo Lower bound (NULL for no lower bound)
+ * @param hi Upper bound (NULL for no upper bound)
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @param cb Callback invoked with each element and ctx
+ * @param ctx User context passed to cb
+ * @return DS_OK on success, DS_ERR_NULLARG if B, cmp, or cb is NULL
+ */
+ds_error_t ds_btree_range(ds_btree_t *B, const void *lo, const void *hi,
+                          int (*cmp)(const void *, const void *),
+                          int (*cb)(void *data, void *ctx), void *ctx);
+
+/**
+ * @brief Get the number of elements in the B-tree
+ * 
+ * @param B Pointer to B-tree
+ * @return Number of elements in B-tree, or 0 if B is NULL
+ */
+size_t ds_btree_size(const ds_btree_t *B);
+
+/**
+ * @brief Check if B-tree is empty
+ * 
+ * @param B Pointer to B-tree
+ * @return 1 if empty, 0 if not empty, 1 if B is NULL
+ */
+int ds_btree_is_empty(const ds_btree_t *B);
+
+/**
+ * @brief Get the height of the B-tree
+ * 
+ * @param B Pointer to B-tree
+ * @return Number of node levels, or 0 if B is NULL or empty
+ */
+size_t ds_btree_height(const ds_btree_t *B);
+
+/**
+ * @brief Get the runtime counters of a B-tree
+ * 
+ * Reports node allocations, live bytes, element counts, comparator calls
+ * and, for lookups, the nodes visited (see ds_stats_t).
+ * 
+ * @param B Pointer to B-tree
+ * @param out Receives the counters
+ * @return DS_OK on success, DS_ERR_NULLARG if B or out is NULL
+ */
+ds_error_t ds_btree_stats(const ds_btree_t *B, ds_stats_t *out);
+
+/**
+ * @brief Visualize the B-tree structure
+ * 
+ * Prints each node with its keys, one level of indentation per depth.
+ * Useful for debugging and learning purposes.
+ * 
+ * @param B Pointer to B-tree
+ * @param out Output stream (e.g., stdout, stderr)
+ * 
+ * @note Safe to call with NULL B or out
+ */
+void ds_btree_visualize(const ds_btree_t *B, FILE *out);
+
+#endif /* DS_BTREE_H */
@@ -0,0 +1,87 @@
+/**
+ * @file ds_cstack.h
+ * @brief Lock-free concurrent stack interface
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * This header provides a Treiber stack that any number of threads may
+ * push to and pop from concurrently without a lock. Popped nodes are
+ * reclaimed with hazard pointers: a node is only returned to ds_free once
+ * no thread can still be reading it, which also rules out ABA on the top
+ * pointer. Each thread that pops owns one hazard record, which is handed
+ * back automatically when the thread exits.
+ * 
+ * @note Only available when the library is built with `make CONCURRENT=1`.
+ *       The library-level allocator must be thread-safe (the default is).
+ */
+
+#ifndef DS_CSTACK_H
+#define DS_CSTACK_H
+
+#include "ds.h"
+
+/**
+ * @brief Create a new empty concurrent stack
+ * 
+ * @return Pointer to new stack on success, NULL on memory allocation failure
+ */
+ds_cstack_t *ds_cstack_create(void);
+
+/**
+ * @brief Free a concurrent stack and optionally its data
+ * 
+ * @param S Pointer to stack to free
+ * @param free_data Optional function to free element data (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if S is NULL
+ * 
+ * @note Not thread-safe: no other thread may use S during or after this call
+ */
+ds_error_t ds_cstack_free(ds_cstack_t *S, void (*free_data)(void *));
+
+/**
+ * @brief Push element onto the stack
+ * 
+ * @param S Pointer to stack
+ * @param data Pointer to data to push
+ * @return DS_OK on success, DS_ERR_NULLARG if S or data is NULL, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_cstack_push(ds_cstack_t *S, void *data);
+
+/**
+ * @brief Pop element from the stack
+ * 
+ * @param S Pointer to stack
+ * @param out Receives the popped data pointer
+ * @return DS_OK on success, DS_ERR_NULLARG if S or out is NULL, DS_ERR_EMPTY if the stack is empty,
+ *         DS_ERR_OOM if the calling thread's hazard record cannot be allocated
+ */
+ds_error_t ds_cstack_pop(ds_cstack_t *S, void **out);
+
+/**
+ * @brief Get the number of elements in the stack
+ * 
+ * @param S Pointer to stack
+ * @return Number of elements in stack, or 0 if S is NULL
+ * 
+ * @note The value is a snapshot and may be stale while other threads run
+ */
+size_t ds_cstack_size(const ds_cstack_t *S);
+
+/**
+ * @brief Check if stack is empty
+ * 
+ * @param S Pointer to stack
+ * @return 1 if empty, 0 if not empty, 1 if S is NULL
+ */
+int ds_cstack_is_empty(const ds_cstack_t *S);
+
+/**
+ * @brief Free the calling thread's retired nodes that are no longer in use
+ * 
+ * Reclamation normally runs on its own once enough nodes have been
+ * popped. Call this to release memory early, e.g. at shutdown.
+ */
+void ds_cstack_reclaim(void);
+
+#endif /* DS_CSTACK_H */
@@ -0,0 +1,151 @@
+/**
+ * @file ds_deque.h
+ * @brief Double-ended queue data structure interface
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * This header provides the interface for the double-ended queue. Elements
+ * live in fixed-size contiguous blocks reached through a block map, so
+ * both ends support O(1) push and pop, any element can be read by index
+ * in O(1), and no allocation happens per element.
+ */
+
+#ifndef DS_DEQUE_H
+#define DS_DEQUE_H
+
+#include "ds.h"
+#include <stdio.h>  /* for FILE */
+
+/**
+ * @brief Create a new empty deque
+ * 
+ * @return Pointer to new deque on success, NULL on memory allocation failure
+ */
+ds_deque_t *ds_deque_create(void);
+
+/**
+ * @brief Free a deque and optionally its data
+ * 
+ * Deallocates all blocks of the deque. If free_data is provided,
+ * it will be called for each element's data pointer, front to back.
+ * 
+ * @param D Pointer to deque to free
+ * @param free_data Optional function to free element data (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if D is NULL
+ */
+ds_error_t ds_deque_free(ds_deque_t *D, void (*free_data)(void *));
+
+/**
+ * @brief Insert element at the front of the deque
+ * 
+ * @param D Pointer to deque
+ * @param data Pointer to data to insert
+ * @return DS_OK on success, DS_ERR_NULLARG if D or data is NULL, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_deque_push_front(ds_deque_t *D, void *data);
+
+/**
+ * @brief Insert element at the back of the deque
+ * 
+ * @param D Pointer to deque
+ * @param data Pointer to data to insert
+ * @return DS_OK on success, DS_ERR_NULLARG if D or data is NULL, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_deque_push_back(ds_deque_t *D, void *data);
+
+/**
+ * @brief Remove and return the front element
+ * 
+ * @param D Pointer to deque
+ * @return Pointer to data of removed element, or NULL if deque is empty or D is NULL
+ */
+void *ds_deque_pop_front(ds_deque_t *D);
+
+/**
+ * @brief Remove and return the back element
+ * 
+ * @param D Pointer to deque
+ * @return Pointer to data of removed element, or NULL if deque is empty or D is NULL
+ */
+void *ds_deque_pop_back(ds_deque_t *D);
+
+/**
+ * @brief Peek at the front element without removing it
+ * 
+ * @param D Pointer to deque
+ * @return Pointer to front element's data, or NULL if deque is empty or D is NULL
+ */
+void *ds_deque_peek_front(const ds_deque_t *D);
+
+/**
+ * @brief Peek at the back element without removing it
+ * 
+ * @param D Pointer to deque
+ * @return Pointer to back element's data, or NULL if deque is empty or D is NULL
+ */
+void *ds_deque_peek_back(const ds_deque_t *D);
+
+/**
+ * @brief Get the element at a position
+ * 
+ * @param D Pointer to deque
+ * @param index Position counted from the front (0 is the front element)
+ * @return Pointer to the element's data, or NULL if index is out of range or D is NULL
+ */
+void *ds_deque_get(const ds_deque_t *D, size_t index);
+
+/**
+ * @brief Replace the element at a position
+ * 
+ * The previous data pointer is overwritten without being freed.
+ * 
+ * @param D Pointer to deque
+ * @param index Position counted from the front (0 is the front element)
+ * @param data Pointer to new data
+ * @return DS_OK on success, DS_ERR_NULLARG if D or data is NULL, DS_ERR_INVALID if index is out of range
+ */
+ds_error_t ds_deque_set(ds_deque_t *D, size_t index, void *data);
+
+/**
+ * @brief Get the number of elements in the deque
+ * 
+ * @param D Pointer to deque
+ * @return Number of elements in deque, or 0 if D is NULL
+ */
+size_t ds_deque_size(const ds_deque_t *D);
+
+/**
+ * @brief Check if deque is empty
+ * 
+ * @param D Pointer to deque
+ * @return 1 if empty, 0 if not empty, 1 if D is NULL
+ */
+int ds_deque_is_empty(const ds_deque_t *D);
+
+/**
+ * @brief Get the runtime counters of a deque
+ * 
+ * Reports block and block-map allocations, live bytes and element
+ * counts (see ds_stats_t).
+ * 
+ * @param D Pointer to deque
+ * @param out Receives the counters
+ * @return DS_OK on success, DS_ERR_NULLARG if D or out is NULL
+ */
+ds_error_t ds_deque_stats(const ds_deque_t *D, ds_stats_t *out);
+
+/**
+ * @brief Visualize the deque structure
+ * 
+ * Prints a graphical representation of the deque to the specified output stream.
+ * Useful for debugging and learning purposes.
+ * 
+ * @param D Pointer to deque
+ * @param out Output stream (e.g., stdout, stderr)
+ * 
+ * @note Safe to call with NULL D or out
+ */
+void ds_deque_visualize(const ds_deque_t *D, FILE *out);
+
+#endif /* DS_DEQUE_H */
@@ -0,0 +1,214 @@
+/**
+ * @file ds_hashmap.h
+ * @brief Open-addressing hash map interface
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * This header provides the interface for a hash map from key pointers to
+ * value pointers. Entries live in one flat array and collisions are
+ * resolved with Robin Hood linear probing, so lookups take expected O(1)
+ * time and touch a few adjacent slots. Keys are hashed and compared with
+ * callbacks supplied at creation time.
+ * 
+ * As with the other containers, the map stores pointers only: the caller
+ * owns the keys and values, and may hand cleanup functions to
+ * ds_hashmap_free.
+ */
+
+#ifndef DS_HASHMAP_H
+#define DS_HASHMAP_H
+
+#include "ds.h"
+#include <stdio.h>  /* for FILE */
+
+/**
+ * @brief Default maximum load factor
+ * 
+ * The table grows once size exceeds this fraction of its slots.
+ */
+#define DS_HASHMAP_DEFAULT_LOAD 0.8
+
+/**
+ * @brief Create a new empty hash map
+ * 
+ * The hash callback does not need to be well distributed in every bit;
+ * its result is mixed before use, so e.g. the identity on integers works.
+ * 
+ * @param hash Hash function for keys
+ * @param eq Equality function for keys (returns non-zero if equal)
+ * @return Pointer to new map on success, NULL if hash/eq is NULL or on memory failure
+ */
+ds_hashmap_t *ds_hashmap_create(size_t (*hash)(const void *key),
+                                int (*eq)(const void *a, const void *b));
+
+/**
+ * @brief Free a hash map and optionally its keys and values
+ * 
+ * @param H Pointer to map to free
+ * @param free_key Optional function called for every stored key (may be NULL)
+ * @param free_value Optional function called for every stored value (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if H is NULL
+ */
+ds_error_t ds_hashmap_free(ds_hashmap_t *H, void (*free_key)(void *), void (*free_value)(void *));
+
+/**
+ * @brief Insert or update a key-value pair
+ * 
+ * If an equal key is already present, both its key and value are
+ * replaced by the new ones and the displaced pair is returned through
+ * old_key and old_value, so the caller can release it the same way as
+ * after ds_hashmap_remove.
+ * 
+ * @param H Pointer to map
+ * @param key Pointer to key
+ * @param value Pointer to value
+ * @param old_key Receives the displaced key pointer, or NULL if none (may be NULL)
+ * @param old_value Receives the displaced value pointer, or NULL if none (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if H, key, or value is NULL, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_hashmap_insert(ds_hashmap_t *H, void *key, void *value, void **old_key, void **old_value);
+
+/**
+ * @brief Find the value stored for a key
+ * 
+ * @param H Pointer to map
+ * @param key Pointer to key to look up
+ * @return Pointer to value, or NULL if not found or H/key is NULL
+ */
+void *ds_hashmap_find(const ds_hashmap_t *H, const void *key);
+
+/**
+ * @brief Find the values stored for many keys at once
+ * 
+ * Equivalent to calling ds_hashmap_find for each key, but the hashes of
+ * a group of keys are computed and their slots prefetched before any of
+ * them is probed, so the cache misses of the group overlap.
+ * 
+ * @param H Pointer to map
+ * @param keys Array of n keys to look up (NULL entries are not found)
+ * @param n Number of keys
+ * @param out Array receiving n results: out[i] is the value for keys[i], or NULL
+ * @return Number of keys found, 0 if H, keys, or out is NULL
+ */
+size_t ds_hashmap_find_batch(const ds_hashmap_t *H, const void *const *keys, size_t n, void **out);
+
+/**
+ * @brief Remove a key-value pair
+ * 
+ * The stored key and value are handed back so the caller can release them.
+ * 
+ * @param H Pointer to map
+ * @param key Pointer to key to remove
+ * @param stored_key Receives the stored key pointer (may be NULL)
+ * @param stored_value Receives the stored value pointer (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if H or key is NULL, DS_ERR_NOTFOUND if not found
+ */
+ds_error_t ds_hashmap_remove(ds_hashmap_t *H, const void *key, void **stored_key, void **stored_value);
+
+/**
+ * @brief Make room for at least count entries without further rehashing
+ * 
+ * @param H Pointer to map
+ * @param count Number of entries to accommodate
+ * @return DS_OK on success, DS_ERR_NULLARG if H is NULL, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_hashmap_reserve(ds_hashmap_t *H, size_t count);
+
+/**
+ * @brief Rebuild the table with a given number of slots
+ * 
+ * The slot count is rounded up to a power of two and to the minimum
+ * needed for the current size, so ds_hashmap_rehash(H, 0) shrinks the
+ * table as far as the load factor allows.
+ * 
+ * @param H Pointer to map
+ * @param slots Requested number of slots
+ * @return DS_OK on success, DS_ERR_NULLARG if H is NULL, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_hashmap_rehash(ds_hashmap_t *H, size_t slots);
+
+/**
+ * @brief Set the maximum load factor
+ * 
+ * Grows the table immediately if the current size exceeds the new limit.
+ * 
+ * @param H Pointer to map
+ * @param max_load Fraction of slots that may be occupied, in [0.1, 0.95]
+ * @return DS_OK on success, DS_ERR_NULLARG if H is NULL, DS_ERR_INVALID if out of range,
+ *         DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_hashmap_set_max_load(ds_hashmap_t *H, double max_load);
+
+/**
+ * @brief Get the current load factor
+ * 
+ * @param H Pointer to map
+ * @return Ratio of entries to slots, or 0 if H is NULL
+ */
+double ds_hashmap_load_factor(const ds_hashmap_t *H);
+
+/**
+ * @brief Visit every key-value pair in unspecified order
+ * 
+ * The map must not be modified from within cb. Iteration stops early
+ * when cb returns non-zero.
+ * 
+ * @param H Pointer to map
+ * @param cb Callback invoked with each key, value and ctx
+ * @param ctx User context passed to cb
+ * @return DS_OK on success, DS_ERR_NULLARG if H or cb is NULL
+ */
+ds_error_t ds_hashmap_foreach(const ds_hashmap_t *H, int (*cb)(void *key, void *value, void *ctx),
+                              void *ctx);
+
+/**
+ * @brief Get the number of entries in the map
+ * 
+ * @param H Pointer to map
+ * @return Number of entries in map, or 0 if H is NULL
+ */
+size_t ds_hashmap_size(const ds_hashmap_t *H);
+
+/**
+ * @brief Get the number of slots in the table
+ * 
+ * @param H Pointer to map
+ * @return Number of slots, or 0 if H is NULL
+ */
+size_t ds_hashmap_capacity(const ds_hashmap_t *H);
+
+/**
+ * @brief Check if map is empty
+ * 
+ * @param H Pointer to map
+ * @return 1 if empty, 0 if not empty, 1 if H is NULL
+ */
+int ds_hashmap_is_empty(const ds_hashmap_t *H);
+
+/**
+ * @brief Get the runtime counters of a hash map
+ * 
+ * Reports table allocations, live bytes, entry counts, equality calls
+ * and, for lookups, the slots probed (see ds_stats_t).
+ * 
+ * @param H Pointer to map
+ * @param out Receives the counters
+ * @return DS_OK on success, DS_ERR_NULLARG if H or out is NULL
+ */
+ds_error_t ds_hashmap_stats(const ds_hashmap_t *H, ds_stats_t *out);
+
+/**
+ * @brief Visualize the hash map table
+ * 
+ * Prints every occupied slot with its probe distance and key/value
+ * pointers. Useful for debugging and learning purposes.
+ * 
+ * @param H Pointer to map
+ * @param out Output stream (e.g., stdout, stderr)
+ * 
+ * @note Safe to call with NULL H or out
+ */
+void ds_hashmap_visualize(const ds_hashmap_t *H, FILE *out);
+
+#endif /* DS_HASHMAP_H */
@@ -0,0 +1,254 @@
+/**
+ * @file ds_intrusive.h
+ * @brief Intrusive list, queue and stack interface
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * This header provides intrusive variants of the list, queue and stack.
+ * Users embed a ds_link_t hook in their own structures and the containers
+ * link those hooks directly, so pushing and popping never allocates and a
+ * traversal touches one cache line per element. DS_CONTAINER_OF recovers
+ * the enclosing structure from a hook.
+ * 
+ * A hook may be a member of at most one intrusive container at a time.
+ * Embed several hooks to place an object in several containers.
+ */
+
+#ifndef DS_INTRUSIVE_H
+#define DS_INTRUSIVE_H
+
+#include "ds.h"
+#include <stddef.h>  /* for offsetof */
+
+/**
+ * @brief Link hook embedded in user structures
+ * 
+ * The fields are managed by the containers and must not be modified
+ * while the hook is linked. The queue and stack only use next.
+ */
+typedef struct ds_link {
+    struct ds_link *next;          /**< Pointer to next hook */
+    struct ds_link *prev;          /**< Pointer to previous hook */
+} ds_link_t;
+
+/**
+ * @brief Get a pointer to the structure containing a link hook
+ * 
+ * @param ptr Pointer to the embedded ds_link_t
+ * @param type Type of the enclosing structure
+ * @param member Name of the ds_link_t member within type
+ */
+#define DS_CONTAINER_OF(ptr, type, member) \
+    ((type *)(void *)((char *)(ptr) - offsetof(type, member)))
+
+/**
+ * @brief Create a new empty intrusive list
+ * 
+ * @return Pointer to new list on success, NULL on memory allocation failure
+ */
+ds_ilist_t *ds_ilist_create(void);
+
+/**
+ * @brief Free an intrusive list and optionally its elements
+ * 
+ * If free_elem is provided, it is called for every linked hook. The
+ * hooks themselves belong to the caller and are never freed by the list.
+ * 
+ * @param L Pointer to list to free
+ * @param free_elem Optional function to release each element (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if L is NULL
+ */
+ds_error_t ds_ilist_free(ds_ilist_t *L, void (*free_elem)(ds_link_t *));
+
+/**
+ * @brief Link a hook at the front of the list
+ * 
+ * @param L Pointer to list
+ * @param link Pointer to unlinked hook
+ * @return DS_OK on success, DS_ERR_NULLARG if L or link is NULL
+ */
+ds_error_t ds_ilist_push_front(ds_ilist_t *L, ds_link_t *link);
+
+/**
+ * @brief Link a hook at the back of the list
+ * 
+ * @param L Pointer to list
+ * @param link Pointer to unlinked hook
+ * @return DS_OK on success, DS_ERR_NULLARG if L or link is NULL
+ */
+ds_error_t ds_ilist_push_back(ds_ilist_t *L, ds_link_t *link);
+
+/**
+ * @brief Unlink and return the first hook
+ * 
+ * @param L Pointer to list
+ * @return Pointer to removed hook, or NULL if L is empty or NULL
+ */
+ds_link_t *ds_ilist_pop_front(ds_ilist_t *L);
+
+/**
+ * @brief Unlink and return the last hook
+ * 
+ * @param L Pointer to list
+ * @return Pointer to removed hook, or NULL if L is empty or NULL
+ */
+ds_link_t *ds_ilist_pop_back(ds_ilist_t *L);
+
+/**
+ * @brief Unlink a hook from anywhere in the list in O(1) time
+ * 
+ * @param L Pointer to list containing link
+ * @param link Pointer to linked hook
+ * @return DS_OK on success, DS_ERR_NULLARG if L or link is NULL
+ */
+ds_error_t ds_ilist_remove(ds_ilist_t *L, ds_link_t *link);
+
+/**
+ * @brief Get the first hook without unlinking it
+ * 
+ * @param L Pointer to list
+ * @return Pointer to first hook, or NULL if L is empty or NULL
+ */
+ds_link_t *ds_ilist_first(const ds_ilist_t *L);
+
+/**
+ * @brief Get the hook following link in the list
+ * 
+ * @param L Pointer to list containing link
+ * @param link Pointer to linked hook
+ * @return Pointer to next hook, or NULL at the end of the list
+ */
+ds_link_t *ds_ilist_next(const ds_ilist_t *L, const ds_link_t *link);
+
+/**
+ * @brief Get the number of elements in the list
+ * 
+ * @param L Pointer to list
+ * @return Number of elements in list, or 0 if L is NULL
+ */
+size_t ds_ilist_size(const ds_ilist_t *L);
+
+/**
+ * @brief Check if list is empty
+ * 
+ * @param L Pointer to list
+ * @return 1 if empty, 0 if not empty, 1 if L is NULL
+ */
+int ds_ilist_is_empty(const ds_ilist_t *L);
+
+/**
+ * @brief Create a new empty intrusive queue
+ * 
+ * @return Pointer to new queue on success, NULL on memory allocation failure
+ */
+ds_iqueue_t *ds_iqueue_create(void);
+
+/**
+ * @brief Free an intrusive queue and optionally its elements
+ * 
+ * @param Q Pointer to queue to free
+ * @param free_elem Optional function to release each element (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if Q is NULL
+ */
+ds_error_t ds_iqueue_free(ds_iqueue_t *Q, void (*free_elem)(ds_link_t *));
+
+/**
+ * @brief Link a hook at the rear of the queue
+ * 
+ * @param Q Pointer to queue
+ * @param link Pointer to unlinked hook
+ * @return DS_OK on success, DS_ERR_NULLARG if Q or link is NULL
+ */
+ds_error_t ds_iqueue_enqueue(ds_iqueue_t *Q, ds_link_t *link);
+
+/**
+ * @brief Unlink and return the hook at the front of the queue
+ * 
+ * @param Q Pointer to queue
+ * @return Pointer to removed hook, or NULL if Q is empty or NULL
+ */
+ds_link_t *ds_iqueue_dequeue(ds_iqueue_t *Q);
+
+/**
+ * @brief Get the hook at the front of the queue without unlinking it
+ * 
+ * @param Q Pointer to queue
+ * @return Pointer to front hook, or NULL if Q is empty or NULL
+ */
+ds_link_t *ds_iqueue_peek(const ds_iqueue_t *Q);
+
+/**
+ * @brief Get the number of elements in the queue
+ * 
+ * @param Q Pointer to queue
+ * @return Number of elements in queue, or 0 if Q is NULL
+ */
+size_t ds_iqueue_size(const ds_iqueue_t *Q);
+
+/**
+ * @brief Check if queue is empty
+ * 
+ * @param Q Pointer to queue
+ * @return 1 if empty, 0 if not empty, 1 if Q is NULL
+ */
+int ds_iqueue_is_empty(const ds_iqueue_t *Q);
+
+/**
+ * @brief Create a new empty intrusive stack
+ * 
+ * @return Pointer to new stack on success, NULL on memory allocation failure
+ */
+ds_istack_t *ds_istack_create(void);
+
+/**
+ * @brief Free an intrusive stack and optionally its elements
+ * 
+ * @param S Pointer to stack to free
+ * @param free_elem Optional function to release each element (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if S is NULL
+ */
+ds_error_t ds_istack_free(ds_istack_t *S, void (*free_elem)(ds_link_t *));
+
+/**
+ * @brief Link a hook on top of the stack
+ * 
+ * @param S Pointer to stack
+ * @param link Pointer to unlinked hook
+ * @return DS_OK on success, DS_ERR_NULLARG if S or link is NULL
+ */
+ds_error_t ds_istack_push(ds_istack_t *S, ds_link_t *link);
+
+/**
+ * @brief Unlink and return the hook on top of the stack
+ * 
+ * @param S Pointer to stack
+ * @return Pointer to removed hook, or NULL if S is empty or NULL
+ */
+ds_link_t *ds_istack_pop(ds_istack_t *S);
+
+/**
+ * @brief Get the hook on top of the stack without unlinking it
+ * 
+ * @param S Pointer to stack
+ * @return Pointer to top hook, or NULL if S is empty or NULL
+ */
+ds_link_t *ds_istack_peek(const ds_istack_t *S);
+
+/**
+ * @brief Get the number of elements in the stack
+ * 
+ * @param S Pointer to stack
+ * @return Number of elements in stack, or 0 if S is NULL
+ */
+size_t ds_istack_size(const ds_istack_t *S);
+
+/**
+ * @brief Check if stack is empty
+ * 
+ * @param S Pointer to stack
+ * @return 1 if empty, 0 if not empty, 1 if S is NULL
+ */
+int ds_istack_is_empty(const ds_istack_t *S);
+
+#endif /* DS_INTRUSIVE_H */
@@ -24,6 +24,44 @@
  */
 ds_list_t *ds_list_create(void);
 
+/**
+ * @brief Create a new empty list with a custom node allocator
+ * 
+ * The list structure itself is obtained from ds_alloc, while every
+ * node is obtained from the given allocator. The allocator is copied;
+ * its context must outlive the list. With an arena allocator (see
+ * ds_arena_allocator) ds_list_free without free_data does not visit the
+ * nodes; they are reclaimed by ds_arena_reset.
+ * 
+ * @param a Allocator for nodes, or NULL for the library-level allocator
+ * @return Pointer to new list on success, NULL on invalid allocator or memory failure
+ */
+ds_list_t *ds_list_create_with_allocator(const ds_allocator_t *a);
+
+/**
+ * @brief Create a new empty list backed by a private node pool
+ * 
+ * Nodes are carved out of a slab pool owned by the list instead of
+ * being allocated one by one. The pool is released in a single pass
+ * when the list is freed.
+ * 
+ * @return Pointer to new list on success, NULL on memory allocation failure
+ */
+ds_list_t *ds_list_create_pooled(void);
+
+/**
+ * @brief Create a new empty unrolled list
+ * 
+ * Elements are packed into chunks of contiguous data pointers (two cache
+ * lines each by default) instead of one node per element. This cuts
+ * memory use and allocations by several times and lets ds_list_find scan
+ * consecutive memory. All list operations keep their semantics; removal
+ * from the middle moves at most one chunk's worth of pointers.
+ * 
+ * @return Pointer to new list on success, NULL on memory allocation failure
+ */
+ds_list_t *ds_list_create_unrolled(void);
+
 /**
  * @brief Free a linked list and optionally its data
  * 
@@ -58,6 +96,20 @@ ds_error_t ds_list_push_front(ds_list_t *L, void *data);
  */
 ds_error_t ds_list_push_back(ds_list_t *L, void *data);
 
+/**
+ * @brief Add several elements to the end of the list
+ * 
+ * Appends items[0..n-1] in order. Either all items are appended or, on
+ * failure, the list is left unchanged.
+ * 
+ * @param L Pointer to list
+ * @param items Array of n data pointers
+ * @param n Number of items
+ * @return DS_OK on success, DS_ERR_NULLARG if L or items (with n > 0) or any item is NULL,
+ *         DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_list_push_back_n(ds_list_t *L, void *const *items, size_t n);
+
 /**
  * @brief Remove and return element from the front of the list
  * 
@@ -93,6 +145,74 @@ ds_error_t ds_list_remove(ds_list_t *L, void *data, int (*cmp)(const void *, con
  */
 void *ds_list_find(ds_list_t *L, void *target, int (*cmp)(const void *, const void *));
 
+/**
+ * @brief Find many elements in one pass over the list
+ * 
+ * Equivalent to calling ds_list_find for each key, but the list is
+ * walked once per group of keys instead of once per key, with the next
+ * node prefetched while the current one is compared.
+ * 
+ * @param L Pointer to list
+ * @param keys Array of n keys to find (NULL entries are not found)
+ * @param n Number of keys
+ * @param out Array receiving n results: out[i] is the first element matching keys[i], or NULL
+ * @param cmp Comparison function returning 0 for match
+ * @return Number of keys found, 0 if L, keys, out, or cmp is NULL
+ */
+size_t ds_list_find_batch(ds_list_t *L, void *const *keys, size_t n, void **out,
+                          int (*cmp)(const void *, const void *));
+
+/**
+ * @brief Sort a list in place
+ * 
+ * Stable merge sort in O(n log n) comparisons. A linked list is sorted
+ * by relinking its nodes without allocating or freeing memory. An
+ * unrolled list is sorted through one temporary array of 2n pointers.
+ * 
+ * @param L Pointer to list
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return DS_OK on success, DS_ERR_NULLARG if L or cmp is NULL,
+ *         DS_ERR_OOM if an unrolled list's temporary array cannot be allocated
+ */
+ds_error_t ds_list_sort(ds_list_t *L, int (*cmp)(const void *, const void *));
+
+/**
+ * @brief Merge a sorted list into another sorted list
+ * 
+ * Moves every element of B into A in O(n + m) so that A stays sorted,
+ * leaving B empty but usable. On ties elements of A come first. Linked
+ * lists are merged by relinking nodes without touching the allocator;
+ * unrolled lists take over B's chunks and use one temporary array of
+ * n + m pointers.
+ * 
+ * Both lists must have the same layout and node allocator; pooled lists
+ * cannot be merged because their nodes belong to their private pool.
+ * 
+ * @param A Pointer to sorted list receiving all elements
+ * @param B Pointer to sorted list to empty into A
+ * @param cmp Comparison function A and B are sorted by
+ * @return DS_OK on success, DS_ERR_NULLARG if A, B, or cmp is NULL,
+ *         DS_ERR_INVALID if A and B are the same or incompatible lists,
+ *         DS_ERR_OOM if an unrolled merge's temporary array cannot be allocated
+ */
+ds_error_t ds_list_merge(ds_list_t *A, ds_list_t *B, int (*cmp)(const void *, const void *));
+
+/**
+ * @brief Append all elements of one list to another
+ * 
+ * Moves every element of B to the end of A in O(1) by relinking, leaving
+ * B empty but usable. No memory is allocated or freed, which makes this
+ * the cheap way to hand batches of work between lists.
+ * 
+ * The same layout and allocator rules as for ds_list_merge apply.
+ * 
+ * @param A Pointer to list receiving all elements
+ * @param B Pointer to list to empty into A
+ * @return DS_OK on success, DS_ERR_NULLARG if A or B is NULL,
+ *         DS_ERR_INVALID if A and B are the same or incompatible lists
+ */
+ds_error_t ds_list_concat(ds_list_t *A, ds_list_t *B);
+
 /**
  * @brief Get the number of elements in the list
  * 
@@ -103,6 +223,37 @@ void *ds_list_find(ds_list_t *L, void *target, int (*cmp)(const void *, const vo
  */
 size_t ds_list_size(const ds_list_t *L);
 
+/**
+ * @brief Save a list as a memory-mappable snapshot
+ * 
+ * Writes every element front to back to path in the format described in
+ * ds_snapshot.h; the serializer works as for ds_tree_save. Open the
+ * result with ds_list_open_mapped.
+ * 
+ * @param L Pointer to list
+ * @param path Destination file
+ * @param ser Serializer (data, buf, cap, ctx) returning the payload size
+ * @param ctx User context passed to ser
+ * @return DS_OK on success, DS_ERR_NULLARG if L, path, or ser is NULL,
+ *         DS_ERR_INVALID if ser fails, DS_ERR_OOM on memory failure,
+ *         DS_ERR_IO if the file cannot be written
+ */
+ds_error_t ds_list_save(const ds_list_t *L, const char *path,
+                        size_t (*ser)(const void *data, void *buf, size_t cap, void *ctx),
+                        void *ctx);
+
+/**
+ * @brief Get the runtime counters of a list
+ * 
+ * Reports node allocations, live bytes, element counts, and for lookups
+ * the nodes visited and comparator calls made (see ds_stats_t).
+ * 
+ * @param L Pointer to list
+ * @param out Receives the counters
+ * @return DS_OK on success, DS_ERR_NULLARG if L or out is NULL
+ */
+ds_error_t ds_list_stats(const ds_list_t *L, ds_stats_t *out);
+
 /**
  * @brief Visualize the list structure
  * 
@@ -0,0 +1,119 @@
+/**
+ * @file ds_mpmc.h
+ * @brief Bounded lock-free multi-producer/multi-consumer queue interface
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * This header provides a fixed-capacity FIFO queue that any number of
+ * threads may enqueue to and dequeue from concurrently without a lock.
+ * Each slot carries a sequence number, so producers and consumers only
+ * contend on a single atomic counter each (Vyukov's bounded queue).
+ * 
+ * @note Only available when the library is built with `make CONCURRENT=1`,
+ *       which compiles it as C11 with <stdatomic.h>.
+ */
+
+#ifndef DS_MPMC_H
+#define DS_MPMC_H
+
+#include "ds.h"
+
+/**
+ * @brief Create a new empty MPMC queue
+ * 
+ * The capacity is rounded up to the next power of two. The slot array
+ * is allocated once and never grows.
+ * 
+ * @param capacity Minimum number of elements the queue can hold
+ * @return Pointer to new queue on success, NULL if capacity is 0 or on memory failure
+ */
+ds_mpmc_queue_t *ds_mpmc_queue_create(size_t capacity);
+
+/**
+ * @brief Free an MPMC queue and optionally its remaining data
+ * 
+ * @param Q Pointer to queue to free
+ * @param free_data Optional function to free element data (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if Q is NULL
+ * 
+ * @note Not thread-safe: no other thread may use Q during or after this call
+ */
+ds_error_t ds_mpmc_queue_free(ds_mpmc_queue_t *Q, void (*free_data)(void *));
+
+/**
+ * @brief Add element to the rear of the queue, waiting while it is full
+ * 
+ * @param Q Pointer to queue
+ * @param data Pointer to data to enqueue
+ * @return DS_OK on success, DS_ERR_NULLARG if Q or data is NULL
+ */
+ds_error_t ds_mpmc_queue_enqueue(ds_mpmc_queue_t *Q, void *data);
+
+/**
+ * @brief Add element to the rear of the queue if a slot is free
+ * 
+ * @param Q Pointer to queue
+ * @param data Pointer to data to enqueue
+ * @return DS_OK on success, DS_ERR_NULLARG if Q or data is NULL, DS_ERR_FULL if the queue is full
+ */
+ds_error_t ds_mpmc_queue_try_enqueue(ds_mpmc_queue_t *Q, void *data);
+
+/**
+ * @brief Remove element from the front of the queue, waiting while it is empty
+ * 
+ * @param Q Pointer to queue
+ * @return Pointer to dequeued data, or NULL if Q is NULL
+ */
+void *ds_mpmc_queue_dequeue(ds_mpmc_queue_t *Q);
+
+/**
+ * @brief Remove element from the front of the queue if one is available
+ * 
+ * @param Q Pointer to queue
+ * @param out Receives the dequeued data pointer
+ * @return DS_OK on success, DS_ERR_NULLARG if Q or out is NULL, DS_ERR_EMPTY if the queue is empty
+ */
+ds_error_t ds_mpmc_queue_try_dequeue(ds_mpmc_queue_t *Q, void **out);
+
+/**
+ * @brief Remove up to n elements from the front of the queue
+ * 
+ * Claims a run of consecutive ready slots with a single atomic update,
+ * so draining in batches costs one contended operation per batch rather
+ * than per element. Does not wait.
+ * 
+ * @param Q Pointer to queue
+ * @param out Array receiving up to n data pointers in FIFO order
+ * @param n Maximum number of elements to dequeue
+ * @return Number of elements dequeued (0 if empty or Q/out is NULL)
+ */
+size_t ds_mpmc_queue_dequeue_n(ds_mpmc_queue_t *Q, void **out, size_t n);
+
+/**
+ * @brief Get the number of elements in the queue
+ * 
+ * @param Q Pointer to queue
+ * @return Number of elements in queue, or 0 if Q is NULL
+ * 
+ * @note The value is a snapshot and may be stale while other threads run
+ */
+size_t ds_mpmc_queue_size(const ds_mpmc_queue_t *Q);
+
+/**
+ * @brief Check if queue is empty
+ * 
+ * @param Q Pointer to queue
+ * @return 1 if empty, 0 if not empty, 1 if Q is NULL
+ */
+int ds_mpmc_queue_is_empty(const ds_mpmc_queue_t *Q);
+
+/**
+ * @brief Get the fixed capacity of the queue
+ * 
+ * @param Q Pointer to queue
+ * @return Number of slots, or 0 if Q is NULL
+ */
+size_t ds_mpmc_queue_capacity(const ds_mpmc_queue_t *Q);
+
+#endif /* DS_MPMC_H */
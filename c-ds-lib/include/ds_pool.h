@@ -0,0 +1,158 @@
+/**
+ * @file ds_pool.h
+ * @brief Work-stealing thread pool and parallel operations interface
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * This header provides a fixed-size thread pool in which every worker
+ * owns a task deque. Tasks submitted from inside a task go to the
+ * submitting worker's own deque and run newest first; idle workers steal
+ * the oldest task of another worker. On top of the pool it offers a
+ * parallel sort, a parallel tree build from unsorted input, and parallel
+ * visits and reductions over disjoint subtrees of a tree.
+ * 
+ * @note Only available when the library is built with `make CONCURRENT=1`.
+ *       The library-level allocator must be thread-safe (the default is).
+ */
+
+#ifndef DS_POOL_H
+#define DS_POOL_H
+
+#include "ds.h"
+
+/**
+ * @brief Create a thread pool
+ * 
+ * @param nthreads Number of worker threads, or 0 for one per online CPU
+ * @return Pointer to new pool on success, NULL on memory or thread creation failure
+ */
+ds_pool_t *ds_pool_create(size_t nthreads);
+
+/**
+ * @brief Wait for all tasks, then stop and free the pool
+ * 
+ * @param P Pointer to pool to free
+ * @return DS_OK on success, DS_ERR_NULLARG if P is NULL
+ * 
+ * @note Must not be called from a task of P
+ */
+ds_error_t ds_pool_free(ds_pool_t *P);
+
+/**
+ * @brief Queue a task for execution
+ * 
+ * May be called from any thread, including from tasks of P.
+ * 
+ * @param P Pointer to pool
+ * @param fn Task function
+ * @param arg Argument passed to fn
+ * @return DS_OK on success, DS_ERR_NULLARG if P or fn is NULL, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_pool_submit(ds_pool_t *P, void (*fn)(void *arg), void *arg);
+
+/**
+ * @brief Wait until every submitted task has finished
+ * 
+ * The calling thread runs queued tasks itself while it waits. Tasks
+ * submitted by running tasks are waited for as well.
+ * 
+ * @param P Pointer to pool
+ * @return DS_OK on success, DS_ERR_NULLARG if P is NULL
+ * 
+ * @note Must not be called from a task of P
+ */
+ds_error_t ds_pool_wait(ds_pool_t *P);
+
+/**
+ * @brief Get the number of worker threads
+ * 
+ * @param P Pointer to pool
+ * @return Number of workers, or 0 if P is NULL
+ */
+size_t ds_pool_threads(const ds_pool_t *P);
+
+/**
+ * @brief Sort an array of data pointers in parallel
+ * 
+ * Slices of the array are merge-sorted by separate tasks and then merged
+ * pairwise, one parallel round per doubling of the run length. The sort
+ * is stable.
+ * 
+ * @param P Pointer to pool
+ * @param items Array of n data pointers, sorted in place
+ * @param n Number of items
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return DS_OK on success, DS_ERR_NULLARG if P or cmp is NULL or items is NULL
+ *         while n > 0, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_pool_sort(ds_pool_t *P, void **items, size_t n, int (*cmp)(const void *, const void *));
+
+/**
+ * @brief Build a balanced tree from items in any order
+ * 
+ * Sorts a copy of the items with ds_pool_sort, drops duplicates (keeping
+ * the first occurrence, as ds_tree_insert would) and lays out the result
+ * with ds_tree_build_sorted.
+ * 
+ * @param P Pointer to pool
+ * @param items Array of n data pointers
+ * @param n Number of items (0 yields an empty tree)
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return Pointer to new tree on success, NULL if P or cmp is NULL, if items is
+ *         NULL while n > 0, if any item is NULL, or on memory failure
+ */
+ds_tree_t *ds_tree_build_parallel(ds_pool_t *P, void *const *items, size_t n,
+                                  int (*cmp)(const void *, const void *));
+
+/**
+ * @brief Fold the elements of a range in parallel
+ * 
+ * The tree is cut into a few dozen disjoint pieces per worker: whole
+ * subtrees plus the nodes above them. Each piece folds its elements in
+ * [lo, hi] into a private copy of the initial accumulator with step; the
+ * partial results are then combined into acc with merge in ascending key
+ * order, so merge only needs to be associative. A NULL bound leaves that
+ * side of the range open.
+ * 
+ * Balanced trees split into pieces of similar size; a degenerate plain
+ * tree gives little parallelism.
+ * 
+ * @param T Pointer to tree (must not be modified during the call)
+ * @param P Pointer to pool
+ * @param lo Lower bound (NULL for no lower bound)
+ * @param hi Upper bound (NULL for no upper bound)
+ * @param cmp Comparison function, required when lo or hi is given
+ * @param acc Accumulator of acc_size bytes, holding the identity value on
+ *            entry and the result on return
+ * @param acc_size Size of the accumulator in bytes
+ * @param step Folds one element into an accumulator; called concurrently
+ *             on different accumulators
+ * @param merge Folds the partial accumulator part into acc (may be NULL if acc_size is 0)
+ * @param ctx User context passed to step and merge
+ * @return DS_OK on success, DS_ERR_NULLARG if T, P, acc (with acc_size > 0),
+ *         step, merge (with acc_size > 0), or a needed cmp is NULL,
+ *         DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_tree_reduce_parallel(const ds_tree_t *T, ds_pool_t *P, const void *lo, const void *hi,
+                                   int (*cmp)(const void *, const void *),
+                                   void *acc, size_t acc_size,
+                                   void (*step)(void *acc, void *data, void *ctx),
+                                   void (*merge)(void *acc, const void *part, void *ctx), void *ctx);
+
+/**
+ * @brief Visit every element of a tree in parallel
+ * 
+ * Calls cb once for each element, from several threads at once and in
+ * no particular order.
+ * 
+ * @param T Pointer to tree (must not be modified during the call)
+ * @param P Pointer to pool
+ * @param cb Callback invoked with each element and ctx
+ * @param ctx User context passed to cb
+ * @return DS_OK on success, DS_ERR_NULLARG if T, P, or cb is NULL, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_tree_foreach_parallel(const ds_tree_t *T, ds_pool_t *P,
+                                    void (*cb)(void *data, void *ctx), void *ctx);
+                                    
+#endif /* DS_POOL_H */
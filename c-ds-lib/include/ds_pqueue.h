@@ -0,0 +1,134 @@
+/**
+ * @file ds_pqueue.h
+ * @brief Priority queue data structure interface
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * This header provides the interface for the priority queue. Elements are
+ * kept in a 4-ary min-heap stored in one contiguous array, ordered with
+ * the same comparator convention as ds_tree_insert: the element that
+ * compares smallest is always at the front.
+ */
+
+#ifndef DS_PQUEUE_H
+#define DS_PQUEUE_H
+
+#include "ds.h"
+#include <stdio.h>  /* for FILE */
+
+/**
+ * @brief Create a new empty priority queue
+ * 
+ * The comparator is stored in the queue and used by every operation.
+ * 
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @param capacity_hint Expected number of elements (may be 0)
+ * @return Pointer to new priority queue on success, NULL if cmp is NULL or on memory failure
+ */
+ds_pqueue_t *ds_pqueue_create(int (*cmp)(const void *, const void *), size_t capacity_hint);
+
+/**
+ * @brief Build a priority queue from an array of elements
+ * 
+ * Copies the n data pointers and arranges them into a heap in O(n) time,
+ * which is faster than n calls to ds_pqueue_push.
+ * 
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @param items Array of n data pointers in any order
+ * @param n Number of items (0 yields an empty priority queue)
+ * @return Pointer to new priority queue on success, NULL if cmp is NULL, if items
+ *         is NULL while n > 0, if any item is NULL, or on memory failure
+ */
+ds_pqueue_t *ds_pqueue_create_from_array(int (*cmp)(const void *, const void *),
+                                         void *const *items, size_t n);
+
+/**
+ * @brief Free a priority queue and optionally its data
+ * 
+ * @param P Pointer to priority queue to free
+ * @param free_data Optional function to free element data (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if P is NULL
+ */
+ds_error_t ds_pqueue_free(ds_pqueue_t *P, void (*free_data)(void *));
+
+/**
+ * @brief Insert element into the priority queue
+ * 
+ * Runs in O(log n) time and allocates only when the array has to grow.
+ * 
+ * @param P Pointer to priority queue
+ * @param data Pointer to data to insert
+ * @return DS_OK on success, DS_ERR_NULLARG if P or data is NULL, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_pqueue_push(ds_pqueue_t *P, void *data);
+
+/**
+ * @brief Remove and return the smallest element
+ * 
+ * Elements that compare equal are returned in no particular order.
+ * 
+ * @param P Pointer to priority queue
+ * @return Pointer to data of removed element, or NULL if P is empty or NULL
+ */
+void *ds_pqueue_pop(ds_pqueue_t *P);
+
+/**
+ * @brief Get the smallest element without removing it
+ * 
+ * @param P Pointer to priority queue
+ * @return Pointer to smallest element's data, or NULL if P is empty or NULL
+ */
+void *ds_pqueue_peek(const ds_pqueue_t *P);
+
+/**
+ * @brief Ensure capacity for at least the given number of elements
+ * 
+ * @param P Pointer to priority queue
+ * @param capacity Minimum number of elements to hold without reallocating
+ * @return DS_OK on success, DS_ERR_NULLARG if P is NULL, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_pqueue_reserve(ds_pqueue_t *P, size_t capacity);
+
+/**
+ * @brief Get the number of elements in the priority queue
+ * 
+ * @param P Pointer to priority queue
+ * @return Number of elements, or 0 if P is NULL
+ */
+size_t ds_pqueue_size(const ds_pqueue_t *P);
+
+/**
+ * @brief Check if priority queue is empty
+ * 
+ * @param P Pointer to priority queue
+ * @return 1 if empty, 0 if not empty, 1 if P is NULL
+ */
+int ds_pqueue_is_empty(const ds_pqueue_t *P);
+
+/**
+ * @brief Get the runtime counters of a priority queue
+ * 
+ * Reports array allocations, live bytes, element counts and comparator
+ * calls (see ds_stats_t).
+ * 
+ * @param P Pointer to priority queue
+ * @param out Receives the counters
+ * @return DS_OK on success, DS_ERR_NULLARG if P or out is NULL
+ */
+ds_error_t ds_pqueue_stats(const ds_pqueue_t *P, ds_stats_t *out);
+
+/**
+ * @brief Visualize the priority queue structure
+ * 
+ * Prints the heap array one level per line.
+ * Useful for debugging and learning purposes.
+ * 
+ * @param P Pointer to priority queue
+ * @param out Output stream (e.g., stdout, stderr)
+ * 
+ * @note Safe to call with NULL P or out
+ */
+void ds_pqueue_visualize(const ds_pqueue_t *P, FILE *out);
+
+#endif /* DS_PQUEUE_H */
@@ -24,6 +24,44 @@
  */
 ds_queue_t *ds_queue_create(void);
 
+/**
+ * @brief Create a new empty queue with a custom node allocator
+ * 
+ * The queue structure itself is obtained from ds_alloc, while every
+ * node is obtained from the given allocator. The allocator is copied;
+ * its context must outlive the queue. With an arena allocator (see
+ * ds_arena_allocator) ds_queue_free without free_data does not visit the
+ * nodes; they are reclaimed by ds_arena_reset.
+ * 
+ * @param a Allocator for nodes, or NULL for the library-level allocator
+ * @return Pointer to new queue on success, NULL on invalid allocator or memory failure
+ */
+ds_queue_t *ds_queue_create_with_allocator(const ds_allocator_t *a);
+
+/**
+ * @brief Create a new empty queue backed by a private node pool
+ * 
+ * Nodes are carved out of a slab pool owned by the queue instead of
+ * being allocated one by one. The pool is released in a single pass
+ * when the queue is freed.
+ * 
+ * @return Pointer to new queue on success, NULL on memory allocation failure
+ */
+ds_queue_t *ds_queue_create_pooled(void);
+
+/**
+ * @brief Create a new empty ring-buffer queue
+ * 
+ * The queue stores its elements in one contiguous buffer that grows
+ * geometrically when full and is never shrunk, so steady-state
+ * enqueue/dequeue perform no allocation. All other queue operations
+ * behave exactly as for a linked queue.
+ * 
+ * @param capacity_hint Expected number of elements (rounded up to a power of two)
+ * @return Pointer to new queue on success, NULL on memory allocation failure
+ */
+ds_queue_t *ds_queue_create_ring(size_t capacity_hint);
+
 /**
  * @brief Free a queue and optionally its data
  * 
@@ -87,6 +125,106 @@ int ds_queue_is_empty(const ds_queue_t *Q);
  */
 size_t ds_queue_size(const ds_queue_t *Q);
 
+/**
+ * @brief Move all elements of one queue to the rear of another
+ * 
+ * Appends R's elements to Q in their queue order, leaving R empty but
+ * usable. Node-based queues are relinked in O(1) without touching the
+ * allocator; they must share a node allocator, and pooled queues cannot
+ * be spliced because their nodes belong to their private pool. Two ring
+ * queues (see ds_queue_create_ring) are spliced by copying R's slots.
+ * 
+ * @param Q Pointer to queue receiving all elements
+ * @param R Pointer to queue to empty into Q
+ * @return DS_OK on success, DS_ERR_NULLARG if Q or R is NULL,
+ *         DS_ERR_INVALID if Q and R are the same or incompatible queues,
+ *         DS_ERR_OOM if a ring buffer cannot grow
+ */
+ds_error_t ds_queue_splice(ds_queue_t *Q, ds_queue_t *R);
+
+/**
+ * @brief Exchange the contents of two queues
+ * 
+ * Runs in O(1) for any two queues, whatever their storage mode or
+ * allocator; each handle simply takes over the other's elements.
+ * 
+ * @param Q Pointer to first queue
+ * @param R Pointer to second queue
+ * @return DS_OK on success, DS_ERR_NULLARG if Q or R is NULL
+ */
+ds_error_t ds_queue_swap(ds_queue_t *Q, ds_queue_t *R);
+
+/**
+ * @brief Write queued buffers to a file descriptor with few system calls
+ * 
+ * Treats each element as a buffer of size_cb(data) bytes starting at its
+ * data pointer and writes the elements front to back, collecting many of
+ * them into each writev call. Every element that has been written
+ * completely is dequeued and handed to free_data, following the same
+ * ownership convention as ds_queue_free.
+ * 
+ * Draining stops when the queue is empty, when fd would block, or when
+ * the next element would take the total past max_bytes; the first
+ * element is always written, so an element larger than max_bytes is
+ * never stuck at the front.
+ * 
+ * @param Q Pointer to queue
+ * @param fd File descriptor to write to
+ * @param size_cb Returns the byte length of an element
+ * @param max_bytes Upper bound on bytes written by this call, or 0 for no limit
+ * @param free_data Optional function to release each written element (may be NULL)
+ * @param written Optional; receives the number of bytes written, also on error
+ * @return DS_OK on success, also when a non-blocking fd is full,
+ *         DS_ERR_NULLARG if Q or size_cb is NULL,
+ *         DS_ERR_IO if writev fails (see errno)
+ * 
+ * @note The front element may be left partly written, after EAGAIN or
+ *       DS_ERR_IO; *written includes its written bytes and the queue
+ *       remembers the offset, so the next call sends only the remainder
+ */
+ds_error_t ds_queue_drain_to_fd(ds_queue_t *Q, int fd, size_t (*size_cb)(const void *data),
+                                size_t max_bytes, void (*free_data)(void *), size_t *written);
+
+/**
+ * @brief Read fixed-size records from a file descriptor into the queue
+ * 
+ * The reverse of ds_queue_drain_to_fd: each readv call scatters input
+ * across many newly allocated record buffers, and every complete record
+ * is enqueued. Records are allocated with ds_alloc, so pass ds_free as
+ * free_data when draining or freeing the queue.
+ * 
+ * Reading stops at end of input, after max_records records, or when a
+ * non-blocking descriptor has no more data.
+ * 
+ * @param Q Pointer to queue
+ * @param fd File descriptor to read from
+ * @param record_size Size of each record in bytes
+ * @param max_records Maximum number of records to read, or 0 for no limit
+ * @param records Optional; receives the number of records enqueued, also on error
+ * @return DS_OK on success, DS_ERR_NULLARG if Q is NULL, DS_ERR_INVALID if
+ *         record_size is 0 or differs from a pending partial record, or the
+ *         input ends inside a record, DS_ERR_OOM on memory failure,
+ *         DS_ERR_IO if readv fails (see errno)
+ * 
+ * @note A record cut short because fd would block, or by a read error,
+ *       is held by the queue and completed by the next call with the same
+ *       record_size; one cut short by end of input is discarded
+ */
+ds_error_t ds_queue_fill_from_fd(ds_queue_t *Q, int fd, size_t record_size,
+                                 size_t max_records, size_t *records);
+
+/**
+ * @brief Get the runtime counters of a queue
+ * 
+ * Reports node or ring buffer allocations, live bytes and element
+ * counts (see ds_stats_t).
+ * 
+ * @param Q Pointer to queue
+ * @param out Receives the counters
+ * @return DS_OK on success, DS_ERR_NULLARG if Q or out is NULL
+ */
+ds_error_t ds_queue_stats(const ds_queue_t *Q, ds_stats_t *out);
+
 /**
  * @brief Visualize the queue structure
  * 
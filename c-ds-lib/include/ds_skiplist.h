@@ -0,0 +1,200 @@
+/**
+ * @file ds_skiplist.h
+ * @brief Skip list ordered container interface
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * This header provides the interface for the skip list ordered container.
+ * Elements are kept in a sorted linked list with randomly promoted express
+ * lanes, giving O(log n) expected insert, find and remove without any
+ * rebalancing. Keys are compared with the same comparator convention as
+ * ds_tree_insert/ds_tree_find.
+ * 
+ * When the library is built with CONCURRENT=1, one writer may insert
+ * while any number of threads run ds_skiplist_find, the iterators and
+ * ds_skiplist_range: a new element is fully initialized before it is
+ * linked in, bottom lane first, with release stores. Removal frees the
+ * element's node, so it must not overlap with readers.
+ */
+
+#ifndef DS_SKIPLIST_H
+#define DS_SKIPLIST_H
+
+#include "ds.h"
+#include <stdio.h>  /* for FILE */
+
+/**
+ * @brief In-order iterator over a skip list
+ * 
+ * Iterators live on the caller's stack and need no allocation. An
+ * iterator is invalidated when the element it is positioned at is removed.
+ */
+typedef struct ds_skiplist_iter {
+    const ds_skiplist_t *list;     /**< Skip list being iterated */
+    void *node;                    /**< Current position (internal), NULL when exhausted */
+} ds_skiplist_iter_t;
+
+/**
+ * @brief Create a new empty skip list
+ * 
+ * @return Pointer to new skip list on success, NULL on memory allocation failure
+ */
+ds_skiplist_t *ds_skiplist_create(void);
+
+/**
+ * @brief Create a new empty skip list with a custom node allocator
+ * 
+ * The skip list structure itself is obtained from ds_alloc, while every
+ * node is obtained from the given allocator. The allocator is copied;
+ * its context must outlive the skip list. With an arena allocator (see
+ * ds_arena_allocator) ds_skiplist_free without free_data does not visit
+ * the nodes; they are reclaimed by ds_arena_reset.
+ * 
+ * @param a Allocator for nodes, or NULL for the library-level allocator
+ * @return Pointer to new skip list on success, NULL on invalid allocator or memory failure
+ */
+ds_skiplist_t *ds_skiplist_create_with_allocator(const ds_allocator_t *a);
+
+/**
+ * @brief Free a skip list and optionally its data
+ * 
+ * @param S Pointer to skip list to free
+ * @param free_data Optional function to free element data (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if S is NULL
+ */
+ds_error_t ds_skiplist_free(ds_skiplist_t *S, void (*free_data)(void *));
+
+/**
+ * @brief Insert element into the skip list
+ * 
+ * Inserting an element equal to an existing one is a no-op.
+ * 
+ * @param S Pointer to skip list
+ * @param data Pointer to data to insert
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return DS_OK on success, DS_ERR_NULLARG if S, data, or cmp is NULL, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_skiplist_insert(ds_skiplist_t *S, void *data, int (*cmp)(const void *, const void *));
+
+/**
+ * @brief Find element in the skip list
+ * 
+ * @param S Pointer to skip list
+ * @param target Pointer to data to find
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return Pointer to matching data, or NULL if not found or S/cmp/target is NULL
+ */
+void *ds_skiplist_find(const ds_skiplist_t *S, const void *target,
+                       int (*cmp)(const void *, const void *));
+
+/**
+ * @brief Remove element from the skip list
+ * 
+ * @param S Pointer to skip list
+ * @param target Pointer to data to remove
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return DS_OK on success, DS_ERR_NULLARG if S, target, or cmp is NULL, DS_ERR_NOTFOUND if not found
+ */
+ds_error_t ds_skiplist_remove(ds_skiplist_t *S, const void *target,
+                              int (*cmp)(const void *, const void *));
+
+/**
+ * @brief Get the number of elements in the skip list
+ * 
+ * @param S Pointer to skip list
+ * @return Number of elements in skip list, or 0 if S is NULL
+ */
+size_t ds_skiplist_size(const ds_skiplist_t *S);
+
+/**
+ * @brief Check if skip list is empty
+ * 
+ * @param S Pointer to skip list
+ * @return 1 if empty, 0 if not empty, 1 if S is NULL
+ */
+int ds_skiplist_is_empty(const ds_skiplist_t *S);
+
+/**
+ * @brief Position an iterator at the smallest element
+ * 
+ * @param it Iterator to initialize
+ * @param S Pointer to skip list
+ * @return Pointer to smallest element's data, or NULL if S is empty or it/S is NULL
+ */
+void *ds_skiplist_iter_first(ds_skiplist_iter_t *it, const ds_skiplist_t *S);
+
+/**
+ * @brief Position an iterator at the first element not less than key
+ * 
+ * @param it Iterator to initialize
+ * @param S Pointer to skip list
+ * @param key Pointer to key to seek to
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return Pointer to data of first element >= key, or NULL if none or any argument is NULL
+ */
+void *ds_skiplist_iter_seek(ds_skiplist_iter_t *it, const ds_skiplist_t *S, const void *key,
+                            int (*cmp)(const void *, const void *));
+
+/**
+ * @brief Advance an iterator to the next element in order
+ * 
+ * @param it Pointer to iterator
+ * @return Pointer to next element's data, or NULL when the iteration is over
+ */
+void *ds_skiplist_iter_next(ds_skiplist_iter_t *it);
+
+/**
+ * @brief Get the element an iterator is positioned at
+ * 
+ * @param it Pointer to iterator
+ * @return Pointer to current element's data, or NULL if exhausted or it is NULL
+ */
+void *ds_skiplist_iter_get(const ds_skiplist_iter_t *it);
+
+/**
+ * @brief Visit all elements in the closed range [lo, hi] in order
+ * 
+ * Calls cb for every element e with cmp(lo, e) <= 0 and cmp(e, hi) <= 0,
+ * in ascending order, in O(log n + k) expected time. A NULL bound leaves
+ * that side of the range open. Iteration stops early when cb returns non-zero.
+ * 
+ * @param S Pointer to skip list
+ * @param lo Lower bound (NULL for no lower bound)
+ * @param hi Upper bound (NULL for no upper bound)
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @param cb Callback invoked with each element and ctx
+ * @param ctx User context passed to cb
+ * @return DS_OK on success, DS_ERR_NULLARG if S, cmp, or cb is NULL
+ */
+ds_error_t ds_skiplist_range(const ds_skiplist_t *S, const void *lo, const void *hi,
+                             int (*cmp)(const void *, const void *),
+                             int (*cb)(void *data, void *ctx), void *ctx);
+
+/**
+ * @brief Get the runtime counters of a skip list
+ * 
+ * Reports node allocations, live bytes, element counts and comparator
+ * calls (see ds_stats_t). Lookups are counted only in builds without
+ * CONCURRENT=1, where readers never write to the skip list.
+ * 
+ * @param S Pointer to skip list
+ * @param out Receives the counters
+ * @return DS_OK on success, DS_ERR_NULLARG if S or out is NULL
+ */
+ds_error_t ds_skiplist_stats(const ds_skiplist_t *S, ds_stats_t *out);
+
+/**
+ * @brief Visualize the skip list structure
+ * 
+ * Prints every element with the number of lanes it is linked into.
+ * Useful for debugging and learning purposes.
+ * 
+ * @param S Pointer to skip list
+ * @param out Output stream (e.g., stdout, stderr)
+ * 
+ * @note Safe to call with NULL S or out
+ */
+void ds_skiplist_visualize(const ds_skiplist_t *S, FILE *out);
+
+#endif /* DS_SKIPLIST_H */
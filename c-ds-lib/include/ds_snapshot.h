@@ -0,0 +1,94 @@
+/**
+ * @file ds_snapshot.h
+ * @brief Memory-mapped persistent snapshots of trees and lists
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * ds_tree_save and ds_list_save write a container to a compact file. Each
+ * element's payload is produced by a user serializer, and elements refer
+ * to their payloads by file offset instead of by pointer. A snapshot is
+ * opened read-only with mmap and used in place: nothing is deserialized,
+ * so opening is O(1), and every process mapping the same file shares one
+ * copy through the page cache.
+ * 
+ * The file layout is a 64-byte header, the payloads in element order
+ * (each padded to 8 bytes, so a payload may hold any scalar type or
+ * struct directly), then an index of (offset, length) pairs. Tree
+ * snapshots keep the in-order sequence, so lookups are binary searches
+ * over the index. Files use the writer's byte order and are rejected on
+ * hosts with a different one.
+ */
+
+#ifndef DS_SNAPSHOT_H
+#define DS_SNAPSHOT_H
+
+#include "ds.h"
+
+/**
+ * @brief Open a tree snapshot written by ds_tree_save
+ * 
+ * @param path File to map
+ * @return Pointer to the mapped snapshot, or NULL if path is NULL, the file
+ *         cannot be opened or mapped, or it is not a valid tree snapshot
+ */
+ds_snapshot_t *ds_tree_open_mapped(const char *path);
+
+/**
+ * @brief Open a list snapshot written by ds_list_save
+ * 
+ * @param path File to map
+ * @return Pointer to the mapped snapshot, or NULL if path is NULL, the file
+ *         cannot be opened or mapped, or it is not a valid list snapshot
+ */
+ds_snapshot_t *ds_list_open_mapped(const char *path);
+
+/**
+ * @brief Unmap a snapshot
+ * 
+ * Payload pointers obtained from the snapshot become invalid.
+ * 
+ * @param S Pointer to snapshot
+ * @return DS_OK on success, DS_ERR_NULLARG if S is NULL
+ */
+ds_error_t ds_snapshot_close(ds_snapshot_t *S);
+
+/**
+ * @brief Get the number of elements in a snapshot
+ * 
+ * @param S Pointer to snapshot
+ * @return Number of elements, or 0 if S is NULL
+ */
+size_t ds_snapshot_size(const ds_snapshot_t *S);
+
+/**
+ * @brief Get the payload of the i-th element
+ * 
+ * Elements are numbered in save order: ascending for trees, front to
+ * back for lists.
+ * 
+ * @param S Pointer to snapshot
+ * @param i Element index
+ * @param len Receives the payload length in bytes (may be NULL)
+ * @return Pointer to the payload inside the mapping, or NULL if S is NULL,
+ *         i is out of range, or the entry is corrupt
+ */
+const void *ds_snapshot_get(const ds_snapshot_t *S, size_t i, size_t *len);
+
+/**
+ * @brief Find an element's payload by key
+ * 
+ * Tree snapshots are searched in O(log n) comparisons, list snapshots
+ * front to back. cmp receives the key and a payload pointer, and orders
+ * them the same way as the comparator the tree was built with.
+ * 
+ * @param S Pointer to snapshot
+ * @param key Pointer to key to find
+ * @param cmp Comparison function (key, payload) returning <0, 0, >0
+ * @param len Receives the payload length in bytes (may be NULL)
+ * @return Pointer to the matching payload, or NULL if not found or S/key/cmp is NULL
+ */
+const void *ds_snapshot_find(const ds_snapshot_t *S, const void *key,
+                             int (*cmp)(const void *key, const void *payload), size_t *len);
+                             
+#endif /* DS_SNAPSHOT_H */
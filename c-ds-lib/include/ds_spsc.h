@@ -0,0 +1,136 @@
+/**
+ * @file ds_spsc.h
+ * @brief Bounded lock-free single-producer/single-consumer ring interface
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * This header provides a fixed-capacity FIFO channel between exactly one
+ * producer thread and one consumer thread. Each side owns one index and
+ * keeps a private copy of the other's, so an operation normally touches
+ * no cache line written by the other thread and needs no atomic
+ * read-modify-write at all. Batch operations publish a whole run of
+ * elements with a single index update.
+ * 
+ * @note Only available when the library is built with `make CONCURRENT=1`,
+ *       which compiles it as C11 with <stdatomic.h>.
+ * @note At most one thread may call the enqueue functions and at most one
+ *       (other) thread the dequeue functions at any time.
+ */
+
+#ifndef DS_SPSC_H
+#define DS_SPSC_H
+
+#include "ds.h"
+
+/**
+ * @brief Create a new empty SPSC ring
+ * 
+ * The capacity is rounded up to the next power of two. The slot array
+ * is allocated once and never grows.
+ * 
+ * @param capacity Minimum number of elements the ring can hold
+ * @return Pointer to new ring on success, NULL if capacity is 0 or on memory failure
+ */
+ds_spsc_ring_t *ds_spsc_ring_create(size_t capacity);
+
+/**
+ * @brief Free an SPSC ring and optionally its remaining data
+ * 
+ * @param R Pointer to ring to free
+ * @param free_data Optional function to free element data (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if R is NULL
+ * 
+ * @note Not thread-safe: no other thread may use R during or after this call
+ */
+ds_error_t ds_spsc_ring_free(ds_spsc_ring_t *R, void (*free_data)(void *));
+
+/**
+ * @brief Add element to the rear of the ring, waiting while it is full
+ * 
+ * @param R Pointer to ring
+ * @param data Pointer to data to enqueue
+ * @return DS_OK on success, DS_ERR_NULLARG if R or data is NULL
+ */
+ds_error_t ds_spsc_ring_enqueue(ds_spsc_ring_t *R, void *data);
+
+/**
+ * @brief Add element to the rear of the ring if a slot is free
+ * 
+ * @param R Pointer to ring
+ * @param data Pointer to data to enqueue
+ * @return DS_OK on success, DS_ERR_NULLARG if R or data is NULL, DS_ERR_FULL if the ring is full
+ */
+ds_error_t ds_spsc_ring_try_enqueue(ds_spsc_ring_t *R, void *data);
+
+/**
+ * @brief Add up to n elements to the rear of the ring
+ * 
+ * Copies as many leading elements of items as there are free slots and
+ * makes them visible to the consumer at once, stopping early at a NULL
+ * element. Does not wait.
+ * 
+ * @param R Pointer to ring
+ * @param items Array of n data pointers
+ * @param n Number of elements offered
+ * @return Number of elements enqueued (0 if full or R/items is NULL)
+ */
+size_t ds_spsc_ring_enqueue_n(ds_spsc_ring_t *R, void *const *items, size_t n);
+
+/**
+ * @brief Remove element from the front of the ring, waiting while it is empty
+ * 
+ * @param R Pointer to ring
+ * @return Pointer to dequeued data, or NULL if R is NULL
+ */
+void *ds_spsc_ring_dequeue(ds_spsc_ring_t *R);
+
+/**
+ * @brief Remove element from the front of the ring if one is available
+ * 
+ * @param R Pointer to ring
+ * @param out Receives the dequeued data pointer
+ * @return DS_OK on success, DS_ERR_NULLARG if R or out is NULL, DS_ERR_EMPTY if the ring is empty
+ */
+ds_error_t ds_spsc_ring_try_dequeue(ds_spsc_ring_t *R, void **out);
+
+/**
+ * @brief Remove up to n elements from the front of the ring
+ * 
+ * Takes every available element up to n and hands their slots back to
+ * the producer at once. Does not wait.
+ * 
+ * @param R Pointer to ring
+ * @param out Array receiving up to n data pointers in FIFO order
+ * @param n Maximum number of elements to dequeue
+ * @return Number of elements dequeued (0 if empty or R/out is NULL)
+ */
+size_t ds_spsc_ring_dequeue_n(ds_spsc_ring_t *R, void **out, size_t n);
+
+/**
+ * @brief Get the number of elements in the ring
+ * 
+ * @param R Pointer to ring
+ * @return Number of elements in ring, or 0 if R is NULL
+ * 
+ * @note The value is a snapshot and may be stale while the other side runs
+ */
+size_t ds_spsc_ring_size(const ds_spsc_ring_t *R);
+
+/**
+ * @brief Check if ring is empty
+ * 
+ * @param R Pointer to ring
+ * @return 1 if empty, 0 if not empty, 1 if R is NULL
+ */
+int ds_spsc_ring_is_empty(const ds_spsc_ring_t *R);
+
+/**
+ * @brief Get the fixed capacity of the ring
+ * 
+ * @param R Pointer to ring
+ * @return Number of slots, or 0 if R is NULL
+ */
+size_t ds_spsc_ring_capacity(const ds_spsc_ring_t *R);
+
+#endif /* DS_SPSC_H */
@@ -24,6 +24,44 @@
  */
 ds_stack_t *ds_stack_create(void);
 
+/**
+ * @brief Create a new empty stack with a custom node allocator
+ * 
+ * The stack structure itself is obtained from ds_alloc, while every
+ * node is obtained from the given allocator. The allocator is copied;
+ * its context must outlive the stack. With an arena allocator (see
+ * ds_arena_allocator) ds_stack_free without free_data does not visit the
+ * nodes; they are reclaimed by ds_arena_reset.
+ * 
+ * @param a Allocator for nodes, or NULL for the library-level allocator
+ * @return Pointer to new stack on success, NULL on invalid allocator or memory failure
+ */
+ds_stack_t *ds_stack_create_with_allocator(const ds_allocator_t *a);
+
+/**
+ * @brief Create a new empty stack backed by a private node pool
+ * 
+ * Nodes are carved out of a slab pool owned by the stack instead of
+ * being allocated one by one. The pool is released in a single pass
+ * when the stack is freed.
+ * 
+ * @return Pointer to new stack on success, NULL on memory allocation failure
+ */
+ds_stack_t *ds_stack_create_pooled(void);
+
+/**
+ * @brief Create a new empty array-backed stack
+ * 
+ * The stack keeps its elements in one contiguous array that grows
+ * geometrically, giving amortized O(1) push/pop without per-element
+ * allocation. Use ds_stack_reserve and ds_stack_shrink_to_fit to
+ * control the capacity explicitly.
+ * 
+ * @param capacity_hint Number of elements to reserve up front (may be 0)
+ * @return Pointer to new stack on success, NULL on memory allocation failure
+ */
+ds_stack_t *ds_stack_create_array(size_t capacity_hint);
+
 /**
  * @brief Free a stack and optionally its data
  * 
@@ -67,6 +105,80 @@ void *ds_stack_pop(ds_stack_t *S);
  */
 void *ds_stack_peek(const ds_stack_t *S);
 
+/**
+ * @brief Push a span of elements onto the stack
+ * 
+ * Pushes items[0] first, so items[n - 1] ends up on top. On error the
+ * stack is left unchanged. Array-backed stacks copy the span at once.
+ * 
+ * @param S Pointer to stack
+ * @param items Array of data pointers to push
+ * @param n Number of elements in items
+ * @return DS_OK on success, DS_ERR_NULLARG if S, items, or any element is NULL, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_stack_push_n(ds_stack_t *S, void *const *items, size_t n);
+
+/**
+ * @brief Pop up to n elements from the stack
+ * 
+ * The popped elements are written to out in push order, so out[count - 1]
+ * holds the former top and ds_stack_push_n(S, out, count) restores the
+ * stack. Array-backed stacks copy the span at once.
+ * 
+ * @param S Pointer to stack
+ * @param out Array receiving at least n data pointers
+ * @param n Maximum number of elements to pop
+ * @return Number of elements popped, or 0 if S or out is NULL
+ */
+size_t ds_stack_pop_n(ds_stack_t *S, void **out, size_t n);
+
+/**
+ * @brief Move all elements of one stack on top of another
+ * 
+ * Places T's elements on S in their current order, so T's top becomes
+ * S's top, and leaves T empty but usable. Linked stacks are relinked in
+ * O(1) without touching the allocator; they must share a node allocator,
+ * and pooled stacks cannot be transferred because their nodes belong to
+ * their private pool. Two array-backed stacks (see ds_stack_create_array)
+ * are joined by copying T's slots.
+ * 
+ * @param S Pointer to stack receiving all elements
+ * @param T Pointer to stack to empty onto S
+ * @return DS_OK on success, DS_ERR_NULLARG if S or T is NULL,
+ *         DS_ERR_INVALID if S and T are the same or incompatible stacks,
+ *         DS_ERR_OOM if an element array cannot grow
+ */
+ds_error_t ds_stack_transfer(ds_stack_t *S, ds_stack_t *T);
+
+/**
+ * @brief Reserve capacity in an array-backed stack
+ * 
+ * Ensures that at least capacity elements fit without reallocation.
+ * 
+ * @param S Pointer to stack
+ * @param capacity Minimum number of elements to make room for
+ * @return DS_OK on success, DS_ERR_NULLARG if S is NULL, DS_ERR_INVALID if S is not array-backed, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_stack_reserve(ds_stack_t *S, size_t capacity);
+
+/**
+ * @brief Release unused capacity of an array-backed stack
+ * 
+ * Shrinks the element array to exactly the current size.
+ * 
+ * @param S Pointer to stack
+ * @return DS_OK on success, DS_ERR_NULLARG if S is NULL, DS_ERR_INVALID if S is not array-backed, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_stack_shrink_to_fit(ds_stack_t *S);
+
+/**
+ * @brief Get the capacity of an array-backed stack
+ * 
+ * @param S Pointer to stack
+ * @return Number of elements that fit without reallocation, or 0 if S is NULL or not array-backed
+ */
+size_t ds_stack_capacity(const ds_stack_t *S);
+
 /**
  * @brief Check if stack is empty
  * 
@@ -87,6 +199,18 @@ int ds_stack_is_empty(const ds_stack_t *S);
  */
 size_t ds_stack_size(const ds_stack_t *S);
 
+/**
+ * @brief Get the runtime counters of a stack
+ * 
+ * Reports node or array allocations, live bytes and element counts
+ * (see ds_stats_t).
+ * 
+ * @param S Pointer to stack
+ * @param out Receives the counters
+ * @return DS_OK on success, DS_ERR_NULLARG if S or out is NULL
+ */
+ds_error_t ds_stack_stats(const ds_stack_t *S, ds_stats_t *out);
+
 /**
  * @brief Visualize the stack structure
  * 
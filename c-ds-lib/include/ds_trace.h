@@ -0,0 +1,206 @@
+/**
+ * @file ds_trace.h
+ * @brief Operation tracing and latency histogram interface
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * This header provides the tracing layer that times the hot public
+ * operations of the containers. Sampled calls are recorded into
+ * log-linear latency histograms kept per thread, so recording never
+ * contends, and can additionally be forwarded to a user hook that fires
+ * perf, USDT or eBPF probes.
+ * 
+ * @note Only available when the library is built with `make TRACE=1`.
+ *       Without it the instrumentation compiles away completely.
+ */
+
+#ifndef DS_TRACE_H
+#define DS_TRACE_H
+
+#include "ds.h"
+#include <stdint.h>  /* for uint64_t */
+#include <stdio.h>   /* for FILE */
+
+/**
+ * @brief Number of sub-buckets per power of two, as a bit count
+ * 
+ * Each power-of-two range of latencies is split into 2^3 equal buckets,
+ * so a bucket's bounds are within 12.5% of any value it holds.
+ */
+#define DS_TRACE_SUB_BITS 3
+
+/**
+ * @brief Latencies from 2^DS_TRACE_MAX_BITS ns upwards share the last bucket
+ */
+#define DS_TRACE_MAX_BITS 40
+
+/**
+ * @brief Number of buckets in a latency histogram
+ */
+#define DS_TRACE_BUCKETS (((DS_TRACE_MAX_BITS - DS_TRACE_SUB_BITS) + 1) << DS_TRACE_SUB_BITS)
+
+/**
+ * @brief Traced operations
+ */
+typedef enum ds_trace_op {
+    DS_TRACE_LIST_PUSH_FRONT,      /**< ds_list_push_front */
+    DS_TRACE_LIST_PUSH_BACK,       /**< ds_list_push_back */
+    DS_TRACE_LIST_POP_FRONT,       /**< ds_list_pop_front */
+    DS_TRACE_LIST_FIND,            /**< ds_list_find */
+    DS_TRACE_LIST_REMOVE,          /**< ds_list_remove */
+    DS_TRACE_QUEUE_ENQUEUE,        /**< ds_queue_enqueue */
+    DS_TRACE_QUEUE_DEQUEUE,        /**< ds_queue_dequeue */
+    DS_TRACE_STACK_PUSH,           /**< ds_stack_push */
+    DS_TRACE_STACK_POP,            /**< ds_stack_pop */
+    DS_TRACE_DEQUE_PUSH_BACK,      /**< ds_deque_push_back */
+    DS_TRACE_DEQUE_POP_FRONT,      /**< ds_deque_pop_front */
+    DS_TRACE_PQUEUE_PUSH,          /**< ds_pqueue_push */
+    DS_TRACE_PQUEUE_POP,           /**< ds_pqueue_pop */
+    DS_TRACE_TREE_INSERT,          /**< ds_tree_insert */
+    DS_TRACE_TREE_FIND,            /**< ds_tree_find */
+    DS_TRACE_TREE_REMOVE,          /**< ds_tree_remove */
+    DS_TRACE_BTREE_INSERT,         /**< ds_btree_insert */
+    DS_TRACE_BTREE_FIND,           /**< ds_btree_find */
+    DS_TRACE_BTREE_REMOVE,         /**< ds_btree_remove */
+    DS_TRACE_SKIPLIST_INSERT,      /**< ds_skiplist_insert */
+    DS_TRACE_SKIPLIST_FIND,        /**< ds_skiplist_find */
+    DS_TRACE_SKIPLIST_REMOVE,      /**< ds_skiplist_remove */
+    DS_TRACE_HASHMAP_INSERT,       /**< ds_hashmap_insert */
+    DS_TRACE_HASHMAP_FIND,         /**< ds_hashmap_find */
+    DS_TRACE_HASHMAP_REMOVE,       /**< ds_hashmap_remove */
+    DS_TRACE_OP_COUNT              /**< Number of traced operations */
+} ds_trace_op_t;
+
+/**
+ * @brief Callback invoked for every sampled call
+ * 
+ * Runs on the calling thread right after the operation returns, so it
+ * should be short. A hook that only fires a USDT probe or writes to a
+ * perf ring buffer keeps the traced path cheap.
+ * 
+ * @param op Operation that was timed
+ * @param obj Container the operation ran on
+ * @param ns Latency of the call in nanoseconds
+ * @param ctx User context given to ds_trace_set_hook
+ */
+typedef void (*ds_trace_hook_t)(ds_trace_op_t op, const void *obj, uint64_t ns, void *ctx);
+
+/**
+ * @brief Latency histogram of one operation
+ * 
+ * buckets[i] counts the samples between ds_trace_bucket_floor(i) and
+ * ds_trace_bucket_floor(i + 1) - 1 nanoseconds; the last bucket also
+ * counts every latency of 2^DS_TRACE_MAX_BITS ns or more.
+ */
+typedef struct ds_trace_hist {
+    uint64_t count;                        /**< Number of samples */
+    uint64_t total_ns;                     /**< Sum of all sampled latencies */
+    uint64_t max_ns;                       /**< Largest sampled latency */
+    uint64_t buckets[DS_TRACE_BUCKETS];    /**< Log-linear sample counts */
+} ds_trace_hist_t;
+
+/**
+ * @brief Set how often operations are timed
+ * 
+ * With period N every N-th traced call on each thread is timed; the
+ * calls in between only decrement a thread-local counter. Period 0,
+ * the default, turns timing and the hook off.
+ * 
+ * @param period Sampling period (0 disables, 1 times every call)
+ * @return DS_OK
+ */
+ds_error_t ds_trace_set_sampling(unsigned period);
+
+/**
+ * @brief Get the current sampling period
+ * 
+ * @return Period set with ds_trace_set_sampling, 0 if tracing is off
+ */
+unsigned ds_trace_sampling(void);
+
+/**
+ * @brief Install a hook that receives every sampled call
+ * 
+ * Only one hook is installed at a time; installing another replaces it.
+ * Set the hook while no traced operation is running.
+ * 
+ * @param hook Callback, or NULL to remove the current hook
+ * @param ctx User context passed to hook
+ * @return DS_OK
+ */
+ds_error_t ds_trace_set_hook(ds_trace_hook_t hook, void *ctx);
+
+/**
+ * @brief Get the latency histogram of an operation across all threads
+ * 
+ * Sums the histograms of every thread that has recorded a sample. Taking
+ * a snapshot while other threads record is safe; samples recorded during
+ * the call may or may not be included.
+ * 
+ * @param op Operation to report
+ * @param out Receives the merged histogram
+ * @return DS_OK on success, DS_ERR_NULLARG if out is NULL, DS_ERR_INVALID if op is out of range
+ */
+ds_error_t ds_trace_histogram(ds_trace_op_t op, ds_trace_hist_t *out);
+
+/**
+ * @brief Get the latency histogram of an operation on the calling thread
+ * 
+ * @param op Operation to report
+ * @param out Receives the histogram
+ * @return DS_OK on success, DS_ERR_NULLARG if out is NULL, DS_ERR_INVALID if op is out of range
+ */
+ds_error_t ds_trace_thread_histogram(ds_trace_op_t op, ds_trace_hist_t *out);
+
+/**
+ * @brief Clear all recorded samples of all threads
+ * 
+ * @note Samples recorded by other threads during the call may survive
+ *       it partly; reset while the traced operations are quiet
+ */
+void ds_trace_reset(void);
+
+/**
+ * @brief Get the smallest latency counted by a histogram bucket
+ * 
+ * @param i Bucket index, at most DS_TRACE_BUCKETS
+ * @return Lower bound of bucket i in nanoseconds, 2^DS_TRACE_MAX_BITS
+ *         for i == DS_TRACE_BUCKETS
+ */
+uint64_t ds_trace_bucket_floor(size_t i);
+
+/**
+ * @brief Estimate a latency percentile from a histogram
+ * 
+ * Returns the upper bound of the bucket holding the sample at that rank,
+ * capped at the largest latency seen, so the estimate is at most 12.5%
+ * above the true value.
+ * 
+ * @param h Histogram to read
+ * @param p Percentile between 0 and 100 (e.g. 99.9)
+ * @return Latency in nanoseconds, or 0 if h is NULL or empty
+ */
+uint64_t ds_trace_percentile(const ds_trace_hist_t *h, double p);
+
+/**
+ * @brief Get the name of an operation
+ * 
+ * @param op Operation
+ * @return Public function name such as "ds_tree_find", or "unknown" if op is out of range
+ */
+const char *ds_trace_op_name(ds_trace_op_t op);
+
+/**
+ * @brief Print a latency summary of every operation that has samples
+ * 
+ * Writes one line per operation with the sample count, mean, p50, p99,
+ * p99.9 and maximum latency, merged across threads.
+ * 
+ * @param out Output stream (e.g., stdout, stderr)
+ * 
+ * @note Safe to call with NULL out
+ */
+void ds_trace_print(FILE *out);
+
+#endif /* DS_TRACE_H */
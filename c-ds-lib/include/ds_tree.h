@@ -15,6 +15,17 @@
 #include "ds.h"
 #include <stdio.h>  /* for FILE */
 
+/**
+ * @brief In-order iterator over a tree
+ * 
+ * Iterators live on the caller's stack and need no allocation. An
+ * iterator is invalidated by any insert or remove on its tree.
+ */
+typedef struct ds_tree_iter {
+    const ds_tree_t *tree;         /**< Tree being iterated */
+    void *node;                    /**< Current position (internal), NULL when exhausted */
+} ds_tree_iter_t;
+
 /**
  * @brief Create a new empty tree
  * 
@@ -24,11 +35,84 @@
  */
 ds_tree_t *ds_tree_create(void);
 
+/**
+ * @brief Create a new empty tree with a custom node allocator
+ * 
+ * The tree structure itself is obtained from ds_alloc, while every
+ * node is obtained from the given allocator. The allocator is copied;
+ * its context must outlive the tree. With an arena allocator (see
+ * ds_arena_allocator) ds_tree_free without free_data does not visit the
+ * nodes; they are reclaimed by ds_arena_reset.
+ * 
+ * @param a Allocator for nodes, or NULL for the library-level allocator
+ * @return Pointer to new tree on success, NULL on invalid allocator or memory failure
+ */
+ds_tree_t *ds_tree_create_with_allocator(const ds_allocator_t *a);
+
+/**
+ * @brief Create a new empty tree backed by a private node pool
+ * 
+ * Nodes are carved out of a slab pool owned by the tree instead of
+ * being allocated one by one. The pool is released in a single pass
+ * when the tree is freed.
+ * 
+ * @return Pointer to new tree on success, NULL on memory allocation failure
+ */
+ds_tree_t *ds_tree_create_pooled(void);
+
+/**
+ * @brief Create a new empty self-balancing tree
+ * 
+ * The tree is kept AVL-balanced on every insert and remove, so height,
+ * insert, find and remove stay O(log n) even when keys arrive sorted.
+ * All other tree operations behave exactly as for a plain tree.
+ * 
+ * @return Pointer to new tree on success, NULL on memory allocation failure
+ */
+ds_tree_t *ds_tree_create_balanced(void);
+
+/**
+ * @brief Create a new empty compact tree
+ * 
+ * Nodes are kept in one contiguous array and linked by 32-bit slot
+ * numbers instead of pointers, so each element costs a 24-byte slot on
+ * 64-bit targets with no per-node allocation. The array doubles when
+ * full and never shrinks; removed slots are reused by later inserts.
+ * The tree is AVL-balanced (see ds_tree_create_balanced) and holds at
+ * most 2^32 - 2 elements. All other tree operations behave exactly as
+ * for a pointer-linked tree, except that ds_tree_reduce_parallel and
+ * ds_tree_foreach_parallel run on the calling thread.
+ * 
+ * @param capacity_hint Expected number of elements, reserved up front
+ * @return Pointer to new tree on success, NULL on memory allocation failure
+ *         or if capacity_hint does not fit in 32-bit slot numbers
+ */
+ds_tree_t *ds_tree_create_compact(size_t capacity_hint);
+
+/**
+ * @brief Build a balanced tree from items already in ascending order
+ * 
+ * Lays out all n items as a perfectly balanced self-balancing tree (see
+ * ds_tree_create_balanced) in O(n) time, without comparing items and
+ * with every node taken from a single allocation. This is much faster
+ * than n calls to ds_tree_insert when loading sorted data.
+ * 
+ * @param items Array of n data pointers in strictly ascending order
+ * @param n Number of items (0 yields an empty tree)
+ * @return Pointer to new tree on success, NULL if items is NULL while n > 0,
+ *         if any item is NULL, or on memory allocation failure
+ * 
+ * @note The order is not checked; unsorted input yields a tree on which
+ *       find and remove give wrong answers
+ */
+ds_tree_t *ds_tree_build_sorted(void *const *items, size_t n);
+
 /**
  * @brief Free a tree and optionally its data
  * 
  * Deallocates all nodes in the tree. If free_data is provided,
- * it will be called for each node's data pointer.
+ * it will be called for each node's data pointer. The teardown uses
+ * constant stack space regardless of the tree's shape.
  * 
  * @param T Pointer to tree to free
  * @param free_data Optional function to free node data (may be NULL)
@@ -36,6 +120,19 @@ ds_tree_t *ds_tree_create(void);
  */
 ds_error_t ds_tree_free(ds_tree_t *T, void (*free_data)(void *));
 
+/**
+ * @brief Remove all elements from a tree, keeping the tree itself
+ * 
+ * Deallocates all nodes like ds_tree_free but leaves T empty and ready
+ * for reuse with the same allocator and balancing mode. Runs without
+ * recursion, so it is safe on arbitrarily deep trees.
+ * 
+ * @param T Pointer to tree to clear
+ * @param free_data Optional function to free node data (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if T is NULL
+ */
+ds_error_t ds_tree_clear(ds_tree_t *T, void (*free_data)(void *));
+
 /**
  * @brief Insert element into the tree
  * 
@@ -61,10 +158,29 @@ ds_error_t ds_tree_insert(ds_tree_t *T, void *data, int (*cmp)(const void *, con
  */
 void *ds_tree_find(ds_tree_t *T, void *target, int (*cmp)(const void *, const void *));
 
+/**
+ * @brief Find many elements in the tree at once
+ * 
+ * Equivalent to calling ds_tree_find for each key, but several lookups
+ * descend the tree together with software prefetching so their memory
+ * latency overlaps. Best for groups of tens to hundreds of keys.
+ * 
+ * @param T Pointer to tree
+ * @param keys Array of n keys to find (NULL entries are not found)
+ * @param n Number of keys
+ * @param out Array receiving n results: out[i] is the data matching keys[i], or NULL
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return Number of keys found, 0 if T, keys, out, or cmp is NULL
+ */
+size_t ds_tree_find_batch(ds_tree_t *T, void *const *keys, size_t n, void **out,
+                          int (*cmp)(const void *, const void *));
+
 /**
  * @brief Remove element from the tree
  * 
- * Removes an element from the tree using the comparison function.
+ * Removes an element from the tree using the comparison function. In
+ * lazy-remove mode (see ds_tree_set_lazy_remove) the node is only marked
+ * as a tombstone.
  * 
  * @param T Pointer to tree
  * @param target Pointer to data to remove
@@ -73,6 +189,56 @@ void *ds_tree_find(ds_tree_t *T, void *target, int (*cmp)(const void *, const vo
  */
 ds_error_t ds_tree_remove(ds_tree_t *T, void *target, int (*cmp)(const void *, const void *));
 
+/**
+ * @brief Switch a tree between eager and lazy removal
+ * 
+ * In lazy mode ds_tree_remove only marks the matching node as a
+ * tombstone in O(log n), without restructuring or freeing anything.
+ * Lookups, iterators and every other operation skip tombstones, and
+ * inserting a removed key again reuses its tombstone. Once tombstones
+ * make up more than max_dead of all nodes, the remove that crossed the
+ * limit runs ds_tree_compact; with max_dead 1 only an explicit call
+ * compacts. Setting max_dead to 0 returns to eager removal and sweeps
+ * out any remaining tombstones.
+ * 
+ * A tombstone still routes searches through its element, so a removed
+ * element must stay valid until it is purged. Purged elements are passed
+ * to release, which also applies to the element of a tombstone reused
+ * by an insert of a different object with an equal key (reinserting the
+ * same pointer keeps it) and to tombstones left when the tree is cleared
+ * or freed. Without release the caller must keep removed elements alive
+ * until the next compaction, clear or free.
+ * 
+ * @param T Pointer to tree
+ * @param max_dead Tombstone fraction of all nodes that triggers compaction,
+ *                 in (0, 1]; 0 restores eager removal
+ * @param release Receives the data of every purged tombstone (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if T is NULL, DS_ERR_INVALID if max_dead is out of range
+ */
+ds_error_t ds_tree_set_lazy_remove(ds_tree_t *T, double max_dead, void (*release)(void *data));
+
+/**
+ * @brief Sweep out tombstones and rebuild the tree
+ * 
+ * Unlinks every tombstone, hands its element to the release callback
+ * and relinks the remaining nodes into a perfectly balanced shape. The
+ * rebuild is one O(n) in-order pass over the nodes already allocated:
+ * it allocates nothing, calls no comparator and cannot fail. It may be
+ * called on any tree, and also rebalances a plain one.
+ * 
+ * @param T Pointer to tree
+ * @return DS_OK on success, DS_ERR_NULLARG if T is NULL
+ */
+ds_error_t ds_tree_compact(ds_tree_t *T);
+
+/**
+ * @brief Get the number of tombstones awaiting compaction
+ * 
+ * @param T Pointer to tree
+ * @return Number of lazily removed nodes still linked, or 0 if T is NULL
+ */
+size_t ds_tree_tombstones(const ds_tree_t *T);
+
 /**
  * @brief Get the number of elements in the tree
  * 
@@ -83,6 +249,18 @@ ds_error_t ds_tree_remove(ds_tree_t *T, void *target, int (*cmp)(const void *, c
  */
 size_t ds_tree_size(const ds_tree_t *T);
 
+/**
+ * @brief Get the height of the tree
+ * 
+ * Returns the number of nodes on the longest root-to-leaf path. This is
+ * O(1) for balanced trees and O(n) without recursion otherwise.
+ * Tombstones count towards the height until they are compacted away.
+ * 
+ * @param T Pointer to tree
+ * @return Height of tree, or 0 if T is NULL or empty
+ */
+size_t ds_tree_height(const ds_tree_t *T);
+
 /**
  * @brief Check if tree is empty
  * 
@@ -93,6 +271,118 @@ size_t ds_tree_size(const ds_tree_t *T);
  */
 int ds_tree_is_empty(const ds_tree_t *T);
 
+/**
+ * @brief Position an iterator at the smallest element
+ * 
+ * @param it Iterator to initialize
+ * @param T Pointer to tree
+ * @return Pointer to smallest element's data, or NULL if T is empty or it/T is NULL
+ */
+void *ds_tree_iter_first(ds_tree_iter_t *it, const ds_tree_t *T);
+
+/**
+ * @brief Position an iterator at the first element not less than key
+ * 
+ * @param it Iterator to initialize
+ * @param T Pointer to tree
+ * @param key Pointer to key to seek to
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return Pointer to data of first element >= key, or NULL if none or any argument is NULL
+ */
+void *ds_tree_iter_seek(ds_tree_iter_t *it, const ds_tree_t *T, const void *key,
+                        int (*cmp)(const void *, const void *));
+
+/**
+ * @brief Advance an iterator to the next element in order
+ * 
+ * Runs in amortized O(1) time using the nodes' parent links, without
+ * recursion or extra memory.
+ * 
+ * @param it Pointer to iterator
+ * @return Pointer to next element's data, or NULL when the iteration is over
+ */
+void *ds_tree_iter_next(ds_tree_iter_t *it);
+
+/**
+ * @brief Get the element an iterator is positioned at
+ * 
+ * @param it Pointer to iterator
+ * @return Pointer to current element's data, or NULL if exhausted or it is NULL
+ */
+void *ds_tree_iter_get(const ds_tree_iter_t *it);
+
+/**
+ * @brief Visit all elements in the closed range [lo, hi] in order
+ * 
+ * Calls cb for every element e with cmp(lo, e) <= 0 and cmp(e, hi) <= 0,
+ * in ascending order, in O(log n + k) time. A NULL bound leaves that side
+ * of the range open. Iteration stops early when cb returns non-zero.
+ * 
+ * @param T Pointer to tree
+ * @param lo Lower bound (NULL for no lower bound)
+ * @param hi Upper bound (NULL for no upper bound)
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @param cb Callback invoked with each element and ctx
+ * @param ctx User context passed to cb
+ * @return DS_OK on success, DS_ERR_NULLARG if T, cmp, or cb is NULL
+ */
+ds_error_t ds_tree_range(const ds_tree_t *T, const void *lo, const void *hi,
+                         int (*cmp)(const void *, const void *),
+                         int (*cb)(void *data, void *ctx), void *ctx);
+
+/**
+ * @brief Save a tree as a memory-mappable snapshot
+ * 
+ * Writes every element in ascending order to path in the format
+ * described in ds_snapshot.h.
+ * 
+ * The serializer is called once per element with a scratch buffer of cap
+ * bytes. It returns the payload size and writes the payload only if it
+ * fits; when it does not, the buffer is grown and ser is called again.
+ * Returning (size_t)-1 aborts the save. The file is written under a
+ * temporary name and renamed into place, so processes that have the old
+ * snapshot mapped keep a consistent view. Open it with ds_tree_open_mapped.
+ * 
+ * @param T Pointer to tree
+ * @param path Destination file
+ * @param ser Serializer (data, buf, cap, ctx) returning the payload size
+ * @param ctx User context passed to ser
+ * @return DS_OK on success, DS_ERR_NULLARG if T, path, or ser is NULL,
+ *         DS_ERR_INVALID if ser fails, DS_ERR_OOM on memory failure,
+ *         DS_ERR_IO if the file cannot be written
+ */
+ds_error_t ds_tree_save(const ds_tree_t *T, const char *path,
+                        size_t (*ser)(const void *data, void *buf, size_t cap, void *ctx),
+                        void *ctx);
+
+/**
+ * @brief Get the runtime counters of a tree
+ * 
+ * Reports node allocations, live bytes, element counts, comparator calls
+ * and, for lookups, the nodes visited; find_depth / finds is the average
+ * lookup depth (see ds_stats_t).
+ * 
+ * @param T Pointer to tree
+ * @param out Receives the counters
+ * @return DS_OK on success, DS_ERR_NULLARG if T or out is NULL
+ */
+ds_error_t ds_tree_stats(const ds_tree_t *T, ds_stats_t *out);
+
+/**
+ * @brief Get the number of bytes a tree holds
+ * 
+ * Counts the tree structure and all of its node storage: the node array
+ * of a compact tree (including unused slots), every slab of a pooled or
+ * built tree, and otherwise the bytes of every node requested from the
+ * allocator. Overhead the allocator adds on top of each request, such
+ * as malloc headers, is not visible to the library and is not counted.
+ * Element data is owned by the caller and is not counted either.
+ * 
+ * @param T Pointer to tree
+ * @return Bytes held, or 0 if T is NULL
+ */
+size_t ds_tree_memory_usage(const ds_tree_t *T);
+
 /**
  * @brief Visualize the tree structure
  * 
@@ -0,0 +1,485 @@
+/**
+ * @file ds_typed.h
+ * @brief Macro templates for type-specialized containers
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * The regular containers store void* payloads and order them through a
+ * comparison callback. The macros in this header instead generate a
+ * container for one concrete element type: elements are stored by value
+ * inside the nodes or arrays, and the comparison is an expression the
+ * compiler can inline. Every generated function is static inline, so an
+ * instantiation only costs code for the functions actually used.
+ * 
+ * Instantiate once per type, at file scope:
+ * 
+ * @code
+ * DS_DEFINE_TREE(itree, int64_t, (a > b) - (a < b))
+ * DS_DEFINE_QUEUE(iqueue, int64_t)
+ * DS_DEFINE_STACK(istack, int64_t)
+ * 
+ * itree *t = itree_create();
+ * itree_insert(t, 42);
+ * if (itree_find(t, 42) != NULL) { ... }
+ * itree_free(t);
+ * @endcode
+ * 
+ * Generated containers allocate through ds_alloc/ds_free and report
+ * errors with ds_error_t, like the rest of the library.
+ */
+
+#ifndef DS_TYPED_H
+#define DS_TYPED_H
+
+#include "ds.h"
+#include <string.h>  /* for memcpy */
+
+/**
+ * @brief Upper bound on the height of a generated AVL tree
+ * 
+ * An AVL tree of height h holds at least F(h+2)-1 nodes, so 96 levels
+ * exceed any tree that fits in a 64-bit address space.
+ */
+#define DS_TYPED_MAX_HEIGHT 96
+
+/**
+ * @brief Minimum number of slots in generated queues and stacks
+ */
+#define DS_TYPED_MIN_CAPACITY 16
+
+/**
+ * @brief Define an AVL-balanced ordered set of key_t values
+ * 
+ * Generates the type `name` and the functions name_create, name_free,
+ * name_insert, name_find, name_remove, name_size, name_is_empty and
+ * name_foreach. Nodes hold the key by value and have no parent pointer;
+ * insert and remove keep the descent path on the stack instead.
+ * 
+ * @param name Prefix for the generated type and functions
+ * @param key_t Element type (copied by value)
+ * @param cmp_expr Expression over `a` and `b` (both key_t) returning <0, 0, >0
+ */
+#define DS_DEFINE_TREE(name, key_t, cmp_expr)                                   \
+typedef struct name##_node {                                                    \
+    key_t key;                                                                  \
+    struct name##_node *left;                                                   \
+    struct name##_node *right;                                                  \
+    int height;                                                                 \
+} name##_node;                                                                  \
+                                                                                \
+typedef struct name {                                                           \
+    name##_node *root;                                                          \
+    size_t size;                                                                \
+} name;                                                                         \
+                                                                                \
+static inline int name##_cmp(key_t a, key_t b) {                               \
+    return (cmp_expr);                                                          \
+}                                                                               \
+                                                                                \
+static inline int name##_height_of(const name##_node *n) {                      \
+    return (n != NULL) ? n->height : 0;                                         \
+}                                                                               \
+                                                                                \
+static inline void name##_update(name##_node *n) {                              \
+    int hl = name##_height_of(n->left), hr = name##_height_of(n->right);        \
+    n->height = 1 + ((hl > hr) ? hl : hr);                                      \
+}                                                                               \
+                                                                                \
+static inline name##_node *name##_rotate_right(name##_node *n) {                \
+    name##_node *l = n->left;                                                   \
+    n->left = l->right;                                                         \
+    l->right = n;                                                               \
+    name##_update(n);                                                           \
+    name##_update(l);                                                           \
+    return l;                                                                   \
+}                                                                               \
+                                                                                \
+static inline name##_node *name##_rotate_left(name##_node *n) {                 \
+    name##_node *r = n->right;                                                  \
+    n->right = r->left;                                                         \
+    r->left = n;                                                                \
+    name##_update(n);                                                           \
+    name##_update(r);                                                           \
+    return r;                                                                   \
+}                                                                               \
+                                                                                \
+/* Restore the AVL property at *link and refresh its height */                 \
+static inline void name##_fix(name##_node **link) {                             \
+    name##_node *n = *link;                                                     \
+    int bal = name##_height_of(n->left) - name##_height_of(n->right);           \
+                                                                                \
+    if (bal > 1) {                                                              \
+        if (name##_height_of(n->left->left) < name##_height_of(n->left->right)) { \
+            n->left = name##_rotate_left(n->left);                              \
+        }                                                                       \
+        *link = name##_rotate_right(n);                                         \
+    } else if (bal < -1) {                                                      \
+        if (name##_height_of(n->right->right) < name##_height_of(n->right->left)) { \
+            n->right = name##_rotate_right(n->right);                           \
+        }                                                                       \
+        *link = name##_rotate_left(n);                                          \
+    } else {                                                                    \
+        name##_update(n);                                                       \
+    }                                                                           \
+}                                                                               \
+                                                                                \
+static inline name *name##_create(void) {                                       \
+    name *t = (name *)ds_alloc(sizeof(name));                                   \
+    if (t != NULL) {                                                            \
+        t->root = NULL;                                                         \
+        t->size = 0;                                                            \
+    }                                                                           \
+    return t;                                                                   \
+}                                                                               \
+                                                                                \
+static inline ds_error_t name##_free(name *t) {                                 \
+    name##_node *n, *l;                                                         \
+    if (t == NULL) {                                                            \
+        return DS_ERR_NULLARG;                                                  \
+    }                                                                           \
+    /* Rotate left children up until each node can be freed in turn */         \
+    n = t->root;                                                                \
+    while (n != NULL) {                                                         \
+        if (n->left != NULL) {                                                  \
+            l = n->left;                                                        \
+            n->left = l->right;                                                 \
+            l->right = n;                                                       \
+            n = l;                                                              \
+        } else {                                                                \
+            l = n->right;                                                       \
+            ds_free(n);                                                         \
+            n = l;                                                              \
+        }                                                                       \
+    }                                                                           \
+    ds_free(t);                                                                 \
+    return DS_OK;                                                               \
+}                                                                               \
+                                                                                \
+static inline ds_error_t name##_insert(name *t, key_t key) {                    \
+    name##_node **path[DS_TYPED_MAX_HEIGHT];                                    \
+    name##_node **link, *n;                                                     \
+    int depth = 0, c, old;                                                      \
+    if (t == NULL) {                                                            \
+        return DS_ERR_NULLARG;                                                  \
+    }                                                                           \
+    link = &t->root;                                                            \
+    while (*link != NULL) {                                                     \
+        c = name##_cmp(key, (*link)->key);                                      \
+        if (c == 0) {                                                           \
+            return DS_OK;                                                       \
+        }                                                                       \
+        path[depth++] = link;                                                   \
+        link = (c < 0) ? &(*link)->left : &(*link)->right;                      \
+    }                                                                           \
+    n = (name##_node *)ds_alloc(sizeof(name##_node));                           \
+    if (n == NULL) {                                                            \
+        return DS_ERR_OOM;                                                      \
+    }                                                                           \
+    n->key = key;                                                               \
+    n->left = NULL;                                                             \
+    n->right = NULL;                                                            \
+    n->height = 1;                                                              \
+    *link = n;                                                                  \
+    t->size++;                                                                  \
+    /* Rebalance upwards until a subtree height stops changing */              \
+    while (depth > 0) {                                                         \
+        link = path[--depth];                                                   \
+        old = (*link)->height;                                                  \
+        name##_fix(link);                                                       \
+        if ((*link)->height == old) {                                           \
+            break;                                                              \
+        }                                                                       \
+    }                                                                           \
+    return DS_OK;                                                               \
+}                                                                               \
+                                                                                \
+static inline key_t *name##_find(const name *t, key_t key) {                    \
+    name##_node *n;                                                             \
+    int c;                                                                      \
+    if (t == NULL) {                                                            \
+        return NULL;                                                            \
+    }                                                                           \
+    n = t->root;                                                                \
+    while (n != NULL) {                                                         \
+        c = name##_cmp(key, n->key);                                            \
+        if (c == 0) {                                                           \
+            return &n->key;                                                     \
+        }                                                                       \
+        n = (c < 0) ? n->left : n->right;                                       \
+    }                                                                           \
+    return NULL;                                                                \
+}                                                                               \
+                                                                                \
+static inline ds_error_t name##_remove(name *t, key_t key) {                    \
+    name##_node **path[DS_TYPED_MAX_HEIGHT];                                    \
+    name##_node **link, **succ, *n, *s;                                         \
+    int depth = 0, c;                                                           \
+    if (t == NULL) {                                                            \
+        return DS_ERR_NULLARG;                                                  \
+    }                                                                           \
+    link = &t->root;                                                            \
+    while (*link != NULL && (c = name##_cmp(key, (*link)->key)) != 0) {         \
+        path[depth++] = link;                                                   \
+        link = (c < 0) ? &(*link)->left : &(*link)->right;                      \
+    }                                                                           \
+    if (*link == NULL) {                                                        \
+        return DS_ERR_NOTFOUND;                                                 \
+    }                                                                           \
+    n = *link;                                                                  \
+    if (n->left != NULL && n->right != NULL) {                                  \
+        /* Move the successor's key here and unlink the successor instead */   \
+        path[depth++] = link;                                                   \
+        succ = &n->right;                                                       \
+        while ((*succ)->left != NULL) {                                         \
+            path[depth++] = succ;                                               \
+            succ = &(*succ)->left;                                              \
+        }                                                                       \
+        s = *succ;                                                              \
+        n->key = s->key;                                                        \
+        *succ = s->right;                                                       \
+        n = s;                                                                  \
+    } else {                                                                    \
+        *link = (n->left != NULL) ? n->left : n->right;                         \
+    }                                                                           \
+    ds_free(n);                                                                 \
+    t->size--;                                                                  \
+    while (depth > 0) {                                                         \
+        name##_fix(path[--depth]);                                              \
+    }                                                                           \
+    return DS_OK;                                                               \
+}                                                                               \
+                                                                                \
+static inline size_t name##_size(const name *t) {                               \
+    return (t != NULL) ? t->size : 0;                                           \
+}                                                                               \
+                                                                                \
+static inline int name##_is_empty(const name *t) {                              \
+    return (t == NULL || t->size == 0);                                         \
+}                                                                               \
+                                                                                \
+/* In-order visit; stops early when cb returns non-zero */                     \
+static inline ds_error_t name##_foreach(const name *t, int (*cb)(key_t *key, void *ctx), \
+                                        void *ctx) {                            \
+    name##_node *stack[DS_TYPED_MAX_HEIGHT];                                    \
+    name##_node *n;                                                             \
+    int top = 0;                                                                \
+    if (t == NULL || cb == NULL) {                                              \
+        return DS_ERR_NULLARG;                                                  \
+    }                                                                           \
+    n = t->root;                                                                \
+    while (n != NULL || top > 0) {                                              \
+        while (n != NULL) {                                                     \
+            stack[top++] = n;                                                   \
+            n = n->left;                                                        \
+        }                                                                       \
+        n = stack[--top];                                                       \
+        if (cb(&n->key, ctx)) {                                                 \
+            break;                                                              \
+        }                                                                       \
+        n = n->right;                                                           \
+    }                                                                           \
+    return DS_OK;                                                               \
+}
+
+/**
+ * @brief Define a FIFO queue of T values backed by a growable ring buffer
+ * 
+ * Generates the type `name` and the functions name_create, name_free,
+ * name_enqueue, name_dequeue, name_peek, name_size and name_is_empty.
+ * 
+ * @param name Prefix for the generated type and functions
+ * @param T Element type (copied by value)
+ */
+#define DS_DEFINE_QUEUE(name, T)                                                \
+typedef struct name {                                                           \
+    T *buf;                                                                     \
+    size_t cap;                                                                 \
+    size_t head;                                                                \
+    size_t size;                                                                \
+} name;                                                                         \
+                                                                                \
+static inline name *name##_create(size_t capacity_hint) {                       \
+    name *q = (name *)ds_alloc(sizeof(name));                                   \
+    size_t cap = DS_TYPED_MIN_CAPACITY;                                         \
+    if (q == NULL) {                                                            \
+        return NULL;                                                            \
+    }                                                                           \
+    while (cap < capacity_hint && cap <= (size_t)-1 / 2 / sizeof(T)) {          \
+        cap <<= 1;                                                              \
+    }                                                                           \
+    q->buf = (T *)ds_alloc(cap * sizeof(T));                                    \
+    if (q->buf == NULL) {                                                       \
+        ds_free(q);                                                             \
+        return NULL;                                                            \
+    }                                                                           \
+    q->cap = cap;                                                               \
+    q->head = 0;                                                                \
+    q->size = 0;                                                                \
+    return q;                                                                   \
+}                                                                               \
+                                                                                \
+static inline ds_error_t name##_free(name *q) {                                 \
+    if (q == NULL) {                                                            \
+        return DS_ERR_NULLARG;                                                  \
+    }                                                                           \
+    ds_free(q->buf);                                                            \
+    ds_free(q);                                                                 \
+    return DS_OK;                                                               \
+}                                                                               \
+                                                                                \
+static inline ds_error_t name##_enqueue(name *q, T value) {                     \
+    T *grown;                                                                   \
+    size_t first;                                                               \
+    if (q == NULL) {                                                            \
+        return DS_ERR_NULLARG;                                                  \
+    }                                                                           \
+    if (q->size == q->cap) {                                                    \
+        if (q->cap > (size_t)-1 / 2 / sizeof(T)) {                              \
+            return DS_ERR_OOM;                                                  \
+        }                                                                       \
+        grown = (T *)ds_alloc(2 * q->cap * sizeof(T));                          \
+        if (grown == NULL) {                                                    \
+            return DS_ERR_OOM;                                                  \
+        }                                                                       \
+        /* Unwrap the full ring into the front of the new buffer */            \
+        first = q->cap - q->head;                                               \
+        memcpy(grown, q->buf + q->head, first * sizeof(T));                     \
+        memcpy(grown + first, q->buf, q->head * sizeof(T));                     \
+        ds_free(q->buf);                                                        \
+        q->buf = grown;                                                         \
+        q->cap *= 2;                                                            \
+        q->head = 0;                                                            \
+    }                                                                           \
+    q->buf[(q->head + q->size) & (q->cap - 1)] = value;                         \
+    q->size++;                                                                  \
+    return DS_OK;                                                               \
+}                                                                               \
+                                                                                \
+static inline ds_error_t name##_dequeue(name *q, T *out) {                      \
+    if (q == NULL || out == NULL) {                                             \
+        return DS_ERR_NULLARG;                                                  \
+    }                                                                           \
+    if (q->size == 0) {                                                         \
+        return DS_ERR_EMPTY;                                                    \
+    }                                                                           \
+    *out = q->buf[q->head];                                                     \
+    q->head = (q->head + 1) & (q->cap - 1);                                     \
+    q->size--;                                                                  \
+    return DS_OK;                                                               \
+}                                                                               \
+                                                                                \
+static inline ds_error_t name##_peek(const name *q, T *out) {                   \
+    if (q == NULL || out == NULL) {                                             \
+        return DS_ERR_NULLARG;                                                  \
+    }                                                                           \
+    if (q->size == 0) {                                                         \
+        return DS_ERR_EMPTY;                                                    \
+    }                                                                           \
+    *out = q->buf[q->head];                                                     \
+    return DS_OK;                                                               \
+}                                                                               \
+                                                                                \
+static inline size_t name##_size(const name *q) {                               \
+    return (q != NULL) ? q->size : 0;                                           \
+}                                                                               \
+                                                                                \
+static inline int name##_is_empty(const name *q) {                              \
+    return (q == NULL || q->size == 0);                                         \
+}
+
+/**
+ * @brief Define a LIFO stack of T values backed by a growable array
+ * 
+ * Generates the type `name` and the functions name_create, name_free,
+ * name_push, name_pop, name_peek, name_size and name_is_empty.
+ * 
+ * @param name Prefix for the generated type and functions
+ * @param T Element type (copied by value)
+ */
+#define DS_DEFINE_STACK(name, T)                                                \
+typedef struct name {                                                           \
+    T *items;                                                                   \
+    size_t cap;                                                                 \
+    size_t size;                                                                \
+} name;                                                                         \
+                                                                                \
+static inline name *name##_create(size_t capacity_hint) {                       \
+    name *s = (name *)ds_alloc(sizeof(name));                                   \
+    size_t cap = (capacity_hint > DS_TYPED_MIN_CAPACITY) ? capacity_hint        \
+                                                         : DS_TYPED_MIN_CAPACITY; \
+    if (s == NULL) {                                                            \
+        return NULL;                                                            \
+    }                                                                           \
+    s->items = (cap <= (size_t)-1 / sizeof(T)) ? (T *)ds_alloc(cap * sizeof(T)) : NULL; \
+    if (s->items == NULL) {                                                     \
+        ds_free(s);                                                             \
+        return NULL;                                                            \
+    }                                                                           \
+    s->cap = cap;                                                               \
+    s->size = 0;                                                                \
+    return s;                                                                   \
+}                                                                               \
+                                                                                \
+static inline ds_error_t name##_free(name *s) {                                 \
+    if (s == NULL) {                                                            \
+        return DS_ERR_NULLARG;                                                  \
+    }                                                                           \
+    ds_free(s->items);                                                          \
+    ds_free(s);                                                                 \
+    return DS_OK;                                                               \
+}                                                                               \
+                                                                                \
+static inline ds_error_t name##_push(name *s, T value) {                        \
+    T *grown;                                                                   \
+    if (s == NULL) {                                                            \
+        return DS_ERR_NULLARG;                                                  \
+    }                                                                           \
+    if (s->size == s->cap) {                                                    \
+        if (s->cap > (size_t)-1 / 2 / sizeof(T)) {                              \
+            return DS_ERR_OOM;                                                  \
+        }                                                                       \
+        grown = (T *)ds_alloc(2 * s->cap * sizeof(T));                          \
+        if (grown == NULL) {                                                    \
+            return DS_ERR_OOM;                                                  \
+        }                                                                       \
+        memcpy(grown, s->items, s->size * sizeof(T));                           \
+        ds_free(s->items);                                                      \
+        s->items = grown;                                                       \
+        s->cap *= 2;                                                            \
+    }                                                                           \
+    s->items[s->size++] = value;                                                \
+    return DS_OK;                                                               \
+}                                                                               \
+                                                                                \
+static inline ds_error_t name##_pop(name *s, T *out) {                          \
+    if (s == NULL || out == NULL) {                                             \
+        return DS_ERR_NULLARG;                                                  \
+    }                                                                           \
+    if (s->size == 0) {                                                         \
+        return DS_ERR_EMPTY;                                                    \
+    }                                                                           \
+    *out = s->items[--s->size];                                                 \
+    return DS_OK;                                                               \
+}                                                                               \
+                                                                                \
+static inline ds_error_t name##_peek(const name *s, T *out) {                   \
+    if (s == NULL || out == NULL) {                                             \
+        return DS_ERR_NULLARG;                                                  \
+    }                                                                           \
+    if (s->size == 0) {                                                         \
+        return DS_ERR_EMPTY;                                                    \
+    }                                                                           \
+    *out = s->items[s->size - 1];                                               \
+    return DS_OK;                                                               \
+}                                                                               \
+                                                                                \
+static inline size_t name##_size(const name *s) {                               \
+    return (s != NULL) ? s->size : 0;                                           \
+}                                                                               \
+                                                                                \
+static inline int name##_is_empty(const name *s) {                              \
+    return (s == NULL || s->size == 0);                                         \
+}
+
+#endif /* DS_TYPED_H */
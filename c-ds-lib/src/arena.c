@@ -0,0 +1,206 @@
+/**
+ * @file arena.c
+ * @brief Arena (region) allocator implementation
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * This file implements an arena that bump-allocates objects of any size
+ * from a chain of large blocks. Objects are never released one by one;
+ * ds_arena_reset() rewinds the arena to its first block in O(1) and
+ * keeps the blocks for reuse, and ds_arena_free() returns them all.
+ */
+
+#include "ds_internal.h"
+
+/**
+ * @brief Usable bytes per block when ds_arena_create() is given 0
+ */
+#define DS_ARENA_DEFAULT_BLOCK 65536
+
+/**
+ * @brief Alignment helper covering every fundamental type
+ */
+union ds_arena_align {
+    long double ld;                /**< Widest floating point type */
+    long long ll;                  /**< Widest integer type */
+    void *p;                       /**< Object pointer */
+    void (*fn)(void);              /**< Function pointer */
+};
+
+#define DS_ARENA_ALIGN sizeof(union ds_arena_align)
+#define DS_ARENA_ROUND(n) (((n) + DS_ARENA_ALIGN - 1) / DS_ARENA_ALIGN * DS_ARENA_ALIGN)
+
+/**
+ * @brief Header placed at the start of every block
+ */
+struct ds_arena_block {
+    struct ds_arena_block *next;   /**< Pointer to next block in the chain */
+    size_t size;                   /**< Usable bytes after the header */
+};
+
+/**
+ * @brief Internal arena structure
+ * 
+ * Blocks stay chained in the order they are first used. After a reset
+ * allocation starts over at the head of the chain and moves to the next
+ * block whenever the current one is exhausted.
+ */
+struct ds_arena {
+    struct ds_arena_block *blocks;   /**< First block of the chain */
+    struct ds_arena_block *current;  /**< Block being carved, NULL before the first allocation */
+    char *bump;                      /**< Next unused byte in the current block */
+    char *bump_end;                  /**< End of the current block */
+    size_t block_size;               /**< Usable bytes of a regular block */
+    size_t used;                     /**< Bytes handed out since the last reset */
+};
+
+/**
+ * @brief Allocation callback for arena allocators
+ * 
+ * @param ctx Pointer to the arena
+ * @param n Number of bytes requested
+ * @return Pointer to suitably aligned memory, or NULL on memory failure
+ */
+static void *arena_alloc(void *ctx, size_t n) {
+    ds_arena_t *A = (ds_arena_t *)ctx;
+    struct ds_arena_block *next;
+    void *obj;
+    
+    n = (n > 0) ? DS_ARENA_ROUND(n) : DS_ARENA_ALIGN;
+    
+    if ((size_t)(A->bump_end - A->bump) < n) {
+        // Reuse the next block of the chain if it is large enough
+        next = (A->current != NULL) ? A->current->next : A->blocks;
+        if (next == NULL || next->size < n) {
+            size_t size = (n > A->block_size) ? n : A->block_size;
+            
+            next = (struct ds_arena_block *)ds_alloc(DS_ARENA_ROUND(sizeof(struct ds_arena_block)) + size);
+            if (next == NULL) {
+                return NULL;
+            }
+            next->size = size;
+            
+            // Link the new block in right after the current one
+            if (A->current != NULL) {
+                next->next = A->current->next;
+                A->current->next = next;
+            } else {
+                next->next = A->blocks;
+                A->blocks = next;
+            }
+        }
+        
+        A->current = next;
+        A->bump = (char *)next + DS_ARENA_ROUND(sizeof(struct ds_arena_block));
+        A->bump_end = A->bump + next->size;
+    }
+    
+    obj = A->bump;
+    A->bump += n;
+    A->used += n;
+    return obj;
+}
+
+/**
+ * @brief Create a new arena
+ * 
+ * @param block_size Usable bytes per block (0 selects a default)
+ * @return Pointer to new arena on success, NULL on memory failure
+ */
+ds_arena_t *ds_arena_create(size_t block_size) {
+    ds_arena_t *arena;
+    
+    // Allocate memory for arena structure
+    arena = (ds_arena_t *)ds_alloc(sizeof(struct ds_arena));
+    if (arena == NULL) {
+        return NULL;
+    }
+    
+    // Blocks are allocated on first use
+    arena->blocks = NULL;
+    arena->current = NULL;
+    arena->bump = NULL;
+    arena->bump_end = NULL;
+    arena->block_size = DS_ARENA_ROUND((block_size != 0) ? block_size : DS_ARENA_DEFAULT_BLOCK);
+    arena->used = 0;
+    
+    return arena;
+}
+
+/**
+ * @brief Release everything allocated from an arena at once
+ * 
+ * Only rewinds the allocation position; the blocks are kept and filled
+ * again by later allocations.
+ * 
+ * @param A Pointer to arena
+ * @return DS_OK on success, DS_ERR_NULLARG if A is NULL
+ */
+ds_error_t ds_arena_reset(ds_arena_t *A) {
+    // Validate input parameter
+    if (A == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    A->current = NULL;
+    A->bump = NULL;
+    A->bump_end = NULL;
+    A->used = 0;
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Free an arena and every object it handed out
+ * 
+ * @param A Pointer to arena to free
+ * @return DS_OK on success, DS_ERR_NULLARG if A is NULL
+ */
+ds_error_t ds_arena_free(ds_arena_t *A) {
+    struct ds_arena_block *current, *next;
+    
+    // Validate input parameter
+    if (A == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    // Release every block in one pass
+    current = A->blocks;
+    while (current != NULL) {
+        next = current->next;
+        ds_free(current);
+        current = next;
+    }
+    
+    // Free the arena structure
+    ds_free(A);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Get the number of bytes handed out since the last reset
+ * 
+ * @param A Pointer to arena
+ * @return Bytes in use, including alignment padding, or 0 if A is NULL
+ */
+size_t ds_arena_used(const ds_arena_t *A) {
+    return (A != NULL) ? A->used : 0;
+}
+
+/**
+ * @brief Get an allocator that draws from an arena
+ * 
+ * @param A Pointer to arena
+ * @return Allocator bound to A, with a NULL free callback (alloc is also NULL if A is NULL)
+ */
+ds_allocator_t ds_arena_allocator(ds_arena_t *A) {
+    ds_allocator_t a;
+    
+    a.alloc = (A != NULL) ? arena_alloc : NULL;
+    a.free = NULL;
+    a.ctx = A;
+    
+    return a;
+}
@@ -0,0 +1,784 @@
+/**
+ * @file btree.c
+ * @brief B-tree ordered container implementation
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * This file implements a B-tree of minimum degree DS_BTREE_MIN_DEGREE.
+ * Nodes keep their keys in a contiguous array and are split or merged
+ * on the way down, so insert and remove each make a single root-to-leaf pass.
+ */
+
+#include "ds_btree.h"
+#include "ds_internal.h"
+#include <stdio.h>   /* for printf */
+#include <stddef.h>  /* for offsetof */
+#include <string.h>  /* for memmove */
+
+/**
+ * @brief Minimum degree of the B-tree
+ * 
+ * Every node except the root holds between t - 1 and 2t - 1 keys. The
+ * default of 16 gives 31 keys per node, i.e. the key array of a node
+ * spans four 64-byte cache lines. Override at build time to tune.
+ */
+#ifndef DS_BTREE_MIN_DEGREE
+#define DS_BTREE_MIN_DEGREE 16
+#endif
+
+#define DS_BTREE_MAX_KEYS (2 * DS_BTREE_MIN_DEGREE - 1)
+
+/**
+ * @brief Internal node structure for B-tree
+ * 
+ * Keys are kept sorted in keys[0..nkeys). Internal nodes have nkeys + 1
+ * children; leaves are allocated without the children array.
+ */
+struct ds_btree_node {
+    int nkeys;                                          /**< Number of keys in node */
+    int leaf;                                           /**< Non-zero for leaf nodes */
+    void *keys[DS_BTREE_MAX_KEYS];                      /**< Sorted data pointers */
+    struct ds_btree_node *children[DS_BTREE_MAX_KEYS + 1]; /**< Child pointers (internal only) */
+};
+
+/**
+ * @brief Bytes allocated for a leaf node
+ */
+#define DS_BTREE_LEAF_SIZE offsetof(struct ds_btree_node, children)
+
+/**
+ * @brief Internal B-tree structure
+ * 
+ * Contains root pointer and cached size for efficient operations.
+ */
+struct ds_btree {
+    struct ds_btree_node *root;    /**< Pointer to root node, NULL if empty */
+    size_t size;                   /**< Number of elements in B-tree */
+    ds_allocator_t alloc;          /**< Allocator used for nodes */
+    ds_stats_t stats;              /**< Runtime counters */
+};
+
+/**
+ * @brief Allocate and initialize an empty node
+ * 
+ * @param B Pointer to B-tree
+ * @param leaf Non-zero to allocate a leaf node
+ * @return Pointer to new node, or NULL on memory failure
+ */
+static struct ds_btree_node *node_create(ds_btree_t *B, int leaf) {
+    struct ds_btree_node *node;
+    
+    node = (struct ds_btree_node *)ds_node_alloc(&B->alloc, &B->stats,
+                                                 leaf ? DS_BTREE_LEAF_SIZE : sizeof(struct ds_btree_node));
+    if (node == NULL) {
+        return NULL;
+    }
+    
+    node->nkeys = 0;
+    node->leaf = leaf;
+    return node;
+}
+
+/**
+ * @brief Release a node allocated by node_create
+ * 
+ * @param B Pointer to B-tree
+ * @param node Pointer to node
+ */
+static void node_destroy(ds_btree_t *B, struct ds_btree_node *node) {
+    ds_node_free(&B->alloc, &B->stats, node,
+                 node->leaf ? DS_BTREE_LEAF_SIZE : sizeof(struct ds_btree_node));
+}
+
+/**
+ * @brief Find the first key position not less than target
+ * 
+ * Binary search over the node's key array.
+ * 
+ * @param node Pointer to node
+ * @param target Pointer to key to look for
+ * @param cmp Comparison function
+ * @param found Set to non-zero if keys[result] equals target
+ * @param compares Incremented by the number of comparator calls (may be NULL)
+ * @return Index of first key >= target (nkeys if none)
+ */
+static int node_search(const struct ds_btree_node *node, const void *target,
+                       int (*cmp)(const void *, const void *), int *found, size_t *compares) {
+    int lo = 0, hi = node->nkeys;
+    size_t calls = 0;
+    
+    *found = 0;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        int comparison = cmp(target, node->keys[mid]);
+        
+        calls++;
+        if (comparison == 0) {
+            *found = 1;
+            lo = mid;
+            break;
+        }
+        if (comparison < 0) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    
+    if (compares != NULL) {
+        *compares += calls;
+    }
+    return lo;
+}
+
+/**
+ * @brief Free a subtree of nodes
+ * 
+ * Recursion depth is bounded by the B-tree height, which is tiny.
+ * 
+ * @param B Pointer to B-tree
+ * @param node Pointer to subtree root
+ * @param free_data Function to free element data (may be NULL)
+ */
+static void free_subtree(ds_btree_t *B, struct ds_btree_node *node, void (*free_data)(void *)) {
+    if (!node->leaf) {
+        for (int i = 0; i <= node->nkeys; i++) {
+            free_subtree(B, node->children[i], free_data);
+        }
+    }
+    
+    if (free_data != NULL) {
+        for (int i = 0; i < node->nkeys; i++) {
+            free_data(node->keys[i]);
+        }
+    }
+    
+    node_destroy(B, node);
+}
+
+/**
+ * @brief Split the full child at index i of parent
+ * 
+ * The upper t - 1 keys move to a new sibling and the median key moves up
+ * into parent, which must not be full.
+ * 
+ * @param B Pointer to B-tree
+ * @param parent Non-full internal node
+ * @param i Index of the full child
+ * @return DS_OK on success, DS_ERR_OOM on memory failure
+ */
+static ds_error_t split_child(ds_btree_t *B, struct ds_btree_node *parent, int i) {
+    struct ds_btree_node *full = parent->children[i];
+    struct ds_btree_node *sibling;
+    const int t = DS_BTREE_MIN_DEGREE;
+    
+    sibling = node_create(B, full->leaf);
+    if (sibling == NULL) {
+        return DS_ERR_OOM;
+    }
+    
+    // Move the upper half of the keys (and children) to the sibling
+    sibling->nkeys = t - 1;
+    memcpy(sibling->keys, full->keys + t, (size_t)(t - 1) * sizeof(void *));
+    if (!full->leaf) {
+        memcpy(sibling->children, full->children + t, (size_t)t * sizeof(struct ds_btree_node *));
+    }
+    full->nkeys = t - 1;
+    
+    // Make room in the parent and lift the median key
+    memmove(parent->children + i + 2, parent->children + i + 1,
+            (size_t)(parent->nkeys - i) * sizeof(struct ds_btree_node *));
+    memmove(parent->keys + i + 1, parent->keys + i, (size_t)(parent->nkeys - i) * sizeof(void *));
+    parent->children[i + 1] = sibling;
+    parent->keys[i] = full->keys[t - 1];
+    parent->nkeys++;
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Merge child i + 1 and separator key i into child i
+ * 
+ * Both children must hold t - 1 keys.
+ * 
+ * @param B Pointer to B-tree
+ * @param parent Internal node owning both children
+ * @param i Index of the left child
+ */
+static void merge_children(ds_btree_t *B, struct ds_btree_node *parent, int i) {
+    struct ds_btree_node *left = parent->children[i];
+    struct ds_btree_node *right = parent->children[i + 1];
+    
+    // Pull the separator down and append the right node's contents
+    left->keys[left->nkeys] = parent->keys[i];
+    memcpy(left->keys + left->nkeys + 1, right->keys, (size_t)right->nkeys * sizeof(void *));
+    if (!left->leaf) {
+        memcpy(left->children + left->nkeys + 1, right->children,
+               (size_t)(right->nkeys + 1) * sizeof(struct ds_btree_node *));
+    }
+    left->nkeys += right->nkeys + 1;
+    
+    // Close the gap in the parent
+    memmove(parent->keys + i, parent->keys + i + 1, (size_t)(parent->nkeys - i - 1) * sizeof(void *));
+    memmove(parent->children + i + 1, parent->children + i + 2,
+            (size_t)(parent->nkeys - i - 1) * sizeof(struct ds_btree_node *));
+    parent->nkeys--;
+    
+    node_destroy(B, right);
+}
+
+/**
+ * @brief Make sure child i of parent holds at least t keys
+ * 
+ * Borrows a key from a sibling with spare keys, or merges with a sibling
+ * otherwise.
+ * 
+ * @param B Pointer to B-tree
+ * @param parent Internal node
+ * @param i Index of child about to be descended into
+ * @return Index of the child to descend into afterwards
+ */
+static int fill_child(ds_btree_t *B, struct ds_btree_node *parent, int i) {
+    struct ds_btree_node *child = parent->children[i];
+    const int t = DS_BTREE_MIN_DEGREE;
+    
+    if (child->nkeys >= t) {
+        return i;
+    }
+    
+    if (i > 0 && parent->children[i - 1]->nkeys >= t) {
+        // Rotate the last key of the left sibling through the parent
+        struct ds_btree_node *left = parent->children[i - 1];
+        
+        memmove(child->keys + 1, child->keys, (size_t)child->nkeys * sizeof(void *));
+        child->keys[0] = parent->keys[i - 1];
+        if (!child->leaf) {
+            memmove(child->children + 1, child->children,
+                    (size_t)(child->nkeys + 1) * sizeof(struct ds_btree_node *));
+            child->children[0] = left->children[left->nkeys];
+        }
+        parent->keys[i - 1] = left->keys[left->nkeys - 1];
+        left->nkeys--;
+        child->nkeys++;
+        return i;
+    }
+    
+    if (i < parent->nkeys && parent->children[i + 1]->nkeys >= t) {
+        // Rotate the first key of the right sibling through the parent
+        struct ds_btree_node *right = parent->children[i + 1];
+        
+        child->keys[child->nkeys] = parent->keys[i];
+        if (!child->leaf) {
+            child->children[child->nkeys + 1] = right->children[0];
+            memmove(right->children, right->children + 1,
+                    (size_t)right->nkeys * sizeof(struct ds_btree_node *));
+        }
+        parent->keys[i] = right->keys[0];
+        memmove(right->keys, right->keys + 1, (size_t)(right->nkeys - 1) * sizeof(void *));
+        right->nkeys--;
+        child->nkeys++;
+        return i;
+    }
+    
+    // No sibling can spare a key: merge with one of them
+    if (i < parent->nkeys) {
+        merge_children(B, parent, i);
+        return i;
+    }
+    merge_children(B, parent, i - 1);
+    return i - 1;
+}
+
+/**
+ * @brief Remove target from the subtree rooted at node
+ * 
+ * node is guaranteed to hold at least t keys unless it is the root.
+ * 
+ * @param B Pointer to B-tree
+ * @param node Subtree root
+ * @param target Pointer to key to remove
+ * @param cmp Comparison function
+ * @param compares Incremented by the number of comparator calls
+ * @return DS_OK on success, DS_ERR_NOTFOUND if target is not present
+ */
+static ds_error_t remove_from(ds_btree_t *B, struct ds_btree_node *node, const void *target,
+                              int (*cmp)(const void *, const void *), size_t *compares) {
+    const int t = DS_BTREE_MIN_DEGREE;
+    
+    while (1) {
+        int found;
+        int i = node_search(node, target, cmp, &found, compares);
+        
+        if (node->leaf) {
+            if (!found) {
+                return DS_ERR_NOTFOUND;
+            }
+            memmove(node->keys + i, node->keys + i + 1, (size_t)(node->nkeys - i - 1) * sizeof(void *));
+            node->nkeys--;
+            return DS_OK;
+        }
+        
+        if (found) {
+            struct ds_btree_node *left = node->children[i];
+            struct ds_btree_node *right = node->children[i + 1];
+            
+            if (left->nkeys >= t) {
+                // Replace with the predecessor and delete it from the left subtree
+                struct ds_btree_node *pred = left;
+                while (!pred->leaf) {
+                    pred = pred->children[pred->nkeys];
+                }
+                node->keys[i] = pred->keys[pred->nkeys - 1];
+                target = node->keys[i];
+                node = left;
+            } else if (right->nkeys >= t) {
+                // Replace with the successor and delete it from the right subtree
+                struct ds_btree_node *succ = right;
+                while (!succ->leaf) {
+                    succ = succ->children[0];
+                }
+                node->keys[i] = succ->keys[0];
+                target = node->keys[i];
+                node = right;
+            } else {
+                // Both neighbours are minimal: merge and continue in the merged node
+                merge_children(B, node, i);
+                node = left;
+            }
+            continue;
+        }
+        
+        // Key lives below: make sure the child can lose a key, then descend
+        i = fill_child(B, node, i);
+        node = node->children[i];
+    }
+}
+
+/**
+ * @brief Visit the part of a subtree inside [lo, hi]
+ * 
+ * @return Non-zero if the callback asked to stop
+ */
+static int range_subtree(const struct ds_btree_node *node, const void *lo, const void *hi,
+                         int (*cmp)(const void *, const void *),
+                         int (*cb)(void *data, void *ctx), void *ctx) {
+    int i = 0, found;
+    
+    // Skip keys below the lower bound
+    if (lo != NULL) {
+        i = node_search(node, lo, cmp, &found, NULL);
+    }
+    
+    for (; i <= node->nkeys; i++) {
+        if (!node->leaf && range_subtree(node->children[i], lo, hi, cmp, cb, ctx)) {
+            return 1;
+        }
+        if (i == node->nkeys) {
+            break;
+        }
+        if (hi != NULL && cmp(node->keys[i], hi) > 0) {
+            return 1;
+        }
+        if (cb(node->keys[i], ctx)) {
+            return 1;
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief Get the runtime counters of a B-tree
+ * 
+ * @param B Pointer to B-tree
+ * @param out Receives the counters
+ * @return DS_OK on success, DS_ERR_NULLARG if B or out is NULL
+ */
+ds_error_t ds_btree_stats(const ds_btree_t *B, ds_stats_t *out) {
+    if (B == NULL || out == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    *out = B->stats;
+    return DS_OK;
+}
+
+/**
+ * @brief Print a subtree, one node per line
+ * 
+ * @param node Pointer to subtree root
+ * @param out Output stream
+ * @param depth Current depth in tree
+ */
+static void print_subtree(const struct ds_btree_node *node, FILE *out, int depth) {
+    for (int i = 0; i < depth; i++) {
+        fprintf(out, "  ");
+    }
+    
+    fprintf(out, "[");
+    for (int i = 0; i < node->nkeys; i++) {
+        fprintf(out, (i == 0) ? "%d" : " %d", *(int*)node->keys[i]);
+    }
+    fprintf(out, "]\n");
+    
+    if (!node->leaf) {
+        for (int i = 0; i <= node->nkeys; i++) {
+            print_subtree(node->children[i], out, depth + 1);
+        }
+    }
+}
+
+/**
+ * @brief Create a new empty B-tree
+ * 
+ * @return Pointer to new B-tree on success, NULL on memory allocation failure
+ */
+ds_btree_t *ds_btree_create(void) {
+    ds_btree_t *btree;
+    
+    // Allocate memory for B-tree structure
+    btree = (ds_btree_t *)ds_alloc(sizeof(struct ds_btree));
+    if (btree == NULL) {
+        return NULL;
+    }
+    
+    // Initialize B-tree to empty state
+    ds_allocator_init(&btree->alloc, NULL);
+    btree->root = NULL;
+    btree->size = 0;
+    ds_stats_init(&btree->stats);
+    
+    return btree;
+}
+
+/**
+ * @brief Free a B-tree and optionally its data
+ * 
+ * @param B Pointer to B-tree to free
+ * @param free_data Optional function to free element data (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if B is NULL
+ */
+ds_error_t ds_btree_free(ds_btree_t *B, void (*free_data)(void *)) {
+    // Validate input parameter
+    if (B == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    if (B->root != NULL) {
+        free_subtree(B, B->root, free_data);
+    }
+    
+    // Free the B-tree structure
+    ds_stats_release(&B->stats);
+    ds_free(B);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Untraced implementation of ds_btree_insert
+ */
+static ds_error_t btree_insert(ds_btree_t *B, void *data, int (*cmp)(const void *, const void *)) {
+    struct ds_btree_node *node;
+    size_t compares = 0;
+    
+    // Validate input parameters
+    if (B == NULL || data == NULL || cmp == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    // Empty tree: the first key goes into a fresh leaf root
+    if (B->root == NULL) {
+        B->root = node_create(B, 1);
+        if (B->root == NULL) {
+            return DS_ERR_OOM;
+        }
+    }
+    
+    // Grow the tree at the top when the root is full
+    if (B->root->nkeys == DS_BTREE_MAX_KEYS) {
+        struct ds_btree_node *new_root = node_create(B, 0);
+        if (new_root == NULL) {
+            return DS_ERR_OOM;
+        }
+        new_root->children[0] = B->root;
+        if (split_child(B, new_root, 0) != DS_OK) {
+            node_destroy(B, new_root);
+            return DS_ERR_OOM;
+        }
+        B->root = new_root;
+    }
+    
+    // Descend, splitting full children before entering them
+    node = B->root;
+    while (1) {
+        int found;
+        int i = node_search(node, data, cmp, &found, &compares);
+        
+        if (found) {
+            ds_stats_count_compares(&B->stats, compares);
+            return DS_OK;  // Consider this success (no duplicates)
+        }
+        
+        if (node->leaf) {
+            memmove(node->keys + i + 1, node->keys + i, (size_t)(node->nkeys - i) * sizeof(void *));
+            node->keys[i] = data;
+            node->nkeys++;
+            B->size++;
+            ds_stats_resize(&B->stats, B->size);
+            ds_stats_count_compares(&B->stats, compares);
+            return DS_OK;
+        }
+        
+        if (node->children[i]->nkeys == DS_BTREE_MAX_KEYS) {
+            int comparison;
+            
+            if (split_child(B, node, i) != DS_OK) {
+                ds_stats_count_compares(&B->stats, compares);
+                return DS_ERR_OOM;
+            }
+            
+            // The lifted median decides which half to continue in
+            comparison = cmp(data, node->keys[i]);
+            compares++;
+            if (comparison == 0) {
+                ds_stats_count_compares(&B->stats, compares);
+                return DS_OK;
+            }
+            if (comparison > 0) {
+                i++;
+            }
+        }
+        node = node->children[i];
+    }
+}
+
+/**
+ * @brief Insert element into the B-tree
+ * 
+ * Full nodes are split on the way down so the leaf that receives the new
+ * key always has room for it.
+ * 
+ * @param B Pointer to B-tree
+ * @param data Pointer to data to insert
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return DS_OK on success, DS_ERR_NULLARG if B, data, or cmp is NULL, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_btree_insert(ds_btree_t *B, void *data, int (*cmp)(const void *, const void *)) {
+    ds_error_t result;
+    
+    DS_TRACE_BEGIN();
+    result = btree_insert(B, data, cmp);
+    DS_TRACE_END(DS_TRACE_BTREE_INSERT, B);
+    
+    return result;
+}
+
+/**
+ * @brief Untraced implementation of ds_btree_find
+ */
+static void *btree_find(ds_btree_t *B, void *target, int (*cmp)(const void *, const void *)) {
+    const struct ds_btree_node *node;
+    size_t depth = 0, compares = 0;
+    
+    // Validate input parameters
+    if (B == NULL || target == NULL || cmp == NULL) {
+        return NULL;
+    }
+    
+    node = B->root;
+    while (node != NULL) {
+        int found;
+        int i = node_search(node, target, cmp, &found, &compares);
+        
+        depth++;
+        if (found) {
+            ds_stats_count_find(&B->stats, 1, depth, compares);
+            return node->keys[i];
+        }
+        node = node->leaf ? NULL : node->children[i];
+    }
+    
+    ds_stats_count_find(&B->stats, 1, depth, compares);
+    return NULL;
+}
+
+/**
+ * @brief Find element in the B-tree
+ * 
+ * @param B Pointer to B-tree
+ * @param target Pointer to data to find
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return Pointer to matching data, or NULL if not found or B/cmp/target is NULL
+ */
+void *ds_btree_find(ds_btree_t *B, void *target, int (*cmp)(const void *, const void *)) {
+    void *result;
+    
+    DS_TRACE_BEGIN();
+    result = btree_find(B, target, cmp);
+    DS_TRACE_END(DS_TRACE_BTREE_FIND, B);
+    
+    return result;
+}
+
+/**
+ * @brief Untraced implementation of ds_btree_remove
+ */
+static ds_error_t btree_remove(ds_btree_t *B, void *target, int (*cmp)(const void *, const void *)) {
+    size_t compares = 0;
+    ds_error_t result;
+    
+    // Validate input parameters
+    if (B == NULL || target == NULL || cmp == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    if (B->root == NULL) {
+        return DS_ERR_NOTFOUND;
+    }
+    
+    result = remove_from(B, B->root, target, cmp, &compares);
+    ds_stats_count_compares(&B->stats, compares);
+    
+    // Shrink the tree when the root runs out of keys
+    if (B->root->nkeys == 0) {
+        struct ds_btree_node *old_root = B->root;
+        B->root = old_root->leaf ? NULL : old_root->children[0];
+        node_destroy(B, old_root);
+    }
+    
+    if (result == DS_OK) {
+        B->size--;
+        ds_stats_resize(&B->stats, B->size);
+    }
+    return result;
+}
+
+/**
+ * @brief Remove element from the B-tree
+ * 
+ * Nodes on the search path are topped up before they are entered, so
+ * the removal never has to walk back up.
+ * 
+ * @param B Pointer to B-tree
+ * @param target Pointer to data to remove
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return DS_OK on success, DS_ERR_NULLARG if B, target, or cmp is NULL, DS_ERR_NOTFOUND if not found
+ */
+ds_error_t ds_btree_remove(ds_btree_t *B, void *target, int (*cmp)(const void *, const void *)) {
+    ds_error_t result;
+    
+    DS_TRACE_BEGIN();
+    result = btree_remove(B, target, cmp);
+    DS_TRACE_END(DS_TRACE_BTREE_REMOVE, B);
+    
+    return result;
+}
+
+/**
+ * @brief Visit all elements in the closed range [lo, hi] in order
+ * 
+ * @param B Pointer to B-tree
+ * @param lo Lower bound (NULL for no lower bound)
+ * @param hi Upper bound (NULL for no upper bound)
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @param cb Callback invoked with each element and ctx
+ * @param ctx User context passed to cb
+ * @return DS_OK on success, DS_ERR_NULLARG if B, cmp, or cb is NULL
+ */
+ds_error_t ds_btree_range(ds_btree_t *B, const void *lo, const void *hi,
+                          int (*cmp)(const void *, const void *),
+                          int (*cb)(void *data, void *ctx), void *ctx) {
+    // Validate input parameters
+    if (B == NULL || cmp == NULL || cb == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    if (B->root != NULL) {
+        range_subtree(B->root, lo, hi, cmp, cb, ctx);
+    }
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Get the number of elements in the B-tree
+ * 
+ * @param B Pointer to B-tree
+ * @return Number of elements in B-tree, or 0 if B is NULL
+ */
+size_t ds_btree_size(const ds_btree_t *B) {
+    if (B == NULL) {
+        return 0;
+    }
+    
+    return B->size;
+}
+
+/**
+ * @brief Check if B-tree is empty
+ * 
+ * @param B Pointer to B-tree
+ * @return 1 if empty, 0 if not empty, 1 if B is NULL
+ */
+int ds_btree_is_empty(const ds_btree_t *B) {
+    if (B == NULL) {
+        return 1;  // Consider NULL as empty
+    }
+    
+    return (B->size == 0) ? 1 : 0;
+}
+
+/**
+ * @brief Get the height of the B-tree
+ * 
+ * All leaves sit at the same depth, so following the first child suffices.
+ * 
+ * @param B Pointer to B-tree
+ * @return Number of node levels, or 0 if B is NULL or empty
+ */
+size_t ds_btree_height(const ds_btree_t *B) {
+    const struct ds_btree_node *node;
+    size_t height = 0;
+    
+    if (B == NULL) {
+        return 0;
+    }
+    
+    for (node = B->root; node != NULL; node = node->leaf ? NULL : node->children[0]) {
+        height++;
+    }
+    
+    return height;
+}
+
+/**
+ * @brief Visualize the B-tree structure
+ * 
+ * @param B Pointer to B-tree
+ * @param out Output stream (e.g., stdout, stderr)
+ */
+void ds_btree_visualize(const ds_btree_t *B, FILE *out) {
+    // Handle NULL parameters gracefully
+    if (out == NULL) {
+        out = stdout;  // Default to stdout
+    }
+    
+    if (B == NULL) {
+        fprintf(out, "BTree: NULL\n");
+        return;
+    }
+    
+    if (B->root == NULL) {
+        fprintf(out, "BTree: [empty] (size: %zu)\n", B->size);
+        return;
+    }
+    
+    // Print B-tree header
+    fprintf(out, "BTree: (size: %zu, height: %zu)\n", B->size, ds_btree_height(B));
+    print_subtree(B->root, out, 0);
+    
+    fprintf(out, "\n");
+}
+
@@ -0,0 +1,392 @@
+/**
+ * @file cstack.c
+ * @brief Lock-free concurrent stack implementation
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * This file implements a Treiber stack with hazard-pointer reclamation.
+ * A popping thread publishes the node it is about to dereference in its
+ * hazard record and re-checks the top pointer, so the node cannot have
+ * been freed in between. Popped nodes are retired to a per-thread list
+ * and only passed to ds_free once no hazard record points at them.
+ * 
+ * Hazard records form a global, append-only list shared by every stack.
+ * A thread claims one record on its first pop and hands it back from a
+ * pthread key destructor when it exits; the next thread to claim the
+ * record inherits its pending retired nodes.
+ * 
+ * Built only with `make CONCURRENT=1`.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ds_cstack.h"
+#include "ds_internal.h"
+#include <stdatomic.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+
+/**
+ * @brief Retired nodes a thread keeps before it first scans the hazards
+ * 
+ * The scan threshold also grows with the number of hazard records, so
+ * each scan frees at least half of the retired list.
+ */
+#define DS_HP_SCAN_MIN 64
+
+/**
+ * @brief Internal node structure for the concurrent stack
+ */
+struct ds_cstack_node {
+    void *data;                    /**< Pointer to user data */
+    struct ds_cstack_node *next;   /**< Pointer to node below */
+};
+
+/**
+ * @brief Internal concurrent stack structure
+ * 
+ * The element counter is kept off the cache line of the contended top
+ * pointer.
+ */
+struct ds_cstack {
+    _Atomic(struct ds_cstack_node *) top;  /**< Pointer to top node */
+    char pad[DS_CACHE_LINE - sizeof(void *)];
+    atomic_size_t size;            /**< Number of elements */
+};
+
+/**
+ * @brief Per-thread hazard pointer record
+ * 
+ * Only the owning thread touches the retired list; other threads only
+ * read the hazard slot while scanning.
+ */
+struct ds_hp_record {
+    _Atomic(void *) hazard;        /**< Node the owner is about to dereference */
+    atomic_int active;             /**< Non-zero while owned by a thread */
+    struct ds_hp_record *next;     /**< Next record in the global list */
+    void **retired;                /**< Nodes awaiting reclamation */
+    size_t nretired;               /**< Number of retired nodes */
+    size_t retired_cap;            /**< Capacity of retired array */
+};
+
+static _Atomic(struct ds_hp_record *) hp_records = NULL;
+static atomic_size_t hp_count = 0;
+static _Thread_local struct ds_hp_record *hp_self = NULL;
+static pthread_key_t hp_key;
+static pthread_once_t hp_once = PTHREAD_ONCE_INIT;
+static int hp_key_ok = 0;
+
+/**
+ * @brief Check whether any hazard record protects a node
+ * 
+ * @param p Pointer to node
+ * @return 1 if some thread may still dereference p, 0 otherwise
+ */
+static int hp_is_protected(void *p) {
+    struct ds_hp_record *rec;
+    
+    for (rec = atomic_load(&hp_records); rec != NULL; rec = rec->next) {
+        if (atomic_load(&rec->hazard) == p) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Free every retired node of a record that is no longer protected
+ * 
+ * @param rec Record owned by the calling thread
+ */
+static void hp_scan(struct ds_hp_record *rec) {
+    size_t i, kept = 0;
+    
+    for (i = 0; i < rec->nretired; i++) {
+        if (hp_is_protected(rec->retired[i])) {
+            rec->retired[kept++] = rec->retired[i];
+        } else {
+            ds_free(rec->retired[i]);
+        }
+    }
+    rec->nretired = kept;
+}
+
+/**
+ * @brief Hand a record back when its owning thread exits
+ * 
+ * @param p Record owned by the exiting thread
+ */
+static void hp_release(void *p) {
+    struct ds_hp_record *rec = (struct ds_hp_record *)p;
+    
+    hp_scan(rec);
+    atomic_store(&rec->hazard, NULL);
+    atomic_store_explicit(&rec->active, 0, memory_order_release);
+}
+
+/**
+ * @brief Create the key whose destructor releases hazard records
+ */
+static void hp_key_create(void) {
+    hp_key_ok = (pthread_key_create(&hp_key, hp_release) == 0);
+}
+
+/**
+ * @brief Get the calling thread's hazard record, claiming one if needed
+ * 
+ * Reuses a record abandoned by an exited thread before allocating a
+ * new one and linking it at the head of the global list.
+ * 
+ * @return Pointer to record, or NULL on memory allocation failure
+ */
+static struct ds_hp_record *hp_acquire(void) {
+    struct ds_hp_record *rec;
+    int expected;
+    
+    if (hp_self != NULL) {
+        return hp_self;
+    }
+    
+    pthread_once(&hp_once, hp_key_create);
+    
+    // Try to adopt an inactive record first
+    for (rec = atomic_load(&hp_records); rec != NULL; rec = rec->next) {
+        expected = 0;
+        if (atomic_load_explicit(&rec->active, memory_order_relaxed) == 0 &&
+            atomic_compare_exchange_strong(&rec->active, &expected, 1)) {
+            break;
+        }
+    }
+    
+    if (rec == NULL) {
+        rec = (struct ds_hp_record *)ds_alloc(sizeof(struct ds_hp_record));
+        if (rec == NULL) {
+            return NULL;
+        }
+        
+        atomic_init(&rec->hazard, NULL);
+        atomic_init(&rec->active, 1);
+        rec->retired = NULL;
+        rec->nretired = 0;
+        rec->retired_cap = 0;
+        
+        // Records are never unlinked, so a plain CAS push is safe
+        rec->next = atomic_load(&hp_records);
+        while (!atomic_compare_exchange_weak(&hp_records, &rec->next, rec)) {
+        }
+        atomic_fetch_add(&hp_count, 1);
+    }
+    
+    if (hp_key_ok) {
+        pthread_setspecific(hp_key, rec);
+    }
+    hp_self = rec;
+    return rec;
+}
+
+/**
+ * @brief Defer freeing a popped node until no thread can be reading it
+ * 
+ * @param rec Record owned by the calling thread
+ * @param node Node that has been unlinked from its stack
+ */
+static void hp_retire(struct ds_hp_record *rec, void *node) {
+    size_t threshold = DS_HP_SCAN_MIN + 2 * atomic_load_explicit(&hp_count, memory_order_relaxed);
+    void **grown;
+    size_t new_cap;
+    
+    // Grow the retired list to the scan threshold
+    if (rec->nretired == rec->retired_cap) {
+        new_cap = (rec->retired_cap < threshold) ? threshold : rec->retired_cap * 2;
+        grown = (void **)ds_alloc(new_cap * sizeof(void *));
+        if (grown == NULL) {
+            // Nowhere to park the node: wait until it is unprotected
+            while (hp_is_protected(node)) {
+                sched_yield();
+            }
+            ds_free(node);
+            return;
+        }
+        
+        if (rec->nretired > 0) {
+            memcpy(grown, rec->retired, rec->nretired * sizeof(void *));
+        }
+        ds_free(rec->retired);
+        rec->retired = grown;
+        rec->retired_cap = new_cap;
+    }
+    
+    rec->retired[rec->nretired++] = node;
+    if (rec->nretired >= threshold) {
+        hp_scan(rec);
+    }
+}
+
+/**
+ * @brief Create a new empty concurrent stack
+ * 
+ * @return Pointer to new stack on success, NULL on memory allocation failure
+ */
+ds_cstack_t *ds_cstack_create(void) {
+    ds_cstack_t *stack = (ds_cstack_t *)ds_alloc(sizeof(struct ds_cstack));
+    
+    if (stack == NULL) {
+        return NULL;
+    }
+    
+    atomic_init(&stack->top, NULL);
+    atomic_init(&stack->size, 0);
+    
+    return stack;
+}
+
+/**
+ * @brief Free a concurrent stack and optionally its data
+ * 
+ * @param S Pointer to stack to free
+ * @param free_data Optional function to free element data (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if S is NULL
+ */
+ds_error_t ds_cstack_free(ds_cstack_t *S, void (*free_data)(void *)) {
+    struct ds_cstack_node *current, *next;
+    
+    // Validate input parameter
+    if (S == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    // No other thread may be running, so nodes can be freed directly
+    current = atomic_load_explicit(&S->top, memory_order_acquire);
+    while (current != NULL) {
+        next = current->next;
+        if (free_data != NULL && current->data != NULL) {
+            free_data(current->data);
+        }
+        ds_free(current);
+        current = next;
+    }
+    
+    ds_free(S);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Push element onto the stack
+ * 
+ * @param S Pointer to stack
+ * @param data Pointer to data to push
+ * @return DS_OK on success, DS_ERR_NULLARG if S or data is NULL, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_cstack_push(ds_cstack_t *S, void *data) {
+    struct ds_cstack_node *node;
+    
+    // Validate input parameters
+    if (S == NULL || data == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    node = (struct ds_cstack_node *)ds_alloc(sizeof(struct ds_cstack_node));
+    if (node == NULL) {
+        return DS_ERR_OOM;
+    }
+    
+    // Publish the node once its fields are set
+    node->data = data;
+    node->next = atomic_load_explicit(&S->top, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(&S->top, &node->next, node,
+                                                  memory_order_release,
+                                                  memory_order_relaxed)) {
+    }
+    atomic_fetch_add_explicit(&S->size, 1, memory_order_relaxed);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Pop element from the stack
+ * 
+ * @param S Pointer to stack
+ * @param out Receives the popped data pointer
+ * @return DS_OK on success, DS_ERR_NULLARG if S or out is NULL, DS_ERR_EMPTY if the stack is empty,
+ *         DS_ERR_OOM if the calling thread's hazard record cannot be allocated
+ */
+ds_error_t ds_cstack_pop(ds_cstack_t *S, void **out) {
+    struct ds_hp_record *rec;
+    struct ds_cstack_node *top;
+    
+    // Validate input parameters
+    if (S == NULL || out == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    rec = hp_acquire();
+    if (rec == NULL) {
+        return DS_ERR_OOM;
+    }
+    
+    for (;;) {
+        top = atomic_load(&S->top);
+        if (top == NULL) {
+            atomic_store(&rec->hazard, NULL);
+            return DS_ERR_EMPTY;
+        }
+        
+        // Protect top, then make sure it was not popped before we did so
+        atomic_store(&rec->hazard, top);
+        if (atomic_load(&S->top) != top) {
+            continue;
+        }
+        
+        if (atomic_compare_exchange_strong(&S->top, &top, top->next)) {
+            break;
+        }
+    }
+    atomic_store_explicit(&rec->hazard, NULL, memory_order_release);
+    atomic_fetch_sub_explicit(&S->size, 1, memory_order_relaxed);
+    
+    *out = top->data;
+    hp_retire(rec, top);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Get the number of elements in the stack
+ * 
+ * @param S Pointer to stack
+ * @return Number of elements in stack, or 0 if S is NULL
+ */
+size_t ds_cstack_size(const ds_cstack_t *S) {
+    size_t size;
+    
+    if (S == NULL) {
+        return 0;
+    }
+    
+    // A pop may be counted before its push, so guard against wrap-around
+    size = atomic_load_explicit((atomic_size_t *)&S->size, memory_order_relaxed);
+    return (size > ((size_t)-1) / 2) ? 0 : size;
+}
+
+/**
+ * @brief Check if stack is empty
+ * 
+ * @param S Pointer to stack
+ * @return 1 if empty, 0 if not empty, 1 if S is NULL
+ */
+int ds_cstack_is_empty(const ds_cstack_t *S) {
+    return (S == NULL || atomic_load_explicit((_Atomic(struct ds_cstack_node *) *)&S->top,
+                                              memory_order_relaxed) == NULL);
+}
+
+/**
+ * @brief Free the calling thread's retired nodes that are no longer in use
+ */
+void ds_cstack_reclaim(void) {
+    if (hp_self != NULL) {
+        hp_scan(hp_self);
+    }
+}
@@ -0,0 +1,532 @@
+/**
+ * @file deque.c
+ * @brief Double-ended queue data structure implementation
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * This file implements the deque as a map of pointers to fixed-size
+ * blocks of DS_DEQUE_BLOCK_ITEMS elements. The used blocks form a
+ * contiguous run of the map, so element i lives in block
+ * (head + i) / DS_DEQUE_BLOCK_ITEMS of that run. When one end of the map
+ * runs out of slots the run is re-centered, doubling the map if needed.
+ */
+
+#include "ds_deque.h"
+#include "ds_internal.h"
+#include <stdio.h>   /* for printf */
+#include <string.h>  /* for memcpy, memmove */
+
+/**
+ * @brief Elements per block, as a power of two
+ * 
+ * The default of 6 gives 64 data pointers, i.e. 512-byte blocks on
+ * 64-bit targets. Override at build time to tune.
+ */
+#ifndef DS_DEQUE_BLOCK_SHIFT
+#define DS_DEQUE_BLOCK_SHIFT 6
+#endif
+
+#define DS_DEQUE_BLOCK_ITEMS ((size_t)1 << DS_DEQUE_BLOCK_SHIFT)
+
+/**
+ * @brief Initial number of block map slots
+ */
+#define DS_DEQUE_MIN_MAP 8
+
+/**
+ * @brief Internal deque structure
+ * 
+ * map[first .. first + nblocks) are the allocated blocks in order. The
+ * front element sits at offset head of map[first]. One block released
+ * by a pop is cached in spare, so a deque that oscillates around a block
+ * boundary does not allocate on every push.
+ */
+struct ds_deque {
+    void ***map;                   /**< Block map */
+    size_t map_cap;                /**< Number of map slots */
+    size_t first;                  /**< Map slot of the first block */
+    size_t nblocks;                /**< Number of allocated blocks in the map */
+    size_t head;                   /**< Offset of the front element in the first block */
+    size_t size;                   /**< Number of elements in deque */
+    void **spare;                  /**< Cached empty block, or NULL */
+    ds_stats_t stats;              /**< Runtime counters */
+};
+
+/**
+ * @brief Locate the slot of an element
+ * 
+ * @param D Pointer to deque
+ * @param index Element position, less than or equal to D->size
+ * @return Pointer to the element's slot
+ */
+static void **slot_at(const ds_deque_t *D, size_t index) {
+    size_t pos = D->head + index;
+    
+    return &D->map[D->first + (pos >> DS_DEQUE_BLOCK_SHIFT)][pos & (DS_DEQUE_BLOCK_ITEMS - 1)];
+}
+
+/**
+ * @brief Obtain an empty block, reusing the spare one if present
+ * 
+ * @param D Pointer to deque
+ * @return Pointer to block, or NULL on memory failure
+ */
+static void **block_get(ds_deque_t *D) {
+    void **block = D->spare;
+    
+    if (block != NULL) {
+        D->spare = NULL;
+        return block;
+    }
+    
+    block = (void **)ds_alloc(DS_DEQUE_BLOCK_ITEMS * sizeof(void *));
+    if (block != NULL) {
+        ds_stats_count_alloc(&D->stats, DS_DEQUE_BLOCK_ITEMS * sizeof(void *));
+    }
+    return block;
+}
+
+/**
+ * @brief Retire a block that no longer holds elements
+ * 
+ * @param D Pointer to deque
+ * @param block Block to retire
+ */
+static void block_put(ds_deque_t *D, void **block) {
+    if (D->spare == NULL) {
+        D->spare = block;
+        return;
+    }
+    
+    ds_stats_count_free(&D->stats, DS_DEQUE_BLOCK_ITEMS * sizeof(void *));
+    ds_free(block);
+}
+
+/**
+ * @brief Make sure the map has a free slot at both ends of the block run
+ * 
+ * Re-centers the run inside the current map when it is at most half
+ * full, and moves it to a map of twice the size otherwise.
+ * 
+ * @param D Pointer to deque
+ * @return DS_OK on success, DS_ERR_OOM on memory failure
+ */
+static ds_error_t map_make_room(ds_deque_t *D) {
+    size_t new_cap = D->map_cap, start;
+    void ***new_map;
+    
+    while (new_cap < 2 * (D->nblocks + 1)) {
+        if (new_cap > ((size_t)-1 / sizeof(void **)) / 2) {
+            return DS_ERR_OOM;
+        }
+        new_cap *= 2;
+    }
+    start = (new_cap - D->nblocks) / 2;
+    
+    if (new_cap == D->map_cap) {
+        memmove(D->map + start, D->map + D->first, D->nblocks * sizeof(void **));
+        D->first = start;
+        return DS_OK;
+    }
+    
+    new_map = (void ***)ds_alloc(new_cap * sizeof(void **));
+    if (new_map == NULL) {
+        return DS_ERR_OOM;
+    }
+    memcpy(new_map + start, D->map + D->first, D->nblocks * sizeof(void **));
+    
+    ds_stats_count_alloc(&D->stats, new_cap * sizeof(void **));
+    ds_stats_count_free(&D->stats, D->map_cap * sizeof(void **));
+    ds_free(D->map);
+    D->map = new_map;
+    D->map_cap = new_cap;
+    D->first = start;
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Create a new empty deque
+ * 
+ * Only the block map is allocated; blocks are added on demand.
+ * 
+ * @return Pointer to new deque on success, NULL on memory allocation failure
+ */
+ds_deque_t *ds_deque_create(void) {
+    ds_deque_t *deque;
+    
+    // Allocate memory for deque structure
+    deque = (ds_deque_t *)ds_alloc(sizeof(struct ds_deque));
+    if (deque == NULL) {
+        return NULL;
+    }
+    
+    deque->map = (void ***)ds_alloc(DS_DEQUE_MIN_MAP * sizeof(void **));
+    if (deque->map == NULL) {
+        ds_free(deque);
+        return NULL;
+    }
+    
+    // Initialize deque to empty state, centered in the map
+    deque->map_cap = DS_DEQUE_MIN_MAP;
+    deque->first = DS_DEQUE_MIN_MAP / 2;
+    deque->nblocks = 0;
+    deque->head = 0;
+    deque->size = 0;
+    deque->spare = NULL;
+    ds_stats_init(&deque->stats);
+    ds_stats_count_alloc(&deque->stats, DS_DEQUE_MIN_MAP * sizeof(void **));
+    
+    return deque;
+}
+
+/**
+ * @brief Free a deque and optionally its data
+ * 
+ * @param D Pointer to deque to free
+ * @param free_data Optional function to free element data (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if D is NULL
+ */
+ds_error_t ds_deque_free(ds_deque_t *D, void (*free_data)(void *)) {
+    // Validate input parameter
+    if (D == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    // Call user's free function for each element if provided
+    if (free_data != NULL) {
+        for (size_t i = 0; i < D->size; i++) {
+            void *data = *slot_at(D, i);
+            if (data != NULL) {
+                free_data(data);
+            }
+        }
+    }
+    
+    // Release the blocks, the spare block and the map
+    for (size_t i = 0; i < D->nblocks; i++) {
+        ds_free(D->map[D->first + i]);
+    }
+    ds_free(D->spare);
+    ds_free(D->map);
+    
+    // Free the deque structure
+    ds_stats_release(&D->stats);
+    ds_free(D);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Insert element at the front of the deque
+ * 
+ * Steps back into the previous block, adding one in front of the run
+ * when the first block is full at its start.
+ * 
+ * @param D Pointer to deque
+ * @param data Pointer to data to insert
+ * @return DS_OK on success, DS_ERR_NULLARG if D or data is NULL, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_deque_push_front(ds_deque_t *D, void *data) {
+    void **block;
+    
+    // Validate input parameters
+    if (D == NULL || data == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    if (D->head == 0) {
+        if (D->first == 0 && map_make_room(D) != DS_OK) {
+            return DS_ERR_OOM;
+        }
+        block = block_get(D);
+        if (block == NULL) {
+            return DS_ERR_OOM;
+        }
+        D->map[--D->first] = block;
+        D->nblocks++;
+        D->head = DS_DEQUE_BLOCK_ITEMS;
+    }
+    
+    D->head--;
+    D->size++;
+    *slot_at(D, 0) = data;
+    ds_stats_resize(&D->stats, D->size);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Untraced implementation of ds_deque_push_back
+ */
+static ds_error_t deque_push_back(ds_deque_t *D, void *data) {
+    void **block;
+    
+    // Validate input parameters
+    if (D == NULL || data == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    if (D->head + D->size == D->nblocks * DS_DEQUE_BLOCK_ITEMS) {
+        if (D->first + D->nblocks == D->map_cap && map_make_room(D) != DS_OK) {
+            return DS_ERR_OOM;
+        }
+        block = block_get(D);
+        if (block == NULL) {
+            return DS_ERR_OOM;
+        }
+        D->map[D->first + D->nblocks] = block;
+        D->nblocks++;
+    }
+    
+    *slot_at(D, D->size) = data;
+    D->size++;
+    ds_stats_resize(&D->stats, D->size);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Insert element at the back of the deque
+ * 
+ * Adds a block behind the run when the last block is full.
+ * 
+ * @param D Pointer to deque
+ * @param data Pointer to data to insert
+ * @return DS_OK on success, DS_ERR_NULLARG if D or data is NULL, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_deque_push_back(ds_deque_t *D, void *data) {
+    ds_error_t result;
+    
+    DS_TRACE_BEGIN();
+    result = deque_push_back(D, data);
+    DS_TRACE_END(DS_TRACE_DEQUE_PUSH_BACK, D);
+    
+    return result;
+}
+
+/**
+ * @brief Untraced implementation of ds_deque_pop_front
+ */
+static void *deque_pop_front(ds_deque_t *D) {
+    void *data;
+    
+    // Validate input parameter and check for empty deque
+    if (D == NULL || D->size == 0) {
+        return NULL;
+    }
+    
+    data = *slot_at(D, 0);
+    D->head++;
+    D->size--;
+    ds_stats_resize(&D->stats, D->size);
+    
+    // Retire the first block once it has been emptied
+    if (D->head == DS_DEQUE_BLOCK_ITEMS || D->size == 0) {
+        block_put(D, D->map[D->first]);
+        D->first++;
+        D->nblocks--;
+        D->head = 0;
+    }
+    
+    return data;
+}
+
+/**
+ * @brief Remove and return the front element
+ * 
+ * @param D Pointer to deque
+ * @return Pointer to data of removed element, or NULL if deque is empty or D is NULL
+ */
+void *ds_deque_pop_front(ds_deque_t *D) {
+    void *result;
+    
+    DS_TRACE_BEGIN();
+    result = deque_pop_front(D);
+    DS_TRACE_END(DS_TRACE_DEQUE_POP_FRONT, D);
+    
+    return result;
+}
+
+/**
+ * @brief Remove and return the back element
+ * 
+ * @param D Pointer to deque
+ * @return Pointer to data of removed element, or NULL if deque is empty or D is NULL
+ */
+void *ds_deque_pop_back(ds_deque_t *D) {
+    void *data;
+    
+    // Validate input parameter and check for empty deque
+    if (D == NULL || D->size == 0) {
+        return NULL;
+    }
+    
+    D->size--;
+    data = *slot_at(D, D->size);
+    ds_stats_resize(&D->stats, D->size);
+    
+    // Retire the last block once it has been emptied
+    if (D->size == 0 || D->head + D->size <= (D->nblocks - 1) * DS_DEQUE_BLOCK_ITEMS) {
+        D->nblocks--;
+        block_put(D, D->map[D->first + D->nblocks]);
+        if (D->nblocks == 0) {
+            D->head = 0;
+        }
+    }
+    
+    return data;
+}
+
+/**
+ * @brief Peek at the front element without removing it
+ * 
+ * @param D Pointer to deque
+ * @return Pointer to front element's data, or NULL if deque is empty or D is NULL
+ */
+void *ds_deque_peek_front(const ds_deque_t *D) {
+    return ds_deque_get(D, 0);
+}
+
+/**
+ * @brief Peek at the back element without removing it
+ * 
+ * @param D Pointer to deque
+ * @return Pointer to back element's data, or NULL if deque is empty or D is NULL
+ */
+void *ds_deque_peek_back(const ds_deque_t *D) {
+    if (D == NULL || D->size == 0) {
+        return NULL;
+    }
+    
+    return *slot_at(D, D->size - 1);
+}
+
+/**
+ * @brief Get the element at a position
+ * 
+ * @param D Pointer to deque
+ * @param index Position counted from the front
+ * @return Pointer to the element's data, or NULL if index is out of range or D is NULL
+ */
+void *ds_deque_get(const ds_deque_t *D, size_t index) {
+    if (D == NULL || index >= D->size) {
+        return NULL;
+    }
+    
+    return *slot_at(D, index);
+}
+
+/**
+ * @brief Replace the element at a position
+ * 
+ * @param D Pointer to deque
+ * @param index Position counted from the front
+ * @param data Pointer to new data
+ * @return DS_OK on success, DS_ERR_NULLARG if D or data is NULL, DS_ERR_INVALID if index is out of range
+ */
+ds_error_t ds_deque_set(ds_deque_t *D, size_t index, void *data) {
+    if (D == NULL || data == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    if (index >= D->size) {
+        return DS_ERR_INVALID;
+    }
+    
+    *slot_at(D, index) = data;
+    return DS_OK;
+}
+
+/**
+ * @brief Get the number of elements in the deque
+ * 
+ * @param D Pointer to deque
+ * @return Number of elements in deque, or 0 if D is NULL
+ */
+size_t ds_deque_size(const ds_deque_t *D) {
+    if (D == NULL) {
+        return 0;
+    }
+    
+    return D->size;
+}
+
+/**
+ * @brief Check if deque is empty
+ * 
+ * @param D Pointer to deque
+ * @return 1 if empty, 0 if not empty, 1 if D is NULL
+ */
+int ds_deque_is_empty(const ds_deque_t *D) {
+    if (D == NULL) {
+        return 1;  // Consider NULL as empty
+    }
+    
+    return (D->size == 0) ? 1 : 0;
+}
+
+/**
+ * @brief Get the runtime counters of a deque
+ * 
+ * @param D Pointer to deque
+ * @param out Receives the counters
+ * @return DS_OK on success, DS_ERR_NULLARG if D or out is NULL
+ */
+ds_error_t ds_deque_stats(const ds_deque_t *D, ds_stats_t *out) {
+    if (D == NULL || out == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    *out = D->stats;
+    return DS_OK;
+}
+
+/**
+ * @brief Visualize the deque structure
+ * 
+ * Prints each element front to back, then the block layout.
+ * 
+ * @param D Pointer to deque
+ * @param out Output stream (e.g., stdout, stderr)
+ */
+void ds_deque_visualize(const ds_deque_t *D, FILE *out) {
+    // Handle NULL parameters gracefully
+    if (out == NULL) {
+        out = stdout;  // Default to stdout
+    }
+    
+    if (D == NULL) {
+        fprintf(out, "Deque: NULL\n");
+        return;
+    }
+    
+    if (D->size == 0) {
+        fprintf(out, "Deque: [empty] (size: %zu)\n", D->size);
+        return;
+    }
+    
+    // Print deque header
+    fprintf(out, "Deque: (size: %zu, blocks: %zu)\n", D->size, D->nblocks);
+    
+    for (size_t i = 0; i < D->size; i++) {
+        void *data = *slot_at(D, i);
+        
+        fprintf(out, "  [%zu]: ", i);
+        if (data != NULL) {
+            fprintf(out, "%d", *(int*)data);
+        } else {
+            fprintf(out, "NULL");
+        }
+        if (i == 0) {
+            fprintf(out, " [FRONT]");
+        }
+        if (i == D->size - 1) {
+            fprintf(out, " [BACK]");
+        }
+        fprintf(out, "\n");
+    }
+    
+    fprintf(out, "\n");
+}
@@ -0,0 +1,215 @@
+/**
+ * @file ds.c
+ * @brief Library-wide memory management and learning mode support
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * This file holds the single definition of the allocator wrappers, the
+ * library-wide counters and the learning mode state shared by every data
+ * structure in the library.
+ */
+
+#include "ds.h"
+#include "ds_internal.h"
+#include <stdlib.h>  /* for malloc, free */
+#include <stdio.h>   /* for printf */
+
+/**
+ * @brief Internal flag for learning mode
+ * 
+ * When enabled, memory operations are logged for educational purposes.
+ */
+static int learning_mode = 0;
+
+/**
+ * @brief Library-wide counters, updated alongside every container's own
+ */
+struct ds_lib_counters ds_lib_stats;
+
+/**
+ * @brief Default allocation callback with learning mode support
+ * 
+ * @param ctx Unused allocator context
+ * @param n Number of bytes to allocate
+ * @return Pointer to allocated memory, or NULL on failure
+ */
+static void *default_alloc(void *ctx, size_t n) {
+    void *ptr = malloc(n);
+    
+    (void)ctx;
+    
+#ifdef DS_LEARNING_MODE
+    if (learning_mode) {
+        printf("[LEARN] malloc(%zu) = %p\n", n, ptr);
+    }
+#endif
+    
+    return ptr;
+}
+
+/**
+ * @brief Default deallocation callback with learning mode support
+ * 
+ * @param ctx Unused allocator context
+ * @param p Pointer to memory to deallocate
+ */
+static void default_free(void *ctx, void *p) {
+    (void)ctx;
+    
+#ifdef DS_LEARNING_MODE
+    if (learning_mode && p) {
+        printf("[LEARN] free(%p)\n", p);
+    }
+#endif
+    
+    free(p);
+}
+
+/**
+ * @brief Currently installed library-level allocator
+ */
+static ds_allocator_t library_allocator = { default_alloc, default_free, NULL };
+
+/**
+ * @brief Install the library-level allocator
+ * 
+ * @param a Allocator to install, or NULL to restore the malloc/free default
+ * @return DS_OK on success, DS_ERR_INVALID if a is missing its callbacks
+ */
+ds_error_t ds_set_allocator(const ds_allocator_t *a) {
+    if (a == NULL) {
+        library_allocator.alloc = default_alloc;
+        library_allocator.free = default_free;
+        library_allocator.ctx = NULL;
+        return DS_OK;
+    }
+    
+    if (a->alloc == NULL || a->free == NULL) {
+        return DS_ERR_INVALID;
+    }
+    
+    library_allocator = *a;
+    return DS_OK;
+}
+
+/**
+ * @brief Get the library-level allocator
+ * 
+ * @return Pointer to the allocator currently used by ds_alloc/ds_free
+ */
+const ds_allocator_t *ds_get_allocator(void) {
+    return &library_allocator;
+}
+
+/**
+ * @brief Memory allocation wrapper
+ * 
+ * Allocates memory through the library-level allocator.
+ * 
+ * @param n Number of bytes to allocate
+ * @return Pointer to allocated memory, or NULL on failure
+ */
+void *ds_alloc(size_t n) {
+    return library_allocator.alloc(library_allocator.ctx, n);
+}
+
+/**
+ * @brief Memory deallocation wrapper
+ * 
+ * Deallocates memory through the library-level allocator.
+ * 
+ * @param p Pointer to memory to deallocate
+ */
+void ds_free(void *p) {
+    if (p == NULL) {
+        return;
+    }
+    
+    library_allocator.free(library_allocator.ctx, p);
+}
+
+/**
+ * @brief Enable or disable learning mode
+ * 
+ * @param enable Non-zero to enable, zero to disable
+ */
+void ds_enable_learning_mode(int enable) {
+    learning_mode = enable;
+}
+
+/**
+ * @brief Take a snapshot of the library-wide counters
+ * 
+ * @param out Receives the counters
+ * @return DS_OK on success, DS_ERR_NULLARG if out is NULL
+ */
+ds_error_t ds_stats_get(ds_stats_t *out) {
+    if (out == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    out->allocs = DS_STAT_LOAD(ds_lib_stats.allocs);
+    out->frees = DS_STAT_LOAD(ds_lib_stats.frees);
+    out->bytes_live = DS_STAT_LOAD(ds_lib_stats.bytes_live);
+    out->bytes_peak = DS_STAT_LOAD(ds_lib_stats.bytes_peak);
+    out->size = DS_STAT_LOAD(ds_lib_stats.size);
+    out->peak_size = DS_STAT_LOAD(ds_lib_stats.peak_size);
+    out->finds = DS_STAT_LOAD(ds_lib_stats.finds);
+    out->find_depth = DS_STAT_LOAD(ds_lib_stats.find_depth);
+    out->compares = DS_STAT_LOAD(ds_lib_stats.compares);
+    return DS_OK;
+}
+
+/**
+ * @brief Reset the library-wide operation counters
+ */
+void ds_stats_reset(void) {
+    DS_STAT_STORE(ds_lib_stats.allocs, 0);
+    DS_STAT_STORE(ds_lib_stats.frees, 0);
+    DS_STAT_STORE(ds_lib_stats.finds, 0);
+    DS_STAT_STORE(ds_lib_stats.find_depth, 0);
+    DS_STAT_STORE(ds_lib_stats.compares, 0);
+    DS_STAT_STORE(ds_lib_stats.bytes_peak, DS_STAT_LOAD(ds_lib_stats.bytes_live));
+    DS_STAT_STORE(ds_lib_stats.peak_size, DS_STAT_LOAD(ds_lib_stats.size));
+}
+
+/**
+ * @brief Format a counter snapshot as a JSON object
+ * 
+ * @param s Counters to format
+ * @param buf Output buffer (may be NULL if len is 0)
+ * @param len Size of buf in bytes
+ * @return Length of the complete JSON text, or 0 if s is NULL
+ */
+size_t ds_stats_to_json(const ds_stats_t *s, char *buf, size_t len) {
+    int n;
+    
+    if (s == NULL) {
+        return 0;
+    }
+    
+    n = snprintf(buf, len,
+                 "{\"allocs\":%zu,\"frees\":%zu,\"bytes_live\":%zu,\"bytes_peak\":%zu,"
+                 "\"size\":%zu,\"peak_size\":%zu,\"finds\":%zu,\"find_depth\":%zu,"
+                 "\"avg_find_depth\":%.2f,\"compares\":%zu}",
+                 s->allocs, s->frees, s->bytes_live, s->bytes_peak, s->size, s->peak_size,
+                 s->finds, s->find_depth,
+                 (s->finds > 0) ? (double)s->find_depth / (double)s->finds : 0.0,
+                 s->compares);
+    return (n > 0) ? (size_t)n : 0;
+}
+
+/**
+ * @brief Dump current state of all data structures
+ * 
+ * Prints the library-wide counters as one line of JSON.
+ */
+void ds_dump_state(void) {
+    ds_stats_t snap;
+    char buf[512];
+    
+    ds_stats_get(&snap);
+    ds_stats_to_json(&snap, buf, sizeof(buf));
+    printf("%s\n", buf);
+}
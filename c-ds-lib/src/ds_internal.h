@@ -0,0 +1,362 @@
+/**
+ * @file ds_internal.h
+ * @brief Internal helpers shared by the data structure implementations
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * This header is private to the library sources and is not installed.
+ * It provides the per-container allocator plumbing used for node storage
+ * and the helpers that keep the runtime counters up to date.
+ */
+
+#ifndef DS_INTERNAL_H
+#define DS_INTERNAL_H
+
+#include "ds.h"
+#include <string.h>  /* for memset */
+#ifdef DS_ENABLE_CONCURRENT
+#include <stdatomic.h>
+#endif
+
+/**
+ * @brief Default number of objects carved out of each slab
+ * 
+ * Used by the *_create_pooled() constructors when sizing their node pool.
+ */
+#define DS_SLAB_DEFAULT_OBJS 256
+
+/**
+ * @brief Assumed cache line size
+ * 
+ * Used to pad apart fields that different threads write concurrently.
+ */
+#define DS_CACHE_LINE 64
+
+/**
+ * @brief Hint that memory at p will be read soon
+ * 
+ * Used by the batch operations to overlap the cache misses of several
+ * independent lookups. Expands to nothing on compilers without
+ * __builtin_prefetch.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define DS_PREFETCH(p) __builtin_prefetch((p))
+#else
+#define DS_PREFETCH(p) ((void)(p))
+#endif
+
+/**
+ * @brief Time a public operation when the library is built with TRACE=1
+ * 
+ * DS_TRACE_BEGIN() starts the measurement and declares its start time,
+ * DS_TRACE_END(op, obj) records it under operation op for container obj.
+ * Both expand to nothing in an untraced build.
+ */
+#ifdef DS_ENABLE_TRACE
+#include "ds_trace.h"
+uint64_t ds_trace_begin(void);
+void ds_trace_end(ds_trace_op_t op, const void *obj, uint64_t start);
+#define DS_TRACE_BEGIN() uint64_t ds_trace_start = ds_trace_begin()
+#define DS_TRACE_END(op, obj) ds_trace_end((op), (obj), ds_trace_start)
+#else
+#define DS_TRACE_BEGIN() ((void)0)
+#define DS_TRACE_END(op, obj) ((void)0)
+#endif
+
+/**
+ * @brief Number of lookups a batch operation keeps in flight at once
+ */
+#define DS_BATCH_LANES 8
+
+/**
+ * @brief Snapshot kinds recorded in the file header
+ */
+#define DS_SNAPSHOT_TREE 1
+#define DS_SNAPSHOT_LIST 2
+
+/**
+ * @brief Write a snapshot file from a sequence of elements
+ * 
+ * Defined in snapshot.c. The file is written next to path and renamed
+ * into place once complete, so readers never see a partial snapshot.
+ * 
+ * @param path Destination file
+ * @param kind DS_SNAPSHOT_TREE or DS_SNAPSHOT_LIST
+ * @param count Number of elements next will yield
+ * @param next Returns the next element's data on each call
+ * @param state State passed to next
+ * @param ser Serializer (see ds_tree_save)
+ * @param ctx User context passed to ser
+ * @return DS_OK on success, DS_ERR_INVALID if ser fails, DS_ERR_OOM on memory
+ *         failure, DS_ERR_IO if the file cannot be written
+ */
+ds_error_t ds_snapshot_write(const char *path, unsigned kind, size_t count,
+                             void *(*next)(void *state), void *state,
+                             size_t (*ser)(const void *data, void *buf, size_t cap, void *ctx),
+                             void *ctx);
+
+/**
+ * @brief Library-wide counter access, atomic only when threads exist
+ * 
+ * Containers are private to one thread at a time, but separate
+ * containers on different threads all feed the library-wide set, so
+ * its updates are relaxed atomic adds in concurrent builds.
+ */
+#ifdef DS_ENABLE_CONCURRENT
+#define DS_STAT_ATOMIC(T) _Atomic(T)
+#define DS_STAT_LOAD(x) atomic_load_explicit(&(x), memory_order_relaxed)
+#define DS_STAT_STORE(x, v) atomic_store_explicit(&(x), (v), memory_order_relaxed)
+#else
+#define DS_STAT_ATOMIC(T) T
+#define DS_STAT_LOAD(x) (x)
+#define DS_STAT_STORE(x, v) ((x) = (v))
+#endif
+
+/**
+ * @brief Library-wide counters, laid out as ds_stats_t
+ */
+struct ds_lib_counters {
+    DS_STAT_ATOMIC(size_t) allocs;      /**< Storage allocations */
+    DS_STAT_ATOMIC(size_t) frees;       /**< Storage releases */
+    DS_STAT_ATOMIC(size_t) bytes_live;  /**< Bytes currently allocated for storage */
+    DS_STAT_ATOMIC(size_t) bytes_peak;  /**< High-water mark of bytes_live */
+    DS_STAT_ATOMIC(size_t) size;        /**< Elements currently stored */
+    DS_STAT_ATOMIC(size_t) peak_size;   /**< High-water mark of size */
+    DS_STAT_ATOMIC(size_t) finds;       /**< Lookups performed */
+    DS_STAT_ATOMIC(size_t) find_depth;  /**< Nodes or slots visited by all lookups */
+    DS_STAT_ATOMIC(size_t) compares;    /**< Comparator or equality callback invocations */
+};
+
+/**
+ * @brief Library-wide counters, defined in ds.c
+ */
+extern struct ds_lib_counters ds_lib_stats;
+
+/**
+ * @brief Add to a library-wide counter
+ * 
+ * @param x Counter to update
+ * @param n Amount to add (wraps around, so adding -n subtracts n)
+ * @return Value of the counter after the add
+ */
+static inline size_t ds_stats_add(DS_STAT_ATOMIC(size_t) *x, size_t n) {
+#ifdef DS_ENABLE_CONCURRENT
+    return atomic_fetch_add_explicit(x, n, memory_order_relaxed) + n;
+#else
+    return *x += n;
+#endif
+}
+
+/**
+ * @brief Raise a library-wide high-water mark
+ * 
+ * @param peak High-water mark to update
+ * @param value Value just reached
+ */
+static inline void ds_stats_raise(DS_STAT_ATOMIC(size_t) *peak, size_t value) {
+#ifdef DS_ENABLE_CONCURRENT
+    size_t cur = atomic_load_explicit(peak, memory_order_relaxed);
+    
+    while (cur < value &&
+           !atomic_compare_exchange_weak_explicit(peak, &cur, value, memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+    }
+#else
+    if (*peak < value) {
+        *peak = value;
+    }
+#endif
+}
+
+/**
+ * @brief Zero a new container's counters
+ * 
+ * @param s Container counters
+ */
+static inline void ds_stats_init(ds_stats_t *s) {
+    memset(s, 0, sizeof(*s));
+}
+
+/**
+ * @brief Record a storage allocation of the given size
+ * 
+ * @param s Container counters
+ * @param bytes Number of bytes allocated
+ */
+static inline void ds_stats_count_alloc(ds_stats_t *s, size_t bytes) {
+    s->allocs++;
+    s->bytes_live += bytes;
+    if (s->bytes_live > s->bytes_peak) {
+        s->bytes_peak = s->bytes_live;
+    }
+    ds_stats_add(&ds_lib_stats.allocs, 1);
+    ds_stats_raise(&ds_lib_stats.bytes_peak, ds_stats_add(&ds_lib_stats.bytes_live, bytes));
+}
+
+/**
+ * @brief Record the release of storage of the given size
+ * 
+ * @param s Container counters
+ * @param bytes Number of bytes released
+ */
+static inline void ds_stats_count_free(ds_stats_t *s, size_t bytes) {
+    s->frees++;
+    s->bytes_live -= bytes;
+    ds_stats_add(&ds_lib_stats.frees, 1);
+    ds_stats_add(&ds_lib_stats.bytes_live, 0 - bytes);
+}
+
+/**
+ * @brief Move ownership of live storage from one container to another
+ * 
+ * Used when nodes are spliced between containers without being
+ * reallocated. The storage counts as allocated by dst and released by
+ * src; the library-wide totals do not change.
+ * 
+ * @param dst Counters of the receiving container
+ * @param src Counters of the giving container
+ * @param allocs Number of allocations moved
+ * @param bytes Number of bytes moved
+ */
+static inline void ds_stats_transfer(ds_stats_t *dst, ds_stats_t *src, size_t allocs, size_t bytes) {
+    dst->allocs += allocs;
+    dst->bytes_live += bytes;
+    if (dst->bytes_live > dst->bytes_peak) {
+        dst->bytes_peak = dst->bytes_live;
+    }
+    src->frees += allocs;
+    src->bytes_live -= bytes;
+}
+
+/**
+ * @brief Record a container's new element count
+ * 
+ * @param s Container counters
+ * @param size Element count after the operation
+ */
+static inline void ds_stats_resize(ds_stats_t *s, size_t size) {
+    // Unsigned wrap-around makes the add a subtraction when the container shrinks
+    ds_stats_raise(&ds_lib_stats.peak_size, ds_stats_add(&ds_lib_stats.size, size - s->size));
+    s->size = size;
+    if (size > s->peak_size) {
+        s->peak_size = size;
+    }
+}
+
+/**
+ * @brief Record one or more lookups
+ * 
+ * @param s Container counters
+ * @param finds Number of lookups
+ * @param depth Nodes or slots visited by all of them
+ * @param compares Comparator calls made
+ */
+static inline void ds_stats_count_find(ds_stats_t *s, size_t finds, size_t depth, size_t compares) {
+    s->finds += finds;
+    s->find_depth += depth;
+    s->compares += compares;
+    ds_stats_add(&ds_lib_stats.finds, finds);
+    ds_stats_add(&ds_lib_stats.find_depth, depth);
+    ds_stats_add(&ds_lib_stats.compares, compares);
+}
+
+/**
+ * @brief Record comparator calls made outside lookups
+ * 
+ * @param s Container counters
+ * @param compares Comparator calls made
+ */
+static inline void ds_stats_count_compares(ds_stats_t *s, size_t compares) {
+    s->compares += compares;
+    ds_stats_add(&ds_lib_stats.compares, compares);
+}
+
+/**
+ * @brief Retire a container's counters from the library-wide totals
+ * 
+ * Called when a container is freed, so storage released in bulk (such
+ * as a node pool) and remaining elements stop counting as live.
+ * 
+ * @param s Container counters
+ */
+static inline void ds_stats_release(ds_stats_t *s) {
+    ds_stats_add(&ds_lib_stats.frees, s->allocs - s->frees);
+    ds_stats_add(&ds_lib_stats.bytes_live, 0 - s->bytes_live);
+    ds_stats_add(&ds_lib_stats.size, 0 - s->size);
+}
+
+/**
+ * @brief Resolve the node allocator for a new container
+ * 
+ * Copies the caller supplied allocator into dst, or the current
+ * library-level allocator when a is NULL. A NULL free callback is
+ * accepted and marks a bulk allocator (see ds_allocator_frees).
+ * 
+ * @param dst Destination allocator stored in the container
+ * @param a Caller supplied allocator (may be NULL)
+ * @return DS_OK on success, DS_ERR_INVALID if a has no alloc callback
+ */
+static inline ds_error_t ds_allocator_init(ds_allocator_t *dst, const ds_allocator_t *a) {
+    if (a == NULL) {
+        a = ds_get_allocator();
+    }
+    
+    if (a->alloc == NULL) {
+        return DS_ERR_INVALID;
+    }
+    
+    *dst = *a;
+    return DS_OK;
+}
+
+/**
+ * @brief Check whether nodes must be handed back to an allocator one by one
+ * 
+ * Bulk allocators such as arenas have no free callback and reclaim all
+ * of their memory at once, so teardown can skip the node walk.
+ * 
+ * @param a Container allocator
+ * @return Non-zero if a has a free callback
+ */
+static inline int ds_allocator_frees(const ds_allocator_t *a) {
+    return a->free != NULL;
+}
+
+/**
+ * @brief Allocate a node through a container's allocator
+ * 
+ * @param a Container allocator
+ * @param s Container counters
+ * @param n Number of bytes to allocate
+ * @return Pointer to allocated memory, or NULL on failure
+ */
+static inline void *ds_node_alloc(const ds_allocator_t *a, ds_stats_t *s, size_t n) {
+    void *p = a->alloc(a->ctx, n);
+    
+    if (p != NULL) {
+        ds_stats_count_alloc(s, n);
+    }
+    return p;
+}
+
+/**
+ * @brief Release a node through a container's allocator
+ * 
+ * With a bulk allocator only the counters are updated.
+ * 
+ * @param a Container allocator
+ * @param s Container counters
+ * @param p Pointer to node memory (may be NULL)
+ * @param n Size the node was allocated with
+ */
+static inline void ds_node_free(const ds_allocator_t *a, ds_stats_t *s, void *p, size_t n) {
+    if (p != NULL) {
+        if (a->free != NULL) {
+            a->free(a->ctx, p);
+        }
+        ds_stats_count_free(s, n);
+    }
+}
+
+#endif /* DS_INTERNAL_H */
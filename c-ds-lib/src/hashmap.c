@@ -0,0 +1,696 @@
+/**
+ * @file hashmap.c
+ * @brief Open-addressing hash map implementation
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * This file implements a Robin Hood hash map. Each slot records how far
+ * its entry sits from the slot its hash maps to (its probe distance).
+ * On insertion an entry takes over any slot whose occupant is closer to
+ * home, which keeps probe sequences short and lets a lookup stop as soon
+ * as it meets an entry closer to home than the key would be. Removal
+ * shifts the following entries back by one instead of leaving tombstones.
+ * 
+ * Probe distances are kept in their own array, so a probe scans a dense
+ * run of small integers and only touches an entry when a hash matches.
+ */
+
+#include "ds_hashmap.h"
+#include "ds_internal.h"
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief Smallest table size
+ */
+#define DS_HASHMAP_MIN_SLOTS 8
+
+/**
+ * @brief Stored key-value pair
+ */
+struct ds_hashmap_entry {
+    void *key;                     /**< Pointer to user key */
+    void *value;                   /**< Pointer to user value */
+    size_t hash;                   /**< Mixed hash of key */
+};
+
+/**
+ * @brief Internal hash map structure
+ */
+struct ds_hashmap {
+    uint32_t *dist;                        /**< Probe distance + 1 per slot, 0 if empty */
+    struct ds_hashmap_entry *entries;      /**< Entry per slot */
+    size_t slots;                          /**< Number of slots (power of two) */
+    size_t size;                           /**< Number of entries */
+    size_t grow_at;                        /**< Size above which the table grows */
+    double max_load;                       /**< Maximum load factor */
+    size_t (*hash)(const void *key);       /**< User hash function */
+    int (*eq)(const void *a, const void *b); /**< User equality function */
+    ds_stats_t stats;                      /**< Runtime counters */
+};
+
+/**
+ * @brief Spread a user hash over all bits (64-bit finalizer from MurmurHash3)
+ * 
+ * @param h User hash value
+ * @return Mixed hash value
+ */
+static size_t mix_hash(size_t h) {
+    uint64_t x = (uint64_t)h;
+    
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return (size_t)x;
+}
+
+/**
+ * @brief Number of entries a table of the given size may hold
+ */
+static size_t grow_threshold(size_t slots, double max_load) {
+    return (size_t)((double)slots * max_load);
+}
+
+/**
+ * @brief Smallest power-of-two slot count that holds count entries
+ * 
+ * @param count Number of entries
+ * @param max_load Maximum load factor
+ * @return Slot count, or 0 on overflow
+ */
+static size_t slots_for(size_t count, double max_load) {
+    size_t slots = DS_HASHMAP_MIN_SLOTS;
+    
+    while (grow_threshold(slots, max_load) < count) {
+        if (slots > SIZE_MAX / 2 / sizeof(struct ds_hashmap_entry)) {
+            return 0;
+        }
+        slots <<= 1;
+    }
+    return slots;
+}
+
+/**
+ * @brief Place an entry known to be absent, displacing richer occupants
+ * 
+ * @param H Pointer to map (must have a free slot)
+ * @param e Entry to place
+ */
+static void place_entry(ds_hashmap_t *H, struct ds_hashmap_entry e) {
+    size_t mask = H->slots - 1;
+    size_t idx = e.hash & mask;
+    uint32_t d = 1, td;
+    struct ds_hashmap_entry te;
+    
+    for (;;) {
+        if (H->dist[idx] == 0) {
+            H->dist[idx] = d;
+            H->entries[idx] = e;
+            return;
+        }
+        
+        // Take the slot from an occupant closer to its home
+        if (H->dist[idx] < d) {
+            td = H->dist[idx];
+            te = H->entries[idx];
+            H->dist[idx] = d;
+            H->entries[idx] = e;
+            d = td;
+            e = te;
+        }
+        
+        idx = (idx + 1) & mask;
+        d++;
+    }
+}
+
+/**
+ * @brief Locate the slot holding a key
+ * 
+ * @param H Pointer to map
+ * @param key Pointer to key
+ * @param hash Mixed hash of key
+ * @param probes Incremented by the number of slots inspected
+ * @param compares Incremented by the number of equality calls
+ * @return Slot index, or H->slots if the key is absent
+ */
+static size_t find_slot(const ds_hashmap_t *H, const void *key, size_t hash,
+                        size_t *probes, size_t *compares) {
+    size_t mask = H->slots - 1;
+    size_t idx = hash & mask;
+    uint32_t d = 1;
+    
+    // An entry closer to home than d means the key would have been placed here
+    while (H->dist[idx] >= d) {
+        if (H->entries[idx].hash == hash) {
+            (*compares)++;
+            if (H->eq(H->entries[idx].key, key)) {
+                break;
+            }
+        }
+        idx = (idx + 1) & mask;
+        d++;
+    }
+    *probes += d;
+    return (H->dist[idx] >= d) ? idx : H->slots;
+}
+
+/**
+ * @brief Rebuild the table with a new slot count
+ * 
+ * @param H Pointer to map
+ * @param slots New slot count (power of two, large enough for H->size)
+ * @return DS_OK on success, DS_ERR_OOM on memory failure
+ */
+static ds_error_t resize(ds_hashmap_t *H, size_t slots) {
+    uint32_t *old_dist = H->dist;
+    struct ds_hashmap_entry *old_entries = H->entries;
+    size_t old_slots = H->slots, i;
+    uint32_t *dist;
+    struct ds_hashmap_entry *entries;
+    
+    dist = (uint32_t *)ds_alloc(slots * sizeof(uint32_t));
+    entries = (struct ds_hashmap_entry *)ds_alloc(slots * sizeof(struct ds_hashmap_entry));
+    if (dist == NULL || entries == NULL) {
+        ds_free(dist);
+        ds_free(entries);
+        return DS_ERR_OOM;
+    }
+    memset(dist, 0, slots * sizeof(uint32_t));
+    ds_stats_count_alloc(&H->stats, slots * sizeof(uint32_t));
+    ds_stats_count_alloc(&H->stats, slots * sizeof(struct ds_hashmap_entry));
+    
+    H->dist = dist;
+    H->entries = entries;
+    H->slots = slots;
+    H->grow_at = grow_threshold(slots, H->max_load);
+    
+    // Stored hashes make reinsertion independent of the user callbacks
+    for (i = 0; i < old_slots; i++) {
+        if (old_dist[i] != 0) {
+            place_entry(H, old_entries[i]);
+        }
+    }
+    
+    if (old_dist != NULL) {
+        ds_stats_count_free(&H->stats, old_slots * sizeof(uint32_t));
+        ds_stats_count_free(&H->stats, old_slots * sizeof(struct ds_hashmap_entry));
+    }
+    ds_free(old_dist);
+    ds_free(old_entries);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Create a new empty hash map
+ * 
+ * @param hash Hash function for keys
+ * @param eq Equality function for keys (returns non-zero if equal)
+ * @return Pointer to new map on success, NULL if hash/eq is NULL or on memory failure
+ */
+ds_hashmap_t *ds_hashmap_create(size_t (*hash)(const void *key),
+                                int (*eq)(const void *a, const void *b)) {
+    ds_hashmap_t *map;
+    
+    if (hash == NULL || eq == NULL) {
+        return NULL;
+    }
+    
+    // Allocate memory for map structure
+    map = (ds_hashmap_t *)ds_alloc(sizeof(struct ds_hashmap));
+    if (map == NULL) {
+        return NULL;
+    }
+    
+    map->dist = NULL;
+    map->entries = NULL;
+    map->slots = 0;
+    map->size = 0;
+    map->max_load = DS_HASHMAP_DEFAULT_LOAD;
+    map->hash = hash;
+    map->eq = eq;
+    ds_stats_init(&map->stats);
+    
+    if (resize(map, DS_HASHMAP_MIN_SLOTS) != DS_OK) {
+        ds_free(map);
+        return NULL;
+    }
+    
+    return map;
+}
+
+/**
+ * @brief Free a hash map and optionally its keys and values
+ * 
+ * @param H Pointer to map to free
+ * @param free_key Optional function called for every stored key (may be NULL)
+ * @param free_value Optional function called for every stored value (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if H is NULL
+ */
+ds_error_t ds_hashmap_free(ds_hashmap_t *H, void (*free_key)(void *), void (*free_value)(void *)) {
+    size_t i;
+    
+    // Validate input parameter
+    if (H == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    // Only walk the table if there is user data to release
+    if (free_key != NULL || free_value != NULL) {
+        for (i = 0; i < H->slots; i++) {
+            if (H->dist[i] == 0) {
+                continue;
+            }
+            if (free_key != NULL) {
+                free_key(H->entries[i].key);
+            }
+            if (free_value != NULL) {
+                free_value(H->entries[i].value);
+            }
+        }
+    }
+    
+    ds_stats_release(&H->stats);
+    ds_free(H->dist);
+    ds_free(H->entries);
+    ds_free(H);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Untraced implementation of ds_hashmap_insert
+ */
+static ds_error_t hashmap_insert(ds_hashmap_t *H, void *key, void *value,
+                                 void **old_key, void **old_value) {
+    struct ds_hashmap_entry e;
+    size_t idx, slots, probes = 0, compares = 0;
+    
+    if (old_key != NULL) {
+        *old_key = NULL;
+    }
+    if (old_value != NULL) {
+        *old_value = NULL;
+    }
+    
+    // Validate input parameters
+    if (H == NULL || key == NULL || value == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    e.key = key;
+    e.value = value;
+    e.hash = mix_hash(H->hash(key));
+    
+    // Existing key: replace the pair in place and hand the old one back
+    idx = find_slot(H, key, e.hash, &probes, &compares);
+    ds_stats_count_compares(&H->stats, compares);
+    if (idx != H->slots) {
+        if (old_key != NULL) {
+            *old_key = H->entries[idx].key;
+        }
+        if (old_value != NULL) {
+            *old_value = H->entries[idx].value;
+        }
+        H->entries[idx].key = key;
+        H->entries[idx].value = value;
+        return DS_OK;
+    }
+    
+    // Grow before the table passes its load limit
+    if (H->size + 1 > H->grow_at) {
+        slots = slots_for(H->size + 1, H->max_load);
+        if (slots == 0 || resize(H, slots) != DS_OK) {
+            return DS_ERR_OOM;
+        }
+    }
+    
+    place_entry(H, e);
+    H->size++;
+    ds_stats_resize(&H->stats, H->size);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Insert or update a key-value pair
+ * 
+ * @param H Pointer to map
+ * @param key Pointer to key
+ * @param value Pointer to value
+ * @param old_key Receives the displaced key pointer, or NULL if none (may be NULL)
+ * @param old_value Receives the displaced value pointer, or NULL if none (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if H, key, or value is NULL, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_hashmap_insert(ds_hashmap_t *H, void *key, void *value, void **old_key, void **old_value) {
+    ds_error_t result;
+    
+    DS_TRACE_BEGIN();
+    result = hashmap_insert(H, key, value, old_key, old_value);
+    DS_TRACE_END(DS_TRACE_HASHMAP_INSERT, H);
+    
+    return result;
+}
+
+/**
+ * @brief Untraced implementation of ds_hashmap_find
+ */
+static void *hashmap_find(const ds_hashmap_t *H, const void *key) {
+    size_t idx, probes = 0, compares = 0;
+    
+    if (H == NULL || key == NULL) {
+        return NULL;
+    }
+    
+    idx = find_slot(H, key, mix_hash(H->hash(key)), &probes, &compares);
+    
+    // Counters are not part of the map's logical state
+    ds_stats_count_find(&((ds_hashmap_t *)H)->stats, 1, probes, compares);
+    return (idx != H->slots) ? H->entries[idx].value : NULL;
+}
+
+/**
+ * @brief Find the value stored for a key
+ * 
+ * @param H Pointer to map
+ * @param key Pointer to key to look up
+ * @return Pointer to value, or NULL if not found or H/key is NULL
+ */
+void *ds_hashmap_find(const ds_hashmap_t *H, const void *key) {
+    void *result;
+    
+    DS_TRACE_BEGIN();
+    result = hashmap_find(H, key);
+    DS_TRACE_END(DS_TRACE_HASHMAP_FIND, H);
+    
+    return result;
+}
+
+/**
+ * @brief Find the values stored for many keys at once
+ * 
+ * Works through the keys in groups of DS_BATCH_LANES: hash the whole
+ * group and prefetch each home slot, then probe them in order.
+ * 
+ * @param H Pointer to map
+ * @param keys Array of n keys to look up (NULL entries are not found)
+ * @param n Number of keys
+ * @param out Array receiving n results: out[i] is the value for keys[i], or NULL
+ * @return Number of keys found, 0 if H, keys, or out is NULL
+ */
+size_t ds_hashmap_find_batch(const ds_hashmap_t *H, const void *const *keys, size_t n, void **out) {
+    size_t hashes[DS_BATCH_LANES];
+    size_t mask, base, i, idx, found = 0, probes = 0, compares = 0;
+    
+    if (H == NULL || keys == NULL || out == NULL) {
+        return 0;
+    }
+    
+    mask = H->slots - 1;
+    for (base = 0; base < n; base += DS_BATCH_LANES) {
+        size_t end = (n - base < DS_BATCH_LANES) ? n : base + DS_BATCH_LANES;
+        
+        // Issue the loads for the whole group first
+        for (i = base; i < end; i++) {
+            if (keys[i] != NULL) {
+                hashes[i - base] = mix_hash(H->hash(keys[i]));
+                DS_PREFETCH(&H->dist[hashes[i - base] & mask]);
+                DS_PREFETCH(&H->entries[hashes[i - base] & mask]);
+            }
+        }
+        
+        for (i = base; i < end; i++) {
+            out[i] = NULL;
+            if (keys[i] == NULL) {
+                continue;
+            }
+            idx = find_slot(H, keys[i], hashes[i - base], &probes, &compares);
+            if (idx != H->slots) {
+                out[i] = H->entries[idx].value;
+                found++;
+            }
+        }
+    }
+    
+    ds_stats_count_find(&((ds_hashmap_t *)H)->stats, n, probes, compares);
+    return found;
+}
+
+/**
+ * @brief Untraced implementation of ds_hashmap_remove
+ */
+static ds_error_t hashmap_remove(ds_hashmap_t *H, const void *key, void **stored_key, void **stored_value) {
+    size_t mask, idx, next, probes = 0, compares = 0;
+    
+    // Validate input parameters
+    if (H == NULL || key == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    idx = find_slot(H, key, mix_hash(H->hash(key)), &probes, &compares);
+    ds_stats_count_compares(&H->stats, compares);
+    if (idx == H->slots) {
+        return DS_ERR_NOTFOUND;
+    }
+    
+    if (stored_key != NULL) {
+        *stored_key = H->entries[idx].key;
+    }
+    if (stored_value != NULL) {
+        *stored_value = H->entries[idx].value;
+    }
+    
+    // Backward-shift the rest of the probe run
+    mask = H->slots - 1;
+    next = (idx + 1) & mask;
+    while (H->dist[next] > 1) {
+        H->dist[idx] = H->dist[next] - 1;
+        H->entries[idx] = H->entries[next];
+        idx = next;
+        next = (next + 1) & mask;
+    }
+    H->dist[idx] = 0;
+    H->size--;
+    ds_stats_resize(&H->stats, H->size);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Remove a key-value pair
+ * 
+ * Shifts every following entry that is away from its home back by one
+ * slot, so no tombstones are needed.
+ * 
+ * @param H Pointer to map
+ * @param key Pointer to key to remove
+ * @param stored_key Receives the stored key pointer (may be NULL)
+ * @param stored_value Receives the stored value pointer (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if H or key is NULL, DS_ERR_NOTFOUND if not found
+ */
+ds_error_t ds_hashmap_remove(ds_hashmap_t *H, const void *key, void **stored_key, void **stored_value) {
+    ds_error_t result;
+    
+    DS_TRACE_BEGIN();
+    result = hashmap_remove(H, key, stored_key, stored_value);
+    DS_TRACE_END(DS_TRACE_HASHMAP_REMOVE, H);
+    
+    return result;
+}
+
+/**
+ * @brief Make room for at least count entries without further rehashing
+ * 
+ * @param H Pointer to map
+ * @param count Number of entries to accommodate
+ * @return DS_OK on success, DS_ERR_NULLARG if H is NULL, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_hashmap_reserve(ds_hashmap_t *H, size_t count) {
+    size_t slots;
+    
+    // Validate input parameter
+    if (H == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    if (count <= H->grow_at) {
+        return DS_OK;
+    }
+    
+    slots = slots_for(count, H->max_load);
+    if (slots == 0) {
+        return DS_ERR_OOM;
+    }
+    return resize(H, slots);
+}
+
+/**
+ * @brief Rebuild the table with a given number of slots
+ * 
+ * @param H Pointer to map
+ * @param slots Requested number of slots
+ * @return DS_OK on success, DS_ERR_NULLARG if H is NULL, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_hashmap_rehash(ds_hashmap_t *H, size_t slots) {
+    size_t target;
+    
+    // Validate input parameter
+    if (H == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    target = slots_for(H->size, H->max_load);
+    if (target == 0) {
+        return DS_ERR_OOM;
+    }
+    while (target < slots) {
+        if (target > SIZE_MAX / 2 / sizeof(struct ds_hashmap_entry)) {
+            return DS_ERR_OOM;
+        }
+        target <<= 1;
+    }
+    
+    return resize(H, target);
+}
+
+/**
+ * @brief Set the maximum load factor
+ * 
+ * @param H Pointer to map
+ * @param max_load Fraction of slots that may be occupied, in [0.1, 0.95]
+ * @return DS_OK on success, DS_ERR_NULLARG if H is NULL, DS_ERR_INVALID if out of range,
+ *         DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_hashmap_set_max_load(ds_hashmap_t *H, double max_load) {
+    // Validate input parameters
+    if (H == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    if (!(max_load >= 0.1 && max_load <= 0.95)) {
+        return DS_ERR_INVALID;
+    }
+    
+    H->max_load = max_load;
+    H->grow_at = grow_threshold(H->slots, max_load);
+    if (H->size > H->grow_at) {
+        return ds_hashmap_reserve(H, H->size);
+    }
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Get the current load factor
+ * 
+ * @param H Pointer to map
+ * @return Ratio of entries to slots, or 0 if H is NULL
+ */
+double ds_hashmap_load_factor(const ds_hashmap_t *H) {
+    return (H != NULL) ? (double)H->size / (double)H->slots : 0.0;
+}
+
+/**
+ * @brief Visit every key-value pair in unspecified order
+ * 
+ * @param H Pointer to map
+ * @param cb Callback invoked with each key, value and ctx
+ * @param ctx User context passed to cb
+ * @return DS_OK on success, DS_ERR_NULLARG if H or cb is NULL
+ */
+ds_error_t ds_hashmap_foreach(const ds_hashmap_t *H, int (*cb)(void *key, void *value, void *ctx),
+                              void *ctx) {
+    size_t i;
+    
+    // Validate input parameters
+    if (H == NULL || cb == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    for (i = 0; i < H->slots; i++) {
+        if (H->dist[i] != 0 && cb(H->entries[i].key, H->entries[i].value, ctx)) {
+            break;
+        }
+    }
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Get the number of entries in the map
+ * 
+ * @param H Pointer to map
+ * @return Number of entries in map, or 0 if H is NULL
+ */
+size_t ds_hashmap_size(const ds_hashmap_t *H) {
+    return (H != NULL) ? H->size : 0;
+}
+
+/**
+ * @brief Get the number of slots in the table
+ * 
+ * @param H Pointer to map
+ * @return Number of slots, or 0 if H is NULL
+ */
+size_t ds_hashmap_capacity(const ds_hashmap_t *H) {
+    return (H != NULL) ? H->slots : 0;
+}
+
+/**
+ * @brief Check if map is empty
+ * 
+ * @param H Pointer to map
+ * @return 1 if empty, 0 if not empty, 1 if H is NULL
+ */
+int ds_hashmap_is_empty(const ds_hashmap_t *H) {
+    return (H == NULL || H->size == 0);
+}
+
+/**
+ * @brief Get the runtime counters of a hash map
+ * 
+ * @param H Pointer to map
+ * @param out Receives the counters
+ * @return DS_OK on success, DS_ERR_NULLARG if H or out is NULL
+ */
+ds_error_t ds_hashmap_stats(const ds_hashmap_t *H, ds_stats_t *out) {
+    if (H == NULL || out == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    *out = H->stats;
+    return DS_OK;
+}
+
+/**
+ * @brief Visualize the hash map table
+ * 
+ * @param H Pointer to map
+ * @param out Output stream (e.g., stdout, stderr)
+ */
+void ds_hashmap_visualize(const ds_hashmap_t *H, FILE *out) {
+    size_t i;
+    
+    // Handle NULL parameters gracefully
+    if (out == NULL) {
+        out = stdout;  // Default to stdout
+    }
+    
+    if (H == NULL) {
+        fprintf(out, "HashMap: NULL\n");
+        return;
+    }
+    
+    // Print header, then one line per occupied slot
+    fprintf(out, "HashMap: (size: %zu, slots: %zu, load: %.2f)\n",
+            H->size, H->slots, ds_hashmap_load_factor(H));
+    for (i = 0; i < H->slots; i++) {
+        if (H->dist[i] != 0) {
+            fprintf(out, "  [%zu] probe %u: %p -> %p\n", i, (unsigned)(H->dist[i] - 1),
+                    H->entries[i].key, H->entries[i].value);
+        }
+    }
+}
@@ -0,0 +1,510 @@
+/**
+ * @file intrusive.c
+ * @brief Intrusive list, queue and stack implementation
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * This file implements containers that link ds_link_t hooks embedded in
+ * caller-owned structures. Only the container structure itself is
+ * allocated; element operations never touch the allocator.
+ */
+
+#include "ds_intrusive.h"
+
+/**
+ * @brief Internal intrusive list structure
+ * 
+ * The list is circular around a sentinel hook, so insertion and removal
+ * need no special cases for the ends.
+ */
+struct ds_ilist {
+    ds_link_t head;                /**< Sentinel; head.next is first, head.prev is last */
+    size_t size;                   /**< Number of linked hooks */
+};
+
+/**
+ * @brief Internal intrusive queue structure
+ */
+struct ds_iqueue {
+    ds_link_t *front;              /**< Pointer to front hook */
+    ds_link_t *rear;               /**< Pointer to rear hook */
+    size_t size;                   /**< Number of linked hooks */
+};
+
+/**
+ * @brief Internal intrusive stack structure
+ */
+struct ds_istack {
+    ds_link_t *top;                /**< Pointer to top hook */
+    size_t size;                   /**< Number of linked hooks */
+};
+
+/**
+ * @brief Link a hook between two adjacent hooks
+ * 
+ * @param link Hook to insert
+ * @param prev Hook that will precede link
+ * @param next Hook that will follow link
+ */
+static void link_between(ds_link_t *link, ds_link_t *prev, ds_link_t *next) {
+    link->prev = prev;
+    link->next = next;
+    prev->next = link;
+    next->prev = link;
+}
+
+/**
+ * @brief Unlink a hook from its neighbours and clear it
+ * 
+ * @param link Hook to remove
+ */
+static void unlink_hook(ds_link_t *link) {
+    link->prev->next = link->next;
+    link->next->prev = link->prev;
+    link->next = NULL;
+    link->prev = NULL;
+}
+
+/**
+ * @brief Create a new empty intrusive list
+ * 
+ * @return Pointer to new list on success, NULL on memory allocation failure
+ */
+ds_ilist_t *ds_ilist_create(void) {
+    ds_ilist_t *list = (ds_ilist_t *)ds_alloc(sizeof(struct ds_ilist));
+    
+    if (list == NULL) {
+        return NULL;
+    }
+    
+    // An empty list is a sentinel pointing at itself
+    list->head.next = &list->head;
+    list->head.prev = &list->head;
+    list->size = 0;
+    
+    return list;
+}
+
+/**
+ * @brief Free an intrusive list and optionally its elements
+ * 
+ * @param L Pointer to list to free
+ * @param free_elem Optional function to release each element (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if L is NULL
+ */
+ds_error_t ds_ilist_free(ds_ilist_t *L, void (*free_elem)(ds_link_t *)) {
+    ds_link_t *current, *next;
+    
+    // Validate input parameter
+    if (L == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    // Hooks belong to the caller, so only walk if elements need releasing
+    if (free_elem != NULL) {
+        current = L->head.next;
+        while (current != &L->head) {
+            next = current->next;
+            free_elem(current);
+            current = next;
+        }
+    }
+    
+    ds_free(L);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Link a hook at the front of the list
+ * 
+ * @param L Pointer to list
+ * @param link Pointer to unlinked hook
+ * @return DS_OK on success, DS_ERR_NULLARG if L or link is NULL
+ */
+ds_error_t ds_ilist_push_front(ds_ilist_t *L, ds_link_t *link) {
+    // Validate input parameters
+    if (L == NULL || link == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    link_between(link, &L->head, L->head.next);
+    L->size++;
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Link a hook at the back of the list
+ * 
+ * @param L Pointer to list
+ * @param link Pointer to unlinked hook
+ * @return DS_OK on success, DS_ERR_NULLARG if L or link is NULL
+ */
+ds_error_t ds_ilist_push_back(ds_ilist_t *L, ds_link_t *link) {
+    // Validate input parameters
+    if (L == NULL || link == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    link_between(link, L->head.prev, &L->head);
+    L->size++;
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Unlink and return the first hook
+ * 
+ * @param L Pointer to list
+ * @return Pointer to removed hook, or NULL if L is empty or NULL
+ */
+ds_link_t *ds_ilist_pop_front(ds_ilist_t *L) {
+    ds_link_t *link;
+    
+    if (L == NULL || L->size == 0) {
+        return NULL;
+    }
+    
+    link = L->head.next;
+    unlink_hook(link);
+    L->size--;
+    
+    return link;
+}
+
+/**
+ * @brief Unlink and return the last hook
+ * 
+ * @param L Pointer to list
+ * @return Pointer to removed hook, or NULL if L is empty or NULL
+ */
+ds_link_t *ds_ilist_pop_back(ds_ilist_t *L) {
+    ds_link_t *link;
+    
+    if (L == NULL || L->size == 0) {
+        return NULL;
+    }
+    
+    link = L->head.prev;
+    unlink_hook(link);
+    L->size--;
+    
+    return link;
+}
+
+/**
+ * @brief Unlink a hook from anywhere in the list in O(1) time
+ * 
+ * @param L Pointer to list containing link
+ * @param link Pointer to linked hook
+ * @return DS_OK on success, DS_ERR_NULLARG if L or link is NULL
+ */
+ds_error_t ds_ilist_remove(ds_ilist_t *L, ds_link_t *link) {
+    // Validate input parameters
+    if (L == NULL || link == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    unlink_hook(link);
+    L->size--;
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Get the first hook without unlinking it
+ * 
+ * @param L Pointer to list
+ * @return Pointer to first hook, or NULL if L is empty or NULL
+ */
+ds_link_t *ds_ilist_first(const ds_ilist_t *L) {
+    if (L == NULL || L->size == 0) {
+        return NULL;
+    }
+    
+    return L->head.next;
+}
+
+/**
+ * @brief Get the hook following link in the list
+ * 
+ * @param L Pointer to list containing link
+ * @param link Pointer to linked hook
+ * @return Pointer to next hook, or NULL at the end of the list
+ */
+ds_link_t *ds_ilist_next(const ds_ilist_t *L, const ds_link_t *link) {
+    if (L == NULL || link == NULL || link->next == &L->head) {
+        return NULL;
+    }
+    
+    return link->next;
+}
+
+/**
+ * @brief Get the number of elements in the list
+ * 
+ * @param L Pointer to list
+ * @return Number of elements in list, or 0 if L is NULL
+ */
+size_t ds_ilist_size(const ds_ilist_t *L) {
+    return (L != NULL) ? L->size : 0;
+}
+
+/**
+ * @brief Check if list is empty
+ * 
+ * @param L Pointer to list
+ * @return 1 if empty, 0 if not empty, 1 if L is NULL
+ */
+int ds_ilist_is_empty(const ds_ilist_t *L) {
+    return (L == NULL || L->size == 0);
+}
+
+/**
+ * @brief Create a new empty intrusive queue
+ * 
+ * @return Pointer to new queue on success, NULL on memory allocation failure
+ */
+ds_iqueue_t *ds_iqueue_create(void) {
+    ds_iqueue_t *queue = (ds_iqueue_t *)ds_alloc(sizeof(struct ds_iqueue));
+    
+    if (queue == NULL) {
+        return NULL;
+    }
+    
+    queue->front = NULL;
+    queue->rear = NULL;
+    queue->size = 0;
+    
+    return queue;
+}
+
+/**
+ * @brief Free an intrusive queue and optionally its elements
+ * 
+ * @param Q Pointer to queue to free
+ * @param free_elem Optional function to release each element (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if Q is NULL
+ */
+ds_error_t ds_iqueue_free(ds_iqueue_t *Q, void (*free_elem)(ds_link_t *)) {
+    ds_link_t *current, *next;
+    
+    // Validate input parameter
+    if (Q == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    if (free_elem != NULL) {
+        current = Q->front;
+        while (current != NULL) {
+            next = current->next;
+            free_elem(current);
+            current = next;
+        }
+    }
+    
+    ds_free(Q);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Link a hook at the rear of the queue
+ * 
+ * @param Q Pointer to queue
+ * @param link Pointer to unlinked hook
+ * @return DS_OK on success, DS_ERR_NULLARG if Q or link is NULL
+ */
+ds_error_t ds_iqueue_enqueue(ds_iqueue_t *Q, ds_link_t *link) {
+    // Validate input parameters
+    if (Q == NULL || link == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    link->next = NULL;
+    link->prev = NULL;
+    if (Q->rear == NULL) {
+        Q->front = link;
+    } else {
+        Q->rear->next = link;
+    }
+    Q->rear = link;
+    Q->size++;
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Unlink and return the hook at the front of the queue
+ * 
+ * @param Q Pointer to queue
+ * @return Pointer to removed hook, or NULL if Q is empty or NULL
+ */
+ds_link_t *ds_iqueue_dequeue(ds_iqueue_t *Q) {
+    ds_link_t *link;
+    
+    if (Q == NULL || Q->front == NULL) {
+        return NULL;
+    }
+    
+    link = Q->front;
+    Q->front = link->next;
+    if (Q->front == NULL) {
+        Q->rear = NULL;
+    }
+    link->next = NULL;
+    Q->size--;
+    
+    return link;
+}
+
+/**
+ * @brief Get the hook at the front of the queue without unlinking it
+ * 
+ * @param Q Pointer to queue
+ * @return Pointer to front hook, or NULL if Q is empty or NULL
+ */
+ds_link_t *ds_iqueue_peek(const ds_iqueue_t *Q) {
+    return (Q != NULL) ? Q->front : NULL;
+}
+
+/**
+ * @brief Get the number of elements in the queue
+ * 
+ * @param Q Pointer to queue
+ * @return Number of elements in queue, or 0 if Q is NULL
+ */
+size_t ds_iqueue_size(const ds_iqueue_t *Q) {
+    return (Q != NULL) ? Q->size : 0;
+}
+
+/**
+ * @brief Check if queue is empty
+ * 
+ * @param Q Pointer to queue
+ * @return 1 if empty, 0 if not empty, 1 if Q is NULL
+ */
+int ds_iqueue_is_empty(const ds_iqueue_t *Q) {
+    return (Q == NULL || Q->size == 0);
+}
+
+/**
+ * @brief Create a new empty intrusive stack
+ * 
+ * @return Pointer to new stack on success, NULL on memory allocation failure
+ */
+ds_istack_t *ds_istack_create(void) {
+    ds_istack_t *stack = (ds_istack_t *)ds_alloc(sizeof(struct ds_istack));
+    
+    if (stack == NULL) {
+        return NULL;
+    }
+    
+    stack->top = NULL;
+    stack->size = 0;
+    
+    return stack;
+}
+
+/**
+ * @brief Free an intrusive stack and optionally its elements
+ * 
+ * @param S Pointer to stack to free
+ * @param free_elem Optional function to release each element (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if S is NULL
+ */
+ds_error_t ds_istack_free(ds_istack_t *S, void (*free_elem)(ds_link_t *)) {
+    ds_link_t *current, *next;
+    
+    // Validate input parameter
+    if (S == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    if (free_elem != NULL) {
+        current = S->top;
+        while (current != NULL) {
+            next = current->next;
+            free_elem(current);
+            current = next;
+        }
+    }
+    
+    ds_free(S);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Link a hook on top of the stack
+ * 
+ * @param S Pointer to stack
+ * @param link Pointer to unlinked hook
+ * @return DS_OK on success, DS_ERR_NULLARG if S or link is NULL
+ */
+ds_error_t ds_istack_push(ds_istack_t *S, ds_link_t *link) {
+    // Validate input parameters
+    if (S == NULL || link == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    link->next = S->top;
+    link->prev = NULL;
+    S->top = link;
+    S->size++;
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Unlink and return the hook on top of the stack
+ * 
+ * @param S Pointer to stack
+ * @return Pointer to removed hook, or NULL if S is empty or NULL
+ */
+ds_link_t *ds_istack_pop(ds_istack_t *S) {
+    ds_link_t *link;
+    
+    if (S == NULL || S->top == NULL) {
+        return NULL;
+    }
+    
+    link = S->top;
+    S->top = link->next;
+    link->next = NULL;
+    S->size--;
+    
+    return link;
+}
+
+/**
+ * @brief Get the hook on top of the stack without unlinking it
+ * 
+ * @param S Pointer to stack
+ * @return Pointer to top hook, or NULL if S is empty or NULL
+ */
+ds_link_t *ds_istack_peek(const ds_istack_t *S) {
+    return (S != NULL) ? S->top : NULL;
+}
+
+/**
+ * @brief Get the number of elements in the stack
+ * 
+ * @param S Pointer to stack
+ * @return Number of elements in stack, or 0 if S is NULL
+ */
+size_t ds_istack_size(const ds_istack_t *S) {
+    return (S != NULL) ? S->size : 0;
+}
+
+/**
+ * @brief Check if stack is empty
+ * 
+ * @param S Pointer to stack
+ * @return 1 if empty, 0 if not empty, 1 if S is NULL
+ */
+int ds_istack_is_empty(const ds_istack_t *S) {
+    return (S == NULL || S->size == 0);
+}
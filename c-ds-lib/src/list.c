@@ -6,12 +6,30 @@
  * @date 2024
  * 
  * This file implements the linked list data structure with memory management
- * and learning mode support for educational purposes.
+ * and learning mode support for educational purposes. Lists created with
+ * ds_list_create_unrolled() store their elements in chunks of contiguous
+ * data pointers instead of one node per element.
  */
 
 #include "ds_list.h"
-#include <stdlib.h>  /* for malloc, free */
+#include "ds_internal.h"
 #include <stdio.h>   /* for printf */
+#include <string.h>  /* for memcpy, memmove */
+
+/**
+ * @brief Number of keys matched per pass of ds_list_find_batch
+ */
+#define DS_LIST_BATCH_GROUP 64
+
+/**
+ * @brief Merge bins used by ds_list_sort; bin i holds a run of 2^i nodes
+ */
+#define DS_LIST_SORT_BINS 64
+
+/**
+ * @brief Runs insertion-sorted before merging when sorting unrolled lists
+ */
+#define DS_LIST_SORT_RUN 8
 
 /**
  * @brief Internal node structure for linked list
@@ -24,91 +42,164 @@ struct ds_list_node {
     struct ds_list_node *next;     /**< Pointer to next node */
 };
 
+/**
+ * @brief Size of one unrolled-list chunk in bytes
+ * 
+ * The default of two cache lines holds 14 data pointers on 64-bit
+ * targets. Override at build time to tune.
+ */
+#ifndef DS_LIST_CHUNK_BYTES
+#define DS_LIST_CHUNK_BYTES (2 * DS_CACHE_LINE)
+#endif
+
+#define DS_LIST_CHUNK_ITEMS \
+    ((DS_LIST_CHUNK_BYTES - sizeof(void *) - 2 * sizeof(unsigned)) / sizeof(void *))
+
+/**
+ * @brief Chunk of an unrolled list
+ * 
+ * Elements occupy items[start..start + count) in list order. Chunks are
+ * never empty; a chunk that loses its last element is freed.
+ */
+struct ds_list_chunk {
+    struct ds_list_chunk *next;    /**< Pointer to next chunk */
+    unsigned start;                /**< Index of the first element */
+    unsigned count;                /**< Number of elements in chunk */
+    void *items[DS_LIST_CHUNK_ITEMS]; /**< Element data pointers */
+};
+
 /**
  * @brief Internal list structure
  * 
  * Contains head and tail pointers for efficient insertion operations.
- * Size is cached for O(1) size queries.
+ * Size is cached for O(1) size queries. In unrolled mode the elements
+ * live in the chunk chain and the node pointers stay NULL.
  */
 struct ds_list {
     struct ds_list_node *head;     /**< Pointer to first node */
     struct ds_list_node *tail;     /**< Pointer to last node */
+    struct ds_list_chunk *chunks;  /**< First chunk in unrolled mode, or NULL */
+    struct ds_list_chunk *last_chunk; /**< Last chunk in unrolled mode, or NULL */
+    int unrolled;                  /**< Non-zero for unrolled mode */
     size_t size;                   /**< Number of elements in list */
+    ds_allocator_t alloc;          /**< Allocator used for nodes */
+    ds_slab_t *pool;               /**< Private node pool, or NULL */
+    ds_stats_t stats;              /**< Runtime counters */
 };
 
 /**
- * @brief Internal flag for learning mode
- * 
- * When enabled, memory operations are logged for educational purposes.
+ * @brief Position in a front-to-back walk over either list layout
  */
-static int learning_mode = 0;
+struct list_cursor {
+    struct ds_list_node *node;     /**< Current node in linked mode */
+    struct ds_list_chunk *chunk;   /**< Current chunk in unrolled mode */
+    unsigned i;                    /**< Offset within chunk items */
+};
 
 /**
- * @brief Memory allocation wrapper with learning mode support
- * 
- * Allocates memory and optionally logs the operation when learning mode is enabled.
+ * @brief Start a walk at the first element
  * 
- * @param n Number of bytes to allocate
- * @return Pointer to allocated memory, or NULL on failure
+ * @param L Pointer to list
+ * @param c Cursor to initialize
  */
-void *ds_alloc(size_t n) {
-    void *ptr = malloc(n);
-    
-#ifdef DS_LEARNING_MODE
-    if (learning_mode) {
-        printf("[LEARN] malloc(%zu) = %p\n", n, ptr);
-    }
-#endif
-    
-    return ptr;
+static void cursor_init(const ds_list_t *L, struct list_cursor *c) {
+    c->node = L->head;
+    c->chunk = L->chunks;
+    c->i = (c->chunk != NULL) ? c->chunk->start : 0;
 }
 
 /**
- * @brief Memory deallocation wrapper with learning mode support
- * 
- * Deallocates memory and optionally logs the operation when learning mode is enabled.
+ * @brief Return the current element and advance
  * 
- * @param p Pointer to memory to deallocate
+ * @param c Pointer to cursor
+ * @return Data of the current element, or NULL at the end of the list
  */
-void ds_free(void *p) {
-#ifdef DS_LEARNING_MODE
-    if (learning_mode && p) {
-        printf("[LEARN] free(%p)\n", p);
+static void *cursor_next(struct list_cursor *c) {
+    void *data;
+    
+    if (c->node != NULL) {
+        data = c->node->data;
+        c->node = c->node->next;
+        DS_PREFETCH(c->node);
+        return data;
+    }
+    if (c->chunk == NULL) {
+        return NULL;
     }
-#endif
     
-    free(p);
+    data = c->chunk->items[c->i++];
+    if (c->i == c->chunk->start + c->chunk->count) {
+        c->chunk = c->chunk->next;
+        if (c->chunk != NULL) {
+            DS_PREFETCH(c->chunk->next);
+            c->i = c->chunk->start;
+        }
+    }
+    return data;
 }
 
 /**
- * @brief Enable or disable learning mode
+ * @brief Allocate an empty chunk
  * 
- * @param enable Non-zero to enable, zero to disable
+ * @param L Pointer to unrolled list
+ * @param start Initial start index (0 to fill forwards, DS_LIST_CHUNK_ITEMS to fill backwards)
+ * @return Pointer to new chunk, or NULL on memory failure
  */
-void ds_enable_learning_mode(int enable) {
-    learning_mode = enable;
+static struct ds_list_chunk *chunk_create(ds_list_t *L, unsigned start) {
+    struct ds_list_chunk *c;
+    
+    c = (struct ds_list_chunk *)ds_node_alloc(&L->alloc, &L->stats, sizeof(struct ds_list_chunk));
+    if (c == NULL) {
+        return NULL;
+    }
+    
+    c->next = NULL;
+    c->start = start;
+    c->count = 0;
+    return c;
 }
 
 /**
- * @brief Dump current state of all data structures
+ * @brief Unlink a chunk from the chain and free it
  * 
- * Currently not implemented - placeholder for future functionality.
+ * @param L Pointer to unrolled list
+ * @param prev Chunk before c, or NULL if c is the first chunk
+ * @param c Chunk to remove
  */
-void ds_dump_state(void) {
-    if (learning_mode) {
-        printf("[LEARN] ds_dump_state() - not yet implemented\n");
+static void chunk_unlink(ds_list_t *L, struct ds_list_chunk *prev, struct ds_list_chunk *c) {
+    if (prev == NULL) {
+        L->chunks = c->next;
+    } else {
+        prev->next = c->next;
     }
+    if (L->last_chunk == c) {
+        L->last_chunk = prev;
+    }
+    ds_node_free(&L->alloc, &L->stats, c, sizeof(struct ds_list_chunk));
 }
 
 /**
  * @brief Create a new empty linked list
  * 
  * Allocates and initializes a new linked list structure with head and tail
- * set to NULL and size set to 0.
+ * set to NULL and size set to 0. Nodes use the library-level allocator.
  * 
  * @return Pointer to new list on success, NULL on memory allocation failure
  */
 ds_list_t *ds_list_create(void) {
+    return ds_list_create_with_allocator(NULL);
+}
+
+/**
+ * @brief Create a new empty linked list with a custom node allocator
+ * 
+ * The list structure itself comes from ds_alloc; every node is obtained
+ * from the given allocator.
+ * 
+ * @param a Allocator for nodes, or NULL for the library-level allocator
+ * @return Pointer to new list on success, NULL on invalid allocator or memory failure
+ */
+ds_list_t *ds_list_create_with_allocator(const ds_allocator_t *a) {
     ds_list_t *list;
     
     // Allocate memory for list structure
@@ -117,11 +208,70 @@ ds_list_t *ds_list_create(void) {
         return NULL;
     }
     
+    // Capture the node allocator
+    if (ds_allocator_init(&list->alloc, a) != DS_OK) {
+        ds_free(list);
+        return NULL;
+    }
+    
     // Initialize list to empty state
     list->head = NULL;
     list->tail = NULL;
+    list->chunks = NULL;
+    list->last_chunk = NULL;
+    list->unrolled = 0;
     list->size = 0;
+    list->pool = NULL;
+    ds_stats_init(&list->stats);
+    
+    return list;
+}
+
+/**
+ * @brief Create a new empty linked list backed by a private node pool
+ * 
+ * Nodes are served from a slab pool owned by the list, which is released
+ * in one pass by ds_list_free.
+ * 
+ * @return Pointer to new list on success, NULL on memory allocation failure
+ */
+ds_list_t *ds_list_create_pooled(void) {
+    ds_list_t *list;
+    ds_slab_t *pool;
+    ds_allocator_t a;
+    
+    // Create the node pool first
+    pool = ds_slab_create(sizeof(struct ds_list_node), DS_SLAB_DEFAULT_OBJS);
+    if (pool == NULL) {
+        return NULL;
+    }
+    
+    a = ds_slab_allocator(pool);
+    list = ds_list_create_with_allocator(&a);
+    if (list == NULL) {
+        ds_slab_free(pool);
+        return NULL;
+    }
+    
+    list->pool = pool;
+    return list;
+}
+
+/**
+ * @brief Create a new empty unrolled list
+ * 
+ * Elements are packed into fixed-size chunks of DS_LIST_CHUNK_ITEMS data
+ * pointers, so the list needs far fewer allocations and a scan touches
+ * consecutive memory instead of following one pointer per element.
+ * 
+ * @return Pointer to new list on success, NULL on memory allocation failure
+ */
+ds_list_t *ds_list_create_unrolled(void) {
+    ds_list_t *list = ds_list_create_with_allocator(NULL);
     
+    if (list != NULL) {
+        list->unrolled = 1;
+    }
     return list;
 }
 
@@ -143,38 +293,54 @@ ds_error_t ds_list_free(ds_list_t *L, void (*free_data)(void *)) {
         return DS_ERR_NULLARG;
     }
     
-    // Iterate through all nodes and free them
-    current = L->head;
-    while (current != NULL) {
-        next = current->next;
+    // Unrolled mode: hand each element to free_data, then drop the chunk
+    while (L->chunks != NULL && (ds_allocator_frees(&L->alloc) || free_data != NULL)) {
+        struct ds_list_chunk *chunk = L->chunks;
         
-        // Call user's free function for data if provided
-        if (free_data != NULL && current->data != NULL) {
-            free_data(current->data);
+        if (free_data != NULL) {
+            for (unsigned i = chunk->start; i < chunk->start + chunk->count; i++) {
+                free_data(chunk->items[i]);
+            }
         }
-        
-        // Free the node structure
-        ds_free(current);
-        current = next;
+        L->chunks = chunk->next;
+        ds_node_free(&L->alloc, &L->stats, chunk, sizeof(struct ds_list_chunk));
+    }
+    
+    // Pooled and arena nodes are released wholesale, so only walk if data needs freeing
+    if ((L->pool == NULL && ds_allocator_frees(&L->alloc)) || free_data != NULL) {
+        current = L->head;
+        while (current != NULL) {
+            next = current->next;
+            
+            // Call user's free function for data if provided
+            if (free_data != NULL && current->data != NULL) {
+                free_data(current->data);
+            }
+            
+            // Free the node structure
+            if (L->pool == NULL) {
+                ds_node_free(&L->alloc, &L->stats, current, sizeof(struct ds_list_node));
+            }
+            current = next;
+        }
+    }
+    
+    // Release the node pool in one pass
+    if (L->pool != NULL) {
+        ds_slab_free(L->pool);
     }
     
     // Free the list structure
+    ds_stats_release(&L->stats);
     ds_free(L);
     
     return DS_OK;
 }
 
 /**
- * @brief Insert element at the front of the list
- * 
- * Adds a new element to the beginning of the list. Updates head pointer
- * and increments size. For empty lists, also updates tail pointer.
- * 
- * @param L Pointer to list
- * @param data Pointer to data to insert
- * @return DS_OK on success, DS_ERR_NULLARG if L or data is NULL, DS_ERR_OOM on memory failure
+ * @brief Untraced implementation of ds_list_push_front
  */
-ds_error_t ds_list_push_front(ds_list_t *L, void *data) {
+static ds_error_t list_push_front(ds_list_t *L, void *data) {
     struct ds_list_node *new_node;
     
     // Validate input parameters
@@ -182,8 +348,33 @@ ds_error_t ds_list_push_front(ds_list_t *L, void *data) {
         return DS_ERR_NULLARG;
     }
     
+    // Unrolled mode: fill the first chunk backwards, shifting or adding one as needed
+    if (L->unrolled) {
+        struct ds_list_chunk *chunk = L->chunks;
+        
+        if (chunk != NULL && chunk->start == 0 && chunk->count < DS_LIST_CHUNK_ITEMS) {
+            chunk->start = (unsigned)DS_LIST_CHUNK_ITEMS - chunk->count;
+            memmove(chunk->items + chunk->start, chunk->items, chunk->count * sizeof(void *));
+        } else if (chunk == NULL || chunk->start == 0) {
+            chunk = chunk_create(L, (unsigned)DS_LIST_CHUNK_ITEMS);
+            if (chunk == NULL) {
+                return DS_ERR_OOM;
+            }
+            chunk->next = L->chunks;
+            L->chunks = chunk;
+            if (L->last_chunk == NULL) {
+                L->last_chunk = chunk;
+            }
+        }
+        chunk->items[--chunk->start] = data;
+        chunk->count++;
+        L->size++;
+        ds_stats_resize(&L->stats, L->size);
+        return DS_OK;
+    }
+    
     // Allocate memory for new node
-    new_node = (struct ds_list_node *)ds_alloc(sizeof(struct ds_list_node));
+    new_node = (struct ds_list_node *)ds_node_alloc(&L->alloc, &L->stats, sizeof(struct ds_list_node));
     if (new_node == NULL) {
         return DS_ERR_OOM;
     }
@@ -199,21 +390,35 @@ ds_error_t ds_list_push_front(ds_list_t *L, void *data) {
         L->tail = new_node;
     }
     L->size++;
+    ds_stats_resize(&L->stats, L->size);
     
     return DS_OK;
 }
 
 /**
- * @brief Insert element at the back of the list
+ * @brief Insert element at the front of the list
  * 
- * Adds a new element to the end of the list. Updates tail pointer
- * and increments size. For empty lists, also updates head pointer.
+ * Adds a new element to the beginning of the list. Updates head pointer
+ * and increments size. For empty lists, also updates tail pointer.
  * 
  * @param L Pointer to list
  * @param data Pointer to data to insert
  * @return DS_OK on success, DS_ERR_NULLARG if L or data is NULL, DS_ERR_OOM on memory failure
  */
-ds_error_t ds_list_push_back(ds_list_t *L, void *data) {
+ds_error_t ds_list_push_front(ds_list_t *L, void *data) {
+    ds_error_t result;
+    
+    DS_TRACE_BEGIN();
+    result = list_push_front(L, data);
+    DS_TRACE_END(DS_TRACE_LIST_PUSH_FRONT, L);
+    
+    return result;
+}
+
+/**
+ * @brief Untraced implementation of ds_list_push_back
+ */
+static ds_error_t list_push_back(ds_list_t *L, void *data) {
     struct ds_list_node *new_node;
     
     // Validate input parameters
@@ -221,8 +426,33 @@ ds_error_t ds_list_push_back(ds_list_t *L, void *data) {
         return DS_ERR_NULLARG;
     }
     
+    // Unrolled mode: fill the last chunk forwards, shifting or adding one as needed
+    if (L->unrolled) {
+        struct ds_list_chunk *chunk = L->last_chunk;
+        
+        if (chunk != NULL && chunk->start + chunk->count == DS_LIST_CHUNK_ITEMS && chunk->start > 0) {
+            memmove(chunk->items, chunk->items + chunk->start, chunk->count * sizeof(void *));
+            chunk->start = 0;
+        } else if (chunk == NULL || chunk->start + chunk->count == DS_LIST_CHUNK_ITEMS) {
+            chunk = chunk_create(L, 0);
+            if (chunk == NULL) {
+                return DS_ERR_OOM;
+            }
+            if (L->last_chunk == NULL) {
+                L->chunks = chunk;
+            } else {
+                L->last_chunk->next = chunk;
+            }
+            L->last_chunk = chunk;
+        }
+        chunk->items[chunk->start + chunk->count++] = data;
+        L->size++;
+        ds_stats_resize(&L->stats, L->size);
+        return DS_OK;
+    }
+    
     // Allocate memory for new node
-    new_node = (struct ds_list_node *)ds_alloc(sizeof(struct ds_list_node));
+    new_node = (struct ds_list_node *)ds_node_alloc(&L->alloc, &L->stats, sizeof(struct ds_list_node));
     if (new_node == NULL) {
         return DS_ERR_OOM;
     }
@@ -242,21 +472,175 @@ ds_error_t ds_list_push_back(ds_list_t *L, void *data) {
         L->tail = new_node;
     }
     L->size++;
+    ds_stats_resize(&L->stats, L->size);
     
     return DS_OK;
 }
 
 /**
- * @brief Remove and return element from the front of the list
+ * @brief Insert element at the back of the list
  * 
- * Removes the first element from the list and returns its data.
- * Updates head pointer and decrements size. If list becomes empty,
- * also updates tail pointer to NULL.
+ * Adds a new element to the end of the list. Updates tail pointer
+ * and increments size. For empty lists, also updates head pointer.
  * 
  * @param L Pointer to list
- * @return Pointer to data of removed element, or NULL if list is empty or L is NULL
+ * @param data Pointer to data to insert
+ * @return DS_OK on success, DS_ERR_NULLARG if L or data is NULL, DS_ERR_OOM on memory failure
  */
-void *ds_list_pop_front(ds_list_t *L) {
+ds_error_t ds_list_push_back(ds_list_t *L, void *data) {
+    ds_error_t result;
+    
+    DS_TRACE_BEGIN();
+    result = list_push_back(L, data);
+    DS_TRACE_END(DS_TRACE_LIST_PUSH_BACK, L);
+    
+    return result;
+}
+
+/**
+ * @brief Append items to an unrolled list
+ * 
+ * Tops up the last chunk and fills new chunks to capacity. All chunks are
+ * allocated before the list is touched, so a failure leaves it unchanged.
+ * 
+ * @param L Pointer to unrolled list
+ * @param items Array of n non-NULL data pointers
+ * @param n Number of items, greater than 0
+ * @return DS_OK on success, DS_ERR_OOM on memory failure
+ */
+static ds_error_t push_back_n_unrolled(ds_list_t *L, void *const *items, size_t n) {
+    struct ds_list_chunk *first = NULL, *last = NULL, *chunk = L->last_chunk;
+    size_t room = 0, i = 0, take;
+    
+    // Make the free slots of the last chunk contiguous at its end
+    if (chunk != NULL) {
+        if (chunk->start > 0) {
+            memmove(chunk->items, chunk->items + chunk->start, chunk->count * sizeof(void *));
+            chunk->start = 0;
+        }
+        room = DS_LIST_CHUNK_ITEMS - chunk->count;
+    }
+    
+    // Build the chain of new chunks
+    while (room < n) {
+        struct ds_list_chunk *c = chunk_create(L, 0);
+        
+        if (c == NULL) {
+            while (first != NULL) {
+                c = first->next;
+                ds_node_free(&L->alloc, &L->stats, first, sizeof(struct ds_list_chunk));
+                first = c;
+            }
+            return DS_ERR_OOM;
+        }
+        if (last == NULL) {
+            first = c;
+        } else {
+            last->next = c;
+        }
+        last = c;
+        room += DS_LIST_CHUNK_ITEMS;
+    }
+    
+    // Top up the old last chunk, then splice the chain and fill it
+    if (chunk != NULL) {
+        take = DS_LIST_CHUNK_ITEMS - chunk->count;
+        take = (take < n) ? take : n;
+        memcpy(chunk->items + chunk->count, items, take * sizeof(void *));
+        chunk->count += (unsigned)take;
+        i = take;
+        chunk->next = first;
+    } else {
+        L->chunks = first;
+    }
+    for (chunk = first; chunk != NULL; chunk = chunk->next) {
+        take = (n - i < DS_LIST_CHUNK_ITEMS) ? n - i : DS_LIST_CHUNK_ITEMS;
+        memcpy(chunk->items, items + i, take * sizeof(void *));
+        chunk->count = (unsigned)take;
+        i += take;
+        L->last_chunk = chunk;
+    }
+    
+    L->size += n;
+    ds_stats_resize(&L->stats, L->size);
+    return DS_OK;
+}
+
+/**
+ * @brief Add several elements to the end of the list
+ * 
+ * Builds the new nodes as a private chain first and splices it onto the
+ * tail only once every allocation has succeeded.
+ * 
+ * @param L Pointer to list
+ * @param items Array of n data pointers
+ * @param n Number of items
+ * @return DS_OK on success, DS_ERR_NULLARG if L or items (with n > 0) or any item is NULL,
+ *         DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_list_push_back_n(ds_list_t *L, void *const *items, size_t n) {
+    struct ds_list_node *first = NULL, *last = NULL, *node;
+    size_t i;
+    
+    // Validate input parameters
+    if (L == NULL || (items == NULL && n > 0)) {
+        return DS_ERR_NULLARG;
+    }
+    for (i = 0; i < n; i++) {
+        if (items[i] == NULL) {
+            return DS_ERR_NULLARG;
+        }
+    }
+    
+    if (n == 0) {
+        return DS_OK;
+    }
+    
+    // Unrolled mode: allocate the extra chunks first, then copy the items in
+    if (L->unrolled) {
+        return push_back_n_unrolled(L, items, n);
+    }
+    
+    // Allocate and link the chain
+    for (i = 0; i < n; i++) {
+        node = (struct ds_list_node *)ds_node_alloc(&L->alloc, &L->stats, sizeof(struct ds_list_node));
+        if (node == NULL) {
+            // Roll back the partial chain
+            while (first != NULL) {
+                node = first->next;
+                ds_node_free(&L->alloc, &L->stats, first, sizeof(struct ds_list_node));
+                first = node;
+            }
+            return DS_ERR_OOM;
+        }
+        
+        node->data = items[i];
+        node->next = NULL;
+        if (last == NULL) {
+            first = node;
+        } else {
+            last->next = node;
+        }
+        last = node;
+    }
+    
+    // Splice the chain onto the tail
+    if (L->tail == NULL) {
+        L->head = first;
+    } else {
+        L->tail->next = first;
+    }
+    L->tail = last;
+    L->size += n;
+    ds_stats_resize(&L->stats, L->size);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Untraced implementation of ds_list_pop_front
+ */
+static void *list_pop_front(ds_list_t *L) {
     struct ds_list_node *old_head;
     void *data;
     
@@ -265,6 +649,22 @@ void *ds_list_pop_front(ds_list_t *L) {
         return NULL;
     }
     
+    // Unrolled mode: take the first item of the first chunk
+    if (L->unrolled) {
+        struct ds_list_chunk *chunk = L->chunks;
+        
+        if (chunk == NULL) {
+            return NULL;
+        }
+        data = chunk->items[chunk->start++];
+        if (--chunk->count == 0) {
+            chunk_unlink(L, NULL, chunk);
+        }
+        L->size--;
+        ds_stats_resize(&L->stats, L->size);
+        return data;
+    }
+    
     // Check if list is empty
     if (L->head == NULL) {
         return NULL;
@@ -281,37 +681,117 @@ void *ds_list_pop_front(ds_list_t *L) {
         L->tail = NULL;
     }
     L->size--;
+    ds_stats_resize(&L->stats, L->size);
     
     // Free the old head node
-    ds_free(old_head);
+    ds_node_free(&L->alloc, &L->stats, old_head, sizeof(struct ds_list_node));
     
     return data;
 }
 
 /**
- * @brief Remove element matching comparison criteria
+ * @brief Remove and return element from the front of the list
  * 
- * Searches for the first element that matches the comparison function
- * and removes it from the list. Updates size and pointer connections.
+ * Removes the first element from the list and returns its data.
+ * Updates head pointer and decrements size. If list becomes empty,
+ * also updates tail pointer to NULL.
  * 
  * @param L Pointer to list
+ * @return Pointer to data of removed element, or NULL if list is empty or L is NULL
+ */
+void *ds_list_pop_front(ds_list_t *L) {
+    void *result;
+    
+    DS_TRACE_BEGIN();
+    result = list_pop_front(L);
+    DS_TRACE_END(DS_TRACE_LIST_POP_FRONT, L);
+    
+    return result;
+}
+
+/**
+ * @brief Remove the first matching element of an unrolled list
+ * 
+ * The gap is closed inside the chunk. A chunk that ends up empty is
+ * freed, and one that fits together with its successor absorbs it, so
+ * chunks stay at least half full on average after removals.
+ * 
+ * @param L Pointer to unrolled list
  * @param data Pointer to data to match against
  * @param cmp Comparison function returning 0 for match
- * @return DS_OK on success, DS_ERR_NULLARG if L, data, or cmp is NULL, DS_ERR_NOTFOUND if no match
+ * @return DS_OK on success, DS_ERR_NOTFOUND if no match
  */
-ds_error_t ds_list_remove(ds_list_t *L, void *data, int (*cmp)(const void *, const void *)) {
+static ds_error_t remove_unrolled(ds_list_t *L, const void *data, int (*cmp)(const void *, const void *)) {
+    struct ds_list_chunk *chunk, *prev = NULL, *next;
+    size_t compares = 0;
+    unsigned i, end;
+    
+    for (chunk = L->chunks; chunk != NULL; prev = chunk, chunk = chunk->next) {
+        end = chunk->start + chunk->count;
+        for (i = chunk->start; i < end; i++) {
+            compares++;
+            if (cmp(chunk->items[i], data) == 0) {
+                break;
+            }
+        }
+        if (i < end) {
+            break;
+        }
+    }
+    ds_stats_count_compares(&L->stats, compares);
+    if (chunk == NULL) {
+        return DS_ERR_NOTFOUND;
+    }
+    
+    memmove(chunk->items + i, chunk->items + i + 1, (end - i - 1) * sizeof(void *));
+    chunk->count--;
+    L->size--;
+    ds_stats_resize(&L->stats, L->size);
+    
+    if (chunk->count == 0) {
+        chunk_unlink(L, prev, chunk);
+        return DS_OK;
+    }
+    
+    // Merge with the next chunk when both fit into one
+    next = chunk->next;
+    if (next != NULL && chunk->count + next->count <= DS_LIST_CHUNK_ITEMS) {
+        if (chunk->start + chunk->count + next->count > DS_LIST_CHUNK_ITEMS) {
+            memmove(chunk->items, chunk->items + chunk->start, chunk->count * sizeof(void *));
+            chunk->start = 0;
+        }
+        memcpy(chunk->items + chunk->start + chunk->count, next->items + next->start,
+               next->count * sizeof(void *));
+        chunk->count += next->count;
+        chunk_unlink(L, chunk, next);
+    }
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Untraced implementation of ds_list_remove
+ */
+static ds_error_t list_remove(ds_list_t *L, void *data, int (*cmp)(const void *, const void *)) {
     struct ds_list_node *current, *previous;
+    size_t compares = 0;
     
     // Validate input parameters
     if (L == NULL || data == NULL || cmp == NULL) {
         return DS_ERR_NULLARG;
     }
     
+    // Unrolled mode: close the gap inside the chunk
+    if (L->unrolled) {
+        return remove_unrolled(L, data, cmp);
+    }
+    
     // Search for matching node
     current = L->head;
     previous = NULL;
     
     while (current != NULL) {
+        compares++;
         if (cmp(current->data, data) == 0) {
             // Found match - remove the node
             if (previous == NULL) {
@@ -329,7 +809,10 @@ ds_error_t ds_list_remove(ds_list_t *L, void *data, int (*cmp)(const void *, con
             }
             
             L->size--;
-            ds_free(current);
+            
+            ds_stats_resize(&L->stats, L->size);
+            ds_node_free(&L->alloc, &L->stats, current, sizeof(struct ds_list_node));
+            ds_stats_count_compares(&L->stats, compares);
             return DS_OK;
         }
         
@@ -338,43 +821,512 @@ ds_error_t ds_list_remove(ds_list_t *L, void *data, int (*cmp)(const void *, con
     }
     
     // No match found
+    ds_stats_count_compares(&L->stats, compares);
     return DS_ERR_NOTFOUND;
 }
 
 /**
- * @brief Find element matching comparison criteria
+ * @brief Remove element matching comparison criteria
  * 
  * Searches for the first element that matches the comparison function
- * when compared against the target data. The comparison function should
- * return 0 when the element matches the target.
+ * and removes it from the list. Updates size and pointer connections.
  * 
  * @param L Pointer to list
- * @param target Pointer to data to match against
+ * @param data Pointer to data to match against
  * @param cmp Comparison function returning 0 for match
- * @return Pointer to matching data, or NULL if not found or L/cmp/target is NULL
+ * @return DS_OK on success, DS_ERR_NULLARG if L, data, or cmp is NULL, DS_ERR_NOTFOUND if no match
  */
-void *ds_list_find(ds_list_t *L, void *target, int (*cmp)(const void *, const void *)) {
+ds_error_t ds_list_remove(ds_list_t *L, void *data, int (*cmp)(const void *, const void *)) {
+    ds_error_t result;
+    
+    DS_TRACE_BEGIN();
+    result = list_remove(L, data, cmp);
+    DS_TRACE_END(DS_TRACE_LIST_REMOVE, L);
+    
+    return result;
+}
+
+/**
+ * @brief Untraced implementation of ds_list_find
+ */
+static void *list_find(ds_list_t *L, void *target, int (*cmp)(const void *, const void *)) {
     struct ds_list_node *current;
+    size_t depth = 0;
     
     // Validate input parameters
     if (L == NULL || target == NULL || cmp == NULL) {
         return NULL;
     }
     
+    // Unrolled mode: scan each chunk's contiguous items
+    for (struct ds_list_chunk *chunk = L->chunks; chunk != NULL; chunk = chunk->next) {
+        unsigned end = chunk->start + chunk->count;
+        
+        DS_PREFETCH(chunk->next);
+        for (unsigned i = chunk->start; i < end; i++) {
+            depth++;
+            if (cmp(chunk->items[i], target) == 0) {
+                ds_stats_count_find(&L->stats, 1, depth, depth);
+                return chunk->items[i];
+            }
+        }
+    }
+    
     // Search through list
     current = L->head;
     while (current != NULL) {
+        depth++;
         if (cmp(current->data, target) == 0) {
             // Found match
+            ds_stats_count_find(&L->stats, 1, depth, depth);
             return current->data;
         }
         current = current->next;
     }
     
     // No match found
+    ds_stats_count_find(&L->stats, 1, depth, depth);
     return NULL;
 }
 
+/**
+ * @brief Find element matching comparison criteria
+ * 
+ * Searches for the first element that matches the comparison function
+ * when compared against the target data. The comparison function should
+ * return 0 when the element matches the target.
+ * 
+ * @param L Pointer to list
+ * @param target Pointer to data to match against
+ * @param cmp Comparison function returning 0 for match
+ * @return Pointer to matching data, or NULL if not found or L/cmp/target is NULL
+ */
+void *ds_list_find(ds_list_t *L, void *target, int (*cmp)(const void *, const void *)) {
+    void *result;
+    
+    DS_TRACE_BEGIN();
+    result = list_find(L, target, cmp);
+    DS_TRACE_END(DS_TRACE_LIST_FIND, L);
+    
+    return result;
+}
+
+/**
+ * @brief Find many elements in one pass over the list
+ * 
+ * Keys are handled in groups of DS_LIST_BATCH_GROUP. For each group the list is
+ * walked once, each node is compared against every key still pending,
+ * and the walk stops as soon as all keys of the group are matched.
+ * 
+ * @param L Pointer to list
+ * @param keys Array of n keys to find (NULL entries are not found)
+ * @param n Number of keys
+ * @param out Array receiving n results: out[i] is the first element matching keys[i], or NULL
+ * @param cmp Comparison function returning 0 for match
+ * @return Number of keys found, 0 if L, keys, out, or cmp is NULL
+ */
+size_t ds_list_find_batch(ds_list_t *L, void *const *keys, size_t n, void **out,
+                          int (*cmp)(const void *, const void *)) {
+    size_t pending[DS_LIST_BATCH_GROUP];
+    struct list_cursor cur;
+    void *data;
+    size_t base, i, npending, found = 0, depth = 0, compares = 0;
+    
+    // Validate input parameters
+    if (L == NULL || keys == NULL || out == NULL || cmp == NULL) {
+        return 0;
+    }
+    
+    for (base = 0; base < n; base += DS_LIST_BATCH_GROUP) {
+        // Collect the group's searchable keys
+        npending = 0;
+        for (i = base; i < n && i < base + DS_LIST_BATCH_GROUP; i++) {
+            out[i] = NULL;
+            if (keys[i] != NULL) {
+                pending[npending++] = i;
+            }
+        }
+        
+        cursor_init(L, &cur);
+        while (npending > 0 && (data = cursor_next(&cur)) != NULL) {
+            depth++;
+            compares += npending;
+            
+            // Matched keys are swapped out of the pending set
+            i = 0;
+            while (i < npending) {
+                if (cmp(data, keys[pending[i]]) == 0) {
+                    out[pending[i]] = data;
+                    found++;
+                    pending[i] = pending[--npending];
+                } else {
+                    i++;
+                }
+            }
+        }
+    }
+    
+    ds_stats_count_find(&L->stats, n, depth, compares);
+    return found;
+}
+
+/**
+ * @brief Check that nodes of one list may be handed to another
+ * 
+ * Both lists must use the same layout and hand nodes back to the same
+ * allocator. Pooled lists own their pool, so their nodes never move.
+ * 
+ * @param A Pointer to receiving list
+ * @param B Pointer to giving list
+ * @return Non-zero if B's nodes or chunks can be linked into A
+ */
+static int lists_compatible(const ds_list_t *A, const ds_list_t *B) {
+    return A->unrolled == B->unrolled && A->pool == NULL && B->pool == NULL &&
+           A->alloc.alloc == B->alloc.alloc && A->alloc.free == B->alloc.free &&
+           A->alloc.ctx == B->alloc.ctx;
+}
+
+/**
+ * @brief Merge two sorted node chains
+ * 
+ * Takes from a on ties, so a merge of an earlier and a later run is
+ * stable.
+ * 
+ * @param a First sorted chain (earlier elements)
+ * @param b Second sorted chain (later elements)
+ * @param cmp Comparison function
+ * @param compares Incremented by the comparator calls made
+ * @param a_last Set to non-zero if the merged chain ends with a's tail (may be NULL)
+ * @return Head of the merged chain
+ */
+static struct ds_list_node *merge_nodes(struct ds_list_node *a, struct ds_list_node *b,
+                                        int (*cmp)(const void *, const void *), size_t *compares,
+                                        int *a_last) {
+    struct ds_list_node head, *tail = &head;
+    
+    while (a != NULL && b != NULL) {
+        (*compares)++;
+        if (cmp(b->data, a->data) < 0) {
+            tail->next = b;
+            b = b->next;
+        } else {
+            tail->next = a;
+            a = a->next;
+        }
+        tail = tail->next;
+    }
+    tail->next = (a != NULL) ? a : b;
+    if (a_last != NULL) {
+        *a_last = (a != NULL);
+    }
+    
+    return head.next;
+}
+
+/**
+ * @brief Stable merge sort of an array of data pointers
+ * 
+ * Insertion-sorts runs of DS_LIST_SORT_RUN, then merges runs back and
+ * forth between items and tmp. The result always ends up in items.
+ * 
+ * @param items Array of n data pointers
+ * @param tmp Scratch array of n pointers
+ * @param n Number of items
+ * @param cmp Comparison function
+ * @param compares Incremented by the comparator calls made
+ */
+static void sort_pointers(void **items, void **tmp, size_t n,
+                          int (*cmp)(const void *, const void *), size_t *compares) {
+    void **src = items, **dst = tmp, **swap;
+    size_t width, lo, i, j;
+    
+    for (lo = 0; lo < n; lo += DS_LIST_SORT_RUN) {
+        size_t hi = (n - lo < DS_LIST_SORT_RUN) ? n : lo + DS_LIST_SORT_RUN;
+        
+        for (i = lo + 1; i < hi; i++) {
+            void *item = items[i];
+            
+            for (j = i; j > lo; j--) {
+                (*compares)++;
+                if (cmp(item, items[j - 1]) >= 0) {
+                    break;
+                }
+                items[j] = items[j - 1];
+            }
+            items[j] = item;
+        }
+    }
+    
+    for (width = DS_LIST_SORT_RUN; width < n; width *= 2) {
+        for (lo = 0; lo < n; lo += 2 * width) {
+            size_t mid = (n - lo < width) ? n : lo + width;
+            size_t hi = (n - mid < width) ? n : mid + width;
+            size_t k = lo;
+            
+            i = lo;
+            j = mid;
+            while (i < mid && j < hi) {
+                (*compares)++;
+                dst[k++] = (cmp(src[j], src[i]) < 0) ? src[j++] : src[i++];
+            }
+            while (i < mid) {
+                dst[k++] = src[i++];
+            }
+            while (j < hi) {
+                dst[k++] = src[j++];
+            }
+        }
+        swap = src;
+        src = dst;
+        dst = swap;
+    }
+    
+    if (src != items) {
+        memcpy(items, src, n * sizeof(void *));
+    }
+}
+
+/**
+ * @brief Write elements back into the chunk chain in order
+ * 
+ * Keeps every chunk's start and count, so the chain must hold exactly
+ * as many slots as there are items.
+ * 
+ * @param L Pointer to unrolled list
+ * @param items Elements in their new order
+ */
+static void chunks_scatter(ds_list_t *L, void *const *items) {
+    struct ds_list_chunk *c;
+    size_t k = 0;
+    
+    for (c = L->chunks; c != NULL; c = c->next) {
+        memcpy(c->items + c->start, items + k, c->count * sizeof(void *));
+        k += c->count;
+    }
+}
+
+/**
+ * @brief Sort a list in place
+ * 
+ * Linked lists are sorted by relinking their nodes: every node starts as
+ * a run of one and is merged into bins[i], which holds a sorted run of
+ * 2^i nodes or nothing, like incrementing a binary counter. Unrolled
+ * lists are copied into a temporary array, sorted there and written back
+ * into the same chunks.
+ * 
+ * @param L Pointer to list
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return DS_OK on success, DS_ERR_NULLARG if L or cmp is NULL,
+ *         DS_ERR_OOM if an unrolled list's temporary array cannot be allocated
+ */
+ds_error_t ds_list_sort(ds_list_t *L, int (*cmp)(const void *, const void *)) {
+    struct ds_list_node *bins[DS_LIST_SORT_BINS] = { NULL };
+    struct ds_list_node *run, *next;
+    size_t compares = 0, i;
+    
+    // Validate input parameters
+    if (L == NULL || cmp == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    if (L->size < 2) {
+        return DS_OK;
+    }
+    
+    if (L->unrolled) {
+        struct list_cursor cur;
+        void **items = (void **)ds_alloc(2 * L->size * sizeof(void *));
+        
+        if (items == NULL) {
+            return DS_ERR_OOM;
+        }
+        
+        cursor_init(L, &cur);
+        for (i = 0; i < L->size; i++) {
+            items[i] = cursor_next(&cur);
+        }
+        sort_pointers(items, items + L->size, L->size, cmp, &compares);
+        chunks_scatter(L, items);
+        
+        ds_free(items);
+        ds_stats_count_compares(&L->stats, compares);
+        return DS_OK;
+    }
+    
+    // Carry each node up through the bins; earlier runs sit in higher bins
+    for (run = L->head; run != NULL; run = next) {
+        next = run->next;
+        run->next = NULL;
+        for (i = 0; i < DS_LIST_SORT_BINS - 1 && bins[i] != NULL; i++) {
+            run = merge_nodes(bins[i], run, cmp, &compares, NULL);
+            bins[i] = NULL;
+        }
+        bins[i] = (bins[i] != NULL) ? merge_nodes(bins[i], run, cmp, &compares, NULL) : run;
+    }
+    
+    run = NULL;
+    for (i = 0; i < DS_LIST_SORT_BINS; i++) {
+        if (bins[i] != NULL) {
+            run = (run != NULL) ? merge_nodes(bins[i], run, cmp, &compares, NULL) : bins[i];
+        }
+    }
+    
+    L->head = run;
+    while (run->next != NULL) {
+        run = run->next;
+    }
+    L->tail = run;
+    
+    ds_stats_count_compares(&L->stats, compares);
+    return DS_OK;
+}
+
+/**
+ * @brief Merge a sorted list into another sorted list
+ * 
+ * Linked lists are merged by relinking nodes, so no memory is allocated
+ * or freed. Unrolled lists append B's chunks to A's chain and rewrite
+ * the combined slots through a temporary array of merged elements.
+ * 
+ * @param A Pointer to sorted list receiving all elements
+ * @param B Pointer to sorted list to empty into A
+ * @param cmp Comparison function A and B are sorted by
+ * @return DS_OK on success, DS_ERR_NULLARG if A, B, or cmp is NULL,
+ *         DS_ERR_INVALID if A and B are the same or incompatible lists,
+ *         DS_ERR_OOM if an unrolled merge's temporary array cannot be allocated
+ */
+ds_error_t ds_list_merge(ds_list_t *A, ds_list_t *B, int (*cmp)(const void *, const void *)) {
+    size_t compares = 0, total;
+    
+    // Validate input parameters
+    if (A == NULL || B == NULL || cmp == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    if (A == B || !lists_compatible(A, B)) {
+        return DS_ERR_INVALID;
+    }
+    if (B->size == 0) {
+        return DS_OK;
+    }
+    
+    total = A->size + B->size;
+    if (A->unrolled) {
+        struct list_cursor ca, cb;
+        void **items = (void **)ds_alloc(total * sizeof(void *));
+        void *a, *b;
+        size_t k = 0;
+        
+        if (items == NULL) {
+            return DS_ERR_OOM;
+        }
+        
+        cursor_init(A, &ca);
+        cursor_init(B, &cb);
+        a = cursor_next(&ca);
+        b = cursor_next(&cb);
+        while (a != NULL && b != NULL) {
+            compares++;
+            if (cmp(b, a) < 0) {
+                items[k++] = b;
+                b = cursor_next(&cb);
+            } else {
+                items[k++] = a;
+                a = cursor_next(&ca);
+            }
+        }
+        for (; a != NULL; a = cursor_next(&ca)) {
+            items[k++] = a;
+        }
+        for (; b != NULL; b = cursor_next(&cb)) {
+            items[k++] = b;
+        }
+        
+        // Hand B's chunks to A, then refill the joint chain in merged order
+        if (A->last_chunk != NULL) {
+            A->last_chunk->next = B->chunks;
+        } else {
+            A->chunks = B->chunks;
+        }
+        A->last_chunk = B->last_chunk;
+        B->chunks = NULL;
+        B->last_chunk = NULL;
+        chunks_scatter(A, items);
+        ds_free(items);
+    } else {
+        int a_last;
+        
+        A->head = merge_nodes(A->head, B->head, cmp, &compares, &a_last);
+        
+        // The merged chain ends with the tail of whichever list ran out last
+        if (!a_last) {
+            A->tail = B->tail;
+        }
+        B->head = NULL;
+        B->tail = NULL;
+    }
+    
+    ds_stats_transfer(&A->stats, &B->stats, B->stats.allocs - B->stats.frees, B->stats.bytes_live);
+    A->size = total;
+    B->size = 0;
+    ds_stats_resize(&A->stats, total);
+    ds_stats_resize(&B->stats, 0);
+    ds_stats_count_compares(&A->stats, compares);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Append all elements of one list to another
+ * 
+ * Links B's node or chunk chain behind A's tail, so the cost does not
+ * depend on the length of either list.
+ * 
+ * @param A Pointer to list receiving all elements
+ * @param B Pointer to list to empty into A
+ * @return DS_OK on success, DS_ERR_NULLARG if A or B is NULL,
+ *         DS_ERR_INVALID if A and B are the same or incompatible lists
+ */
+ds_error_t ds_list_concat(ds_list_t *A, ds_list_t *B) {
+    // Validate input parameters
+    if (A == NULL || B == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    if (A == B || !lists_compatible(A, B)) {
+        return DS_ERR_INVALID;
+    }
+    if (B->size == 0) {
+        return DS_OK;
+    }
+    
+    if (A->unrolled) {
+        if (A->last_chunk != NULL) {
+            A->last_chunk->next = B->chunks;
+        } else {
+            A->chunks = B->chunks;
+        }
+        A->last_chunk = B->last_chunk;
+        B->chunks = NULL;
+        B->last_chunk = NULL;
+    } else {
+        if (A->tail != NULL) {
+            A->tail->next = B->head;
+        } else {
+            A->head = B->head;
+        }
+        A->tail = B->tail;
+        B->head = NULL;
+        B->tail = NULL;
+    }
+    
+    // The nodes now belong to A, so their allocations move with them
+    ds_stats_transfer(&A->stats, &B->stats, B->stats.allocs - B->stats.frees, B->stats.bytes_live);
+    A->size += B->size;
+    B->size = 0;
+    ds_stats_resize(&A->stats, A->size);
+    ds_stats_resize(&B->stats, 0);
+    
+    return DS_OK;
+}
+
 /**
  * @brief Get the number of elements in the list
  * 
@@ -392,6 +1344,56 @@ size_t ds_list_size(const ds_list_t *L) {
     return L->size;
 }
 
+/**
+ * @brief Yield the next element of a front-to-back snapshot walk
+ * 
+ * @param state Pointer to a list_cursor, advanced on each call
+ * @return Data of the current element
+ */
+static void *snapshot_next(void *state) {
+    return cursor_next((struct list_cursor *)state);
+}
+
+/**
+ * @brief Save a list as a memory-mappable snapshot
+ * 
+ * @param L Pointer to list
+ * @param path Destination file
+ * @param ser Serializer for element payloads
+ * @param ctx User context passed to ser
+ * @return DS_OK on success, DS_ERR_NULLARG if L, path, or ser is NULL,
+ *         DS_ERR_INVALID if ser fails, DS_ERR_OOM or DS_ERR_IO on failure
+ */
+ds_error_t ds_list_save(const ds_list_t *L, const char *path,
+                        size_t (*ser)(const void *data, void *buf, size_t cap, void *ctx),
+                        void *ctx) {
+    struct list_cursor cur;
+    
+    // Validate input parameters
+    if (L == NULL || path == NULL || ser == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    cursor_init(L, &cur);
+    return ds_snapshot_write(path, DS_SNAPSHOT_LIST, L->size, snapshot_next, &cur, ser, ctx);
+}
+
+/**
+ * @brief Get the runtime counters of a list
+ * 
+ * @param L Pointer to list
+ * @param out Receives the counters
+ * @return DS_OK on success, DS_ERR_NULLARG if L or out is NULL
+ */
+ds_error_t ds_list_stats(const ds_list_t *L, ds_stats_t *out) {
+    if (L == NULL || out == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    *out = L->stats;
+    return DS_OK;
+}
+
 /**
  * @brief Visualize the list structure
  * 
@@ -403,6 +1405,8 @@ size_t ds_list_size(const ds_list_t *L) {
  */
 void ds_list_visualize(const ds_list_t *L, FILE *out) {
     struct ds_list_node *current;
+    struct list_cursor cur;
+    void *data;
     int count = 0;
     
     // Handle NULL parameters gracefully
@@ -415,7 +1419,7 @@ void ds_list_visualize(const ds_list_t *L, FILE *out) {
         return;
     }
     
-    if (L->head == NULL) {
+    if (L->size == 0) {
         fprintf(out, "List: [empty] (size: %zu)\n", L->size);
         return;
     }
@@ -423,6 +1427,24 @@ void ds_list_visualize(const ds_list_t *L, FILE *out) {
     // Print list header
     fprintf(out, "List: (size: %zu)\n", L->size);
     
+    // Unrolled mode: walk the chunks with a cursor
+    if (L->unrolled) {
+        cursor_init(L, &cur);
+        while ((data = cursor_next(&cur)) != NULL) {
+            fprintf(out, "  [%d]: %d", count, *(int*)data);
+            if (count == 0) {
+                fprintf(out, " [HEAD]");
+            }
+            if ((size_t)count == L->size - 1) {
+                fprintf(out, " [TAIL]");
+            }
+            fprintf(out, "\n");
+            count++;
+        }
+        fprintf(out, "\n");
+        return;
+    }
+    
     // Print each node
     current = L->head;
     while (current != NULL) {
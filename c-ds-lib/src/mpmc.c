@@ -0,0 +1,372 @@
+/**
+ * @file mpmc.c
+ * @brief Bounded lock-free multi-producer/multi-consumer queue implementation
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * This file implements Dmitry Vyukov's bounded MPMC queue with C11
+ * atomics. Every slot holds a sequence number telling whether it is
+ * ready to be written (seq == pos) or read (seq == pos + 1) for the
+ * position pos that maps onto it. Producers claim positions by advancing
+ * enqueue_pos, consumers by advancing dequeue_pos, and each side then
+ * publishes the slot to the other with a release store of its sequence.
+ * 
+ * Built only with `make CONCURRENT=1`.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ds_mpmc.h"
+#include "ds_internal.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <sched.h>
+
+/**
+ * @brief Spins before a waiting thread starts yielding the CPU
+ */
+#define DS_MPMC_SPIN_LIMIT 64
+
+/**
+ * @brief Queue slot with its sequence number
+ */
+struct ds_mpmc_cell {
+    atomic_size_t seq;             /**< Position this slot is ready for */
+    void *data;                    /**< Stored data pointer */
+};
+
+/**
+ * @brief Internal MPMC queue structure
+ * 
+ * The two position counters are written by different sets of threads,
+ * so they are padded onto separate cache lines to avoid false sharing.
+ */
+struct ds_mpmc_queue {
+    struct ds_mpmc_cell *cells;    /**< Slot array of mask + 1 entries */
+    size_t mask;                   /**< Capacity minus one (capacity is a power of two) */
+    char pad0[DS_CACHE_LINE - sizeof(void *) - sizeof(size_t)];
+    atomic_size_t enqueue_pos;     /**< Next position to be claimed by a producer */
+    char pad1[DS_CACHE_LINE - sizeof(atomic_size_t)];
+    atomic_size_t dequeue_pos;     /**< Next position to be claimed by a consumer */
+    char pad2[DS_CACHE_LINE - sizeof(atomic_size_t)];
+};
+
+/**
+ * @brief Wait a little before retrying a contended or blocked operation
+ * 
+ * @param spins Counter of attempts so far, updated by the call
+ */
+static void backoff(unsigned *spins) {
+    if (*spins < DS_MPMC_SPIN_LIMIT) {
+        (*spins)++;
+    } else {
+        sched_yield();
+    }
+}
+
+/**
+ * @brief Create a new empty MPMC queue
+ * 
+ * @param capacity Minimum number of elements the queue can hold
+ * @return Pointer to new queue on success, NULL if capacity is 0 or on memory failure
+ */
+ds_mpmc_queue_t *ds_mpmc_queue_create(size_t capacity) {
+    ds_mpmc_queue_t *queue;
+    size_t cap = 2, i;
+    
+    if (capacity == 0 || capacity > (SIZE_MAX / 2) / sizeof(struct ds_mpmc_cell)) {
+        return NULL;
+    }
+    
+    // Round up to a power of two so positions map to slots with a mask
+    while (cap < capacity) {
+        cap <<= 1;
+    }
+    
+    queue = (ds_mpmc_queue_t *)ds_alloc(sizeof(struct ds_mpmc_queue));
+    if (queue == NULL) {
+        return NULL;
+    }
+    
+    queue->cells = (struct ds_mpmc_cell *)ds_alloc(cap * sizeof(struct ds_mpmc_cell));
+    if (queue->cells == NULL) {
+        ds_free(queue);
+        return NULL;
+    }
+    
+    // Slot i is initially ready to be written for position i
+    for (i = 0; i < cap; i++) {
+        atomic_init(&queue->cells[i].seq, i);
+        queue->cells[i].data = NULL;
+    }
+    queue->mask = cap - 1;
+    atomic_init(&queue->enqueue_pos, 0);
+    atomic_init(&queue->dequeue_pos, 0);
+    
+    return queue;
+}
+
+/**
+ * @brief Free an MPMC queue and optionally its remaining data
+ * 
+ * @param Q Pointer to queue to free
+ * @param free_data Optional function to free element data (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if Q is NULL
+ */
+ds_error_t ds_mpmc_queue_free(ds_mpmc_queue_t *Q, void (*free_data)(void *)) {
+    void *data;
+    
+    // Validate input parameter
+    if (Q == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    // Drain remaining elements if their data needs freeing
+    if (free_data != NULL) {
+        while (ds_mpmc_queue_try_dequeue(Q, &data) == DS_OK) {
+            free_data(data);
+        }
+    }
+    
+    ds_free(Q->cells);
+    ds_free(Q);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Add element to the rear of the queue if a slot is free
+ * 
+ * @param Q Pointer to queue
+ * @param data Pointer to data to enqueue
+ * @return DS_OK on success, DS_ERR_NULLARG if Q or data is NULL, DS_ERR_FULL if the queue is full
+ */
+ds_error_t ds_mpmc_queue_try_enqueue(ds_mpmc_queue_t *Q, void *data) {
+    struct ds_mpmc_cell *cell;
+    size_t pos, seq;
+    intptr_t diff;
+    
+    // Validate input parameters
+    if (Q == NULL || data == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    pos = atomic_load_explicit(&Q->enqueue_pos, memory_order_relaxed);
+    for (;;) {
+        cell = &Q->cells[pos & Q->mask];
+        seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        diff = (intptr_t)seq - (intptr_t)pos;
+        
+        if (diff == 0) {
+            // Slot is free for this position; try to claim it
+            if (atomic_compare_exchange_weak_explicit(&Q->enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Slot still holds the element from one lap ago
+            return DS_ERR_FULL;
+        } else {
+            // Another producer claimed this position first
+            pos = atomic_load_explicit(&Q->enqueue_pos, memory_order_relaxed);
+        }
+    }
+    
+    // Publish the element to consumers
+    cell->data = data;
+    atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Add element to the rear of the queue, waiting while it is full
+ * 
+ * @param Q Pointer to queue
+ * @param data Pointer to data to enqueue
+ * @return DS_OK on success, DS_ERR_NULLARG if Q or data is NULL
+ */
+ds_error_t ds_mpmc_queue_enqueue(ds_mpmc_queue_t *Q, void *data) {
+    unsigned spins = 0;
+    ds_error_t err;
+    
+    while ((err = ds_mpmc_queue_try_enqueue(Q, data)) == DS_ERR_FULL) {
+        backoff(&spins);
+    }
+    
+    return err;
+}
+
+/**
+ * @brief Remove element from the front of the queue if one is available
+ * 
+ * @param Q Pointer to queue
+ * @param out Receives the dequeued data pointer
+ * @return DS_OK on success, DS_ERR_NULLARG if Q or out is NULL, DS_ERR_EMPTY if the queue is empty
+ */
+ds_error_t ds_mpmc_queue_try_dequeue(ds_mpmc_queue_t *Q, void **out) {
+    struct ds_mpmc_cell *cell;
+    size_t pos, seq;
+    intptr_t diff;
+    
+    // Validate input parameters
+    if (Q == NULL || out == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    pos = atomic_load_explicit(&Q->dequeue_pos, memory_order_relaxed);
+    for (;;) {
+        cell = &Q->cells[pos & Q->mask];
+        seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        diff = (intptr_t)seq - (intptr_t)(pos + 1);
+        
+        if (diff == 0) {
+            // Slot holds the element for this position; try to claim it
+            if (atomic_compare_exchange_weak_explicit(&Q->dequeue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // No producer has published this position yet
+            return DS_ERR_EMPTY;
+        } else {
+            // Another consumer claimed this position first
+            pos = atomic_load_explicit(&Q->dequeue_pos, memory_order_relaxed);
+        }
+    }
+    
+    // Hand the slot back to producers for the next lap
+    *out = cell->data;
+    atomic_store_explicit(&cell->seq, pos + Q->mask + 1, memory_order_release);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Remove element from the front of the queue, waiting while it is empty
+ * 
+ * @param Q Pointer to queue
+ * @return Pointer to dequeued data, or NULL if Q is NULL
+ */
+void *ds_mpmc_queue_dequeue(ds_mpmc_queue_t *Q) {
+    unsigned spins = 0;
+    void *data = NULL;
+    
+    if (Q == NULL) {
+        return NULL;
+    }
+    
+    while (ds_mpmc_queue_try_dequeue(Q, &data) == DS_ERR_EMPTY) {
+        backoff(&spins);
+    }
+    
+    return data;
+}
+
+/**
+ * @brief Remove up to n elements from the front of the queue
+ * 
+ * Counts how many consecutive slots from dequeue_pos are already
+ * published, then claims all of them with one compare-and-swap.
+ * 
+ * @param Q Pointer to queue
+ * @param out Array receiving up to n data pointers in FIFO order
+ * @param n Maximum number of elements to dequeue
+ * @return Number of elements dequeued (0 if empty or Q/out is NULL)
+ */
+size_t ds_mpmc_queue_dequeue_n(ds_mpmc_queue_t *Q, void **out, size_t n) {
+    struct ds_mpmc_cell *cell;
+    size_t pos, seq, ready, i;
+    intptr_t diff;
+    
+    if (Q == NULL || out == NULL || n == 0) {
+        return 0;
+    }
+    
+    pos = atomic_load_explicit(&Q->dequeue_pos, memory_order_relaxed);
+    for (;;) {
+        // Count the run of published slots starting at pos
+        ready = 0;
+        diff = 0;
+        while (ready < n && ready <= Q->mask) {
+            cell = &Q->cells[(pos + ready) & Q->mask];
+            seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+            diff = (intptr_t)seq - (intptr_t)(pos + ready + 1);
+            if (diff != 0) {
+                break;
+            }
+            ready++;
+        }
+        
+        if (ready == 0) {
+            if (diff < 0) {
+                return 0;
+            }
+            
+            // Our view of dequeue_pos was stale
+            pos = atomic_load_explicit(&Q->dequeue_pos, memory_order_relaxed);
+            continue;
+        }
+        
+        if (atomic_compare_exchange_weak_explicit(&Q->dequeue_pos, &pos, pos + ready,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+            break;
+        }
+    }
+    
+    // Copy out the claimed run and release its slots in order
+    for (i = 0; i < ready; i++) {
+        cell = &Q->cells[(pos + i) & Q->mask];
+        out[i] = cell->data;
+        atomic_store_explicit(&cell->seq, pos + i + Q->mask + 1, memory_order_release);
+    }
+    
+    return ready;
+}
+
+/**
+ * @brief Get the number of elements in the queue
+ * 
+ * @param Q Pointer to queue
+ * @return Number of elements in queue, or 0 if Q is NULL
+ */
+size_t ds_mpmc_queue_size(const ds_mpmc_queue_t *Q) {
+    size_t head, tail;
+    
+    if (Q == NULL) {
+        return 0;
+    }
+    
+    // Counters are read separately, so clamp the snapshot to a sane range
+    head = atomic_load_explicit((atomic_size_t *)&Q->dequeue_pos, memory_order_acquire);
+    tail = atomic_load_explicit((atomic_size_t *)&Q->enqueue_pos, memory_order_acquire);
+    if (tail <= head) {
+        return 0;
+    }
+    
+    return (tail - head > Q->mask + 1) ? Q->mask + 1 : tail - head;
+}
+
+/**
+ * @brief Check if queue is empty
+ * 
+ * @param Q Pointer to queue
+ * @return 1 if empty, 0 if not empty, 1 if Q is NULL
+ */
+int ds_mpmc_queue_is_empty(const ds_mpmc_queue_t *Q) {
+    return ds_mpmc_queue_size(Q) == 0;
+}
+
+/**
+ * @brief Get the fixed capacity of the queue
+ * 
+ * @param Q Pointer to queue
+ * @return Number of slots, or 0 if Q is NULL
+ */
+size_t ds_mpmc_queue_capacity(const ds_mpmc_queue_t *Q) {
+    return (Q != NULL) ? Q->mask + 1 : 0;
+}
@@ -0,0 +1,623 @@
+/**
+ * @file pool.c
+ * @brief Work-stealing thread pool implementation
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * This file implements a fixed-size thread pool. Every worker owns a
+ * growable ring of tasks guarded by its own mutex: the owner pushes and
+ * pops at the back, so nested tasks run depth first while their data is
+ * still in cache, and idle threads steal from the front, taking the
+ * oldest and usually largest piece of work. Threads outside the pool
+ * spread their tasks over the workers round-robin.
+ * 
+ * Idle workers sleep on a pool-wide condition variable. The counts of
+ * queued and unfinished tasks are atomics, so the pool mutex is only
+ * taken to sleep and to wake sleepers.
+ * 
+ * Built only with `make CONCURRENT=1`.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ds_pool.h"
+#include "ds_internal.h"
+#include <stdatomic.h>
+#include <string.h>  /* for memcpy */
+#include <pthread.h>
+#include <unistd.h>  /* for sysconf */
+
+/**
+ * @brief Initial task capacity of a worker's ring
+ */
+#define DS_POOL_RING_MIN 64
+
+/**
+ * @brief Slices below this many items are sorted without the pool
+ */
+#define DS_POOL_SORT_SERIAL 4096
+
+/**
+ * @brief Runs sorted by insertion before the first merge pass
+ */
+#define DS_POOL_SORT_RUN 16
+
+/**
+ * @brief Queued task
+ */
+struct ds_pool_task {
+    void (*fn)(void *arg);         /**< Task function */
+    void *arg;                     /**< Argument passed to fn */
+};
+
+/**
+ * @brief Worker thread and its task ring
+ * 
+ * Tasks occupy ring[head .. head + count) modulo cap.
+ */
+struct ds_pool_worker {
+    pthread_mutex_t lock;          /**< Guards the ring */
+    struct ds_pool_task *ring;     /**< Task ring */
+    size_t head;                   /**< Index of the oldest task */
+    size_t count;                  /**< Number of queued tasks */
+    size_t cap;                    /**< Ring capacity (power of two) */
+    ds_pool_t *pool;               /**< Owning pool */
+    pthread_t thread;              /**< Worker thread */
+};
+
+/**
+ * @brief Internal thread pool structure
+ */
+struct ds_pool {
+    struct ds_pool_worker *workers;  /**< Array of nthreads workers */
+    size_t nthreads;               /**< Number of workers */
+    atomic_size_t queued;          /**< Tasks waiting in some ring */
+    atomic_size_t pending;         /**< Tasks submitted and not yet finished */
+    atomic_size_t next;            /**< Round-robin cursor for outside submits */
+    pthread_mutex_t lock;          /**< Guards sleeping and stop */
+    pthread_cond_t work_cv;        /**< Signalled when a task is queued */
+    pthread_cond_t done_cv;        /**< Broadcast when pending drops to zero */
+    int stop;                      /**< Set when the workers should exit */
+};
+
+/**
+ * @brief Worker the calling thread belongs to, or NULL outside any pool
+ */
+static _Thread_local struct ds_pool_worker *current_worker = NULL;
+
+/**
+ * @brief Take a task from a worker's ring
+ * 
+ * @param w Worker to take from
+ * @param back Non-zero to take the newest task (owner), zero for the oldest (thief)
+ * @param out Receives the task
+ * @return 1 if a task was taken, 0 if the ring was empty
+ */
+static int ring_take(struct ds_pool_worker *w, int back, struct ds_pool_task *out) {
+    int taken = 0;
+    
+    pthread_mutex_lock(&w->lock);
+    if (w->count > 0) {
+        if (back) {
+            *out = w->ring[(w->head + w->count - 1) & (w->cap - 1)];
+        } else {
+            *out = w->ring[w->head];
+            w->head = (w->head + 1) & (w->cap - 1);
+        }
+        w->count--;
+        taken = 1;
+    }
+    pthread_mutex_unlock(&w->lock);
+    
+    return taken;
+}
+
+/**
+ * @brief Find a task to run, own ring first, then by stealing
+ * 
+ * @param P Pointer to pool
+ * @param self Calling worker, or NULL for a thread outside the pool
+ * @param out Receives the task
+ * @return 1 if a task was found, 0 if every ring was empty
+ */
+static int pool_take(ds_pool_t *P, struct ds_pool_worker *self, struct ds_pool_task *out) {
+    size_t start, i;
+    
+    if (atomic_load(&P->queued) == 0) {
+        return 0;
+    }
+    
+    if (self != NULL && ring_take(self, 1, out)) {
+        atomic_fetch_sub(&P->queued, 1);
+        return 1;
+    }
+    
+    // Steal starting after ourselves so thieves spread over the victims
+    start = (self != NULL) ? (size_t)(self - P->workers) + 1 : 0;
+    for (i = 0; i < P->nthreads; i++) {
+        struct ds_pool_worker *victim = &P->workers[(start + i) % P->nthreads];
+        
+        if (victim != self && ring_take(victim, 0, out)) {
+            atomic_fetch_sub(&P->queued, 1);
+            return 1;
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief Run a task and retire it
+ * 
+ * @param P Pointer to pool
+ * @param task Task to run
+ */
+static void pool_run(ds_pool_t *P, const struct ds_pool_task *task) {
+    task->fn(task->arg);
+    
+    if (atomic_fetch_sub(&P->pending, 1) == 1) {
+        pthread_mutex_lock(&P->lock);
+        pthread_cond_broadcast(&P->done_cv);
+        pthread_mutex_unlock(&P->lock);
+    }
+}
+
+/**
+ * @brief Worker thread main loop
+ * 
+ * @param arg Pointer to the worker
+ * @return NULL
+ */
+static void *worker_main(void *arg) {
+    struct ds_pool_worker *self = (struct ds_pool_worker *)arg;
+    ds_pool_t *P = self->pool;
+    struct ds_pool_task task;
+    
+    current_worker = self;
+    for (;;) {
+        if (pool_take(P, self, &task)) {
+            pool_run(P, &task);
+            continue;
+        }
+        
+        pthread_mutex_lock(&P->lock);
+        while (atomic_load(&P->queued) == 0 && !P->stop) {
+            pthread_cond_wait(&P->work_cv, &P->lock);
+        }
+        if (P->stop && atomic_load(&P->queued) == 0) {
+            pthread_mutex_unlock(&P->lock);
+            break;
+        }
+        pthread_mutex_unlock(&P->lock);
+    }
+    current_worker = NULL;
+    
+    return NULL;
+}
+
+/**
+ * @brief Stop and join the started workers, then release the pool
+ * 
+ * @param P Pointer to pool
+ * @param started Number of workers whose thread was started
+ */
+static void pool_shutdown(ds_pool_t *P, size_t started) {
+    size_t i;
+    
+    pthread_mutex_lock(&P->lock);
+    P->stop = 1;
+    pthread_cond_broadcast(&P->work_cv);
+    pthread_mutex_unlock(&P->lock);
+    
+    for (i = 0; i < started; i++) {
+        pthread_join(P->workers[i].thread, NULL);
+    }
+    for (i = 0; i < P->nthreads; i++) {
+        pthread_mutex_destroy(&P->workers[i].lock);
+        ds_free(P->workers[i].ring);
+    }
+    
+    pthread_cond_destroy(&P->done_cv);
+    pthread_cond_destroy(&P->work_cv);
+    pthread_mutex_destroy(&P->lock);
+    ds_free(P->workers);
+    ds_free(P);
+}
+
+/**
+ * @brief Create a thread pool
+ * 
+ * @param nthreads Number of worker threads, or 0 for one per online CPU
+ * @return Pointer to new pool on success, NULL on memory or thread creation failure
+ */
+ds_pool_t *ds_pool_create(size_t nthreads) {
+    ds_pool_t *P;
+    size_t i;
+    
+    if (nthreads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        
+        nthreads = (cpus > 0) ? (size_t)cpus : 1;
+    }
+    
+    P = (ds_pool_t *)ds_alloc(sizeof(ds_pool_t));
+    if (P == NULL) {
+        return NULL;
+    }
+    
+    P->workers = (struct ds_pool_worker *)ds_alloc(nthreads * sizeof(struct ds_pool_worker));
+    if (P->workers == NULL) {
+        ds_free(P);
+        return NULL;
+    }
+    
+    P->nthreads = nthreads;
+    atomic_init(&P->queued, 0);
+    atomic_init(&P->pending, 0);
+    atomic_init(&P->next, 0);
+    pthread_mutex_init(&P->lock, NULL);
+    pthread_cond_init(&P->work_cv, NULL);
+    pthread_cond_init(&P->done_cv, NULL);
+    P->stop = 0;
+    
+    // Set up every ring before any thread can start stealing
+    for (i = 0; i < nthreads; i++) {
+        struct ds_pool_worker *w = &P->workers[i];
+        
+        pthread_mutex_init(&w->lock, NULL);
+        w->ring = (struct ds_pool_task *)ds_alloc(DS_POOL_RING_MIN * sizeof(struct ds_pool_task));
+        w->head = 0;
+        w->count = 0;
+        w->cap = DS_POOL_RING_MIN;
+        w->pool = P;
+        if (w->ring == NULL) {
+            P->nthreads = i + 1;
+            pool_shutdown(P, 0);
+            return NULL;
+        }
+    }
+    
+    for (i = 0; i < nthreads; i++) {
+        if (pthread_create(&P->workers[i].thread, NULL, worker_main, &P->workers[i]) != 0) {
+            pool_shutdown(P, i);
+            return NULL;
+        }
+    }
+    
+    return P;
+}
+
+/**
+ * @brief Wait for all tasks, then stop and free the pool
+ * 
+ * @param P Pointer to pool to free
+ * @return DS_OK on success, DS_ERR_NULLARG if P is NULL
+ */
+ds_error_t ds_pool_free(ds_pool_t *P) {
+    if (P == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    ds_pool_wait(P);
+    pool_shutdown(P, P->nthreads);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Queue a task for execution
+ * 
+ * Pushes onto the calling worker's own ring when called from a task of
+ * P, otherwise onto the next worker in round-robin order. A full ring
+ * doubles in place.
+ * 
+ * @param P Pointer to pool
+ * @param fn Task function
+ * @param arg Argument passed to fn
+ * @return DS_OK on success, DS_ERR_NULLARG if P or fn is NULL, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_pool_submit(ds_pool_t *P, void (*fn)(void *arg), void *arg) {
+    struct ds_pool_worker *w;
+    
+    if (P == NULL || fn == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    w = current_worker;
+    if (w == NULL || w->pool != P) {
+        w = &P->workers[atomic_fetch_add(&P->next, 1) % P->nthreads];
+    }
+    
+    pthread_mutex_lock(&w->lock);
+    if (w->count == w->cap) {
+        struct ds_pool_task *ring;
+        size_t i;
+        
+        ring = (struct ds_pool_task *)ds_alloc(2 * w->cap * sizeof(struct ds_pool_task));
+        if (ring == NULL) {
+            pthread_mutex_unlock(&w->lock);
+            return DS_ERR_OOM;
+        }
+        
+        // Unwrap the old ring to the front of the new one
+        for (i = 0; i < w->count; i++) {
+            ring[i] = w->ring[(w->head + i) & (w->cap - 1)];
+        }
+        ds_free(w->ring);
+        w->ring = ring;
+        w->head = 0;
+        w->cap *= 2;
+    }
+    w->ring[(w->head + w->count) & (w->cap - 1)].fn = fn;
+    w->ring[(w->head + w->count) & (w->cap - 1)].arg = arg;
+    w->count++;
+    
+    // Count the task before it becomes visible as queued, so it can never
+    // finish while pending still reads zero
+    atomic_fetch_add(&P->pending, 1);
+    atomic_fetch_add(&P->queued, 1);
+    pthread_mutex_unlock(&w->lock);
+    
+    pthread_mutex_lock(&P->lock);
+    pthread_cond_signal(&P->work_cv);
+    pthread_mutex_unlock(&P->lock);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Wait until every submitted task has finished
+ * 
+ * The caller steals and runs tasks while any are queued and sleeps only
+ * once the remaining tasks are all running on workers.
+ * 
+ * @param P Pointer to pool
+ * @return DS_OK on success, DS_ERR_NULLARG if P is NULL
+ */
+ds_error_t ds_pool_wait(ds_pool_t *P) {
+    struct ds_pool_task task;
+    
+    if (P == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    for (;;) {
+        int done;
+        
+        if (pool_take(P, NULL, &task)) {
+            pool_run(P, &task);
+            continue;
+        }
+        
+        pthread_mutex_lock(&P->lock);
+        while (atomic_load(&P->pending) > 0 && atomic_load(&P->queued) == 0) {
+            pthread_cond_wait(&P->done_cv, &P->lock);
+        }
+        done = (atomic_load(&P->pending) == 0);
+        pthread_mutex_unlock(&P->lock);
+        if (done) {
+            break;
+        }
+    }
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Get the number of worker threads
+ * 
+ * @param P Pointer to pool
+ * @return Number of workers, or 0 if P is NULL
+ */
+size_t ds_pool_threads(const ds_pool_t *P) {
+    return (P != NULL) ? P->nthreads : 0;
+}
+
+/**
+ * @brief Merge two adjacent sorted slices
+ * 
+ * Takes from the left slice on ties, which keeps the sort stable.
+ * 
+ * @param src Source array holding src[lo, mid) and src[mid, hi) sorted
+ * @param dst Destination array receiving dst[lo, hi)
+ * @param lo First index
+ * @param mid Start of the right slice
+ * @param hi One past the last index
+ * @param cmp Comparison function
+ */
+static void merge_runs(void **src, void **dst, size_t lo, size_t mid, size_t hi,
+                       int (*cmp)(const void *, const void *)) {
+    size_t i = lo, j = mid, k = lo;
+    
+    while (i < mid && j < hi) {
+        dst[k++] = (cmp(src[j], src[i]) < 0) ? src[j++] : src[i++];
+    }
+    while (i < mid) {
+        dst[k++] = src[i++];
+    }
+    while (j < hi) {
+        dst[k++] = src[j++];
+    }
+}
+
+/**
+ * @brief Sort a slice with bottom-up merge sort
+ * 
+ * Insertion-sorts short runs, then merges them back and forth between
+ * items and tmp. The sorted slice always ends up in items.
+ * 
+ * @param items Array holding the slice
+ * @param tmp Scratch array of the same length as items
+ * @param lo First index of the slice
+ * @param hi One past the last index of the slice
+ * @param cmp Comparison function
+ */
+static void sort_slice(void **items, void **tmp, size_t lo, size_t hi,
+                       int (*cmp)(const void *, const void *)) {
+    void **src = items, **dst = tmp;
+    size_t width, i;
+    
+    for (i = lo; i < hi; i += DS_POOL_SORT_RUN) {
+        size_t end = (hi - i < DS_POOL_SORT_RUN) ? hi : i + DS_POOL_SORT_RUN;
+        size_t j;
+        
+        for (j = i + 1; j < end; j++) {
+            void *item = items[j];
+            size_t k = j;
+            
+            while (k > i && cmp(item, items[k - 1]) < 0) {
+                items[k] = items[k - 1];
+                k--;
+            }
+            items[k] = item;
+        }
+    }
+    
+    for (width = DS_POOL_SORT_RUN; width < hi - lo; width *= 2) {
+        void **swap;
+        
+        for (i = lo; i < hi; i += 2 * width) {
+            size_t mid = (hi - i < width) ? hi : i + width;
+            size_t end = (hi - mid < width) ? hi : mid + width;
+            
+            merge_runs(src, dst, i, mid, end, cmp);
+        }
+        swap = src;
+        src = dst;
+        dst = swap;
+    }
+    
+    if (src != items) {
+        memcpy(items + lo, src + lo, (hi - lo) * sizeof(void *));
+    }
+}
+
+/**
+ * @brief One slice sort or merge step of ds_pool_sort
+ */
+struct sort_job {
+    void **src;                    /**< Array to read (sort: items) */
+    void **dst;                    /**< Array to write (sort: scratch) */
+    size_t lo, mid, hi;            /**< Slice bounds; mid is unused for slice sorts */
+    int (*cmp)(const void *, const void *);  /**< Comparison function */
+};
+
+/**
+ * @brief Task body sorting one slice in place
+ * 
+ * @param arg Pointer to a sort_job
+ */
+static void sort_task(void *arg) {
+    struct sort_job *job = (struct sort_job *)arg;
+    
+    sort_slice(job->src, job->dst, job->lo, job->hi, job->cmp);
+}
+
+/**
+ * @brief Task body merging two adjacent slices
+ * 
+ * @param arg Pointer to a sort_job
+ */
+static void merge_task(void *arg) {
+    struct sort_job *job = (struct sort_job *)arg;
+    
+    merge_runs(job->src, job->dst, job->lo, job->mid, job->hi, job->cmp);
+}
+
+/**
+ * @brief Sort an array of data pointers in parallel
+ * 
+ * Cuts the array into about four slices per worker, sorts the slices as
+ * separate tasks and then merges neighbours pairwise, each round
+ * ping-ponging between items and a scratch array. A task that cannot be
+ * queued runs on the calling thread instead.
+ * 
+ * @param P Pointer to pool
+ * @param items Array of n data pointers, sorted in place
+ * @param n Number of items
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return DS_OK on success, DS_ERR_NULLARG if P or cmp is NULL or items is NULL
+ *         while n > 0, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_pool_sort(ds_pool_t *P, void **items, size_t n, int (*cmp)(const void *, const void *)) {
+    struct sort_job *jobs;
+    void **tmp, **src, **dst;
+    size_t slices, width, count, i;
+    
+    if (P == NULL || cmp == NULL || (items == NULL && n > 0)) {
+        return DS_ERR_NULLARG;
+    }
+    if (n < 2) {
+        return DS_OK;
+    }
+    
+    tmp = (void **)ds_alloc(n * sizeof(void *));
+    if (tmp == NULL) {
+        return DS_ERR_OOM;
+    }
+    if (n < DS_POOL_SORT_SERIAL || P->nthreads == 1) {
+        sort_slice(items, tmp, 0, n, cmp);
+        ds_free(tmp);
+        return DS_OK;
+    }
+    
+    slices = 4 * P->nthreads;
+    if (n / slices < DS_POOL_SORT_SERIAL / 4) {
+        slices = n / (DS_POOL_SORT_SERIAL / 4);
+    }
+    width = (n + slices - 1) / slices;
+    slices = (n + width - 1) / width;
+    
+    jobs = (struct sort_job *)ds_alloc(slices * sizeof(struct sort_job));
+    if (jobs == NULL) {
+        ds_free(tmp);
+        return DS_ERR_OOM;
+    }
+    
+    for (i = 0; i < slices; i++) {
+        jobs[i].src = items;
+        jobs[i].dst = tmp;
+        jobs[i].lo = i * width;
+        jobs[i].hi = (n - jobs[i].lo < width) ? n : jobs[i].lo + width;
+        jobs[i].cmp = cmp;
+        if (ds_pool_submit(P, sort_task, &jobs[i]) != DS_OK) {
+            sort_task(&jobs[i]);
+        }
+    }
+    ds_pool_wait(P);
+    
+    // Each round halves the number of runs
+    src = items;
+    dst = tmp;
+    for (; width < n; width *= 2) {
+        void **swap;
+        
+        count = 0;
+        for (i = 0; i < n; i += 2 * width) {
+            struct sort_job *job = &jobs[count++];
+            
+            job->src = src;
+            job->dst = dst;
+            job->lo = i;
+            job->mid = (n - i < width) ? n : i + width;
+            job->hi = (n - job->mid < width) ? n : job->mid + width;
+            job->cmp = cmp;
+            if (ds_pool_submit(P, merge_task, job) != DS_OK) {
+                merge_task(job);
+            }
+        }
+        ds_pool_wait(P);
+        swap = src;
+        src = dst;
+        dst = swap;
+    }
+    
+    if (src != items) {
+        memcpy(items, src, n * sizeof(void *));
+    }
+    
+    ds_free(jobs);
+    ds_free(tmp);
+    return DS_OK;
+}
@@ -0,0 +1,449 @@
+/**
+ * @file pqueue.c
+ * @brief Priority queue data structure implementation
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * This file implements the priority queue as a 4-ary min-heap in a flat
+ * array: the children of slot i are slots 4i + 1 to 4i + 4. Compared to
+ * a binary heap this halves the tree height, and the four children of a
+ * slot share one cache line, so sifting down touches fewer lines.
+ */
+
+#include "ds_pqueue.h"
+#include "ds_internal.h"
+#include <stdio.h>   /* for printf */
+#include <string.h>  /* for memcpy */
+
+/**
+ * @brief Number of children per heap slot
+ */
+#define DS_PQUEUE_ARITY 4
+
+/**
+ * @brief Minimum capacity of the heap array
+ */
+#define DS_PQUEUE_MIN 16
+
+/**
+ * @brief Internal priority queue structure
+ * 
+ * items[0 .. size) satisfy the heap property: no element compares
+ * greater than its children.
+ */
+struct ds_pqueue {
+    void **items;                  /**< Heap array */
+    size_t size;                   /**< Number of elements in queue */
+    size_t capacity;               /**< Allocated array slots */
+    int (*cmp)(const void *, const void *); /**< Element ordering */
+    ds_stats_t stats;              /**< Runtime counters */
+};
+
+/**
+ * @brief Move the heap array to a buffer of the given capacity
+ * 
+ * @param P Pointer to priority queue
+ * @param capacity New capacity, at least P->size
+ * @return DS_OK on success, DS_ERR_OOM on memory failure
+ */
+static ds_error_t array_resize(ds_pqueue_t *P, size_t capacity) {
+    void **items;
+    
+    if (capacity > (size_t)-1 / sizeof(void *)) {
+        return DS_ERR_OOM;
+    }
+    
+    items = (void **)ds_alloc(capacity * sizeof(void *));
+    if (items == NULL) {
+        return DS_ERR_OOM;
+    }
+    if (P->size != 0) {
+        memcpy(items, P->items, P->size * sizeof(void *));
+    }
+    
+    ds_stats_count_alloc(&P->stats, capacity * sizeof(void *));
+    if (P->items != NULL) {
+        ds_stats_count_free(&P->stats, P->capacity * sizeof(void *));
+    }
+    ds_free(P->items);
+    P->items = items;
+    P->capacity = capacity;
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Move an element up from slot i to its place
+ * 
+ * Parents are shifted down into the hole instead of being swapped, so
+ * each level costs one comparison and one store.
+ * 
+ * @param P Pointer to priority queue
+ * @param i Slot holding the element to sift
+ */
+static void sift_up(ds_pqueue_t *P, size_t i) {
+    void *data = P->items[i];
+    size_t compares = 0;
+    
+    while (i > 0) {
+        size_t parent = (i - 1) / DS_PQUEUE_ARITY;
+        
+        compares++;
+        if (P->cmp(data, P->items[parent]) >= 0) {
+            break;
+        }
+        P->items[i] = P->items[parent];
+        i = parent;
+    }
+    P->items[i] = data;
+    ds_stats_count_compares(&P->stats, compares);
+}
+
+/**
+ * @brief Move an element down from slot i to its place
+ * 
+ * @param P Pointer to priority queue
+ * @param i Slot holding the element to sift
+ */
+static void sift_down(ds_pqueue_t *P, size_t i) {
+    void *data = P->items[i];
+    size_t compares = 0;
+    
+    for (;;) {
+        size_t first = DS_PQUEUE_ARITY * i + 1;
+        size_t last, best;
+        
+        if (first >= P->size) {
+            break;
+        }
+        
+        // Pick the smallest of up to four children
+        last = (P->size - first < DS_PQUEUE_ARITY) ? P->size : first + DS_PQUEUE_ARITY;
+        best = first;
+        for (size_t c = first + 1; c < last; c++) {
+            compares++;
+            if (P->cmp(P->items[c], P->items[best]) < 0) {
+                best = c;
+            }
+        }
+        
+        compares++;
+        if (P->cmp(P->items[best], data) >= 0) {
+            break;
+        }
+        P->items[i] = P->items[best];
+        i = best;
+    }
+    P->items[i] = data;
+    ds_stats_count_compares(&P->stats, compares);
+}
+
+/**
+ * @brief Create a new empty priority queue
+ * 
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @param capacity_hint Expected number of elements (may be 0)
+ * @return Pointer to new priority queue on success, NULL if cmp is NULL or on memory failure
+ */
+ds_pqueue_t *ds_pqueue_create(int (*cmp)(const void *, const void *), size_t capacity_hint) {
+    ds_pqueue_t *pqueue;
+    
+    // Validate input parameter
+    if (cmp == NULL) {
+        return NULL;
+    }
+    
+    // Allocate memory for priority queue structure
+    pqueue = (ds_pqueue_t *)ds_alloc(sizeof(struct ds_pqueue));
+    if (pqueue == NULL) {
+        return NULL;
+    }
+    
+    // Initialize priority queue to empty state
+    pqueue->items = NULL;
+    pqueue->size = 0;
+    pqueue->capacity = 0;
+    pqueue->cmp = cmp;
+    ds_stats_init(&pqueue->stats);
+    
+    if (array_resize(pqueue, (capacity_hint < DS_PQUEUE_MIN) ? DS_PQUEUE_MIN : capacity_hint) != DS_OK) {
+        ds_free(pqueue);
+        return NULL;
+    }
+    
+    return pqueue;
+}
+
+/**
+ * @brief Build a priority queue from an array of elements
+ * 
+ * Uses Floyd's bottom-up construction: every slot that has children is
+ * sifted down, starting from the last one.
+ * 
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @param items Array of n data pointers in any order
+ * @param n Number of items
+ * @return Pointer to new priority queue on success, NULL on invalid input or memory failure
+ */
+ds_pqueue_t *ds_pqueue_create_from_array(int (*cmp)(const void *, const void *),
+                                         void *const *items, size_t n) {
+    ds_pqueue_t *pqueue;
+    size_t i;
+    
+    // Validate input parameters
+    if (items == NULL && n > 0) {
+        return NULL;
+    }
+    for (i = 0; i < n; i++) {
+        if (items[i] == NULL) {
+            return NULL;
+        }
+    }
+    
+    pqueue = ds_pqueue_create(cmp, n);
+    if (pqueue == NULL) {
+        return NULL;
+    }
+    
+    if (n > 0) {
+        memcpy(pqueue->items, items, n * sizeof(void *));
+    }
+    pqueue->size = n;
+    for (i = (n + DS_PQUEUE_ARITY - 2) / DS_PQUEUE_ARITY; i-- > 0;) {
+        sift_down(pqueue, i);
+    }
+    ds_stats_resize(&pqueue->stats, n);
+    
+    return pqueue;
+}
+
+/**
+ * @brief Free a priority queue and optionally its data
+ * 
+ * @param P Pointer to priority queue to free
+ * @param free_data Optional function to free element data (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if P is NULL
+ */
+ds_error_t ds_pqueue_free(ds_pqueue_t *P, void (*free_data)(void *)) {
+    // Validate input parameter
+    if (P == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    // Call user's free function for each element if provided
+    if (free_data != NULL) {
+        for (size_t i = 0; i < P->size; i++) {
+            free_data(P->items[i]);
+        }
+    }
+    
+    // Free the heap array and the priority queue structure
+    ds_stats_release(&P->stats);
+    ds_free(P->items);
+    ds_free(P);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Untraced implementation of ds_pqueue_push
+ */
+static ds_error_t pqueue_push(ds_pqueue_t *P, void *data) {
+    // Validate input parameters
+    if (P == NULL || data == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    // Double the array when full
+    if (P->size == P->capacity) {
+        if (P->capacity > (size_t)-1 / 2 || array_resize(P, P->capacity * 2) != DS_OK) {
+            return DS_ERR_OOM;
+        }
+    }
+    
+    P->items[P->size] = data;
+    P->size++;
+    sift_up(P, P->size - 1);
+    ds_stats_resize(&P->stats, P->size);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Insert element into the priority queue
+ * 
+ * @param P Pointer to priority queue
+ * @param data Pointer to data to insert
+ * @return DS_OK on success, DS_ERR_NULLARG if P or data is NULL, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_pqueue_push(ds_pqueue_t *P, void *data) {
+    ds_error_t result;
+    
+    DS_TRACE_BEGIN();
+    result = pqueue_push(P, data);
+    DS_TRACE_END(DS_TRACE_PQUEUE_PUSH, P);
+    
+    return result;
+}
+
+/**
+ * @brief Untraced implementation of ds_pqueue_pop
+ */
+static void *pqueue_pop(ds_pqueue_t *P) {
+    void *data;
+    
+    // Validate input parameter and check for empty queue
+    if (P == NULL || P->size == 0) {
+        return NULL;
+    }
+    
+    data = P->items[0];
+    P->size--;
+    if (P->size > 0) {
+        P->items[0] = P->items[P->size];
+        sift_down(P, 0);
+    }
+    ds_stats_resize(&P->stats, P->size);
+    
+    return data;
+}
+
+/**
+ * @brief Remove and return the smallest element
+ * 
+ * The last element takes the root slot and is sifted down.
+ * 
+ * @param P Pointer to priority queue
+ * @return Pointer to data of removed element, or NULL if P is empty or NULL
+ */
+void *ds_pqueue_pop(ds_pqueue_t *P) {
+    void *result;
+    
+    DS_TRACE_BEGIN();
+    result = pqueue_pop(P);
+    DS_TRACE_END(DS_TRACE_PQUEUE_POP, P);
+    
+    return result;
+}
+
+/**
+ * @brief Get the smallest element without removing it
+ * 
+ * @param P Pointer to priority queue
+ * @return Pointer to smallest element's data, or NULL if P is empty or NULL
+ */
+void *ds_pqueue_peek(const ds_pqueue_t *P) {
+    if (P == NULL || P->size == 0) {
+        return NULL;
+    }
+    
+    return P->items[0];
+}
+
+/**
+ * @brief Ensure capacity for at least the given number of elements
+ * 
+ * @param P Pointer to priority queue
+ * @param capacity Minimum number of elements to hold without reallocating
+ * @return DS_OK on success, DS_ERR_NULLARG if P is NULL, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_pqueue_reserve(ds_pqueue_t *P, size_t capacity) {
+    // Validate input parameter
+    if (P == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    if (capacity <= P->capacity) {
+        return DS_OK;
+    }
+    
+    return array_resize(P, capacity);
+}
+
+/**
+ * @brief Get the number of elements in the priority queue
+ * 
+ * @param P Pointer to priority queue
+ * @return Number of elements, or 0 if P is NULL
+ */
+size_t ds_pqueue_size(const ds_pqueue_t *P) {
+    if (P == NULL) {
+        return 0;
+    }
+    
+    return P->size;
+}
+
+/**
+ * @brief Check if priority queue is empty
+ * 
+ * @param P Pointer to priority queue
+ * @return 1 if empty, 0 if not empty, 1 if P is NULL
+ */
+int ds_pqueue_is_empty(const ds_pqueue_t *P) {
+    if (P == NULL) {
+        return 1;  // Consider NULL as empty
+    }
+    
+    return (P->size == 0) ? 1 : 0;
+}
+
+/**
+ * @brief Get the runtime counters of a priority queue
+ * 
+ * @param P Pointer to priority queue
+ * @param out Receives the counters
+ * @return DS_OK on success, DS_ERR_NULLARG if P or out is NULL
+ */
+ds_error_t ds_pqueue_stats(const ds_pqueue_t *P, ds_stats_t *out) {
+    if (P == NULL || out == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    *out = P->stats;
+    return DS_OK;
+}
+
+/**
+ * @brief Visualize the priority queue structure
+ * 
+ * @param P Pointer to priority queue
+ * @param out Output stream (e.g., stdout, stderr)
+ */
+void ds_pqueue_visualize(const ds_pqueue_t *P, FILE *out) {
+    size_t begin = 0, width = 1;
+    
+    // Handle NULL parameters gracefully
+    if (out == NULL) {
+        out = stdout;  // Default to stdout
+    }
+    
+    if (P == NULL) {
+        fprintf(out, "PQueue: NULL\n");
+        return;
+    }
+    
+    if (P->size == 0) {
+        fprintf(out, "PQueue: [empty] (size: %zu)\n", P->size);
+        return;
+    }
+    
+    // Print priority queue header
+    fprintf(out, "PQueue: (size: %zu)\n", P->size);
+    
+    // Each heap level is ARITY times wider than the one above it
+    while (begin < P->size) {
+        size_t end = (P->size - begin < width) ? P->size : begin + width;
+        
+        fprintf(out, " ");
+        for (size_t i = begin; i < end; i++) {
+            fprintf(out, " %d", *(int*)P->items[i]);
+        }
+        fprintf(out, "\n");
+        begin = end;
+        width *= DS_PQUEUE_ARITY;
+    }
+    
+    fprintf(out, "\n");
+}
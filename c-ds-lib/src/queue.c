@@ -6,121 +6,237 @@
  * @date 2024
  * 
  * This file implements the queue data structure using a linked list approach
- * with memory management and learning mode support.
+ * with memory management and learning mode support. Queues created with
+ * ds_queue_create_ring() use a growable ring buffer instead. Bulk transfer
+ * to and from file descriptors uses POSIX writev/readv.
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "ds_queue.h"
-#include <stdlib.h>  /* for malloc, free */
-#include <stdio.h>   /* for printf */
+#include "ds_internal.h"
+#include <errno.h>     /* for errno, EINTR, EAGAIN */
+#include <limits.h>    /* for IOV_MAX */
+#include <stdio.h>     /* for printf */
+#include <string.h>    /* for memcpy */
+#include <sys/uio.h>   /* for writev, readv, struct iovec */
 
 /**
- * @brief Internal flag for learning mode
+ * @brief Internal node structure for queue
  * 
- * When enabled, memory operations are logged for educational purposes.
+ * Each node contains a pointer to data and a pointer to the next node.
+ * The queue structure maintains pointers to front and rear for efficient operations.
  */
-static int learning_mode = 0;
+struct ds_queue_node {
+    void *data;                    /**< Pointer to user data */
+    struct ds_queue_node *next;    /**< Pointer to next node */
+};
 
 /**
- * @brief Memory allocation wrapper with learning mode support
+ * @brief Minimum capacity of a ring-buffer queue
+ */
+#define DS_QUEUE_RING_MIN 16
+
+/**
+ * @brief Maximum number of buffers handed to one writev/readv call
+ */
+#if defined(IOV_MAX) && IOV_MAX < 64
+#define DS_QUEUE_IOV_BATCH IOV_MAX
+#else
+#define DS_QUEUE_IOV_BATCH 64
+#endif
+
+/**
+ * @brief Internal queue structure
  * 
- * Allocates memory and optionally logs the operation when learning mode is enabled.
+ * Contains front and rear pointers for efficient enqueue/dequeue operations.
+ * Size is cached for O(1) size queries. In ring mode the elements live in
+ * a contiguous power-of-two buffer and the node pointers stay NULL.
+ */
+struct ds_queue {
+    struct ds_queue_node *front;   /**< Pointer to front node */
+    struct ds_queue_node *rear;    /**< Pointer to rear node */
+    size_t size;                   /**< Number of elements in queue */
+    ds_allocator_t alloc;          /**< Allocator used for nodes */
+    ds_slab_t *pool;               /**< Private node pool, or NULL */
+    void **ring;                   /**< Ring buffer storage, or NULL in linked mode */
+    size_t ring_cap;               /**< Ring capacity, always a power of two */
+    size_t ring_head;              /**< Ring index of the front element */
+    size_t io_sent;                /**< Bytes of the front element already written */
+    void *io_partial;              /**< Record partly read by fill_from_fd, or NULL */
+    size_t io_filled;              /**< Bytes of io_partial read so far */
+    size_t io_record;              /**< Record size io_partial was allocated for */
+    ds_stats_t stats;              /**< Runtime counters */
+};
+
+/**
+ * @brief Check whether nodes of one queue may be relinked into another
  * 
- * @param n Number of bytes to allocate
- * @return Pointer to allocated memory, or NULL on failure
+ * @param Q First queue
+ * @param R Second queue
+ * @return Non-zero if both are node-based, unpooled and share a node allocator
  */
-void *ds_alloc(size_t n) {
-    void *ptr = malloc(n);
-    
-#ifdef DS_LEARNING_MODE
-    if (learning_mode) {
-        printf("[LEARN] malloc(%zu) = %p\n", n, ptr);
-    }
-#endif
-    
-    return ptr;
+static int queues_compatible(const ds_queue_t *Q, const ds_queue_t *R) {
+    return Q->ring == NULL && R->ring == NULL && Q->pool == NULL && R->pool == NULL &&
+           Q->alloc.alloc == R->alloc.alloc && Q->alloc.free == R->alloc.free &&
+           Q->alloc.ctx == R->alloc.ctx;
 }
 
 /**
- * @brief Memory deallocation wrapper with learning mode support
+ * @brief Grow the ring buffer to twice its capacity
  * 
- * Deallocates memory and optionally logs the operation when learning mode is enabled.
+ * Copies the elements to a new buffer in queue order so that the front
+ * element ends up at index 0.
  * 
- * @param p Pointer to memory to deallocate
+ * @param Q Pointer to ring-mode queue
+ * @return DS_OK on success, DS_ERR_OOM on memory failure
  */
-void ds_free(void *p) {
-#ifdef DS_LEARNING_MODE
-    if (learning_mode && p) {
-        printf("[LEARN] free(%p)\n", p);
+static ds_error_t ring_grow(ds_queue_t *Q) {
+    size_t new_cap = Q->ring_cap * 2;
+    size_t first;
+    void **new_ring;
+    
+    if (new_cap < Q->ring_cap || new_cap > (size_t)-1 / sizeof(void *)) {
+        return DS_ERR_OOM;
     }
-#endif
     
-    free(p);
+    new_ring = (void **)ds_alloc(new_cap * sizeof(void *));
+    if (new_ring == NULL) {
+        return DS_ERR_OOM;
+    }
+    
+    // Copy the (possibly wrapped) contents in two spans
+    first = Q->ring_cap - Q->ring_head;
+    if (first > Q->size) {
+        first = Q->size;
+    }
+    memcpy(new_ring, Q->ring + Q->ring_head, first * sizeof(void *));
+    memcpy(new_ring + first, Q->ring, (Q->size - first) * sizeof(void *));
+    
+    ds_stats_count_alloc(&Q->stats, new_cap * sizeof(void *));
+    ds_stats_count_free(&Q->stats, Q->ring_cap * sizeof(void *));
+    ds_free(Q->ring);
+    Q->ring = new_ring;
+    Q->ring_cap = new_cap;
+    Q->ring_head = 0;
+    
+    return DS_OK;
 }
 
 /**
- * @brief Enable or disable learning mode
+ * @brief Create a new empty queue
+ * 
+ * Allocates and initializes a new queue structure with the library-level
+ * node allocator.
  * 
- * @param enable Non-zero to enable, zero to disable
+ * @return Pointer to new queue on success, NULL on memory allocation failure
  */
-void ds_enable_learning_mode(int enable) {
-    learning_mode = enable;
+ds_queue_t *ds_queue_create(void) {
+    return ds_queue_create_with_allocator(NULL);
 }
 
 /**
- * @brief Dump current state of all data structures
+ * @brief Create a new empty queue with a custom node allocator
  * 
- * Currently not implemented - placeholder for future functionality.
+ * The queue structure itself comes from ds_alloc; every node is obtained
+ * from the given allocator.
+ * 
+ * @param a Allocator for nodes, or NULL for the library-level allocator
+ * @return Pointer to new queue on success, NULL on invalid allocator or memory failure
  */
-void ds_dump_state(void) {
-    if (learning_mode) {
-        printf("[LEARN] ds_dump_state() - not yet implemented\n");
+ds_queue_t *ds_queue_create_with_allocator(const ds_allocator_t *a) {
+    ds_queue_t *queue;
+    
+    // Allocate memory for queue structure
+    queue = (ds_queue_t *)ds_alloc(sizeof(struct ds_queue));
+    if (queue == NULL) {
+        return NULL;
     }
+    
+    // Capture the node allocator
+    if (ds_allocator_init(&queue->alloc, a) != DS_OK) {
+        ds_free(queue);
+        return NULL;
+    }
+    
+    // Initialize queue to empty state
+    queue->front = NULL;
+    queue->rear = NULL;
+    queue->size = 0;
+    queue->pool = NULL;
+    queue->ring = NULL;
+    queue->ring_cap = 0;
+    queue->ring_head = 0;
+    queue->io_sent = 0;
+    queue->io_partial = NULL;
+    queue->io_filled = 0;
+    queue->io_record = 0;
+    ds_stats_init(&queue->stats);
+    
+    return queue;
 }
 
 /**
- * @brief Internal node structure for queue
+ * @brief Create a new empty queue backed by a private node pool
  * 
- * Each node contains a pointer to data and a pointer to the next node.
- * The queue structure maintains pointers to front and rear for efficient operations.
- */
-struct ds_queue_node {
-    void *data;                    /**< Pointer to user data */
-    struct ds_queue_node *next;    /**< Pointer to next node */
-};
-
-/**
- * @brief Internal queue structure
+ * Nodes are served from a slab pool owned by the queue, which is released
+ * in one pass by ds_queue_free.
  * 
- * Contains front and rear pointers for efficient enqueue/dequeue operations.
- * Size is cached for O(1) size queries.
+ * @return Pointer to new queue on success, NULL on memory allocation failure
  */
-struct ds_queue {
-    struct ds_queue_node *front;   /**< Pointer to front node */
-    struct ds_queue_node *rear;    /**< Pointer to rear node */
-    size_t size;                   /**< Number of elements in queue */
-};
+ds_queue_t *ds_queue_create_pooled(void) {
+    ds_queue_t *queue;
+    ds_slab_t *pool;
+    ds_allocator_t a;
+    
+    // Create the node pool first
+    pool = ds_slab_create(sizeof(struct ds_queue_node), DS_SLAB_DEFAULT_OBJS);
+    if (pool == NULL) {
+        return NULL;
+    }
+    
+    a = ds_slab_allocator(pool);
+    queue = ds_queue_create_with_allocator(&a);
+    if (queue == NULL) {
+        ds_slab_free(pool);
+        return NULL;
+    }
+    
+    queue->pool = pool;
+    return queue;
+}
 
 /**
- * @brief Create a new empty queue
+ * @brief Create a new empty ring-buffer queue
  * 
- * Allocates and initializes a new queue structure with front and rear
- * set to NULL and size set to 0.
+ * Elements are stored in a contiguous buffer that doubles whenever it is
+ * full, so enqueue and dequeue do not allocate once the buffer has grown
+ * to the working set size.
  * 
+ * @param capacity_hint Expected number of elements (rounded up to a power of two)
  * @return Pointer to new queue on success, NULL on memory allocation failure
  */
-ds_queue_t *ds_queue_create(void) {
+ds_queue_t *ds_queue_create_ring(size_t capacity_hint) {
     ds_queue_t *queue;
+    size_t cap = DS_QUEUE_RING_MIN;
     
-    // Allocate memory for queue structure
-    queue = (ds_queue_t *)ds_alloc(sizeof(struct ds_queue));
+    // Round the hint up to a power of two
+    while (cap < capacity_hint && cap <= ((size_t)-1 / sizeof(void *)) / 2) {
+        cap *= 2;
+    }
+    
+    queue = ds_queue_create_with_allocator(NULL);
     if (queue == NULL) {
         return NULL;
     }
     
-    // Initialize queue to empty state
-    queue->front = NULL;
-    queue->rear = NULL;
-    queue->size = 0;
+    queue->ring = (void **)ds_alloc(cap * sizeof(void *));
+    if (queue->ring == NULL) {
+        ds_free(queue);
+        return NULL;
+    }
+    queue->ring_cap = cap;
+    ds_stats_count_alloc(&queue->stats, cap * sizeof(void *));
     
     return queue;
 }
@@ -143,38 +259,60 @@ ds_error_t ds_queue_free(ds_queue_t *Q, void (*free_data)(void *)) {
         return DS_ERR_NULLARG;
     }
     
-    // Iterate through all nodes and free them
-    current = Q->front;
-    while (current != NULL) {
-        next = current->next;
-        
-        // Call user's free function for data if provided
-        if (free_data != NULL && current->data != NULL) {
-            free_data(current->data);
+    // A record left half-read by ds_queue_fill_from_fd never reached the queue
+    ds_free(Q->io_partial);
+    
+    // Ring mode: hand each element to free_data, then drop the buffer
+    if (Q->ring != NULL) {
+        if (free_data != NULL) {
+            for (size_t i = 0; i < Q->size; i++) {
+                void *data = Q->ring[(Q->ring_head + i) & (Q->ring_cap - 1)];
+                if (data != NULL) {
+                    free_data(data);
+                }
+            }
         }
-        
-        // Free the node structure
-        ds_free(current);
-        current = next;
+        ds_stats_release(&Q->stats);
+        ds_free(Q->ring);
+        ds_free(Q);
+        return DS_OK;
+    }
+    
+    // Pooled and arena nodes are released wholesale, so only walk if data needs freeing
+    if ((Q->pool == NULL && ds_allocator_frees(&Q->alloc)) || free_data != NULL) {
+        current = Q->front;
+        while (current != NULL) {
+            next = current->next;
+            
+            // Call user's free function for data if provided
+            if (free_data != NULL && current->data != NULL) {
+                free_data(current->data);
+            }
+            
+            // Free the node structure
+            if (Q->pool == NULL) {
+                ds_node_free(&Q->alloc, &Q->stats, current, sizeof(struct ds_queue_node));
+            }
+            current = next;
+        }
+    }
+    
+    // Release the node pool in one pass
+    if (Q->pool != NULL) {
+        ds_slab_free(Q->pool);
     }
     
     // Free the queue structure
+    ds_stats_release(&Q->stats);
     ds_free(Q);
     
     return DS_OK;
 }
 
 /**
- * @brief Enqueue element at the rear of the queue
- * 
- * Adds a new element to the rear of the queue. Updates rear pointer
- * and increments size. For empty queues, also updates front pointer.
- * 
- * @param Q Pointer to queue
- * @param data Pointer to data to enqueue
- * @return DS_OK on success, DS_ERR_NULLARG if Q or data is NULL, DS_ERR_OOM on memory failure
+ * @brief Untraced implementation of ds_queue_enqueue
  */
-ds_error_t ds_queue_enqueue(ds_queue_t *Q, void *data) {
+static ds_error_t queue_enqueue(ds_queue_t *Q, void *data) {
     struct ds_queue_node *new_node;
     
     // Validate input parameters
@@ -182,8 +320,19 @@ ds_error_t ds_queue_enqueue(ds_queue_t *Q, void *data) {
         return DS_ERR_NULLARG;
     }
     
+    // Ring mode: append at the slot after the last element
+    if (Q->ring != NULL) {
+        if (Q->size == Q->ring_cap && ring_grow(Q) != DS_OK) {
+            return DS_ERR_OOM;
+        }
+        Q->ring[(Q->ring_head + Q->size) & (Q->ring_cap - 1)] = data;
+        Q->size++;
+        ds_stats_resize(&Q->stats, Q->size);
+        return DS_OK;
+    }
+    
     // Allocate memory for new node
-    new_node = (struct ds_queue_node *)ds_alloc(sizeof(struct ds_queue_node));
+    new_node = (struct ds_queue_node *)ds_node_alloc(&Q->alloc, &Q->stats, sizeof(struct ds_queue_node));
     if (new_node == NULL) {
         return DS_ERR_OOM;
     }
@@ -203,21 +352,35 @@ ds_error_t ds_queue_enqueue(ds_queue_t *Q, void *data) {
         Q->rear = new_node;
     }
     Q->size++;
+    ds_stats_resize(&Q->stats, Q->size);
     
     return DS_OK;
 }
 
 /**
- * @brief Dequeue element from the front of the queue
+ * @brief Enqueue element at the rear of the queue
  * 
- * Removes the front element from the queue and returns its data.
- * Updates front pointer and decrements size. If queue becomes empty,
- * also updates rear pointer to NULL.
+ * Adds a new element to the rear of the queue. Updates rear pointer
+ * and increments size. For empty queues, also updates front pointer.
  * 
  * @param Q Pointer to queue
- * @return Pointer to data of dequeued element, or NULL if queue is empty or Q is NULL
+ * @param data Pointer to data to enqueue
+ * @return DS_OK on success, DS_ERR_NULLARG if Q or data is NULL, DS_ERR_OOM on memory failure
  */
-void *ds_queue_dequeue(ds_queue_t *Q) {
+ds_error_t ds_queue_enqueue(ds_queue_t *Q, void *data) {
+    ds_error_t result;
+    
+    DS_TRACE_BEGIN();
+    result = queue_enqueue(Q, data);
+    DS_TRACE_END(DS_TRACE_QUEUE_ENQUEUE, Q);
+    
+    return result;
+}
+
+/**
+ * @brief Untraced implementation of ds_queue_dequeue
+ */
+static void *queue_dequeue(ds_queue_t *Q) {
     struct ds_queue_node *old_front;
     void *data;
     
@@ -226,13 +389,27 @@ void *ds_queue_dequeue(ds_queue_t *Q) {
         return NULL;
     }
     
+    // Ring mode: take the element at the head index
+    if (Q->ring != NULL) {
+        if (Q->size == 0) {
+            return NULL;
+        }
+        Q->io_sent = 0;
+        data = Q->ring[Q->ring_head];
+        Q->ring_head = (Q->ring_head + 1) & (Q->ring_cap - 1);
+        Q->size--;
+        ds_stats_resize(&Q->stats, Q->size);
+        return data;
+    }
+    
     // Check if queue is empty
     if (Q->front == NULL) {
         return NULL;
     }
     
-    // Get old front and its data
+    // Get old front and its data; a partial drain no longer applies
     old_front = Q->front;
+    Q->io_sent = 0;
     data = old_front->data;
     
     // Update queue pointers
@@ -242,13 +419,34 @@ void *ds_queue_dequeue(ds_queue_t *Q) {
         Q->rear = NULL;
     }
     Q->size--;
+    ds_stats_resize(&Q->stats, Q->size);
     
     // Free the old front node
-    ds_free(old_front);
+    ds_node_free(&Q->alloc, &Q->stats, old_front, sizeof(struct ds_queue_node));
     
     return data;
 }
 
+/**
+ * @brief Dequeue element from the front of the queue
+ * 
+ * Removes the front element from the queue and returns its data.
+ * Updates front pointer and decrements size. If queue becomes empty,
+ * also updates rear pointer to NULL.
+ * 
+ * @param Q Pointer to queue
+ * @return Pointer to data of dequeued element, or NULL if queue is empty or Q is NULL
+ */
+void *ds_queue_dequeue(ds_queue_t *Q) {
+    void *result;
+    
+    DS_TRACE_BEGIN();
+    result = queue_dequeue(Q);
+    DS_TRACE_END(DS_TRACE_QUEUE_DEQUEUE, Q);
+    
+    return result;
+}
+
 /**
  * @brief Peek at the front element without removing it
  * 
@@ -263,6 +461,11 @@ void *ds_queue_peek(const ds_queue_t *Q) {
         return NULL;
     }
     
+    // Ring mode: front element sits at the head index
+    if (Q->ring != NULL) {
+        return (Q->size != 0) ? Q->ring[Q->ring_head] : NULL;
+    }
+    
     // Check if queue is empty
     if (Q->front == NULL) {
         return NULL;
@@ -284,7 +487,7 @@ int ds_queue_is_empty(const ds_queue_t *Q) {
         return 1;  // Consider NULL as empty
     }
     
-    return (Q->front == NULL) ? 1 : 0;
+    return (Q->size == 0) ? 1 : 0;
 }
 
 /**
@@ -304,6 +507,355 @@ size_t ds_queue_size(const ds_queue_t *Q) {
     return Q->size;
 }
 
+/**
+ * @brief Move all elements of one queue to the rear of another
+ * 
+ * Node-based queues are joined by linking R's chain behind Q's rear in
+ * O(1). Ring queues copy R's slots into Q's buffer, without any
+ * per-element allocation.
+ * 
+ * @param Q Pointer to queue receiving all elements
+ * @param R Pointer to queue to empty into Q
+ * @return DS_OK on success, DS_ERR_NULLARG if Q or R is NULL,
+ *         DS_ERR_INVALID if Q and R are the same or incompatible queues,
+ *         DS_ERR_OOM if a ring buffer cannot grow
+ */
+ds_error_t ds_queue_splice(ds_queue_t *Q, ds_queue_t *R) {
+    // Validate input parameters
+    if (Q == NULL || R == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    if (Q == R) {
+        return DS_ERR_INVALID;
+    }
+    
+    // Ring mode: copy the slots, the buffers themselves stay put
+    if (Q->ring != NULL && R->ring != NULL) {
+        while (Q->ring_cap - Q->size < R->size) {
+            if (ring_grow(Q) != DS_OK) {
+                return DS_ERR_OOM;
+            }
+        }
+        for (size_t i = 0; i < R->size; i++) {
+            Q->ring[(Q->ring_head + Q->size + i) & (Q->ring_cap - 1)] =
+                R->ring[(R->ring_head + i) & (R->ring_cap - 1)];
+        }
+        if (Q->size == 0) {
+            Q->io_sent = R->io_sent;
+        }
+        Q->size += R->size;
+        R->size = 0;
+        R->ring_head = 0;
+        R->io_sent = 0;
+        ds_stats_resize(&Q->stats, Q->size);
+        ds_stats_resize(&R->stats, 0);
+        return DS_OK;
+    }
+    
+    if (!queues_compatible(Q, R)) {
+        return DS_ERR_INVALID;
+    }
+    if (R->size == 0) {
+        return DS_OK;
+    }
+    
+    // Linked mode: hang R's chain off Q's rear
+    if (Q->rear != NULL) {
+        Q->rear->next = R->front;
+    } else {
+        Q->front = R->front;
+    }
+    Q->rear = R->rear;
+    R->front = NULL;
+    R->rear = NULL;
+    
+    // A partly written front element keeps its offset if it becomes Q's front
+    if (Q->size == 0) {
+        Q->io_sent = R->io_sent;
+    }
+    R->io_sent = 0;
+    
+    // The nodes now belong to Q, so their allocations move with them
+    ds_stats_transfer(&Q->stats, &R->stats, R->stats.allocs - R->stats.frees, R->stats.bytes_live);
+    Q->size += R->size;
+    R->size = 0;
+    ds_stats_resize(&Q->stats, Q->size);
+    ds_stats_resize(&R->stats, 0);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Exchange the contents of two queues
+ * 
+ * Swaps the queue structures wholesale, including storage mode, node
+ * allocator, pool and counters, so it works for any pair of queues.
+ * 
+ * @param Q Pointer to first queue
+ * @param R Pointer to second queue
+ * @return DS_OK on success, DS_ERR_NULLARG if Q or R is NULL
+ */
+ds_error_t ds_queue_swap(ds_queue_t *Q, ds_queue_t *R) {
+    struct ds_queue tmp;
+    
+    // Validate input parameters
+    if (Q == NULL || R == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    tmp = *Q;
+    *Q = *R;
+    *R = tmp;
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Drain queued buffers into a file descriptor
+ * 
+ * Gathers up to DS_QUEUE_IOV_BATCH elements per writev call. Elements
+ * leave the queue only once all of their bytes have been written, and
+ * partial writes resume inside the element where they stopped, also
+ * across calls. A descriptor that would block ends the call early.
+ * 
+ * @param Q Pointer to queue
+ * @param fd File descriptor to write to
+ * @param size_cb Returns the number of bytes stored at an element's data pointer
+ * @param max_bytes Byte budget for this call, or 0 for no limit
+ * @param free_data Optional function called on each fully written element (may be NULL)
+ * @param written Optional; receives the number of bytes written
+ * @return DS_OK on success or when fd would block, DS_ERR_NULLARG if Q or
+ *         size_cb is NULL, DS_ERR_IO if writev fails
+ */
+ds_error_t ds_queue_drain_to_fd(ds_queue_t *Q, int fd, size_t (*size_cb)(const void *data),
+                                size_t max_bytes, void (*free_data)(void *), size_t *written) {
+    struct iovec iov[DS_QUEUE_IOV_BATCH];
+    struct ds_queue_node *node;
+    size_t total = 0;
+    
+    if (written != NULL) {
+        *written = 0;
+    }
+    if (Q == NULL || size_cb == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    while (Q->size > 0) {
+        size_t count = 0, batch = 0, done = 0;
+        
+        // Gather the next elements that fit the budget; the very first one
+        // is always taken so that an oversized element cannot stall the drain
+        node = Q->front;
+        while (count < DS_QUEUE_IOV_BATCH && count < Q->size) {
+            void *data = (Q->ring != NULL)
+                ? Q->ring[(Q->ring_head + count) & (Q->ring_cap - 1)] : node->data;
+            size_t len = size_cb(data);
+            size_t skip = (count == 0) ? Q->io_sent : 0;
+            
+            // Resume a front element that an earlier call left partly written
+            data = (char *)data + skip;
+            len -= skip;
+            if (max_bytes != 0 && total + batch + len > max_bytes && total + batch > 0) {
+                break;
+            }
+            iov[count].iov_base = data;
+            iov[count].iov_len = len;
+            batch += len;
+            count++;
+            if (Q->ring == NULL) {
+                node = node->next;
+            }
+        }
+        if (count == 0) {
+            break;
+        }
+        
+        // Write the batch, releasing each element as soon as it is complete
+        while (done < count) {
+            ssize_t n = writev(fd, iov + done, (int)(count - done));
+            
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                return DS_OK;
+            }
+            if (n < 0 || (n == 0 && iov[done].iov_len > 0)) {
+                return DS_ERR_IO;
+            }
+            total += (size_t)n;
+            if (written != NULL) {
+                *written = total;
+            }
+            while (done < count && (size_t)n >= iov[done].iov_len) {
+                void *data;
+                
+                n -= (ssize_t)iov[done].iov_len;
+                data = queue_dequeue(Q);
+                if (free_data != NULL) {
+                    free_data(data);
+                }
+                done++;
+            }
+            if (n > 0) {
+                iov[done].iov_base = (char *)iov[done].iov_base + n;
+                iov[done].iov_len -= (size_t)n;
+                Q->io_sent += (size_t)n;
+            }
+        }
+        
+        if (max_bytes != 0 && total >= max_bytes) {
+            break;
+        }
+    }
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Read fixed-size records from a file descriptor into the queue
+ * 
+ * Scatters each readv call across up to DS_QUEUE_IOV_BATCH freshly
+ * allocated records and enqueues every record once it is complete. A
+ * record cut short by a descriptor that would block is kept in the queue
+ * structure and completed by the next call.
+ * 
+ * @param Q Pointer to queue
+ * @param fd File descriptor to read from
+ * @param record_size Size of each record in bytes
+ * @param max_records Maximum number of records to read, or 0 for no limit
+ * @param records Optional; receives the number of records enqueued
+ * @return DS_OK on success, DS_ERR_NULLARG if Q is NULL, DS_ERR_INVALID if
+ *         record_size is 0 or differs from a pending partial record, or the
+ *         input ends inside a record, DS_ERR_OOM on memory failure,
+ *         DS_ERR_IO if readv fails
+ */
+ds_error_t ds_queue_fill_from_fd(ds_queue_t *Q, int fd, size_t record_size,
+                                 size_t max_records, size_t *records) {
+    struct iovec iov[DS_QUEUE_IOV_BATCH];
+    void *bufs[DS_QUEUE_IOV_BATCH];
+    size_t total = 0;
+    ds_error_t err = DS_OK;
+    int more = 1;
+    
+    if (records != NULL) {
+        *records = 0;
+    }
+    if (Q == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    if (record_size == 0 || (Q->io_partial != NULL && Q->io_record != record_size)) {
+        return DS_ERR_INVALID;
+    }
+    
+    while (more && err == DS_OK && (max_records == 0 || total < max_records)) {
+        size_t count = DS_QUEUE_IOV_BATCH, filled = 0, first = 0, i;
+        
+        if (max_records != 0 && max_records - total < count) {
+            count = max_records - total;
+        }
+        for (i = 0; i < count; i++) {
+            bufs[i] = ds_alloc(record_size);
+            if (bufs[i] == NULL) {
+                break;
+            }
+            iov[i].iov_base = bufs[i];
+            iov[i].iov_len = record_size;
+        }
+        
+        // Continue the record an earlier call stopped inside of
+        if (Q->io_partial != NULL && i > 0) {
+            ds_free(bufs[0]);
+            bufs[0] = Q->io_partial;
+            iov[0].iov_base = (char *)bufs[0] + Q->io_filled;
+            iov[0].iov_len = record_size - Q->io_filled;
+            filled = Q->io_filled;
+            Q->io_partial = NULL;
+        }
+        if (i == 0) {
+            err = DS_ERR_OOM;
+            break;
+        }
+        count = i;
+        
+        // Read until the batch is full, the input ends, or no more data is
+        // available right now
+        while (first < count) {
+            ssize_t n = readv(fd, iov + first, (int)(count - first));
+            
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                more = 0;
+                break;
+            }
+            if (n < 0) {
+                err = DS_ERR_IO;
+                more = 0;
+                break;
+            }
+            if (n == 0) {
+                if (filled % record_size != 0) {
+                    err = DS_ERR_INVALID;
+                }
+                more = 0;
+                break;
+            }
+            filled += (size_t)n;
+            while (first < count && (size_t)n >= iov[first].iov_len) {
+                n -= (ssize_t)iov[first].iov_len;
+                first++;
+            }
+            if (n > 0) {
+                iov[first].iov_base = (char *)iov[first].iov_base + n;
+                iov[first].iov_len -= (size_t)n;
+            }
+        }
+        
+        // Keep a partly read record for the next call unless the input ended
+        if (first < count && iov[first].iov_len < record_size && err != DS_ERR_INVALID) {
+            Q->io_partial = bufs[first];
+            Q->io_filled = record_size - iov[first].iov_len;
+            Q->io_record = record_size;
+            bufs[first] = NULL;
+        }
+        
+        // Enqueue the complete records and drop the rest
+        for (i = 0; i < count; i++) {
+            if (i < first && err != DS_ERR_OOM && queue_enqueue(Q, bufs[i]) == DS_OK) {
+                total++;
+                continue;
+            }
+            if (i < first) {
+                err = DS_ERR_OOM;
+            }
+            ds_free(bufs[i]);
+        }
+        if (records != NULL) {
+            *records = total;
+        }
+    }
+    
+    return err;
+}
+
+/**
+ * @brief Get the runtime counters of a queue
+ * 
+ * @param Q Pointer to queue
+ * @param out Receives the counters
+ * @return DS_OK on success, DS_ERR_NULLARG if Q or out is NULL
+ */
+ds_error_t ds_queue_stats(const ds_queue_t *Q, ds_stats_t *out) {
+    if (Q == NULL || out == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    *out = Q->stats;
+    return DS_OK;
+}
+
 /**
  * @brief Visualize the queue structure
  * 
@@ -327,7 +879,7 @@ void ds_queue_visualize(const ds_queue_t *Q, FILE *out) {
         return;
     }
     
-    if (Q->front == NULL) {
+    if (Q->size == 0) {
         fprintf(out, "Queue: [empty] (size: %zu)\n", Q->size);
         return;
     }
@@ -335,6 +887,29 @@ void ds_queue_visualize(const ds_queue_t *Q, FILE *out) {
     // Print queue header
     fprintf(out, "Queue: (size: %zu)\n", Q->size);
     
+    // Ring mode: walk the buffer from the head index
+    if (Q->ring != NULL) {
+        for (size_t i = 0; i < Q->size; i++) {
+            void *data = Q->ring[(Q->ring_head + i) & (Q->ring_cap - 1)];
+            
+            fprintf(out, "  [%zu]: ", i);
+            if (data != NULL) {
+                fprintf(out, "%d", *(int*)data);
+            } else {
+                fprintf(out, "NULL");
+            }
+            if (i == 0) {
+                fprintf(out, " [FRONT]");
+            }
+            if (i == Q->size - 1) {
+                fprintf(out, " [REAR]");
+            }
+            fprintf(out, "\n");
+        }
+        fprintf(out, "\n");
+        return;
+    }
+    
     // Print each element (front to rear)
     current = Q->front;
     while (current != NULL) {
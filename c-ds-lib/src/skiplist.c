@@ -0,0 +1,603 @@
+/**
+ * @file skiplist.c
+ * @brief Skip list ordered container implementation
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * This file implements a skip list with promotion probability 1/4 and at
+ * most DS_SKIPLIST_MAX_LEVEL lanes. Every node is allocated with exactly
+ * as many forward links as lanes it belongs to. Searches remember the
+ * link they came through on each lane, so insert and remove splice the
+ * node in or out without a second pass.
+ * 
+ * In CONCURRENT=1 builds the links are C11 atomics: the single writer
+ * publishes with release stores and readers follow links with acquire
+ * loads, so lookups and scans can run while an insert is in progress.
+ */
+
+#include "ds_skiplist.h"
+#include "ds_internal.h"
+#include <stdio.h>   /* for printf */
+#include <stddef.h>  /* for offsetof */
+#include <stdint.h>  /* for uint64_t */
+#ifdef DS_ENABLE_CONCURRENT
+#include <stdatomic.h>
+#endif
+
+/**
+ * @brief Maximum number of lanes
+ * 
+ * With promotion probability 1/4, 32 lanes cover far more elements than
+ * fit in memory. Override at build time to tune.
+ */
+#ifndef DS_SKIPLIST_MAX_LEVEL
+#define DS_SKIPLIST_MAX_LEVEL 32
+#endif
+
+struct ds_skiplist_node;
+
+/**
+ * @brief Forward link and lane count, atomic when readers may run concurrently
+ */
+#ifdef DS_ENABLE_CONCURRENT
+typedef _Atomic(struct ds_skiplist_node *) ds_sl_link_t;
+typedef atomic_uint ds_sl_level_t;
+#define DS_SL_LOAD(x) atomic_load_explicit(&(x), memory_order_acquire)
+#define DS_SL_STORE(x, v) atomic_store_explicit(&(x), (v), memory_order_release)
+#define DS_SL_INIT(x, v) atomic_init(&(x), (v))
+#else
+typedef struct ds_skiplist_node *ds_sl_link_t;
+typedef unsigned ds_sl_level_t;
+#define DS_SL_LOAD(x) (x)
+#define DS_SL_STORE(x, v) ((x) = (v))
+#define DS_SL_INIT(x, v) ((x) = (v))
+#endif
+
+/**
+ * @brief Internal node structure for skip list
+ * 
+ * next[i] is the following node on lane i; lane 0 links every element
+ * in ascending order.
+ */
+struct ds_skiplist_node {
+    void *data;                    /**< Pointer to user data */
+    unsigned levels;               /**< Number of lanes this node is linked into */
+    ds_sl_link_t next[];           /**< Forward links, one per lane */
+};
+
+/**
+ * @brief Bytes allocated for a node with the given number of lanes
+ */
+#define DS_SL_NODE_SIZE(levels) \
+    (offsetof(struct ds_skiplist_node, next) + (size_t)(levels) * sizeof(ds_sl_link_t))
+
+/**
+ * @brief Internal skip list structure
+ * 
+ * The head links act as the forward links of a sentinel that precedes
+ * every element.
+ */
+struct ds_skiplist {
+    ds_sl_link_t head[DS_SKIPLIST_MAX_LEVEL]; /**< First node on each lane */
+    ds_sl_level_t level;           /**< Number of lanes in use */
+    size_t size;                   /**< Number of elements in skip list */
+    uint64_t rng;                  /**< Xorshift state for lane counts */
+    ds_allocator_t alloc;          /**< Allocator used for nodes */
+    ds_stats_t stats;              /**< Runtime counters */
+};
+
+/**
+ * @brief Draw the number of lanes for a new node
+ * 
+ * Each further lane is taken with probability 1/4, using two bits of a
+ * xorshift64 draw per lane.
+ * 
+ * @param S Pointer to skip list
+ * @return Lane count between 1 and DS_SKIPLIST_MAX_LEVEL
+ */
+static unsigned random_level(ds_skiplist_t *S) {
+    uint64_t r;
+    unsigned level = 1;
+    
+    S->rng ^= S->rng << 13;
+    S->rng ^= S->rng >> 7;
+    S->rng ^= S->rng << 17;
+    
+    for (r = S->rng; (r & 3) == 0 && level < DS_SKIPLIST_MAX_LEVEL; r >>= 2) {
+        level++;
+    }
+    return level;
+}
+
+/**
+ * @brief Find the first node not less than key
+ * 
+ * Descends from the highest lane in use. When preds is given, preds[i]
+ * receives the link on lane i that leads to the result, which is where
+ * a node would be spliced in or out.
+ * 
+ * @param S Pointer to skip list
+ * @param key Pointer to key to look for
+ * @param cmp Comparison function
+ * @param preds Receives one link per lane in use (may be NULL)
+ * @param found Set to non-zero if the result equals key
+ * @param steps Incremented by the number of nodes compared against key
+ * @return First node >= key, or NULL if none
+ */
+static struct ds_skiplist_node *lower_bound(const ds_skiplist_t *S, const void *key,
+                                            int (*cmp)(const void *, const void *),
+                                            ds_sl_link_t **preds, int *found, size_t *steps) {
+    const ds_sl_link_t *links = S->head;
+    struct ds_skiplist_node *next = NULL;
+    unsigned i = DS_SL_LOAD(S->level);
+    int r = 1;
+    
+    while (i-- > 0) {
+        // Move right while the next node on this lane is still below key
+        while ((next = DS_SL_LOAD(links[i])) != NULL) {
+            (*steps)++;
+            r = cmp(key, next->data);
+            if (r <= 0) {
+                break;
+            }
+            links = next->next;
+        }
+        if (preds != NULL) {
+            preds[i] = (ds_sl_link_t *)&links[i];
+        }
+    }
+    
+    *found = (next != NULL && r == 0);
+    return next;
+}
+
+/**
+ * @brief Create a new empty skip list
+ * 
+ * @return Pointer to new skip list on success, NULL on memory allocation failure
+ */
+ds_skiplist_t *ds_skiplist_create(void) {
+    return ds_skiplist_create_with_allocator(NULL);
+}
+
+/**
+ * @brief Create a new empty skip list with a custom node allocator
+ * 
+ * @param a Allocator for nodes, or NULL for the library-level allocator
+ * @return Pointer to new skip list on success, NULL on invalid allocator or memory failure
+ */
+ds_skiplist_t *ds_skiplist_create_with_allocator(const ds_allocator_t *a) {
+    ds_skiplist_t *list;
+    
+    // Allocate memory for skip list structure
+    list = (ds_skiplist_t *)ds_alloc(sizeof(struct ds_skiplist));
+    if (list == NULL) {
+        return NULL;
+    }
+    
+    // Capture the node allocator
+    if (ds_allocator_init(&list->alloc, a) != DS_OK) {
+        ds_free(list);
+        return NULL;
+    }
+    
+    // Initialize skip list to empty state
+    for (int i = 0; i < DS_SKIPLIST_MAX_LEVEL; i++) {
+        DS_SL_INIT(list->head[i], NULL);
+    }
+    DS_SL_INIT(list->level, 0);
+    list->size = 0;
+    list->rng = 0x9E3779B97F4A7C15u;
+    ds_stats_init(&list->stats);
+    
+    return list;
+}
+
+/**
+ * @brief Free a skip list and optionally its data
+ * 
+ * Walks the bottom lane, which links every node exactly once.
+ * 
+ * @param S Pointer to skip list to free
+ * @param free_data Optional function to free element data (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if S is NULL
+ */
+ds_error_t ds_skiplist_free(ds_skiplist_t *S, void (*free_data)(void *)) {
+    struct ds_skiplist_node *current, *next;
+    
+    // Validate input parameter
+    if (S == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    // Arena nodes are released wholesale, so only walk if data needs freeing
+    current = (ds_allocator_frees(&S->alloc) || free_data != NULL) ? DS_SL_LOAD(S->head[0]) : NULL;
+    while (current != NULL) {
+        next = DS_SL_LOAD(current->next[0]);
+        
+        // Call user's free function for data if provided
+        if (free_data != NULL && current->data != NULL) {
+            free_data(current->data);
+        }
+        
+        ds_node_free(&S->alloc, &S->stats, current, DS_SL_NODE_SIZE(current->levels));
+        current = next;
+    }
+    
+    // Free the skip list structure
+    ds_stats_release(&S->stats);
+    ds_free(S);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Untraced implementation of ds_skiplist_insert
+ */
+static ds_error_t skiplist_insert(ds_skiplist_t *S, void *data, int (*cmp)(const void *, const void *)) {
+    ds_sl_link_t *preds[DS_SKIPLIST_MAX_LEVEL];
+    struct ds_skiplist_node *node;
+    unsigned level, old_level, i;
+    size_t steps = 0;
+    int found;
+    
+    // Validate input parameters
+    if (S == NULL || data == NULL || cmp == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    lower_bound(S, data, cmp, preds, &found, &steps);
+    ds_stats_count_compares(&S->stats, steps);
+    if (found) {
+        return DS_OK;  // Consider this success (no duplicates)
+    }
+    
+    // Lanes above the ones in use start at the head
+    level = random_level(S);
+    old_level = DS_SL_LOAD(S->level);
+    for (i = old_level; i < level; i++) {
+        preds[i] = &S->head[i];
+    }
+    
+    node = (struct ds_skiplist_node *)ds_node_alloc(&S->alloc, &S->stats, DS_SL_NODE_SIZE(level));
+    if (node == NULL) {
+        return DS_ERR_OOM;
+    }
+    node->data = data;
+    node->levels = level;
+    for (i = 0; i < level; i++) {
+        DS_SL_INIT(node->next[i], DS_SL_LOAD(*preds[i]));
+    }
+    
+    // Publish bottom-up, then make the new lanes visible to searches
+    for (i = 0; i < level; i++) {
+        DS_SL_STORE(*preds[i], node);
+    }
+    if (level > old_level) {
+        DS_SL_STORE(S->level, level);
+    }
+    
+    S->size++;
+    ds_stats_resize(&S->stats, S->size);
+    return DS_OK;
+}
+
+/**
+ * @brief Insert element into the skip list
+ * 
+ * The new node is fully built before it is linked in, lane 0 first, so a
+ * concurrent reader sees either the old list or a consistent new one.
+ * 
+ * @param S Pointer to skip list
+ * @param data Pointer to data to insert
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return DS_OK on success, DS_ERR_NULLARG if S, data, or cmp is NULL, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_skiplist_insert(ds_skiplist_t *S, void *data, int (*cmp)(const void *, const void *)) {
+    ds_error_t result;
+    
+    DS_TRACE_BEGIN();
+    result = skiplist_insert(S, data, cmp);
+    DS_TRACE_END(DS_TRACE_SKIPLIST_INSERT, S);
+    
+    return result;
+}
+
+/**
+ * @brief Untraced implementation of ds_skiplist_find
+ */
+static void *skiplist_find(const ds_skiplist_t *S, const void *target,
+                           int (*cmp)(const void *, const void *)) {
+    struct ds_skiplist_node *node;
+    size_t steps = 0;
+    int found;
+    
+    // Validate input parameters
+    if (S == NULL || target == NULL || cmp == NULL) {
+        return NULL;
+    }
+    
+    node = lower_bound(S, target, cmp, NULL, &found, &steps);
+#ifndef DS_ENABLE_CONCURRENT
+    // Readers must not write shared state when they may run concurrently
+    ds_stats_count_find((ds_stats_t *)&S->stats, 1, steps, steps);
+#endif
+    
+    return found ? node->data : NULL;
+}
+
+/**
+ * @brief Find element in the skip list
+ * 
+ * @param S Pointer to skip list
+ * @param target Pointer to data to find
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return Pointer to matching data, or NULL if not found or S/cmp/target is NULL
+ */
+void *ds_skiplist_find(const ds_skiplist_t *S, const void *target,
+                       int (*cmp)(const void *, const void *)) {
+    void *result;
+    
+    DS_TRACE_BEGIN();
+    result = skiplist_find(S, target, cmp);
+    DS_TRACE_END(DS_TRACE_SKIPLIST_FIND, S);
+    
+    return result;
+}
+
+/**
+ * @brief Untraced implementation of ds_skiplist_remove
+ */
+static ds_error_t skiplist_remove(ds_skiplist_t *S, const void *target,
+                                  int (*cmp)(const void *, const void *)) {
+    ds_sl_link_t *preds[DS_SKIPLIST_MAX_LEVEL];
+    struct ds_skiplist_node *node;
+    unsigned level;
+    size_t steps = 0;
+    int found;
+    
+    // Validate input parameters
+    if (S == NULL || target == NULL || cmp == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    node = lower_bound(S, target, cmp, preds, &found, &steps);
+    ds_stats_count_compares(&S->stats, steps);
+    if (!found) {
+        return DS_ERR_NOTFOUND;
+    }
+    
+    // Unlink from every lane the node belongs to, top lane first
+    for (unsigned i = node->levels; i-- > 0;) {
+        DS_SL_STORE(*preds[i], DS_SL_LOAD(node->next[i]));
+    }
+    
+    // Drop lanes that became empty
+    level = DS_SL_LOAD(S->level);
+    while (level > 0 && DS_SL_LOAD(S->head[level - 1]) == NULL) {
+        level--;
+    }
+    DS_SL_STORE(S->level, level);
+    
+    ds_node_free(&S->alloc, &S->stats, node, DS_SL_NODE_SIZE(node->levels));
+    S->size--;
+    ds_stats_resize(&S->stats, S->size);
+    return DS_OK;
+}
+
+/**
+ * @brief Remove element from the skip list
+ * 
+ * @param S Pointer to skip list
+ * @param target Pointer to data to remove
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return DS_OK on success, DS_ERR_NULLARG if S, target, or cmp is NULL, DS_ERR_NOTFOUND if not found
+ */
+ds_error_t ds_skiplist_remove(ds_skiplist_t *S, const void *target,
+                              int (*cmp)(const void *, const void *)) {
+    ds_error_t result;
+    
+    DS_TRACE_BEGIN();
+    result = skiplist_remove(S, target, cmp);
+    DS_TRACE_END(DS_TRACE_SKIPLIST_REMOVE, S);
+    
+    return result;
+}
+
+/**
+ * @brief Get the number of elements in the skip list
+ * 
+ * @param S Pointer to skip list
+ * @return Number of elements in skip list, or 0 if S is NULL
+ */
+size_t ds_skiplist_size(const ds_skiplist_t *S) {
+    if (S == NULL) {
+        return 0;
+    }
+    
+    return S->size;
+}
+
+/**
+ * @brief Check if skip list is empty
+ * 
+ * @param S Pointer to skip list
+ * @return 1 if empty, 0 if not empty, 1 if S is NULL
+ */
+int ds_skiplist_is_empty(const ds_skiplist_t *S) {
+    if (S == NULL) {
+        return 1;  // Consider NULL as empty
+    }
+    
+    return (S->size == 0) ? 1 : 0;
+}
+
+/**
+ * @brief Position an iterator at the smallest element
+ * 
+ * @param it Iterator to initialize
+ * @param S Pointer to skip list
+ * @return Pointer to smallest element's data, or NULL if S is empty or it/S is NULL
+ */
+void *ds_skiplist_iter_first(ds_skiplist_iter_t *it, const ds_skiplist_t *S) {
+    if (it == NULL) {
+        return NULL;
+    }
+    
+    it->list = S;
+    it->node = (S != NULL) ? DS_SL_LOAD(S->head[0]) : NULL;
+    return ds_skiplist_iter_get(it);
+}
+
+/**
+ * @brief Position an iterator at the first element not less than key
+ * 
+ * @param it Iterator to initialize
+ * @param S Pointer to skip list
+ * @param key Pointer to key to seek to
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return Pointer to data of first element >= key, or NULL if none or any argument is NULL
+ */
+void *ds_skiplist_iter_seek(ds_skiplist_iter_t *it, const ds_skiplist_t *S, const void *key,
+                            int (*cmp)(const void *, const void *)) {
+    size_t steps = 0;
+    int found;
+    
+    if (it == NULL) {
+        return NULL;
+    }
+    
+    it->list = S;
+    it->node = NULL;
+    if (S == NULL || key == NULL || cmp == NULL) {
+        return NULL;
+    }
+    
+    it->node = lower_bound(S, key, cmp, NULL, &found, &steps);
+    return ds_skiplist_iter_get(it);
+}
+
+/**
+ * @brief Advance an iterator to the next element in order
+ * 
+ * @param it Pointer to iterator
+ * @return Pointer to next element's data, or NULL when the iteration is over
+ */
+void *ds_skiplist_iter_next(ds_skiplist_iter_t *it) {
+    if (it == NULL || it->node == NULL) {
+        return NULL;
+    }
+    
+    it->node = DS_SL_LOAD(((struct ds_skiplist_node *)it->node)->next[0]);
+    return ds_skiplist_iter_get(it);
+}
+
+/**
+ * @brief Get the element an iterator is positioned at
+ * 
+ * @param it Pointer to iterator
+ * @return Pointer to current element's data, or NULL if exhausted or it is NULL
+ */
+void *ds_skiplist_iter_get(const ds_skiplist_iter_t *it) {
+    if (it == NULL || it->node == NULL) {
+        return NULL;
+    }
+    
+    return ((struct ds_skiplist_node *)it->node)->data;
+}
+
+/**
+ * @brief Visit all elements in the closed range [lo, hi] in order
+ * 
+ * @param S Pointer to skip list
+ * @param lo Lower bound (NULL for no lower bound)
+ * @param hi Upper bound (NULL for no upper bound)
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @param cb Callback invoked with each element and ctx
+ * @param ctx User context passed to cb
+ * @return DS_OK on success, DS_ERR_NULLARG if S, cmp, or cb is NULL
+ */
+ds_error_t ds_skiplist_range(const ds_skiplist_t *S, const void *lo, const void *hi,
+                             int (*cmp)(const void *, const void *),
+                             int (*cb)(void *data, void *ctx), void *ctx) {
+    ds_skiplist_iter_t it;
+    void *data;
+    
+    // Validate input parameters
+    if (S == NULL || cmp == NULL || cb == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    // Seek to the lower bound, then walk the bottom lane up to hi
+    data = (lo != NULL) ? ds_skiplist_iter_seek(&it, S, lo, cmp) : ds_skiplist_iter_first(&it, S);
+    while (data != NULL) {
+        if (hi != NULL && cmp(data, hi) > 0) {
+            break;
+        }
+        if (cb(data, ctx) != 0) {
+            break;
+        }
+        data = ds_skiplist_iter_next(&it);
+    }
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Get the runtime counters of a skip list
+ * 
+ * @param S Pointer to skip list
+ * @param out Receives the counters
+ * @return DS_OK on success, DS_ERR_NULLARG if S or out is NULL
+ */
+ds_error_t ds_skiplist_stats(const ds_skiplist_t *S, ds_stats_t *out) {
+    if (S == NULL || out == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    *out = S->stats;
+    return DS_OK;
+}
+
+/**
+ * @brief Visualize the skip list structure
+ * 
+ * @param S Pointer to skip list
+ * @param out Output stream (e.g., stdout, stderr)
+ */
+void ds_skiplist_visualize(const ds_skiplist_t *S, FILE *out) {
+    const struct ds_skiplist_node *current;
+    size_t count = 0;
+    
+    // Handle NULL parameters gracefully
+    if (out == NULL) {
+        out = stdout;  // Default to stdout
+    }
+    
+    if (S == NULL) {
+        fprintf(out, "SkipList: NULL\n");
+        return;
+    }
+    
+    if (S->size == 0) {
+        fprintf(out, "SkipList: [empty] (size: %zu)\n", S->size);
+        return;
+    }
+    
+    // Print skip list header
+    fprintf(out, "SkipList: (size: %zu, lanes: %u)\n", S->size, (unsigned)DS_SL_LOAD(S->level));
+    
+    // Print each element with its lane count
+    for (current = DS_SL_LOAD(S->head[0]); current != NULL; current = DS_SL_LOAD(current->next[0])) {
+        fprintf(out, "  [%zu]: ", count++);
+        if (current->data != NULL) {
+            fprintf(out, "%d", *(int*)current->data);
+        } else {
+            fprintf(out, "NULL");
+        }
+        fprintf(out, " (lanes: %u)\n", current->levels);
+    }
+    
+    fprintf(out, "\n");
+}
@@ -0,0 +1,230 @@
+/**
+ * @file slab.c
+ * @brief Fixed-size slab pool implementation
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * This file implements a slab pool that serves equally sized objects from
+ * large contiguous slabs. It backs the node storage of pooled containers.
+ */
+
+#include "ds_internal.h"
+
+/**
+ * @brief Alignment helper covering every fundamental type
+ */
+union ds_slab_align {
+    long double ld;                /**< Widest floating point type */
+    long long ll;                  /**< Widest integer type */
+    void *p;                       /**< Object pointer */
+    void (*fn)(void);              /**< Function pointer */
+};
+
+#define DS_SLAB_ALIGN sizeof(union ds_slab_align)
+#define DS_SLAB_ROUND(n) (((n) + DS_SLAB_ALIGN - 1) / DS_SLAB_ALIGN * DS_SLAB_ALIGN)
+
+/**
+ * @brief Header placed at the start of every slab
+ * 
+ * Slabs are chained so they can all be released when the pool is freed.
+ */
+struct ds_slab_chunk {
+    struct ds_slab_chunk *next;    /**< Pointer to previously allocated slab */
+};
+
+/**
+ * @brief Released object, linked into the pool's free list
+ */
+struct ds_slab_free_obj {
+    struct ds_slab_free_obj *next; /**< Pointer to next free object */
+};
+
+/**
+ * @brief Internal slab pool structure
+ * 
+ * Fresh objects are bump-allocated from the newest slab; released objects
+ * are pushed onto a free list and handed out again first.
+ */
+struct ds_slab {
+    size_t obj_size;                   /**< Object size rounded to alignment */
+    size_t objs_per_slab;              /**< Number of objects per slab */
+    struct ds_slab_free_obj *free_list; /**< Recycled objects */
+    struct ds_slab_chunk *chunks;      /**< Chain of allocated slabs */
+    char *bump;                        /**< Next unused object in newest slab */
+    char *bump_end;                    /**< End of newest slab */
+};
+
+/**
+ * @brief Allocation callback for slab allocators
+ * 
+ * @param ctx Pointer to the slab pool
+ * @param n Number of bytes requested
+ * @return Pointer to an object, or NULL if n is too large or on memory failure
+ */
+static void *slab_alloc(void *ctx, size_t n) {
+    ds_slab_t *P = (ds_slab_t *)ctx;
+    struct ds_slab_chunk *chunk;
+    void *obj;
+    
+    if (n > P->obj_size) {
+        return NULL;
+    }
+    
+    // Reuse a released object if one is available
+    if (P->free_list != NULL) {
+        obj = P->free_list;
+        P->free_list = P->free_list->next;
+        return obj;
+    }
+    
+    // Start a new slab when the current one is exhausted
+    if (P->bump == P->bump_end) {
+        chunk = (struct ds_slab_chunk *)ds_alloc(DS_SLAB_ROUND(sizeof(struct ds_slab_chunk)) +
+                                                 P->obj_size * P->objs_per_slab);
+        if (chunk == NULL) {
+            return NULL;
+        }
+        
+        chunk->next = P->chunks;
+        P->chunks = chunk;
+        P->bump = (char *)chunk + DS_SLAB_ROUND(sizeof(struct ds_slab_chunk));
+        P->bump_end = P->bump + P->obj_size * P->objs_per_slab;
+    }
+    
+    obj = P->bump;
+    P->bump += P->obj_size;
+    return obj;
+}
+
+/**
+ * @brief Deallocation callback for slab allocators
+ * 
+ * @param ctx Pointer to the slab pool
+ * @param p Pointer to object to release
+ */
+static void slab_release(void *ctx, void *p) {
+    ds_slab_t *P = (ds_slab_t *)ctx;
+    struct ds_slab_free_obj *obj = (struct ds_slab_free_obj *)p;
+    
+    if (obj == NULL) {
+        return;
+    }
+    
+    obj->next = P->free_list;
+    P->free_list = obj;
+}
+
+/**
+ * @brief Create a new fixed-size slab pool
+ * 
+ * @param obj_size Size in bytes of each object
+ * @param objs_per_slab Number of objects per slab (0 selects a default)
+ * @return Pointer to new pool on success, NULL if obj_size is 0, a slab of
+ *         objs_per_slab objects would not fit in a size_t, or on memory failure
+ */
+ds_slab_t *ds_slab_create(size_t obj_size, size_t objs_per_slab) {
+    ds_slab_t *pool;
+    
+    if (obj_size == 0 || obj_size > (size_t)-1 - DS_SLAB_ALIGN) {
+        return NULL;
+    }
+    
+    // Objects must be able to hold a free list link
+    if (obj_size < sizeof(struct ds_slab_free_obj)) {
+        obj_size = sizeof(struct ds_slab_free_obj);
+    }
+    obj_size = DS_SLAB_ROUND(obj_size);
+    if (objs_per_slab == 0) {
+        objs_per_slab = DS_SLAB_DEFAULT_OBJS;
+    }
+    
+    // The slab header plus all objects must fit in a size_t
+    if (objs_per_slab > ((size_t)-1 - DS_SLAB_ROUND(sizeof(struct ds_slab_chunk))) / obj_size) {
+        return NULL;
+    }
+    
+    // Allocate memory for pool structure
+    pool = (ds_slab_t *)ds_alloc(sizeof(struct ds_slab));
+    if (pool == NULL) {
+        return NULL;
+    }
+    
+    // Initialize pool with no slabs allocated yet
+    pool->obj_size = obj_size;
+    pool->objs_per_slab = objs_per_slab;
+    pool->free_list = NULL;
+    pool->chunks = NULL;
+    pool->bump = NULL;
+    pool->bump_end = NULL;
+    
+    return pool;
+}
+
+/**
+ * @brief Free a slab pool and every object it handed out
+ * 
+ * @param P Pointer to pool to free
+ * @return DS_OK on success, DS_ERR_NULLARG if P is NULL
+ */
+ds_error_t ds_slab_free(ds_slab_t *P) {
+    struct ds_slab_chunk *current, *next;
+    
+    // Validate input parameter
+    if (P == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    // Release every slab in one pass
+    current = P->chunks;
+    while (current != NULL) {
+        next = current->next;
+        ds_free(current);
+        current = next;
+    }
+    
+    // Free the pool structure
+    ds_free(P);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Get the number of bytes a slab pool holds
+ * 
+ * Walks the slab chain, so the cost grows with the number of slabs.
+ * 
+ * @param P Pointer to pool
+ * @return Bytes of the pool structure and every slab, 0 if P is NULL
+ */
+size_t ds_slab_bytes(const ds_slab_t *P) {
+    const struct ds_slab_chunk *chunk;
+    size_t bytes;
+    
+    if (P == NULL) {
+        return 0;
+    }
+    
+    bytes = sizeof(struct ds_slab);
+    for (chunk = P->chunks; chunk != NULL; chunk = chunk->next) {
+        bytes += DS_SLAB_ROUND(sizeof(struct ds_slab_chunk)) + P->obj_size * P->objs_per_slab;
+    }
+    return bytes;
+}
+
+/**
+ * @brief Get an allocator that draws from a slab pool
+ * 
+ * @param P Pointer to pool
+ * @return Allocator bound to P (callbacks are NULL if P is NULL)
+ */
+ds_allocator_t ds_slab_allocator(ds_slab_t *P) {
+    ds_allocator_t a;
+    
+    a.alloc = (P != NULL) ? slab_alloc : NULL;
+    a.free = (P != NULL) ? slab_release : NULL;
+    a.ctx = P;
+    
+    return a;
+}
+
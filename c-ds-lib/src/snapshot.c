@@ -0,0 +1,437 @@
+/**
+ * @file snapshot.c
+ * @brief Memory-mapped snapshot writer and reader
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * Implements the file format described in ds_snapshot.h. Writing uses
+ * stdio; reading maps the whole file read-only and serves payload
+ * pointers straight out of the mapping.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ds.h"
+#include "ds_snapshot.h"
+#include "ds_internal.h"
+#include <stdint.h>     /* for uint32_t, uint64_t */
+#include <stdio.h>      /* for FILE, fopen, rename */
+#include <string.h>     /* for memcmp, memcpy, strlen */
+#include <fcntl.h>      /* for open */
+#include <unistd.h>     /* for close */
+#include <sys/mman.h>   /* for mmap, munmap */
+#include <sys/stat.h>   /* for fstat */
+
+/**
+ * @brief File signature, including the format version
+ */
+static const char snapshot_magic[8] = "DSSNAP1";
+
+/**
+ * @brief Value stored in native byte order to detect foreign files
+ */
+#define DS_SNAPSHOT_BYTE_ORDER 0x01020304u
+
+/**
+ * @brief Alignment of payloads and of the index
+ */
+#define DS_SNAPSHOT_ALIGN 8
+
+/**
+ * @brief Initial size of the serialization buffer
+ */
+#define DS_SNAPSHOT_BUF_MIN 256
+
+/**
+ * @brief On-disk file header (64 bytes)
+ */
+struct ds_snapshot_header {
+    char magic[8];                 /**< snapshot_magic */
+    uint32_t kind;                 /**< DS_SNAPSHOT_TREE or DS_SNAPSHOT_LIST */
+    uint32_t byte_order;           /**< DS_SNAPSHOT_BYTE_ORDER */
+    uint64_t count;                /**< Number of elements */
+    uint64_t index_off;            /**< File offset of the index */
+    uint64_t file_size;            /**< Total file size in bytes */
+    uint64_t reserved[3];          /**< Zero */
+};
+
+/**
+ * @brief On-disk index entry
+ */
+struct ds_snapshot_entry {
+    uint64_t off;                  /**< File offset of the payload */
+    uint64_t len;                  /**< Payload length in bytes */
+};
+
+/**
+ * @brief Internal mapped snapshot structure
+ */
+struct ds_snapshot {
+    const unsigned char *base;     /**< Start of the mapping */
+    size_t length;                 /**< Mapping length in bytes */
+    unsigned kind;                 /**< Snapshot kind from the header */
+    size_t count;                  /**< Number of elements */
+    const struct ds_snapshot_entry *index; /**< Index inside the mapping */
+};
+
+/**
+ * @brief Write zero padding up to the next alignment boundary
+ * 
+ * @param f Output file
+ * @param pos Current file offset, advanced past the padding
+ * @return 1 on success, 0 on write failure
+ */
+static int write_padding(FILE *f, uint64_t *pos) {
+    static const unsigned char zeros[DS_SNAPSHOT_ALIGN];
+    size_t pad = (size_t)((DS_SNAPSHOT_ALIGN - *pos % DS_SNAPSHOT_ALIGN) % DS_SNAPSHOT_ALIGN);
+    
+    if (pad != 0 && fwrite(zeros, 1, pad, f) != pad) {
+        return 0;
+    }
+    *pos += pad;
+    return 1;
+}
+
+/**
+ * @brief Serialize every element into an open snapshot file
+ * 
+ * Payloads are streamed out as they are serialized; the index is kept
+ * in memory and appended at the end, and the header is written last.
+ * 
+ * @param f Output file, positioned at offset 0
+ * @param kind Snapshot kind
+ * @param count Number of elements next will yield
+ * @param next Returns the next element's data on each call
+ * @param state State passed to next
+ * @param ser Serializer
+ * @param ctx User context passed to ser
+ * @return DS_OK on success, DS_ERR_INVALID, DS_ERR_OOM or DS_ERR_IO on failure
+ */
+static ds_error_t write_snapshot(FILE *f, unsigned kind, size_t count,
+                                 void *(*next)(void *state), void *state,
+                                 size_t (*ser)(const void *data, void *buf, size_t cap, void *ctx),
+                                 void *ctx) {
+    struct ds_snapshot_header header;
+    struct ds_snapshot_entry *index;
+    unsigned char *buf;
+    size_t cap = DS_SNAPSHOT_BUF_MIN, len, i;
+    uint64_t pos;
+    ds_error_t result = DS_OK;
+    
+    buf = (unsigned char *)ds_alloc(cap);
+    index = (struct ds_snapshot_entry *)ds_alloc((count > 0 ? count : 1) * sizeof(*index));
+    if (buf == NULL || index == NULL) {
+        ds_free(buf);
+        ds_free(index);
+        return DS_ERR_OOM;
+    }
+    
+    // Reserve the header; it is filled in once the layout is known
+    memset(&header, 0, sizeof(header));
+    if (fwrite(&header, sizeof(header), 1, f) != 1) {
+        result = DS_ERR_IO;
+    }
+    pos = sizeof(header);
+    
+    for (i = 0; i < count && result == DS_OK; i++) {
+        const void *data = next(state);
+        
+        len = ser(data, buf, cap, ctx);
+        if (len == (size_t)-1) {
+            result = DS_ERR_INVALID;
+            break;
+        }
+        if (len > cap) {
+            // Grow the scratch buffer and serialize again
+            unsigned char *grown = (unsigned char *)ds_alloc(len);
+            
+            if (grown == NULL) {
+                result = DS_ERR_OOM;
+                break;
+            }
+            ds_free(buf);
+            buf = grown;
+            cap = len;
+            if (ser(data, buf, cap, ctx) != len) {
+                result = DS_ERR_INVALID;
+                break;
+            }
+        }
+        
+        index[i].off = pos;
+        index[i].len = len;
+        if (len != 0 && fwrite(buf, 1, len, f) != len) {
+            result = DS_ERR_IO;
+            break;
+        }
+        pos += len;
+        if (!write_padding(f, &pos)) {
+            result = DS_ERR_IO;
+        }
+    }
+    
+    // Append the index and go back for the header
+    if (result == DS_OK) {
+        memcpy(header.magic, snapshot_magic, sizeof(header.magic));
+        header.kind = kind;
+        header.byte_order = DS_SNAPSHOT_BYTE_ORDER;
+        header.count = count;
+        header.index_off = pos;
+        header.file_size = pos + count * sizeof(*index);
+        if ((count != 0 && fwrite(index, sizeof(*index), count, f) != count) ||
+            fseek(f, 0, SEEK_SET) != 0 || fwrite(&header, sizeof(header), 1, f) != 1) {
+            result = DS_ERR_IO;
+        }
+    }
+    
+    ds_free(buf);
+    ds_free(index);
+    return result;
+}
+
+/**
+ * @brief Write a snapshot file from a sequence of elements
+ * 
+ * @param path Destination file
+ * @param kind Snapshot kind
+ * @param count Number of elements next will yield
+ * @param next Returns the next element's data on each call
+ * @param state State passed to next
+ * @param ser Serializer
+ * @param ctx User context passed to ser
+ * @return DS_OK on success, DS_ERR_INVALID, DS_ERR_OOM or DS_ERR_IO on failure
+ */
+ds_error_t ds_snapshot_write(const char *path, unsigned kind, size_t count,
+                             void *(*next)(void *state), void *state,
+                             size_t (*ser)(const void *data, void *buf, size_t cap, void *ctx),
+                             void *ctx) {
+    size_t len = strlen(path);
+    ds_error_t result;
+    char *tmp;
+    FILE *f;
+    
+    if (count > SIZE_MAX / sizeof(struct ds_snapshot_entry)) {
+        return DS_ERR_OOM;
+    }
+    
+    // Write beside the target, then rename, so readers see old or new
+    tmp = (char *)ds_alloc(len + 5);
+    if (tmp == NULL) {
+        return DS_ERR_OOM;
+    }
+    memcpy(tmp, path, len);
+    memcpy(tmp + len, ".tmp", 5);
+    
+    f = fopen(tmp, "wb");
+    if (f == NULL) {
+        ds_free(tmp);
+        return DS_ERR_IO;
+    }
+    
+    result = write_snapshot(f, kind, count, next, state, ser, ctx);
+    if (fclose(f) != 0 && result == DS_OK) {
+        result = DS_ERR_IO;
+    }
+    if (result == DS_OK && rename(tmp, path) != 0) {
+        result = DS_ERR_IO;
+    }
+    if (result != DS_OK) {
+        remove(tmp);
+    }
+    
+    ds_free(tmp);
+    return result;
+}
+
+/**
+ * @brief Map a snapshot file and validate its header
+ * 
+ * @param path File to map
+ * @param kind Expected snapshot kind
+ * @return Pointer to mapped snapshot, or NULL on any failure
+ */
+static ds_snapshot_t *snapshot_open(const char *path, unsigned kind) {
+    struct ds_snapshot_header header;
+    ds_snapshot_t *S;
+    struct stat st;
+    void *base;
+    int fd;
+    
+    if (path == NULL) {
+        return NULL;
+    }
+    
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(header)) {
+        close(fd);
+        return NULL;
+    }
+    
+    // The mapping stays valid after the descriptor is closed
+    base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+    
+    memcpy(&header, base, sizeof(header));
+    if (memcmp(header.magic, snapshot_magic, sizeof(header.magic)) != 0 ||
+        header.kind != kind || header.byte_order != DS_SNAPSHOT_BYTE_ORDER ||
+        header.file_size != (uint64_t)st.st_size ||
+        header.index_off < sizeof(header) || header.index_off % DS_SNAPSHOT_ALIGN != 0 ||
+        header.index_off > header.file_size ||
+        header.count != (header.file_size - header.index_off) / sizeof(struct ds_snapshot_entry) ||
+        (header.file_size - header.index_off) % sizeof(struct ds_snapshot_entry) != 0) {
+        munmap(base, (size_t)st.st_size);
+        return NULL;
+    }
+    
+    S = (ds_snapshot_t *)ds_alloc(sizeof(struct ds_snapshot));
+    if (S == NULL) {
+        munmap(base, (size_t)st.st_size);
+        return NULL;
+    }
+    S->base = (const unsigned char *)base;
+    S->length = (size_t)st.st_size;
+    S->kind = kind;
+    S->count = (size_t)header.count;
+    S->index = (const struct ds_snapshot_entry *)(S->base + header.index_off);
+    
+    return S;
+}
+
+/**
+ * @brief Open a tree snapshot written by ds_tree_save
+ * 
+ * @param path File to map
+ * @return Pointer to the mapped snapshot, or NULL on failure
+ */
+ds_snapshot_t *ds_tree_open_mapped(const char *path) {
+    return snapshot_open(path, DS_SNAPSHOT_TREE);
+}
+
+/**
+ * @brief Open a list snapshot written by ds_list_save
+ * 
+ * @param path File to map
+ * @return Pointer to the mapped snapshot, or NULL on failure
+ */
+ds_snapshot_t *ds_list_open_mapped(const char *path) {
+    return snapshot_open(path, DS_SNAPSHOT_LIST);
+}
+
+/**
+ * @brief Unmap a snapshot
+ * 
+ * @param S Pointer to snapshot
+ * @return DS_OK on success, DS_ERR_NULLARG if S is NULL
+ */
+ds_error_t ds_snapshot_close(ds_snapshot_t *S) {
+    if (S == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    munmap((void *)S->base, S->length);
+    ds_free(S);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Get the number of elements in a snapshot
+ * 
+ * @param S Pointer to snapshot
+ * @return Number of elements, or 0 if S is NULL
+ */
+size_t ds_snapshot_size(const ds_snapshot_t *S) {
+    return (S != NULL) ? S->count : 0;
+}
+
+/**
+ * @brief Get the payload of the i-th element
+ * 
+ * Entries are bounds-checked on access rather than at open time, so
+ * opening stays O(1) however large the snapshot is.
+ * 
+ * @param S Pointer to snapshot
+ * @param i Element index
+ * @param len Receives the payload length (may be NULL)
+ * @return Pointer to the payload, or NULL if out of range or corrupt
+ */
+const void *ds_snapshot_get(const ds_snapshot_t *S, size_t i, size_t *len) {
+    const struct ds_snapshot_entry *e;
+    uint64_t limit;
+    
+    if (S == NULL || i >= S->count) {
+        return NULL;
+    }
+    
+    // Payloads must lie between the header and the index
+    e = &S->index[i];
+    limit = (uint64_t)((const unsigned char *)S->index - S->base);
+    if (e->off < sizeof(struct ds_snapshot_header) || e->off > limit || e->len > limit - e->off) {
+        return NULL;
+    }
+    
+    if (len != NULL) {
+        *len = (size_t)e->len;
+    }
+    return S->base + e->off;
+}
+
+/**
+ * @brief Find an element's payload by key
+ * 
+ * @param S Pointer to snapshot
+ * @param key Pointer to key to find
+ * @param cmp Comparison function (key, payload)
+ * @param len Receives the payload length (may be NULL)
+ * @return Pointer to the matching payload, or NULL if not found
+ */
+const void *ds_snapshot_find(const ds_snapshot_t *S, const void *key,
+                             int (*cmp)(const void *key, const void *payload), size_t *len) {
+    const void *payload;
+    size_t lo = 0, hi, i;
+    
+    if (S == NULL || key == NULL || cmp == NULL) {
+        return NULL;
+    }
+    
+    // Lists have no order to exploit
+    if (S->kind == DS_SNAPSHOT_LIST) {
+        for (i = 0; i < S->count; i++) {
+            payload = ds_snapshot_get(S, i, len);
+            if (payload != NULL && cmp(key, payload) == 0) {
+                return payload;
+            }
+        }
+        return NULL;
+    }
+    
+    // Tree payloads are stored in order
+    hi = S->count;
+    while (lo < hi) {
+        int comparison;
+        
+        i = lo + (hi - lo) / 2;
+        payload = ds_snapshot_get(S, i, len);
+        if (payload == NULL) {
+            return NULL;
+        }
+        comparison = cmp(key, payload);
+        if (comparison == 0) {
+            return payload;
+        }
+        if (comparison < 0) {
+            hi = i;
+        } else {
+            lo = i + 1;
+        }
+    }
+    
+    return NULL;
+}
@@ -0,0 +1,371 @@
+/**
+ * @file spsc.c
+ * @brief Bounded lock-free single-producer/single-consumer ring implementation
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * This file implements a Lamport ring with C11 atomics. The indices run
+ * freely and are masked on access, so all slots are usable and full and
+ * empty are told apart by the distance between the indices. Only the
+ * producer writes tail and only the consumer writes head; each side
+ * publishes its index with a release store, and reads the other's with
+ * an acquire load only when its cached copy says the ring is full or
+ * empty.
+ * 
+ * Built only with `make CONCURRENT=1`.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ds_spsc.h"
+#include "ds_internal.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <sched.h>
+
+/**
+ * @brief Spins before a waiting thread starts yielding the CPU
+ */
+#define DS_SPSC_SPIN_LIMIT 64
+
+/**
+ * @brief Internal SPSC ring structure
+ * 
+ * Each index shares its cache line with the owner's cached copy of the
+ * other index, so the producer and consumer each work on their own line
+ * and only pull the other's line in when the cache runs out.
+ */
+struct ds_spsc_ring {
+    void **slots;                  /**< Slot array of mask + 1 entries */
+    size_t mask;                   /**< Capacity minus one (capacity is a power of two) */
+    char pad0[DS_CACHE_LINE - sizeof(void *) - sizeof(size_t)];
+    atomic_size_t head;            /**< Next position to read, written by the consumer */
+    size_t tail_cache;             /**< Consumer's last view of tail */
+    char pad1[DS_CACHE_LINE - sizeof(atomic_size_t) - sizeof(size_t)];
+    atomic_size_t tail;            /**< Next position to write, written by the producer */
+    size_t head_cache;             /**< Producer's last view of head */
+    char pad2[DS_CACHE_LINE - sizeof(atomic_size_t) - sizeof(size_t)];
+};
+
+/**
+ * @brief Wait a little before retrying a blocked operation
+ * 
+ * @param spins Counter of attempts so far, updated by the call
+ */
+static void backoff(unsigned *spins) {
+    if (*spins < DS_SPSC_SPIN_LIMIT) {
+        (*spins)++;
+    } else {
+        sched_yield();
+    }
+}
+
+/**
+ * @brief Count the free slots as seen by the producer
+ * 
+ * Refreshes the cached head only if the cache shows fewer than want
+ * free slots.
+ * 
+ * @param R Pointer to ring
+ * @param tail Producer's current tail
+ * @param want Number of free slots the caller would like
+ * @return Number of free slots
+ */
+static size_t producer_space(ds_spsc_ring_t *R, size_t tail, size_t want) {
+    size_t space = R->mask + 1 - (tail - R->head_cache);
+    
+    if (space < want) {
+        R->head_cache = atomic_load_explicit(&R->head, memory_order_acquire);
+        space = R->mask + 1 - (tail - R->head_cache);
+    }
+    return space;
+}
+
+/**
+ * @brief Count the filled slots as seen by the consumer
+ * 
+ * Refreshes the cached tail only if the cache shows fewer than want
+ * elements.
+ * 
+ * @param R Pointer to ring
+ * @param head Consumer's current head
+ * @param want Number of elements the caller would like
+ * @return Number of available elements
+ */
+static size_t consumer_avail(ds_spsc_ring_t *R, size_t head, size_t want) {
+    size_t avail = R->tail_cache - head;
+    
+    if (avail < want) {
+        R->tail_cache = atomic_load_explicit(&R->tail, memory_order_acquire);
+        avail = R->tail_cache - head;
+    }
+    return avail;
+}
+
+/**
+ * @brief Create a new empty SPSC ring
+ * 
+ * @param capacity Minimum number of elements the ring can hold
+ * @return Pointer to new ring on success, NULL if capacity is 0 or on memory failure
+ */
+ds_spsc_ring_t *ds_spsc_ring_create(size_t capacity) {
+    ds_spsc_ring_t *ring;
+    size_t cap = 2;
+    
+    if (capacity == 0 || capacity > (SIZE_MAX / 2) / sizeof(void *)) {
+        return NULL;
+    }
+    
+    // Round up to a power of two so positions map to slots with a mask
+    while (cap < capacity) {
+        cap <<= 1;
+    }
+    
+    ring = (ds_spsc_ring_t *)ds_alloc(sizeof(struct ds_spsc_ring));
+    if (ring == NULL) {
+        return NULL;
+    }
+    
+    ring->slots = (void **)ds_alloc(cap * sizeof(void *));
+    if (ring->slots == NULL) {
+        ds_free(ring);
+        return NULL;
+    }
+    
+    ring->mask = cap - 1;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    ring->tail_cache = 0;
+    ring->head_cache = 0;
+    
+    return ring;
+}
+
+/**
+ * @brief Free an SPSC ring and optionally its remaining data
+ * 
+ * @param R Pointer to ring to free
+ * @param free_data Optional function to free element data (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if R is NULL
+ */
+ds_error_t ds_spsc_ring_free(ds_spsc_ring_t *R, void (*free_data)(void *)) {
+    void *data;
+    
+    // Validate input parameter
+    if (R == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    // Drain remaining elements if their data needs freeing
+    if (free_data != NULL) {
+        while (ds_spsc_ring_try_dequeue(R, &data) == DS_OK) {
+            free_data(data);
+        }
+    }
+    
+    ds_free(R->slots);
+    ds_free(R);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Add element to the rear of the ring if a slot is free
+ * 
+ * @param R Pointer to ring
+ * @param data Pointer to data to enqueue
+ * @return DS_OK on success, DS_ERR_NULLARG if R or data is NULL, DS_ERR_FULL if the ring is full
+ */
+ds_error_t ds_spsc_ring_try_enqueue(ds_spsc_ring_t *R, void *data) {
+    size_t tail;
+    
+    // Validate input parameters
+    if (R == NULL || data == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    tail = atomic_load_explicit(&R->tail, memory_order_relaxed);
+    if (producer_space(R, tail, 1) == 0) {
+        return DS_ERR_FULL;
+    }
+    
+    // Publish the element to the consumer
+    R->slots[tail & R->mask] = data;
+    atomic_store_explicit(&R->tail, tail + 1, memory_order_release);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Add element to the rear of the ring, waiting while it is full
+ * 
+ * @param R Pointer to ring
+ * @param data Pointer to data to enqueue
+ * @return DS_OK on success, DS_ERR_NULLARG if R or data is NULL
+ */
+ds_error_t ds_spsc_ring_enqueue(ds_spsc_ring_t *R, void *data) {
+    unsigned spins = 0;
+    ds_error_t err;
+    
+    while ((err = ds_spsc_ring_try_enqueue(R, data)) == DS_ERR_FULL) {
+        backoff(&spins);
+    }
+    
+    return err;
+}
+
+/**
+ * @brief Add up to n elements to the rear of the ring
+ * 
+ * @param R Pointer to ring
+ * @param items Array of n data pointers
+ * @param n Number of elements offered
+ * @return Number of elements enqueued (0 if full or R/items is NULL)
+ */
+size_t ds_spsc_ring_enqueue_n(ds_spsc_ring_t *R, void *const *items, size_t n) {
+    size_t tail, space, i;
+    
+    if (R == NULL || items == NULL || n == 0) {
+        return 0;
+    }
+    
+    tail = atomic_load_explicit(&R->tail, memory_order_relaxed);
+    space = producer_space(R, tail, n);
+    if (n > space) {
+        n = space;
+    }
+    
+    for (i = 0; i < n && items[i] != NULL; i++) {
+        R->slots[(tail + i) & R->mask] = items[i];
+    }
+    
+    // One release store publishes the whole run
+    if (i > 0) {
+        atomic_store_explicit(&R->tail, tail + i, memory_order_release);
+    }
+    
+    return i;
+}
+
+/**
+ * @brief Remove element from the front of the ring if one is available
+ * 
+ * @param R Pointer to ring
+ * @param out Receives the dequeued data pointer
+ * @return DS_OK on success, DS_ERR_NULLARG if R or out is NULL, DS_ERR_EMPTY if the ring is empty
+ */
+ds_error_t ds_spsc_ring_try_dequeue(ds_spsc_ring_t *R, void **out) {
+    size_t head;
+    
+    // Validate input parameters
+    if (R == NULL || out == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    head = atomic_load_explicit(&R->head, memory_order_relaxed);
+    if (consumer_avail(R, head, 1) == 0) {
+        return DS_ERR_EMPTY;
+    }
+    
+    // Hand the slot back to the producer
+    *out = R->slots[head & R->mask];
+    atomic_store_explicit(&R->head, head + 1, memory_order_release);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Remove element from the front of the ring, waiting while it is empty
+ * 
+ * @param R Pointer to ring
+ * @return Pointer to dequeued data, or NULL if R is NULL
+ */
+void *ds_spsc_ring_dequeue(ds_spsc_ring_t *R) {
+    unsigned spins = 0;
+    void *data = NULL;
+    
+    if (R == NULL) {
+        return NULL;
+    }
+    
+    while (ds_spsc_ring_try_dequeue(R, &data) == DS_ERR_EMPTY) {
+        backoff(&spins);
+    }
+    
+    return data;
+}
+
+/**
+ * @brief Remove up to n elements from the front of the ring
+ * 
+ * @param R Pointer to ring
+ * @param out Array receiving up to n data pointers in FIFO order
+ * @param n Maximum number of elements to dequeue
+ * @return Number of elements dequeued (0 if empty or R/out is NULL)
+ */
+size_t ds_spsc_ring_dequeue_n(ds_spsc_ring_t *R, void **out, size_t n) {
+    size_t head, avail, i;
+    
+    if (R == NULL || out == NULL || n == 0) {
+        return 0;
+    }
+    
+    head = atomic_load_explicit(&R->head, memory_order_relaxed);
+    avail = consumer_avail(R, head, n);
+    if (n > avail) {
+        n = avail;
+    }
+    
+    for (i = 0; i < n; i++) {
+        out[i] = R->slots[(head + i) & R->mask];
+    }
+    
+    // One release store frees the whole run
+    if (n > 0) {
+        atomic_store_explicit(&R->head, head + n, memory_order_release);
+    }
+    
+    return n;
+}
+
+/**
+ * @brief Get the number of elements in the ring
+ * 
+ * @param R Pointer to ring
+ * @return Number of elements in ring, or 0 if R is NULL
+ */
+size_t ds_spsc_ring_size(const ds_spsc_ring_t *R) {
+    size_t head, tail;
+    
+    if (R == NULL) {
+        return 0;
+    }
+    
+    // Reading head first means tail can only have moved further ahead;
+    // clamp the snapshot to the capacity
+    head = atomic_load_explicit((atomic_size_t *)&R->head, memory_order_acquire);
+    tail = atomic_load_explicit((atomic_size_t *)&R->tail, memory_order_acquire);
+    
+    return (tail - head > R->mask + 1) ? R->mask + 1 : tail - head;
+}
+
+/**
+ * @brief Check if ring is empty
+ * 
+ * @param R Pointer to ring
+ * @return 1 if empty, 0 if not empty, 1 if R is NULL
+ */
+int ds_spsc_ring_is_empty(const ds_spsc_ring_t *R) {
+    return ds_spsc_ring_size(R) == 0;
+}
+
+/**
+ * @brief Get the fixed capacity of the ring
+ * 
+ * @param R Pointer to ring
+ * @return Number of slots, or 0 if R is NULL
+ */
+size_t ds_spsc_ring_capacity(const ds_spsc_ring_t *R) {
+    return (R != NULL) ? R->mask + 1 : 0;
+}
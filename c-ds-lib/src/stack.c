@@ -6,118 +6,220 @@
  * @date 2024
  * 
  * This file implements the stack data structure using a linked list approach
- * with memory management and learning mode support.
+ * with memory management and learning mode support. Stacks created with
+ * ds_stack_create_array() keep their elements in a growable array instead.
  */
 
 #include "ds_stack.h"
-#include <stdlib.h>  /* for malloc, free */
+#include "ds_internal.h"
 #include <stdio.h>   /* for printf */
+#include <string.h>  /* for memcpy */
 
 /**
- * @brief Internal flag for learning mode
+ * @brief Internal node structure for stack
  * 
- * When enabled, memory operations are logged for educational purposes.
+ * Each node contains a pointer to data and a pointer to the next node.
+ * The stack structure maintains a pointer to the top element.
+ */
+struct ds_stack_node {
+    void *data;                    /**< Pointer to user data */
+    struct ds_stack_node *next;    /**< Pointer to next node */
+};
+
+/**
+ * @brief Minimum capacity allocated by a growing array stack
  */
-static int learning_mode = 0;
+#define DS_STACK_ARRAY_MIN 16
 
 /**
- * @brief Memory allocation wrapper with learning mode support
+ * @brief Internal stack structure
  * 
- * Allocates memory and optionally logs the operation when learning mode is enabled.
+ * Contains top pointer and cached size for efficient operations.
+ * In array mode the elements live in items[0..size) with the top at
+ * items[size - 1], and the node pointer stays NULL.
+ */
+struct ds_stack {
+    struct ds_stack_node *top;     /**< Pointer to top node */
+    struct ds_stack_node *bottom;  /**< Pointer to bottom node, for O(1) transfer */
+    size_t size;                   /**< Number of elements in stack */
+    ds_allocator_t alloc;          /**< Allocator used for nodes */
+    ds_slab_t *pool;               /**< Private node pool, or NULL */
+    int array;                     /**< Non-zero for array-backed storage */
+    void **items;                  /**< Element array in array mode */
+    size_t capacity;               /**< Number of slots in items */
+    ds_stats_t stats;              /**< Runtime counters */
+};
+
+/**
+ * @brief Resize the element array of an array-mode stack
  * 
- * @param n Number of bytes to allocate
- * @return Pointer to allocated memory, or NULL on failure
+ * @param S Pointer to array-mode stack
+ * @param capacity New capacity, at least S->size
+ * @return DS_OK on success, DS_ERR_OOM on memory failure
  */
-void *ds_alloc(size_t n) {
-    void *ptr = malloc(n);
+static ds_error_t array_resize(ds_stack_t *S, size_t capacity) {
+    void **items = NULL;
     
-#ifdef DS_LEARNING_MODE
-    if (learning_mode) {
-        printf("[LEARN] malloc(%zu) = %p\n", n, ptr);
+    if (capacity > (size_t)-1 / sizeof(void *)) {
+        return DS_ERR_OOM;
+    }
+    
+    if (capacity != 0) {
+        items = (void **)ds_alloc(capacity * sizeof(void *));
+        if (items == NULL) {
+            return DS_ERR_OOM;
+        }
+        if (S->size != 0) {
+            memcpy(items, S->items, S->size * sizeof(void *));
+        }
+    }
+    
+    if (items != NULL) {
+        ds_stats_count_alloc(&S->stats, capacity * sizeof(void *));
+    }
+    if (S->items != NULL) {
+        ds_stats_count_free(&S->stats, S->capacity * sizeof(void *));
     }
-#endif
+    ds_free(S->items);
+    S->items = items;
+    S->capacity = capacity;
     
-    return ptr;
+    return DS_OK;
 }
 
 /**
- * @brief Memory deallocation wrapper with learning mode support
+ * @brief Make room for at least extra more elements in an array-mode stack
  * 
- * Deallocates memory and optionally logs the operation when learning mode is enabled.
+ * Grows geometrically so that repeated pushes are amortized O(1).
  * 
- * @param p Pointer to memory to deallocate
+ * @param S Pointer to array-mode stack
+ * @param extra Number of additional elements needed
+ * @return DS_OK on success, DS_ERR_OOM on memory failure
  */
-void ds_free(void *p) {
-#ifdef DS_LEARNING_MODE
-    if (learning_mode && p) {
-        printf("[LEARN] free(%p)\n", p);
+static ds_error_t array_grow(ds_stack_t *S, size_t extra) {
+    size_t needed = S->size + extra;
+    size_t capacity;
+    
+    if (needed < S->size) {
+        return DS_ERR_OOM;
+    }
+    if (needed <= S->capacity) {
+        return DS_OK;
     }
-#endif
     
-    free(p);
+    capacity = (S->capacity < DS_STACK_ARRAY_MIN) ? DS_STACK_ARRAY_MIN : S->capacity;
+    while (capacity < needed) {
+        if (capacity > (size_t)-1 / 2) {
+            capacity = needed;
+            break;
+        }
+        capacity *= 2;
+    }
+    
+    return array_resize(S, capacity);
 }
 
 /**
- * @brief Enable or disable learning mode
+ * @brief Create a new empty stack
+ * 
+ * Allocates and initializes a new stack structure with the library-level
+ * node allocator.
  * 
- * @param enable Non-zero to enable, zero to disable
+ * @return Pointer to new stack on success, NULL on memory allocation failure
  */
-void ds_enable_learning_mode(int enable) {
-    learning_mode = enable;
+ds_stack_t *ds_stack_create(void) {
+    return ds_stack_create_with_allocator(NULL);
 }
 
 /**
- * @brief Dump current state of all data structures
+ * @brief Create a new empty stack with a custom node allocator
+ * 
+ * The stack structure itself comes from ds_alloc; every node is obtained
+ * from the given allocator.
  * 
- * Currently not implemented - placeholder for future functionality.
+ * @param a Allocator for nodes, or NULL for the library-level allocator
+ * @return Pointer to new stack on success, NULL on invalid allocator or memory failure
  */
-void ds_dump_state(void) {
-    if (learning_mode) {
-        printf("[LEARN] ds_dump_state() - not yet implemented\n");
+ds_stack_t *ds_stack_create_with_allocator(const ds_allocator_t *a) {
+    ds_stack_t *stack;
+    
+    // Allocate memory for stack structure
+    stack = (ds_stack_t *)ds_alloc(sizeof(struct ds_stack));
+    if (stack == NULL) {
+        return NULL;
     }
+    
+    // Capture the node allocator
+    if (ds_allocator_init(&stack->alloc, a) != DS_OK) {
+        ds_free(stack);
+        return NULL;
+    }
+    
+    // Initialize stack to empty state
+    stack->top = NULL;
+    stack->bottom = NULL;
+    stack->size = 0;
+    stack->pool = NULL;
+    stack->array = 0;
+    stack->items = NULL;
+    stack->capacity = 0;
+    ds_stats_init(&stack->stats);
+    
+    return stack;
 }
 
 /**
- * @brief Internal node structure for stack
+ * @brief Create a new empty stack backed by a private node pool
  * 
- * Each node contains a pointer to data and a pointer to the next node.
- * The stack structure maintains a pointer to the top element.
- */
-struct ds_stack_node {
-    void *data;                    /**< Pointer to user data */
-    struct ds_stack_node *next;    /**< Pointer to next node */
-};
-
-/**
- * @brief Internal stack structure
+ * Nodes are served from a slab pool owned by the stack, which is released
+ * in one pass by ds_stack_free.
  * 
- * Contains top pointer and cached size for efficient operations.
+ * @return Pointer to new stack on success, NULL on memory allocation failure
  */
-struct ds_stack {
-    struct ds_stack_node *top;     /**< Pointer to top node */
-    size_t size;                   /**< Number of elements in stack */
-};
+ds_stack_t *ds_stack_create_pooled(void) {
+    ds_stack_t *stack;
+    ds_slab_t *pool;
+    ds_allocator_t a;
+    
+    // Create the node pool first
+    pool = ds_slab_create(sizeof(struct ds_stack_node), DS_SLAB_DEFAULT_OBJS);
+    if (pool == NULL) {
+        return NULL;
+    }
+    
+    a = ds_slab_allocator(pool);
+    stack = ds_stack_create_with_allocator(&a);
+    if (stack == NULL) {
+        ds_slab_free(pool);
+        return NULL;
+    }
+    
+    stack->pool = pool;
+    return stack;
+}
 
 /**
- * @brief Create a new empty stack
+ * @brief Create a new empty array-backed stack
  * 
- * Allocates and initializes a new stack structure with top set to NULL
- * and size set to 0.
+ * Elements are kept in one contiguous array that grows geometrically, so
+ * push and pop do not allocate per element.
  * 
+ * @param capacity_hint Number of elements to reserve up front (may be 0)
  * @return Pointer to new stack on success, NULL on memory allocation failure
  */
-ds_stack_t *ds_stack_create(void) {
+ds_stack_t *ds_stack_create_array(size_t capacity_hint) {
     ds_stack_t *stack;
     
-    // Allocate memory for stack structure
-    stack = (ds_stack_t *)ds_alloc(sizeof(struct ds_stack));
+    stack = ds_stack_create_with_allocator(NULL);
     if (stack == NULL) {
         return NULL;
     }
     
-    // Initialize stack to empty state
-    stack->top = NULL;
-    stack->size = 0;
+    stack->array = 1;
+    if (capacity_hint != 0 && array_resize(stack, capacity_hint) != DS_OK) {
+        ds_free(stack);
+        return NULL;
+    }
     
     return stack;
 }
@@ -140,38 +242,56 @@ ds_error_t ds_stack_free(ds_stack_t *S, void (*free_data)(void *)) {
         return DS_ERR_NULLARG;
     }
     
-    // Iterate through all nodes and free them
-    current = S->top;
-    while (current != NULL) {
-        next = current->next;
-        
-        // Call user's free function for data if provided
-        if (free_data != NULL && current->data != NULL) {
-            free_data(current->data);
+    // Array mode: hand each element to free_data, then drop the array
+    if (S->array) {
+        if (free_data != NULL) {
+            for (size_t i = S->size; i > 0; i--) {
+                if (S->items[i - 1] != NULL) {
+                    free_data(S->items[i - 1]);
+                }
+            }
+        }
+        ds_stats_release(&S->stats);
+        ds_free(S->items);
+        ds_free(S);
+        return DS_OK;
+    }
+    
+    // Pooled and arena nodes are released wholesale, so only walk if data needs freeing
+    if ((S->pool == NULL && ds_allocator_frees(&S->alloc)) || free_data != NULL) {
+        current = S->top;
+        while (current != NULL) {
+            next = current->next;
+            
+            // Call user's free function for data if provided
+            if (free_data != NULL && current->data != NULL) {
+                free_data(current->data);
+            }
+            
+            // Free the node structure
+            if (S->pool == NULL) {
+                ds_node_free(&S->alloc, &S->stats, current, sizeof(struct ds_stack_node));
+            }
+            current = next;
         }
-        
-        // Free the node structure
-        ds_free(current);
-        current = next;
+    }
+    
+    // Release the node pool in one pass
+    if (S->pool != NULL) {
+        ds_slab_free(S->pool);
     }
     
     // Free the stack structure
+    ds_stats_release(&S->stats);
     ds_free(S);
     
     return DS_OK;
 }
 
 /**
- * @brief Push element onto the top of the stack
- * 
- * Adds a new element to the top of the stack. Updates top pointer
- * and increments size.
- * 
- * @param S Pointer to stack
- * @param data Pointer to data to push
- * @return DS_OK on success, DS_ERR_NULLARG if S or data is NULL, DS_ERR_OOM on memory failure
+ * @brief Untraced implementation of ds_stack_push
  */
-ds_error_t ds_stack_push(ds_stack_t *S, void *data) {
+static ds_error_t stack_push(ds_stack_t *S, void *data) {
     struct ds_stack_node *new_node;
     
     // Validate input parameters
@@ -179,8 +299,18 @@ ds_error_t ds_stack_push(ds_stack_t *S, void *data) {
         return DS_ERR_NULLARG;
     }
     
+    // Array mode: store in the next free slot
+    if (S->array) {
+        if (S->size == S->capacity && array_grow(S, 1) != DS_OK) {
+            return DS_ERR_OOM;
+        }
+        S->items[S->size++] = data;
+        ds_stats_resize(&S->stats, S->size);
+        return DS_OK;
+    }
+    
     // Allocate memory for new node
-    new_node = (struct ds_stack_node *)ds_alloc(sizeof(struct ds_stack_node));
+    new_node = (struct ds_stack_node *)ds_node_alloc(&S->alloc, &S->stats, sizeof(struct ds_stack_node));
     if (new_node == NULL) {
         return DS_ERR_OOM;
     }
@@ -190,22 +320,40 @@ ds_error_t ds_stack_push(ds_stack_t *S, void *data) {
     new_node->next = S->top;
     
     // Update stack pointers
+    if (S->top == NULL) {
+        S->bottom = new_node;
+    }
     S->top = new_node;
     S->size++;
+    ds_stats_resize(&S->stats, S->size);
     
     return DS_OK;
 }
 
 /**
- * @brief Pop element from the top of the stack
+ * @brief Push element onto the top of the stack
  * 
- * Removes the top element from the stack and returns its data.
- * Updates top pointer and decrements size.
+ * Adds a new element to the top of the stack. Updates top pointer
+ * and increments size.
  * 
  * @param S Pointer to stack
- * @return Pointer to data of popped element, or NULL if stack is empty or S is NULL
+ * @param data Pointer to data to push
+ * @return DS_OK on success, DS_ERR_NULLARG if S or data is NULL, DS_ERR_OOM on memory failure
  */
-void *ds_stack_pop(ds_stack_t *S) {
+ds_error_t ds_stack_push(ds_stack_t *S, void *data) {
+    ds_error_t result;
+    
+    DS_TRACE_BEGIN();
+    result = stack_push(S, data);
+    DS_TRACE_END(DS_TRACE_STACK_PUSH, S);
+    
+    return result;
+}
+
+/**
+ * @brief Untraced implementation of ds_stack_pop
+ */
+static void *stack_pop(ds_stack_t *S) {
     struct ds_stack_node *old_top;
     void *data;
     
@@ -214,6 +362,16 @@ void *ds_stack_pop(ds_stack_t *S) {
         return NULL;
     }
     
+    // Array mode: take the last slot
+    if (S->array) {
+        if (S->size == 0) {
+            return NULL;
+        }
+        data = S->items[--S->size];
+        ds_stats_resize(&S->stats, S->size);
+        return data;
+    }
+    
     // Check if stack is empty
     if (S->top == NULL) {
         return NULL;
@@ -225,14 +383,37 @@ void *ds_stack_pop(ds_stack_t *S) {
     
     // Update stack pointers
     S->top = old_top->next;
+    if (S->top == NULL) {
+        S->bottom = NULL;
+    }
     S->size--;
+    ds_stats_resize(&S->stats, S->size);
     
     // Free the old top node
-    ds_free(old_top);
+    ds_node_free(&S->alloc, &S->stats, old_top, sizeof(struct ds_stack_node));
     
     return data;
 }
 
+/**
+ * @brief Pop element from the top of the stack
+ * 
+ * Removes the top element from the stack and returns its data.
+ * Updates top pointer and decrements size.
+ * 
+ * @param S Pointer to stack
+ * @return Pointer to data of popped element, or NULL if stack is empty or S is NULL
+ */
+void *ds_stack_pop(ds_stack_t *S) {
+    void *result;
+    
+    DS_TRACE_BEGIN();
+    result = stack_pop(S);
+    DS_TRACE_END(DS_TRACE_STACK_POP, S);
+    
+    return result;
+}
+
 /**
  * @brief Peek at the top element without removing it
  * 
@@ -247,6 +428,11 @@ void *ds_stack_peek(const ds_stack_t *S) {
         return NULL;
     }
     
+    // Array mode: top is the last slot
+    if (S->array) {
+        return (S->size != 0) ? S->items[S->size - 1] : NULL;
+    }
+    
     // Check if stack is empty
     if (S->top == NULL) {
         return NULL;
@@ -255,6 +441,266 @@ void *ds_stack_peek(const ds_stack_t *S) {
     return S->top->data;
 }
 
+/**
+ * @brief Push a span of elements onto the stack
+ * 
+ * Pushes items[0] first, so items[n - 1] ends up on top. Either all
+ * elements are pushed or, on failure, the stack is left unchanged.
+ * 
+ * @param S Pointer to stack
+ * @param items Array of data pointers to push
+ * @param n Number of elements in items
+ * @return DS_OK on success, DS_ERR_NULLARG if S, items, or any element is NULL, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_stack_push_n(ds_stack_t *S, void *const *items, size_t n) {
+    struct ds_stack_node *chain = NULL, *chain_bottom = NULL, *node;
+    
+    // Validate input parameters
+    if (S == NULL || (items == NULL && n != 0)) {
+        return DS_ERR_NULLARG;
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (items[i] == NULL) {
+            return DS_ERR_NULLARG;
+        }
+    }
+    
+    // Array mode: reserve once and copy the whole span
+    if (S->array) {
+        if (array_grow(S, n) != DS_OK) {
+            return DS_ERR_OOM;
+        }
+        if (n != 0) {
+            memcpy(S->items + S->size, items, n * sizeof(void *));
+        }
+        S->size += n;
+        ds_stats_resize(&S->stats, S->size);
+        return DS_OK;
+    }
+    
+    // Linked mode: build the chain first so failure leaves S untouched
+    for (size_t i = 0; i < n; i++) {
+        node = (struct ds_stack_node *)ds_node_alloc(&S->alloc, &S->stats, sizeof(struct ds_stack_node));
+        if (node == NULL) {
+            while (chain != NULL) {
+                node = chain->next;
+                ds_node_free(&S->alloc, &S->stats, chain, sizeof(struct ds_stack_node));
+                chain = node;
+            }
+            return DS_ERR_OOM;
+        }
+        node->data = items[i];
+        node->next = chain;
+        if (chain == NULL) {
+            chain_bottom = node;
+        }
+        chain = node;
+    }
+    
+    // Splice the chain on top of the existing elements
+    if (chain != NULL) {
+        chain_bottom->next = S->top;
+        if (S->top == NULL) {
+            S->bottom = chain_bottom;
+        }
+        S->top = chain;
+        S->size += n;
+        ds_stats_resize(&S->stats, S->size);
+    }
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Pop up to n elements from the stack
+ * 
+ * The popped elements are written to out in push order: out[count - 1]
+ * receives the former top. Passing the result back to ds_stack_push_n
+ * restores the stack.
+ * 
+ * @param S Pointer to stack
+ * @param out Array receiving at least n data pointers
+ * @param n Maximum number of elements to pop
+ * @return Number of elements popped, or 0 if S or out is NULL
+ */
+size_t ds_stack_pop_n(ds_stack_t *S, void **out, size_t n) {
+    struct ds_stack_node *old_top;
+    size_t count;
+    
+    // Validate input parameters
+    if (S == NULL || out == NULL) {
+        return 0;
+    }
+    
+    count = (n < S->size) ? n : S->size;
+    
+    // Array mode: copy the top span in one go
+    if (S->array) {
+        S->size -= count;
+        ds_stats_resize(&S->stats, S->size);
+        if (count != 0) {
+            memcpy(out, S->items + S->size, count * sizeof(void *));
+        }
+        return count;
+    }
+    
+    // Linked mode: fill from the back so out keeps push order
+    for (size_t i = count; i > 0; i--) {
+        old_top = S->top;
+        out[i - 1] = old_top->data;
+        S->top = old_top->next;
+        ds_node_free(&S->alloc, &S->stats, old_top, sizeof(struct ds_stack_node));
+    }
+    if (S->top == NULL) {
+        S->bottom = NULL;
+    }
+    S->size -= count;
+    ds_stats_resize(&S->stats, S->size);
+    
+    return count;
+}
+
+/**
+ * @brief Check whether nodes of one stack may be relinked into another
+ * 
+ * @param S First stack
+ * @param T Second stack
+ * @return Non-zero if both are linked, unpooled and share a node allocator
+ */
+static int stacks_compatible(const ds_stack_t *S, const ds_stack_t *T) {
+    return !S->array && !T->array && S->pool == NULL && T->pool == NULL &&
+           S->alloc.alloc == T->alloc.alloc && S->alloc.free == T->alloc.free &&
+           S->alloc.ctx == T->alloc.ctx;
+}
+
+/**
+ * @brief Move all elements of one stack on top of another
+ * 
+ * Linked stacks are joined by pointing T's bottom node at S's old top,
+ * which the cached bottom pointer makes O(1). Array stacks copy T's
+ * slots in one block.
+ * 
+ * @param S Pointer to stack receiving all elements
+ * @param T Pointer to stack to empty onto S
+ * @return DS_OK on success, DS_ERR_NULLARG if S or T is NULL,
+ *         DS_ERR_INVALID if S and T are the same or incompatible stacks,
+ *         DS_ERR_OOM if an element array cannot grow
+ */
+ds_error_t ds_stack_transfer(ds_stack_t *S, ds_stack_t *T) {
+    // Validate input parameters
+    if (S == NULL || T == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    if (S == T) {
+        return DS_ERR_INVALID;
+    }
+    
+    // Array mode: append T's span to S's array
+    if (S->array && T->array) {
+        if (array_grow(S, T->size) != DS_OK) {
+            return DS_ERR_OOM;
+        }
+        if (T->size != 0) {
+            memcpy(S->items + S->size, T->items, T->size * sizeof(void *));
+        }
+        S->size += T->size;
+        T->size = 0;
+        ds_stats_resize(&S->stats, S->size);
+        ds_stats_resize(&T->stats, 0);
+        return DS_OK;
+    }
+    
+    if (!stacks_compatible(S, T)) {
+        return DS_ERR_INVALID;
+    }
+    if (T->size == 0) {
+        return DS_OK;
+    }
+    
+    // Linked mode: T's chain goes on top, ending at S's old top
+    T->bottom->next = S->top;
+    if (S->top == NULL) {
+        S->bottom = T->bottom;
+    }
+    S->top = T->top;
+    T->top = NULL;
+    T->bottom = NULL;
+    
+    // The nodes now belong to S, so their allocations move with them
+    ds_stats_transfer(&S->stats, &T->stats, T->stats.allocs - T->stats.frees, T->stats.bytes_live);
+    S->size += T->size;
+    T->size = 0;
+    ds_stats_resize(&S->stats, S->size);
+    ds_stats_resize(&T->stats, 0);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Reserve capacity in an array-backed stack
+ * 
+ * Ensures that at least capacity elements fit without reallocation.
+ * 
+ * @param S Pointer to stack
+ * @param capacity Minimum number of elements to make room for
+ * @return DS_OK on success, DS_ERR_NULLARG if S is NULL, DS_ERR_INVALID if S is not array-backed, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_stack_reserve(ds_stack_t *S, size_t capacity) {
+    // Validate input parameter
+    if (S == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    if (!S->array) {
+        return DS_ERR_INVALID;
+    }
+    
+    if (capacity <= S->capacity) {
+        return DS_OK;
+    }
+    
+    return array_resize(S, capacity);
+}
+
+/**
+ * @brief Release unused capacity of an array-backed stack
+ * 
+ * Shrinks the element array to exactly the current size.
+ * 
+ * @param S Pointer to stack
+ * @return DS_OK on success, DS_ERR_NULLARG if S is NULL, DS_ERR_INVALID if S is not array-backed, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_stack_shrink_to_fit(ds_stack_t *S) {
+    // Validate input parameter
+    if (S == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    if (!S->array) {
+        return DS_ERR_INVALID;
+    }
+    
+    if (S->capacity == S->size) {
+        return DS_OK;
+    }
+    
+    return array_resize(S, S->size);
+}
+
+/**
+ * @brief Get the capacity of an array-backed stack
+ * 
+ * @param S Pointer to stack
+ * @return Number of elements that fit without reallocation, or 0 if S is NULL or linked
+ */
+size_t ds_stack_capacity(const ds_stack_t *S) {
+    if (S == NULL || !S->array) {
+        return 0;
+    }
+    
+    return S->capacity;
+}
+
 /**
  * @brief Check if stack is empty
  * 
@@ -268,7 +714,7 @@ int ds_stack_is_empty(const ds_stack_t *S) {
         return 1;  // Consider NULL as empty
     }
     
-    return (S->top == NULL) ? 1 : 0;
+    return (S->size == 0) ? 1 : 0;
 }
 
 /**
@@ -288,6 +734,22 @@ size_t ds_stack_size(const ds_stack_t *S) {
     return S->size;
 }
 
+/**
+ * @brief Get the runtime counters of a stack
+ * 
+ * @param S Pointer to stack
+ * @param out Receives the counters
+ * @return DS_OK on success, DS_ERR_NULLARG if S or out is NULL
+ */
+ds_error_t ds_stack_stats(const ds_stack_t *S, ds_stats_t *out) {
+    if (S == NULL || out == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    *out = S->stats;
+    return DS_OK;
+}
+
 /**
  * @brief Visualize the stack structure
  * 
@@ -311,7 +773,7 @@ void ds_stack_visualize(const ds_stack_t *S, FILE *out) {
         return;
     }
     
-    if (S->top == NULL) {
+    if (S->size == 0) {
         fprintf(out, "Stack: [empty] (size: %zu)\n", S->size);
         return;
     }
@@ -319,6 +781,24 @@ void ds_stack_visualize(const ds_stack_t *S, FILE *out) {
     // Print stack header
     fprintf(out, "Stack: (size: %zu)\n", S->size);
     
+    // Array mode: walk the slots from the top down
+    if (S->array) {
+        for (size_t i = S->size; i > 0; i--) {
+            fprintf(out, "  [%zu]: ", S->size - i);
+            if (S->items[i - 1] != NULL) {
+                fprintf(out, "%d", *(int*)S->items[i - 1]);
+            } else {
+                fprintf(out, "NULL");
+            }
+            if (i == S->size) {
+                fprintf(out, " [TOP]");
+            }
+            fprintf(out, "\n");
+        }
+        fprintf(out, "\n");
+        return;
+    }
+    
     // Print each element (top to bottom)
     current = S->top;
     while (current != NULL) {
@@ -0,0 +1,543 @@
+/**
+ * @file trace.c
+ * @brief Operation tracing and latency histogram implementation
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * This file implements the sampling layer behind DS_TRACE_BEGIN and
+ * DS_TRACE_END. Every thread records into its own block of histograms,
+ * found through a thread-local pointer, so the traced path never takes a
+ * lock or performs an atomic read-modify-write. Blocks are linked into a
+ * global list that snapshots walk; a block whose thread has exited is
+ * handed to the next new thread, so thread churn does not grow memory
+ * and samples of finished threads stay in the totals.
+ * 
+ * Built only with `make TRACE=1`. Without CONCURRENT=1 the library is
+ * single-threaded and a single block is used.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ds_trace.h"
+#include "ds_internal.h"
+#include <inttypes.h>  /* for PRIu64 */
+#include <stdio.h>     /* for fprintf */
+#include <string.h>    /* for memset */
+#include <time.h>      /* for clock_gettime */
+#ifdef DS_ENABLE_CONCURRENT
+#include <pthread.h>
+#include <stdatomic.h>
+#endif
+
+/**
+ * @brief Shared-state access, atomic only when threads exist
+ * 
+ * Every histogram counter has a single writer, its owning thread, so a
+ * relaxed load and store is enough while still letting snapshots read
+ * the counters from other threads.
+ */
+#ifdef DS_ENABLE_CONCURRENT
+#define TRACE_ATOMIC(T) _Atomic(T)
+#define TRACE_TLS _Thread_local
+#define TRACE_LOAD(x) atomic_load_explicit(&(x), memory_order_relaxed)
+#define TRACE_STORE(x, v) atomic_store_explicit(&(x), (v), memory_order_relaxed)
+#else
+#define TRACE_ATOMIC(T) T
+#define TRACE_TLS
+#define TRACE_LOAD(x) (x)
+#define TRACE_STORE(x, v) ((x) = (v))
+#endif
+
+/**
+ * @brief Samples of one operation recorded by one thread
+ */
+struct trace_hist {
+    TRACE_ATOMIC(uint64_t) total_ns;                  /**< Sum of sampled latencies */
+    TRACE_ATOMIC(uint64_t) max_ns;                    /**< Largest sampled latency */
+    TRACE_ATOMIC(uint64_t) buckets[DS_TRACE_BUCKETS]; /**< Log-linear sample counts */
+};
+
+/**
+ * @brief Histograms of all operations for one thread
+ */
+struct trace_block {
+    struct trace_block *next;      /**< Next block, fixed once published */
+    unsigned countdown;            /**< Calls left until the next sample (owner only) */
+#ifdef DS_ENABLE_CONCURRENT
+    atomic_int in_use;             /**< Non-zero while a live thread owns the block */
+#endif
+    struct trace_hist ops[DS_TRACE_OP_COUNT]; /**< One histogram per operation */
+};
+
+/**
+ * @brief Sampling period, 0 when tracing is off
+ */
+static TRACE_ATOMIC(unsigned) trace_period;
+
+/**
+ * @brief Installed hook and its context
+ */
+static TRACE_ATOMIC(ds_trace_hook_t) trace_hook;
+static TRACE_ATOMIC(void *) trace_hook_ctx;
+
+/**
+ * @brief Head of the list of all blocks ever created
+ */
+static TRACE_ATOMIC(struct trace_block *) trace_blocks;
+
+/**
+ * @brief Block owned by the calling thread, or NULL before its first sample
+ */
+static TRACE_TLS struct trace_block *current_block;
+
+/**
+ * @brief Public function names, indexed by ds_trace_op_t
+ */
+static const char *const op_names[DS_TRACE_OP_COUNT] = {
+    "ds_list_push_front", "ds_list_push_back", "ds_list_pop_front", "ds_list_find",
+    "ds_list_remove", "ds_queue_enqueue", "ds_queue_dequeue", "ds_stack_push",
+    "ds_stack_pop", "ds_deque_push_back", "ds_deque_pop_front", "ds_pqueue_push",
+    "ds_pqueue_pop", "ds_tree_insert", "ds_tree_find", "ds_tree_remove",
+    "ds_btree_insert", "ds_btree_find", "ds_btree_remove", "ds_skiplist_insert",
+    "ds_skiplist_find", "ds_skiplist_remove", "ds_hashmap_insert", "ds_hashmap_find",
+    "ds_hashmap_remove"
+};
+
+#ifdef DS_ENABLE_CONCURRENT
+static pthread_key_t block_key;
+static pthread_once_t block_key_once = PTHREAD_ONCE_INIT;
+static int block_key_ok = 0;
+
+/**
+ * @brief Thread-exit destructor: make the block available for reuse
+ * 
+ * @param p Block owned by the exiting thread
+ */
+static void block_release(void *p) {
+    atomic_store_explicit(&((struct trace_block *)p)->in_use, 0, memory_order_release);
+}
+
+/**
+ * @brief Create the key whose destructor releases blocks
+ */
+static void block_key_create(void) {
+    block_key_ok = (pthread_key_create(&block_key, block_release) == 0);
+}
+#endif
+
+/**
+ * @brief Read the monotonic clock
+ * 
+ * @return Nanoseconds since an arbitrary fixed point, never 0
+ */
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    uint64_t t;
+    
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    t = (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+    return (t != 0) ? t : 1;
+}
+
+/**
+ * @brief Index of the highest set bit
+ * 
+ * @param v Non-zero value
+ * @return floor(log2(v))
+ */
+static unsigned log2_floor(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63u - (unsigned)__builtin_clzll(v);
+#else
+    unsigned k = 0;
+    
+    while (v >>= 1) {
+        k++;
+    }
+    return k;
+#endif
+}
+
+/**
+ * @brief Map a latency to its histogram bucket
+ * 
+ * Values below 2^DS_TRACE_SUB_BITS get a bucket each; above that, the
+ * top DS_TRACE_SUB_BITS bits after the leading one select a sub-bucket
+ * within the value's power of two.
+ * 
+ * @param v Latency in nanoseconds
+ * @return Bucket index below DS_TRACE_BUCKETS
+ */
+static size_t bucket_index(uint64_t v) {
+    unsigned k;
+    
+    if (v < (1u << DS_TRACE_SUB_BITS)) {
+        return (size_t)v;
+    }
+    if (v >= (uint64_t)1 << DS_TRACE_MAX_BITS) {
+        return DS_TRACE_BUCKETS - 1;
+    }
+    
+    k = log2_floor(v);
+    return ((size_t)(k - DS_TRACE_SUB_BITS + 1) << DS_TRACE_SUB_BITS) +
+           (size_t)((v >> (k - DS_TRACE_SUB_BITS)) & ((1u << DS_TRACE_SUB_BITS) - 1));
+}
+
+/**
+ * @brief Find or create the calling thread's block
+ * 
+ * Reuses a block released by an exited thread before allocating a new
+ * one and pushing it onto the global list.
+ * 
+ * @return Block now owned by the caller, or NULL on memory failure
+ */
+static struct trace_block *block_acquire(void) {
+    struct trace_block *b;
+    
+#ifdef DS_ENABLE_CONCURRENT
+    pthread_once(&block_key_once, block_key_create);
+    for (b = atomic_load_explicit(&trace_blocks, memory_order_acquire); b != NULL; b = b->next) {
+        int expected = 0;
+        
+        if (atomic_compare_exchange_strong_explicit(&b->in_use, &expected, 1,
+                                                    memory_order_acquire, memory_order_relaxed)) {
+            break;
+        }
+    }
+    if (b == NULL) {
+        b = (struct trace_block *)ds_alloc(sizeof(struct trace_block));
+        if (b == NULL) {
+            return NULL;
+        }
+        memset(b, 0, sizeof(struct trace_block));
+        atomic_init(&b->in_use, 1);
+        
+        // Blocks are never unlinked, so a plain CAS push is safe
+        b->next = atomic_load_explicit(&trace_blocks, memory_order_relaxed);
+        while (!atomic_compare_exchange_weak_explicit(&trace_blocks, &b->next, b,
+                                                      memory_order_release, memory_order_relaxed)) {
+        }
+    }
+    if (block_key_ok) {
+        (void)pthread_setspecific(block_key, b);
+    }
+#else
+    b = (struct trace_block *)ds_alloc(sizeof(struct trace_block));
+    if (b == NULL) {
+        return NULL;
+    }
+    memset(b, 0, sizeof(struct trace_block));
+    trace_blocks = b;
+#endif
+    
+    current_block = b;
+    return b;
+}
+
+/**
+ * @brief Decide whether the current call is sampled and start its clock
+ * 
+ * @return Start time of a sampled call, 0 if the call is not timed
+ */
+uint64_t ds_trace_begin(void) {
+    unsigned period = TRACE_LOAD(trace_period);
+    struct trace_block *b;
+    
+    if (period == 0) {
+        return 0;
+    }
+    
+    b = current_block;
+    if (b == NULL && (b = block_acquire()) == NULL) {
+        return 0;
+    }
+    
+    // Count down the calls between samples, clamped if the period shrank
+    if (b->countdown > 1) {
+        b->countdown = (b->countdown - 1 < period) ? b->countdown - 1 : period;
+        return 0;
+    }
+    b->countdown = period;
+    
+    return now_ns();
+}
+
+/**
+ * @brief Record a sampled call and pass it to the hook
+ * 
+ * @param op Operation that was timed
+ * @param obj Container the operation ran on
+ * @param start Value returned by ds_trace_begin
+ */
+void ds_trace_end(ds_trace_op_t op, const void *obj, uint64_t start) {
+    struct trace_hist *h;
+    ds_trace_hook_t hook;
+    uint64_t ns;
+    size_t i;
+    
+    if (start == 0) {
+        return;
+    }
+    
+    ns = now_ns() - start;
+    h = &current_block->ops[op];
+    i = bucket_index(ns);
+    TRACE_STORE(h->buckets[i], TRACE_LOAD(h->buckets[i]) + 1);
+    TRACE_STORE(h->total_ns, TRACE_LOAD(h->total_ns) + ns);
+    if (ns > TRACE_LOAD(h->max_ns)) {
+        TRACE_STORE(h->max_ns, ns);
+    }
+    
+#ifdef DS_ENABLE_CONCURRENT
+    hook = atomic_load_explicit(&trace_hook, memory_order_acquire);
+#else
+    hook = trace_hook;
+#endif
+    if (hook != NULL) {
+        hook(op, obj, ns, TRACE_LOAD(trace_hook_ctx));
+    }
+}
+
+/**
+ * @brief Set how often operations are timed
+ * 
+ * @param period Sampling period (0 disables, 1 times every call)
+ * @return DS_OK
+ */
+ds_error_t ds_trace_set_sampling(unsigned period) {
+    TRACE_STORE(trace_period, period);
+    return DS_OK;
+}
+
+/**
+ * @brief Get the current sampling period
+ * 
+ * @return Period set with ds_trace_set_sampling, 0 if tracing is off
+ */
+unsigned ds_trace_sampling(void) {
+    return TRACE_LOAD(trace_period);
+}
+
+/**
+ * @brief Install a hook that receives every sampled call
+ * 
+ * The context is published before the hook, so a thread that sees the
+ * new hook also sees its context.
+ * 
+ * @param hook Callback, or NULL to remove the current hook
+ * @param ctx User context passed to hook
+ * @return DS_OK
+ */
+ds_error_t ds_trace_set_hook(ds_trace_hook_t hook, void *ctx) {
+    TRACE_STORE(trace_hook_ctx, ctx);
+#ifdef DS_ENABLE_CONCURRENT
+    atomic_store_explicit(&trace_hook, hook, memory_order_release);
+#else
+    trace_hook = hook;
+#endif
+    return DS_OK;
+}
+
+/**
+ * @brief Add one thread's samples of an operation to a histogram
+ * 
+ * @param out Histogram to accumulate into
+ * @param h Thread histogram to read
+ */
+static void hist_add(ds_trace_hist_t *out, struct trace_hist *h) {
+    uint64_t max = TRACE_LOAD(h->max_ns);
+    
+    for (size_t i = 0; i < DS_TRACE_BUCKETS; i++) {
+        uint64_t c = TRACE_LOAD(h->buckets[i]);
+        
+        out->buckets[i] += c;
+        out->count += c;
+    }
+    out->total_ns += TRACE_LOAD(h->total_ns);
+    if (max > out->max_ns) {
+        out->max_ns = max;
+    }
+}
+
+/**
+ * @brief Get the latency histogram of an operation across all threads
+ * 
+ * @param op Operation to report
+ * @param out Receives the merged histogram
+ * @return DS_OK on success, DS_ERR_NULLARG if out is NULL, DS_ERR_INVALID if op is out of range
+ */
+ds_error_t ds_trace_histogram(ds_trace_op_t op, ds_trace_hist_t *out) {
+    struct trace_block *b;
+    
+    // Validate input parameters
+    if (out == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    if ((unsigned)op >= DS_TRACE_OP_COUNT) {
+        return DS_ERR_INVALID;
+    }
+    
+    memset(out, 0, sizeof(*out));
+#ifdef DS_ENABLE_CONCURRENT
+    b = atomic_load_explicit(&trace_blocks, memory_order_acquire);
+#else
+    b = trace_blocks;
+#endif
+    for (; b != NULL; b = b->next) {
+        hist_add(out, &b->ops[op]);
+    }
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Get the latency histogram of an operation on the calling thread
+ * 
+ * @param op Operation to report
+ * @param out Receives the histogram
+ * @return DS_OK on success, DS_ERR_NULLARG if out is NULL, DS_ERR_INVALID if op is out of range
+ */
+ds_error_t ds_trace_thread_histogram(ds_trace_op_t op, ds_trace_hist_t *out) {
+    // Validate input parameters
+    if (out == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    if ((unsigned)op >= DS_TRACE_OP_COUNT) {
+        return DS_ERR_INVALID;
+    }
+    
+    memset(out, 0, sizeof(*out));
+    if (current_block != NULL) {
+        hist_add(out, &current_block->ops[op]);
+    }
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Clear all recorded samples of all threads
+ */
+void ds_trace_reset(void) {
+    struct trace_block *b;
+    
+#ifdef DS_ENABLE_CONCURRENT
+    b = atomic_load_explicit(&trace_blocks, memory_order_acquire);
+#else
+    b = trace_blocks;
+#endif
+    for (; b != NULL; b = b->next) {
+        for (size_t op = 0; op < DS_TRACE_OP_COUNT; op++) {
+            struct trace_hist *h = &b->ops[op];
+            
+            for (size_t i = 0; i < DS_TRACE_BUCKETS; i++) {
+                TRACE_STORE(h->buckets[i], 0);
+            }
+            TRACE_STORE(h->total_ns, 0);
+            TRACE_STORE(h->max_ns, 0);
+        }
+    }
+}
+
+/**
+ * @brief Get the smallest latency counted by a histogram bucket
+ * 
+ * @param i Bucket index, at most DS_TRACE_BUCKETS
+ * @return Lower bound of bucket i in nanoseconds
+ */
+uint64_t ds_trace_bucket_floor(size_t i) {
+    unsigned k;
+    
+    if (i < (1u << DS_TRACE_SUB_BITS)) {
+        return (uint64_t)i;
+    }
+    if (i > DS_TRACE_BUCKETS) {
+        i = DS_TRACE_BUCKETS;
+    }
+    
+    k = (unsigned)(i >> DS_TRACE_SUB_BITS) + DS_TRACE_SUB_BITS - 1;
+    return ((uint64_t)(1u << DS_TRACE_SUB_BITS) + (i & ((1u << DS_TRACE_SUB_BITS) - 1)))
+           << (k - DS_TRACE_SUB_BITS);
+}
+
+/**
+ * @brief Estimate a latency percentile from a histogram
+ * 
+ * @param h Histogram to read
+ * @param p Percentile between 0 and 100
+ * @return Latency in nanoseconds, or 0 if h is NULL or empty
+ */
+uint64_t ds_trace_percentile(const ds_trace_hist_t *h, double p) {
+    uint64_t rank, seen = 0;
+    double r;
+    
+    if (h == NULL || h->count == 0) {
+        return 0;
+    }
+    
+    // Rank of the sample to report, rounded up and at least 1
+    if (p < 0.0) {
+        p = 0.0;
+    } else if (p > 100.0) {
+        p = 100.0;
+    }
+    r = p / 100.0 * (double)h->count;
+    rank = (uint64_t)r;
+    if ((double)rank < r) {
+        rank++;
+    }
+    if (rank == 0) {
+        rank = 1;
+    }
+    
+    for (size_t i = 0; i < DS_TRACE_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if (seen >= rank) {
+            uint64_t upper = ds_trace_bucket_floor(i + 1) - 1;
+            
+            return (i == DS_TRACE_BUCKETS - 1 || upper > h->max_ns) ? h->max_ns : upper;
+        }
+    }
+    
+    return h->max_ns;
+}
+
+/**
+ * @brief Get the name of an operation
+ * 
+ * @param op Operation
+ * @return Public function name, or "unknown" if op is out of range
+ */
+const char *ds_trace_op_name(ds_trace_op_t op) {
+    if ((unsigned)op >= DS_TRACE_OP_COUNT) {
+        return "unknown";
+    }
+    
+    return op_names[op];
+}
+
+/**
+ * @brief Print a latency summary of every operation that has samples
+ * 
+ * @param out Output stream (e.g., stdout, stderr)
+ */
+void ds_trace_print(FILE *out) {
+    ds_trace_hist_t h;
+    
+    if (out == NULL) {
+        return;
+    }
+    
+    fprintf(out, "%-20s %12s %10s %10s %10s %10s %12s\n",
+            "operation", "samples", "mean_ns", "p50_ns", "p99_ns", "p99.9_ns", "max_ns");
+    for (unsigned op = 0; op < DS_TRACE_OP_COUNT; op++) {
+        ds_trace_histogram((ds_trace_op_t)op, &h);
+        if (h.count == 0) {
+            continue;
+        }
+        fprintf(out, "%-20s %12" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64
+                " %10" PRIu64 " %12" PRIu64 "\n",
+                op_names[op], h.count, h.total_ns / h.count, ds_trace_percentile(&h, 50.0),
+                ds_trace_percentile(&h, 99.0), ds_trace_percentile(&h, 99.9), h.max_ns);
+    }
+}
@@ -6,87 +6,80 @@
  * @date 2024
  * 
  * This file implements the binary tree data structure with memory management
- * and learning mode support.
+ * and learning mode support. Trees created with ds_tree_create_balanced()
+ * are kept AVL-balanced so their height stays O(log n). Trees created with
+ * ds_tree_create_compact() keep their nodes in one array linked by 32-bit
+ * slot numbers instead of pointers. In lazy-remove mode removals leave
+ * tombstones that ds_tree_compact() sweeps out in one rebuild.
  */
 
 #include "ds_tree.h"
-#include <stdlib.h>  /* for malloc, free */
+#include "ds_internal.h"
+#include <stdint.h>  /* for uint32_t */
 #include <stdio.h>   /* for printf */
+#include <string.h>  /* for memcpy */
 
 /**
- * @brief Internal flag for learning mode
- * 
- * When enabled, memory operations are logged for educational purposes.
+ * @brief Minimum number of slots in a compact tree's node array
  */
-static int learning_mode = 0;
+#define DS_TREE_COMPACT_MIN 16
 
 /**
- * @brief Memory allocation wrapper with learning mode support
- * 
- * Allocates memory and optionally logs the operation when learning mode is enabled.
- * 
- * @param n Number of bytes to allocate
- * @return Pointer to allocated memory, or NULL on failure
+ * @brief Largest number of slots in a compact tree's node array
  */
-void *ds_alloc(size_t n) {
-    void *ptr = malloc(n);
-    
-#ifdef DS_LEARNING_MODE
-    if (learning_mode) {
-        printf("[LEARN] malloc(%zu) = %p\n", n, ptr);
-    }
-#endif
-    
-    return ptr;
-}
+#define DS_TREE_COMPACT_MAX UINT32_MAX
+
+#ifdef DS_ENABLE_CONCURRENT
+#include "ds_pool.h"
 
 /**
- * @brief Memory deallocation wrapper with learning mode support
- * 
- * Deallocates memory and optionally logs the operation when learning mode is enabled.
- * 
- * @param p Pointer to memory to deallocate
+ * @brief Trees smaller than this are reduced as a single piece
  */
-void ds_free(void *p) {
-#ifdef DS_LEARNING_MODE
-    if (learning_mode && p) {
-        printf("[LEARN] free(%p)\n", p);
-    }
-#endif
-    
-    free(p);
-}
+#define DS_TREE_PARALLEL_MIN 4096
 
 /**
- * @brief Enable or disable learning mode
- * 
- * @param enable Non-zero to enable, zero to disable
+ * @brief Subtrees ds_tree_reduce_parallel aims for per pool worker
  */
-void ds_enable_learning_mode(int enable) {
-    learning_mode = enable;
-}
+#define DS_TREE_PIECES_PER_THREAD 8
 
 /**
- * @brief Dump current state of all data structures
- * 
- * Currently not implemented - placeholder for future functionality.
+ * @brief Deepest cut ds_tree_reduce_parallel makes
  */
-void ds_dump_state(void) {
-    if (learning_mode) {
-        printf("[LEARN] ds_dump_state() - not yet implemented\n");
-    }
-}
+#define DS_TREE_PARALLEL_MAX_CUT 16
+#endif
 
 /**
  * @brief Internal node structure for binary tree
  * 
- * Each node contains a pointer to data and pointers to left and right children.
- * The tree structure maintains a pointer to the root node.
+ * Each node contains a pointer to data, pointers to left and right children
+ * and a pointer back to its parent. The tree structure maintains a pointer
+ * to the root node. The height is only maintained in balanced trees. A
+ * tombstone keeps its data so searches can still be routed through it.
  */
 struct ds_tree_node {
     void *data;                    /**< Pointer to user data */
     struct ds_tree_node *left;     /**< Pointer to left child */
     struct ds_tree_node *right;    /**< Pointer to right child */
+    struct ds_tree_node *parent;   /**< Pointer to parent, NULL for root */
+    int height;                    /**< Height of subtree (leaf = 1), balanced mode */
+    int dead;                      /**< Non-zero for a tombstone left by a lazy remove */
+};
+
+/**
+ * @brief Node of a compact tree
+ * 
+ * Links are slot numbers in the tree's node array rather than pointers,
+ * which halves the node and avoids a separate allocation per element.
+ * Slot 0 is a sentinel with height 0 that stands for "no node", so the
+ * height of a missing child is read without a branch.
+ */
+struct ds_tree_cnode {
+    void *data;                    /**< Pointer to user data, NULL in a free slot */
+    uint32_t left;                 /**< Slot of left child, 0 for none */
+    uint32_t right;                /**< Slot of right child, 0 for none; next free slot in a free slot */
+    uint32_t parent;               /**< Slot of parent, 0 for root */
+    unsigned height : 31;          /**< Height of subtree (leaf = 1) */
+    unsigned dead : 1;             /**< Non-zero for a tombstone left by a lazy remove */
 };
 
 /**
@@ -97,47 +90,196 @@ struct ds_tree_node {
 struct ds_tree {
     struct ds_tree_node *root;     /**< Pointer to root node */
     size_t size;                   /**< Number of elements in tree */
+    ds_allocator_t alloc;          /**< Allocator used for nodes */
+    ds_slab_t *pool;               /**< Private node pool, or NULL */
+    int balanced;                  /**< Non-zero to keep the tree AVL-balanced */
+    struct ds_tree_cnode *cnodes;  /**< Node array of a compact tree, NULL otherwise */
+    uint32_t croot;                /**< Root slot of a compact tree, 0 if empty */
+    uint32_t cfree;                /**< First free slot of a compact tree, 0 if none */
+    uint32_t cused;                /**< Slots handed out so far, including the sentinel */
+    uint32_t ccap;                 /**< Slots in the node array */
+    size_t dead;                   /**< Tombstones awaiting compaction */
+    double max_dead;               /**< Tombstone fraction that triggers compaction, 0 for eager removal */
+    void (*release)(void *);       /**< Receives the data of purged tombstones, or NULL */
+    ds_stats_t stats;              /**< Runtime counters */
 };
 
 /**
- * @brief Count nodes in subtree recursively
+ * @brief Get the height of a possibly empty subtree
  * 
- * Helper function to count nodes in a subtree.
+ * @param node Pointer to subtree root (may be NULL)
+ * @return Height of subtree, 0 if node is NULL
+ */
+static int node_height(const struct ds_tree_node *node) {
+    return (node != NULL) ? node->height : 0;
+}
+
+/**
+ * @brief Recompute a node's height from its children
  * 
- * @param node Pointer to subtree root
- * @return Number of nodes in subtree
+ * @param node Pointer to node
  */
-static size_t count_nodes(struct ds_tree_node *node) {
-    if (node == NULL) {
-        return 0;
-    }
-    return 1 + count_nodes(node->left) + count_nodes(node->right);
+static void update_height(struct ds_tree_node *node) {
+    int lh = node_height(node->left);
+    int rh = node_height(node->right);
+    
+    node->height = 1 + ((lh > rh) ? lh : rh);
 }
 
 /**
- * @brief Free subtree recursively
+ * @brief Point the parent's link to old_child at new_child instead
  * 
- * Helper function to free all nodes in a subtree.
+ * @param T Pointer to tree
+ * @param parent Parent of old_child (NULL if old_child is the root)
+ * @param old_child Node being replaced
+ * @param new_child Replacement node (may be NULL)
+ */
+static void replace_child(ds_tree_t *T, struct ds_tree_node *parent,
+                          struct ds_tree_node *old_child, struct ds_tree_node *new_child) {
+    if (parent == NULL) {
+        T->root = new_child;
+    } else if (parent->left == old_child) {
+        parent->left = new_child;
+    } else {
+        parent->right = new_child;
+    }
+    
+    if (new_child != NULL) {
+        new_child->parent = parent;
+    }
+}
+
+/**
+ * @brief Rotate a subtree to the left
  * 
- * @param node Pointer to subtree root
- * @param free_data Function to free node data (may be NULL)
+ * @param T Pointer to tree
+ * @param x Subtree root whose right child becomes the new root
+ * @return New subtree root
  */
-static void free_subtree(struct ds_tree_node *node, void (*free_data)(void *)) {
-    if (node == NULL) {
-        return;
+static struct ds_tree_node *rotate_left(ds_tree_t *T, struct ds_tree_node *x) {
+    struct ds_tree_node *y = x->right;
+    
+    x->right = y->left;
+    if (y->left != NULL) {
+        y->left->parent = x;
     }
+    replace_child(T, x->parent, x, y);
+    y->left = x;
+    x->parent = y;
+    
+    update_height(x);
+    update_height(y);
+    return y;
+}
+
+/**
+ * @brief Rotate a subtree to the right
+ * 
+ * @param T Pointer to tree
+ * @param x Subtree root whose left child becomes the new root
+ * @return New subtree root
+ */
+static struct ds_tree_node *rotate_right(ds_tree_t *T, struct ds_tree_node *x) {
+    struct ds_tree_node *y = x->left;
     
-    // Free left and right subtrees
-    free_subtree(node->left, free_data);
-    free_subtree(node->right, free_data);
+    x->left = y->right;
+    if (y->right != NULL) {
+        y->right->parent = x;
+    }
+    replace_child(T, x->parent, x, y);
+    y->right = x;
+    x->parent = y;
     
-    // Call user's free function for data if provided
-    if (free_data != NULL && node->data != NULL) {
-        free_data(node->data);
+    update_height(x);
+    update_height(y);
+    return y;
+}
+
+/**
+ * @brief Restore the AVL invariant from a node up to the root
+ * 
+ * Walks towards the root updating heights and rotating wherever the
+ * height difference of two siblings exceeds one. Stops early once a
+ * subtree height is unchanged, since ancestors are then unaffected.
+ * 
+ * @param T Pointer to balanced tree
+ * @param node Lowest node whose subtree changed (may be NULL)
+ */
+static void rebalance(ds_tree_t *T, struct ds_tree_node *node) {
+    while (node != NULL) {
+        int old_height = node->height;
+        int balance;
+        
+        update_height(node);
+        balance = node_height(node->left) - node_height(node->right);
+        
+        if (balance > 1) {
+            // Left heavy: left-right case needs a preliminary rotation
+            if (node_height(node->left->left) < node_height(node->left->right)) {
+                rotate_left(T, node->left);
+            }
+            node = rotate_right(T, node);
+        } else if (balance < -1) {
+            // Right heavy: right-left case needs a preliminary rotation
+            if (node_height(node->right->right) < node_height(node->right->left)) {
+                rotate_right(T, node->right);
+            }
+            node = rotate_left(T, node);
+        } else if (node->height == old_height) {
+            break;
+        }
+        
+        node = node->parent;
     }
+}
+
+/**
+ * @brief Free subtree without recursion
+ * 
+ * Helper function to free all nodes in a subtree in O(1) extra space.
+ * Whenever the current node has a left child, a right rotation lifts
+ * that child above it; once no left child remains, the node is freed
+ * and the walk continues with its right child. The subtree is consumed
+ * in the process, so its shape may be arbitrarily degenerate.
+ * 
+ * @param T Pointer to owning tree
+ * @param node Pointer to subtree root
+ * @param free_data Function to free node data (may be NULL)
+ * @param release Non-zero to hand nodes back to the allocator even when pooled
+ * 
+ * @note Tombstones pass their data to the tree's release callback instead
+ */
+static void free_subtree(ds_tree_t *T, struct ds_tree_node *node, void (*free_data)(void *),
+                         int release) {
+    struct ds_tree_node *next;
     
-    // Free the node
-    ds_free(node);
+    while (node != NULL) {
+        if (node->left != NULL) {
+            // Rotate the left child up; parent links no longer matter
+            next = node->left;
+            node->left = next->right;
+            next->right = node;
+            node = next;
+            continue;
+        }
+        
+        next = node->right;
+        
+        // Call user's free function for data if provided; tombstones belong to release
+        if (node->dead) {
+            if (T->release != NULL) {
+                T->release(node->data);
+            }
+        } else if (free_data != NULL && node->data != NULL) {
+            free_data(node->data);
+        }
+        
+        // Free the node unless the tree's pool will release it wholesale
+        if (T->pool == NULL || release) {
+            ds_node_free(&T->alloc, &T->stats, node, sizeof(struct ds_tree_node));
+        }
+        node = next;
+    }
 }
 
 /**
@@ -156,315 +298,2287 @@ static struct ds_tree_node *find_min(struct ds_tree_node *node) {
 }
 
 /**
- * @brief Print subtree recursively
+ * @brief Print subtree without recursion
  * 
- * Helper function to print tree structure recursively.
+ * Helper function to print tree structure, highest values first, in
+ * reverse in-order. The walk steps from each node to its predecessor
+ * through the parent links, tracking depth as it goes, so it needs no
+ * stack however deep the tree is.
  * 
  * @param node Pointer to subtree root
  * @param out Output stream
- * @param depth Current depth in tree
  */
-static void print_subtree(struct ds_tree_node *node, FILE *out, int depth) {
+static void print_subtree(struct ds_tree_node *node, FILE *out) {
+    struct ds_tree_node *top = node;
+    int depth = 0;
+    
     if (node == NULL) {
         return;
     }
     
-    // Print right subtree (higher values)
-    print_subtree(node->right, out, depth + 1);
-    
-    // Print current node
-    for (int i = 0; i < depth; i++) {
-        fprintf(out, "  ");
+    // Start at the rightmost (largest) node
+    while (node->right != NULL) {
+        node = node->right;
+        depth++;
     }
     
-    if (node->data != NULL) {
-        fprintf(out, "%d\n", *(int*)node->data);
-    } else {
-        fprintf(out, "NULL\n");
+    while (node != NULL) {
+        // Print current node
+        for (int i = 0; i < depth; i++) {
+            fprintf(out, "  ");
+        }
+        
+        if (node->data != NULL && node->dead) {
+            fprintf(out, "%d (removed)\n", *(int*)node->data);
+        } else if (node->data != NULL) {
+            fprintf(out, "%d\n", *(int*)node->data);
+        } else {
+            fprintf(out, "NULL\n");
+        }
+        
+        // Step to the predecessor (next lower value)
+        if (node->left != NULL) {
+            node = node->left;
+            depth++;
+            while (node->right != NULL) {
+                node = node->right;
+                depth++;
+            }
+        } else {
+            while (node != top && node == node->parent->left) {
+                node = node->parent;
+                depth--;
+            }
+            node = (node == top) ? NULL : node->parent;
+            depth--;
+        }
     }
-    
-    // Print left subtree (lower values)
-    print_subtree(node->left, out, depth + 1);
 }
 
 /**
- * @brief Create a new empty tree
+ * @brief Recompute a compact node's height from its children
  * 
- * Allocates and initializes a new tree structure with root set to NULL
- * and size set to 0.
+ * @param n Node array
+ * @param node Slot of node
+ */
+static void cnode_update_height(struct ds_tree_cnode *n, uint32_t node) {
+    uint32_t lh = n[n[node].left].height;
+    uint32_t rh = n[n[node].right].height;
+    
+    n[node].height = 1 + ((lh > rh) ? lh : rh);
+}
+
+/**
+ * @brief Point the parent's link to old_child at new_child instead
  * 
- * @return Pointer to new tree on success, NULL on memory allocation failure
+ * @param T Pointer to compact tree
+ * @param parent Parent of old_child (0 if old_child is the root)
+ * @param old_child Slot being replaced
+ * @param new_child Replacement slot (may be 0)
  */
-ds_tree_t *ds_tree_create(void) {
-    ds_tree_t *tree;
+static void cnode_replace_child(ds_tree_t *T, uint32_t parent, uint32_t old_child, uint32_t new_child) {
+    struct ds_tree_cnode *n = T->cnodes;
     
-    // Allocate memory for tree structure
-    tree = (ds_tree_t *)ds_alloc(sizeof(struct ds_tree));
-    if (tree == NULL) {
-        return NULL;
+    if (parent == 0) {
+        T->croot = new_child;
+    } else if (n[parent].left == old_child) {
+        n[parent].left = new_child;
+    } else {
+        n[parent].right = new_child;
     }
     
-    // Initialize tree to empty state
-    tree->root = NULL;
-    tree->size = 0;
-    
-    return tree;
+    // The sentinel's links are never written
+    if (new_child != 0) {
+        n[new_child].parent = parent;
+    }
 }
 
 /**
- * @brief Free a tree and optionally its data
- * 
- * Recursively frees all nodes in the tree, optionally calls free_data
- * for each node's data pointer, then deallocates the tree structure itself.
+ * @brief Rotate a compact subtree to the left
  * 
- * @param T Pointer to tree to free
- * @param free_data Optional function to free node data (may be NULL)
- * @return DS_OK on success, DS_ERR_NULLARG if T is NULL
+ * @param T Pointer to compact tree
+ * @param x Subtree root whose right child becomes the new root
+ * @return New subtree root
  */
-ds_error_t ds_tree_free(ds_tree_t *T, void (*free_data)(void *)) {
-    // Validate input parameter
-    if (T == NULL) {
-        return DS_ERR_NULLARG;
+static uint32_t cnode_rotate_left(ds_tree_t *T, uint32_t x) {
+    struct ds_tree_cnode *n = T->cnodes;
+    uint32_t y = n[x].right;
+    
+    n[x].right = n[y].left;
+    if (n[y].left != 0) {
+        n[n[y].left].parent = x;
     }
+    cnode_replace_child(T, n[x].parent, x, y);
+    n[y].left = x;
+    n[x].parent = y;
     
-    // Free all nodes recursively
-    free_subtree(T->root, free_data);
+    cnode_update_height(n, x);
+    cnode_update_height(n, y);
+    return y;
+}
+
+/**
+ * @brief Rotate a compact subtree to the right
+ * 
+ * @param T Pointer to compact tree
+ * @param x Subtree root whose left child becomes the new root
+ * @return New subtree root
+ */
+static uint32_t cnode_rotate_right(ds_tree_t *T, uint32_t x) {
+    struct ds_tree_cnode *n = T->cnodes;
+    uint32_t y = n[x].left;
     
-    // Free the tree structure
-    ds_free(T);
+    n[x].left = n[y].right;
+    if (n[y].right != 0) {
+        n[n[y].right].parent = x;
+    }
+    cnode_replace_child(T, n[x].parent, x, y);
+    n[y].right = x;
+    n[x].parent = y;
     
-    return DS_OK;
+    cnode_update_height(n, x);
+    cnode_update_height(n, y);
+    return y;
 }
 
 /**
- * @brief Insert element into the tree
+ * @brief Restore the AVL invariant from a compact node up to the root
  * 
- * Inserts a new element into the tree using the comparison function
- * to determine the correct position following binary search tree rules.
+ * Same walk as rebalance(), on slot numbers.
  * 
- * @param T Pointer to tree
- * @param data Pointer to data to insert
- * @param cmp Comparison function for ordering (returns <0, 0, >0)
- * @return DS_OK on success, DS_ERR_NULLARG if T, data, or cmp is NULL, DS_ERR_OOM on memory failure
+ * @param T Pointer to compact tree
+ * @param node Lowest slot whose subtree changed (may be 0)
  */
-ds_error_t ds_tree_insert(ds_tree_t *T, void *data, int (*cmp)(const void *, const void *)) {
-    struct ds_tree_node *new_node, *current, *parent;
+static void cnode_rebalance(ds_tree_t *T, uint32_t node) {
+    struct ds_tree_cnode *n = T->cnodes;
     
-    // Validate input parameters
-    if (T == NULL || data == NULL || cmp == NULL) {
-        return DS_ERR_NULLARG;
+    while (node != 0) {
+        uint32_t old_height = n[node].height;
+        int balance;
+        
+        cnode_update_height(n, node);
+        balance = (int)n[n[node].left].height - (int)n[n[node].right].height;
+        
+        if (balance > 1) {
+            // Left heavy: left-right case needs a preliminary rotation
+            uint32_t l = n[node].left;
+            
+            if (n[n[l].left].height < n[n[l].right].height) {
+                cnode_rotate_left(T, l);
+            }
+            node = cnode_rotate_right(T, node);
+        } else if (balance < -1) {
+            // Right heavy: right-left case needs a preliminary rotation
+            uint32_t r = n[node].right;
+            
+            if (n[n[r].right].height < n[n[r].left].height) {
+                cnode_rotate_right(T, r);
+            }
+            node = cnode_rotate_left(T, node);
+        } else if (n[node].height == old_height) {
+            break;
+        }
+        
+        node = n[node].parent;
     }
+}
+
+/**
+ * @brief Double the node array of a compact tree
+ * 
+ * Links are slot numbers, so moving the array needs no fix-up.
+ * 
+ * @param T Pointer to compact tree
+ * @return DS_OK on success, DS_ERR_OOM on memory failure or when the
+ *         array already has DS_TREE_COMPACT_MAX slots
+ */
+static ds_error_t cnode_grow(ds_tree_t *T) {
+    size_t new_cap = (size_t)T->ccap * 2;
+    struct ds_tree_cnode *new_nodes;
     
-    // Allocate memory for new node
-    new_node = (struct ds_tree_node *)ds_alloc(sizeof(struct ds_tree_node));
-    if (new_node == NULL) {
+    if (T->ccap == DS_TREE_COMPACT_MAX) {
         return DS_ERR_OOM;
     }
-    
-    // Initialize new node
-    new_node->data = data;
-    new_node->left = NULL;
-    new_node->right = NULL;
-    
-    // If tree is empty, make new node the root
-    if (T->root == NULL) {
-        T->root = new_node;
-        T->size++;
-        return DS_OK;
+    if (new_cap > DS_TREE_COMPACT_MAX) {
+        new_cap = DS_TREE_COMPACT_MAX;
     }
-    
-    // Find insertion point
-    current = T->root;
-    parent = NULL;
-    
-    while (current != NULL) {
-        parent = current;
-        int comparison = cmp(data, current->data);
-        
-        if (comparison < 0) {
-            current = current->left;
-        } else if (comparison > 0) {
-            current = current->right;
-        } else {
-            // Element already exists, free new node and return
-            ds_free(new_node);
-            return DS_OK;  // Consider this success (no duplicates)
-        }
+    if (new_cap > (size_t)-1 / sizeof(struct ds_tree_cnode)) {
+        return DS_ERR_OOM;
     }
     
-    // Insert new node
-    if (cmp(data, parent->data) < 0) {
-        parent->left = new_node;
-    } else {
-        parent->right = new_node;
+    new_nodes = (struct ds_tree_cnode *)ds_alloc(new_cap * sizeof(struct ds_tree_cnode));
+    if (new_nodes == NULL) {
+        return DS_ERR_OOM;
     }
+    memcpy(new_nodes, T->cnodes, (size_t)T->cused * sizeof(struct ds_tree_cnode));
+    
+    ds_stats_count_alloc(&T->stats, new_cap * sizeof(struct ds_tree_cnode));
+    ds_stats_count_free(&T->stats, (size_t)T->ccap * sizeof(struct ds_tree_cnode));
+    ds_free(T->cnodes);
+    T->cnodes = new_nodes;
+    T->ccap = (uint32_t)new_cap;
     
-    T->size++;
     return DS_OK;
 }
 
 /**
- * @brief Find element in the tree
+ * @brief Take a slot for a new compact node
  * 
- * Searches for an element in the tree using the comparison function
- * following binary search tree rules.
+ * Free slots are reused first. May move the node array.
  * 
- * @param T Pointer to tree
- * @param target Pointer to data to find
- * @param cmp Comparison function for ordering (returns <0, 0, >0)
- * @return Pointer to matching data, or NULL if not found or T/cmp/target is NULL
+ * @param T Pointer to compact tree
+ * @return Slot number, 0 on memory failure
  */
-void *ds_tree_find(ds_tree_t *T, void *target, int (*cmp)(const void *, const void *)) {
-    struct ds_tree_node *current;
+static uint32_t cnode_alloc(ds_tree_t *T) {
+    uint32_t slot;
     
-    // Validate input parameters
-    if (T == NULL || target == NULL || cmp == NULL) {
-        return NULL;
+    if (T->cfree != 0) {
+        slot = T->cfree;
+        T->cfree = T->cnodes[slot].right;
+        return slot;
     }
     
-    // Search for element
-    current = T->root;
-    while (current != NULL) {
-        int comparison = cmp(target, current->data);
+    if (T->cused == T->ccap && cnode_grow(T) != DS_OK) {
+        return 0;
+    }
+    return T->cused++;
+}
+
+/**
+ * @brief Return a slot to a compact tree's free list
+ * 
+ * @param T Pointer to compact tree
+ * @param slot Slot to release
+ */
+static void cnode_release(ds_tree_t *T, uint32_t slot) {
+    T->cnodes[slot].data = NULL;
+    T->cnodes[slot].right = T->cfree;
+    T->cfree = slot;
+}
+
+/**
+ * @brief Call free_data on every element of a compact tree
+ * 
+ * Scans the node array front to back; free slots hold no data and
+ * tombstones pass theirs to the tree's release callback.
+ * 
+ * @param T Pointer to compact tree
+ * @param free_data Function to free node data (may be NULL)
+ */
+static void cnode_free_data(ds_tree_t *T, void (*free_data)(void *)) {
+    uint32_t i;
+    
+    for (i = 1; i < T->cused; i++) {
+        void (*fn)(void *) = T->cnodes[i].dead ? T->release : free_data;
         
-        if (comparison < 0) {
-            current = current->left;
-        } else if (comparison > 0) {
-            current = current->right;
-        } else {
-            // Found match
-            return current->data;
+        if (T->cnodes[i].data != NULL && fn != NULL) {
+            fn(T->cnodes[i].data);
         }
     }
-    
-    // Not found
-    return NULL;
 }
 
 /**
- * @brief Remove element from the tree
+ * @brief Find the leftmost slot of a compact subtree
  * 
- * Removes an element from the tree using the comparison function.
- * Handles three cases: leaf node, node with one child, node with two children.
+ * @param n Node array
+ * @param node Subtree root (may be 0)
+ * @return Slot of minimum node, 0 if node is 0
+ */
+static uint32_t cnode_min(const struct ds_tree_cnode *n, uint32_t node) {
+    while (node != 0 && n[node].left != 0) {
+        node = n[node].left;
+    }
+    return node;
+}
+
+/**
+ * @brief Find the in-order successor of a compact node
  * 
- * @param T Pointer to tree
- * @param target Pointer to data to remove
- * @param cmp Comparison function for ordering (returns <0, 0, >0)
- * @return DS_OK on success, DS_ERR_NULLARG if T, target, or cmp is NULL, DS_ERR_NOTFOUND if not found
+ * @param n Node array
+ * @param node Slot of node
+ * @return Slot of successor, 0 if node is the largest
  */
-ds_error_t ds_tree_remove(ds_tree_t *T, void *target, int (*cmp)(const void *, const void *)) {
-    struct ds_tree_node *current, *parent, *successor, *successor_parent;
-    
-    // Validate input parameters
-    if (T == NULL || target == NULL || cmp == NULL) {
-        return DS_ERR_NULLARG;
+static uint32_t cnode_next(const struct ds_tree_cnode *n, uint32_t node) {
+    if (n[node].right != 0) {
+        return cnode_min(n, n[node].right);
     }
     
-    // Find node to remove
-    current = T->root;
+    // Climb until we arrive from a left child
+    while (n[node].parent != 0 && node == n[n[node].parent].right) {
+        node = n[node].parent;
+    }
+    return n[node].parent;
+}
+
+/**
+ * @brief Skip tombstones in a compact tree, in order
+ * 
+ * @param n Node array
+ * @param node Starting slot (may be 0)
+ * @return First slot at or after node that is not a tombstone, 0 if none
+ */
+static uint32_t cnode_live(const struct ds_tree_cnode *n, uint32_t node) {
+    while (node != 0 && n[node].dead) {
+        node = cnode_next(n, node);
+    }
+    return node;
+}
+
+/**
+ * @brief Print a compact tree without recursion
+ * 
+ * Same reverse in-order walk as print_subtree(), on slot numbers.
+ * 
+ * @param T Pointer to compact tree
+ * @param out Output stream
+ */
+static void cnode_print(const ds_tree_t *T, FILE *out) {
+    const struct ds_tree_cnode *n = T->cnodes;
+    uint32_t node = T->croot;
+    int depth = 0;
+    
+    if (node == 0) {
+        return;
+    }
+    
+    // Start at the rightmost (largest) node
+    while (n[node].right != 0) {
+        node = n[node].right;
+        depth++;
+    }
+    
+    while (node != 0) {
+        for (int i = 0; i < depth; i++) {
+            fprintf(out, "  ");
+        }
+        fprintf(out, n[node].dead ? "%d (removed)\n" : "%d\n", *(int *)n[node].data);
+        
+        // Step to the predecessor (next lower value)
+        if (n[node].left != 0) {
+            node = n[node].left;
+            depth++;
+            while (n[node].right != 0) {
+                node = n[node].right;
+                depth++;
+            }
+        } else {
+            while (n[node].parent != 0 && node == n[n[node].parent].left) {
+                node = n[node].parent;
+                depth--;
+            }
+            node = n[node].parent;
+            depth--;
+        }
+    }
+}
+
+/**
+ * @brief Create a new empty tree
+ * 
+ * Allocates and initializes a new tree structure with root set to NULL
+ * and size set to 0. Nodes use the library-level allocator.
+ * 
+ * @return Pointer to new tree on success, NULL on memory allocation failure
+ */
+ds_tree_t *ds_tree_create(void) {
+    return ds_tree_create_with_allocator(NULL);
+}
+
+/**
+ * @brief Create a new empty tree with a custom node allocator
+ * 
+ * The tree structure itself comes from ds_alloc; every node is obtained
+ * from the given allocator.
+ * 
+ * @param a Allocator for nodes, or NULL for the library-level allocator
+ * @return Pointer to new tree on success, NULL on invalid allocator or memory failure
+ */
+ds_tree_t *ds_tree_create_with_allocator(const ds_allocator_t *a) {
+    ds_tree_t *tree;
+    
+    // Allocate memory for tree structure
+    tree = (ds_tree_t *)ds_alloc(sizeof(struct ds_tree));
+    if (tree == NULL) {
+        return NULL;
+    }
+    
+    // Capture the node allocator
+    if (ds_allocator_init(&tree->alloc, a) != DS_OK) {
+        ds_free(tree);
+        return NULL;
+    }
+    
+    // Initialize tree to empty state
+    tree->root = NULL;
+    tree->size = 0;
+    tree->pool = NULL;
+    tree->balanced = 0;
+    tree->cnodes = NULL;
+    tree->croot = 0;
+    tree->cfree = 0;
+    tree->cused = 0;
+    tree->ccap = 0;
+    tree->dead = 0;
+    tree->max_dead = 0.0;
+    tree->release = NULL;
+    ds_stats_init(&tree->stats);
+    
+    return tree;
+}
+
+/**
+ * @brief Create a new empty tree backed by a private node pool
+ * 
+ * Nodes are served from a slab pool owned by the tree, which is released
+ * in one pass by ds_tree_free.
+ * 
+ * @return Pointer to new tree on success, NULL on memory allocation failure
+ */
+ds_tree_t *ds_tree_create_pooled(void) {
+    ds_tree_t *tree;
+    ds_slab_t *pool;
+    ds_allocator_t a;
+    
+    // Create the node pool first
+    pool = ds_slab_create(sizeof(struct ds_tree_node), DS_SLAB_DEFAULT_OBJS);
+    if (pool == NULL) {
+        return NULL;
+    }
+    
+    a = ds_slab_allocator(pool);
+    tree = ds_tree_create_with_allocator(&a);
+    if (tree == NULL) {
+        ds_slab_free(pool);
+        return NULL;
+    }
+    
+    tree->pool = pool;
+    return tree;
+}
+
+/**
+ * @brief Create a new empty self-balancing tree
+ * 
+ * The tree is kept AVL-balanced on every insert and remove, so its height
+ * stays O(log n) even for sorted input.
+ * 
+ * @return Pointer to new tree on success, NULL on memory allocation failure
+ */
+ds_tree_t *ds_tree_create_balanced(void) {
+    ds_tree_t *tree;
+    
+    tree = ds_tree_create_with_allocator(NULL);
+    if (tree == NULL) {
+        return NULL;
+    }
+    
+    tree->balanced = 1;
+    return tree;
+}
+
+/**
+ * @brief Create a new empty compact tree
+ * 
+ * Nodes live in one array of DS_TREE_COMPACT_MIN or more slots, sized
+ * for capacity_hint elements up front and doubled whenever it is full.
+ * Slot 0 is the sentinel, so the array holds one slot more than the hint.
+ * 
+ * @param capacity_hint Expected number of elements
+ * @return Pointer to new tree on success, NULL on memory allocation failure
+ *         or if capacity_hint exceeds DS_TREE_COMPACT_MAX - 1
+ */
+ds_tree_t *ds_tree_create_compact(size_t capacity_hint) {
+    ds_tree_t *tree;
+    size_t cap;
+    
+    if (capacity_hint >= DS_TREE_COMPACT_MAX ||
+        capacity_hint >= (size_t)-1 / sizeof(struct ds_tree_cnode)) {
+        return NULL;
+    }
+    cap = (capacity_hint + 1 > DS_TREE_COMPACT_MIN) ? capacity_hint + 1 : DS_TREE_COMPACT_MIN;
+    
+    tree = ds_tree_create_with_allocator(NULL);
+    if (tree == NULL) {
+        return NULL;
+    }
+    
+    tree->cnodes = (struct ds_tree_cnode *)ds_alloc(cap * sizeof(struct ds_tree_cnode));
+    if (tree->cnodes == NULL) {
+        ds_free(tree);
+        return NULL;
+    }
+    ds_stats_count_alloc(&tree->stats, cap * sizeof(struct ds_tree_cnode));
+    
+    // The sentinel is an empty subtree of height 0
+    memset(&tree->cnodes[0], 0, sizeof(struct ds_tree_cnode));
+    tree->ccap = (uint32_t)cap;
+    tree->cused = 1;
+    tree->balanced = 1;
+    
+    return tree;
+}
+
+/**
+ * @brief Build a perfectly balanced subtree from a sorted slice
+ * 
+ * The left subtree is built before its root is allocated, so nodes are
+ * carved out of the pool in in-order sequence and an in-order walk
+ * reads memory front to back. Recursion depth is O(log n).
+ * 
+ * @param T Pointer to tree owning the pool
+ * @param items Sorted item array
+ * @param lo First index of the slice
+ * @param hi One past the last index of the slice
+ * @param parent Parent for the subtree root
+ * @return Pointer to subtree root, NULL for an empty slice
+ */
+static struct ds_tree_node *build_range(ds_tree_t *T, void *const *items, size_t lo, size_t hi,
+                                        struct ds_tree_node *parent) {
+    struct ds_tree_node *node, *left;
+    size_t mid;
+    
+    if (lo == hi) {
+        return NULL;
+    }
+    
+    mid = lo + (hi - lo) / 2;
+    left = build_range(T, items, lo, mid, NULL);
+    
+    // The pool was sized for n nodes, so this cannot fail
+    node = (struct ds_tree_node *)ds_node_alloc(&T->alloc, &T->stats, sizeof(struct ds_tree_node));
+    node->data = items[mid];
+    node->dead = 0;
+    node->parent = parent;
+    node->left = left;
+    if (left != NULL) {
+        left->parent = node;
+    }
+    node->right = build_range(T, items, mid + 1, hi, node);
+    update_height(node);
+    
+    return node;
+}
+
+/**
+ * @brief Build a balanced tree from items already in ascending order
+ * 
+ * Creates a self-balancing tree (see ds_tree_create_balanced) whose
+ * nodes all come from a single pool allocation sized for n, and links
+ * them into a perfectly balanced shape in O(n) time without comparing
+ * any items. Nodes released by later removals are recycled by the pool.
+ * 
+ * @param items Array of n data pointers in strictly ascending order
+ * @param n Number of items
+ * @return Pointer to new tree on success, NULL if items is NULL while n > 0,
+ *         if any item is NULL, or on memory allocation failure
+ */
+ds_tree_t *ds_tree_build_sorted(void *const *items, size_t n) {
+    ds_tree_t *tree;
+    ds_slab_t *pool;
+    ds_allocator_t a;
+    size_t i;
+    
+    if (items == NULL && n > 0) {
+        return NULL;
+    }
+    for (i = 0; i < n; i++) {
+        if (items[i] == NULL) {
+            return NULL;
+        }
+    }
+    
+    // One slab holds every node of the initial tree
+    pool = ds_slab_create(sizeof(struct ds_tree_node), (n > 0) ? n : DS_SLAB_DEFAULT_OBJS);
+    if (pool == NULL) {
+        return NULL;
+    }
+    
+    a = ds_slab_allocator(pool);
+    tree = ds_tree_create_with_allocator(&a);
+    if (tree == NULL) {
+        ds_slab_free(pool);
+        return NULL;
+    }
+    tree->pool = pool;
+    tree->balanced = 1;
+    
+    // Carve the single slab up front so the build itself cannot fail
+    if (n > 0) {
+        void *first = ds_node_alloc(&tree->alloc, &tree->stats, sizeof(struct ds_tree_node));
+        
+        if (first == NULL) {
+            ds_tree_free(tree, NULL);
+            return NULL;
+        }
+        ds_node_free(&tree->alloc, &tree->stats, first, sizeof(struct ds_tree_node));
+    }
+    
+    tree->root = build_range(tree, items, 0, n, NULL);
+    tree->size = n;
+    ds_stats_resize(&tree->stats, n);
+    
+    return tree;
+}
+
+/**
+ * @brief Free a tree and optionally its data
+ * 
+ * Recursively frees all nodes in the tree, optionally calls free_data
+ * for each node's data pointer, then deallocates the tree structure itself.
+ * 
+ * @param T Pointer to tree to free
+ * @param free_data Optional function to free node data (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if T is NULL
+ */
+ds_error_t ds_tree_free(ds_tree_t *T, void (*free_data)(void *)) {
+    // Validate input parameter
+    if (T == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    // A compact tree's nodes all live in its node array
+    if (T->cnodes != NULL) {
+        if (free_data != NULL || (T->dead > 0 && T->release != NULL)) {
+            cnode_free_data(T, free_data);
+        }
+        ds_stats_count_free(&T->stats, (size_t)T->ccap * sizeof(struct ds_tree_cnode));
+        ds_free(T->cnodes);
+    }
+    
+    // Pooled and arena nodes are released wholesale, so only walk if data needs freeing
+    if ((T->pool == NULL && ds_allocator_frees(&T->alloc)) || free_data != NULL ||
+        (T->dead > 0 && T->release != NULL)) {
+        free_subtree(T, T->root, free_data, 0);
+    }
+    
+    // Release the node pool in one pass
+    if (T->pool != NULL) {
+        ds_slab_free(T->pool);
+    }
+    
+    // Free the tree structure
+    ds_stats_release(&T->stats);
+    ds_free(T);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Remove all elements from a tree
+ * 
+ * Frees every node without recursion and leaves the tree empty but
+ * usable. Allocator, pool and balancing mode are kept; pooled nodes go
+ * back to the tree's pool for reuse by later inserts.
+ * 
+ * @param T Pointer to tree to clear
+ * @param free_data Optional function to free node data (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if T is NULL
+ */
+ds_error_t ds_tree_clear(ds_tree_t *T, void (*free_data)(void *)) {
+    // Validate input parameter
+    if (T == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    // A compact tree keeps its node array for reuse
+    if (T->cnodes != NULL) {
+        if (free_data != NULL || (T->dead > 0 && T->release != NULL)) {
+            cnode_free_data(T, free_data);
+        }
+        T->croot = 0;
+        T->cfree = 0;
+        T->cused = 1;
+    }
+    
+    free_subtree(T, T->root, free_data, 1);
+    T->root = NULL;
+    T->size = 0;
+    T->dead = 0;
+    ds_stats_resize(&T->stats, 0);
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Flatten a subtree into a sorted vine, dropping tombstones
+ * 
+ * Rotates left children up as free_subtree() does until the nodes form
+ * one chain linked through right in ascending order. Tombstones are
+ * unlinked as they reach the chain, their data handed to the tree's
+ * release callback and their nodes freed. Runs in O(n) time and O(1)
+ * extra space.
+ * 
+ * @param T Pointer to tree
+ * @param node Subtree root (may be NULL)
+ * @return First node of the vine, NULL if no live node remains
+ */
+static struct ds_tree_node *flatten_live(ds_tree_t *T, struct ds_tree_node *node) {
+    struct ds_tree_node *head = NULL, **tail = &head, *next;
+    
+    while (node != NULL) {
+        if (node->left != NULL) {
+            next = node->left;
+            node->left = next->right;
+            next->right = node;
+            node = next;
+            continue;
+        }
+        
+        next = node->right;
+        if (node->dead) {
+            if (T->release != NULL) {
+                T->release(node->data);
+            }
+            ds_node_free(&T->alloc, &T->stats, node, sizeof(struct ds_tree_node));
+        } else {
+            *tail = node;
+            tail = &node->right;
+        }
+        node = next;
+    }
+    
+    *tail = NULL;
+    return head;
+}
+
+/**
+ * @brief Build a perfectly balanced subtree from the front of a vine
+ * 
+ * Consumes n nodes in order, so the nodes keep their memory location.
+ * Recursion depth is O(log n).
+ * 
+ * @param vine Pointer to the vine head, advanced past the nodes used
+ * @param n Number of nodes to take
+ * @param parent Parent for the subtree root
+ * @return Pointer to subtree root, NULL if n is 0
+ */
+static struct ds_tree_node *build_vine(struct ds_tree_node **vine, size_t n,
+                                       struct ds_tree_node *parent) {
+    struct ds_tree_node *node, *left;
+    
+    if (n == 0) {
+        return NULL;
+    }
+    
+    left = build_vine(vine, n / 2, NULL);
+    node = *vine;
+    *vine = node->right;
+    node->parent = parent;
+    node->left = left;
+    if (left != NULL) {
+        left->parent = node;
+    }
+    node->right = build_vine(vine, n - n / 2 - 1, node);
+    update_height(node);
+    
+    return node;
+}
+
+/**
+ * @brief Flatten a compact subtree into a sorted vine, dropping tombstones
+ * 
+ * Same walk as flatten_live(), on slot numbers; tombstone slots go back
+ * to the free list.
+ * 
+ * @param T Pointer to compact tree
+ * @param node Subtree root (may be 0)
+ * @return First slot of the vine, 0 if no live node remains
+ */
+static uint32_t cnode_flatten_live(ds_tree_t *T, uint32_t node) {
+    struct ds_tree_cnode *n = T->cnodes;
+    uint32_t head = 0, tail = 0, next;
+    
+    while (node != 0) {
+        if (n[node].left != 0) {
+            next = n[node].left;
+            n[node].left = n[next].right;
+            n[next].right = node;
+            node = next;
+            continue;
+        }
+        
+        next = n[node].right;
+        if (n[node].dead) {
+            if (T->release != NULL) {
+                T->release(n[node].data);
+            }
+            n[node].dead = 0;
+            cnode_release(T, node);
+        } else {
+            if (tail == 0) {
+                head = node;
+            } else {
+                n[tail].right = node;
+            }
+            tail = node;
+        }
+        node = next;
+    }
+    
+    if (tail != 0) {
+        n[tail].right = 0;
+    }
+    return head;
+}
+
+/**
+ * @brief Build a perfectly balanced compact subtree from the front of a vine
+ * 
+ * @param n Node array
+ * @param vine Pointer to the vine head, advanced past the slots used
+ * @param count Number of slots to take
+ * @param parent Parent for the subtree root
+ * @return Subtree root, 0 if count is 0
+ */
+static uint32_t cnode_build_vine(struct ds_tree_cnode *n, uint32_t *vine, size_t count, uint32_t parent) {
+    uint32_t node, left;
+    
+    if (count == 0) {
+        return 0;
+    }
+    
+    left = cnode_build_vine(n, vine, count / 2, 0);
+    node = *vine;
+    *vine = n[node].right;
+    n[node].parent = parent;
+    n[node].left = left;
+    if (left != 0) {
+        n[left].parent = node;
+    }
+    n[node].right = cnode_build_vine(n, vine, count - count / 2 - 1, node);
+    cnode_update_height(n, node);
+    
+    return node;
+}
+
+/**
+ * @brief Sweep out every tombstone and rebuild the tree balanced
+ * 
+ * The nodes are reused in place, so the rebuild allocates nothing and
+ * cannot fail.
+ * 
+ * @param T Pointer to tree
+ */
+static void tree_compact(ds_tree_t *T) {
+    if (T->cnodes != NULL) {
+        uint32_t vine = cnode_flatten_live(T, T->croot);
+        
+        T->croot = cnode_build_vine(T->cnodes, &vine, T->size, 0);
+    } else {
+        struct ds_tree_node *vine = flatten_live(T, T->root);
+        
+        T->root = build_vine(&vine, T->size, NULL);
+    }
+    T->dead = 0;
+}
+
+/**
+ * @brief Check whether tombstones exceed the tree's limit
+ * 
+ * @param T Pointer to tree
+ * @return Non-zero if tombstones make up more than max_dead of all nodes
+ */
+static int tombstones_over_limit(const ds_tree_t *T) {
+    return (double)T->dead > T->max_dead * (double)(T->size + T->dead);
+}
+
+/**
+ * @brief Account for a node just turned into a tombstone
+ * 
+ * Compacts the tree once the tombstones cross the limit, so each lazy
+ * remove costs amortized O(log n).
+ * 
+ * @param T Pointer to tree
+ * @return DS_OK
+ */
+static ds_error_t bury(ds_tree_t *T) {
+    T->size--;
+    T->dead++;
+    ds_stats_resize(&T->stats, T->size);
+    
+    if (tombstones_over_limit(T)) {
+        tree_compact(T);
+    }
+    return DS_OK;
+}
+
+/**
+ * @brief Account for a tombstone brought back by an insert of its key
+ * 
+ * The element the tombstone held is purged here and handed to the
+ * release callback, unless it is the very object being reinserted; the
+ * caller then stores the new data in the node and clears its mark.
+ * 
+ * @param T Pointer to tree
+ * @param old Data of the tombstone
+ * @param data Data being inserted
+ * @return DS_OK
+ */
+static ds_error_t revive(ds_tree_t *T, void *old, void *data) {
+    if (T->release != NULL && old != data) {
+        T->release(old);
+    }
+    T->dead--;
+    T->size++;
+    
+    ds_stats_resize(&T->stats, T->size);
+    return DS_OK;
+}
+
+/**
+ * @brief Insert into a compact tree
+ * 
+ * @param T Pointer to compact tree
+ * @param data Pointer to data to insert
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return DS_OK on success, DS_ERR_OOM on memory failure
+ */
+static ds_error_t cnode_insert(ds_tree_t *T, void *data, int (*cmp)(const void *, const void *)) {
+    struct ds_tree_cnode *n;
+    uint32_t slot, current, parent = 0;
+    size_t compares = 0;
+    int comparison = 0;
+    
+    // Find insertion point, remembering the last comparison
+    n = T->cnodes;
+    current = T->croot;
+    while (current != 0) {
+        parent = current;
+        comparison = cmp(data, n[current].data);
+        compares++;
+        
+        if (comparison < 0) {
+            current = n[current].left;
+        } else if (comparison > 0) {
+            current = n[current].right;
+        } else {
+            // Element already exists, so no slot is needed
+            ds_stats_count_compares(&T->stats, compares);
+            if (n[current].dead) {
+                revive(T, n[current].data, data);
+                n[current].data = data;
+                n[current].dead = 0;
+            }
+            return DS_OK;
+        }
+    }
+    
+    // Take a slot only now; growing moves the array but keeps the indices
+    slot = cnode_alloc(T);
+    if (slot == 0) {
+        ds_stats_count_compares(&T->stats, compares);
+        return DS_ERR_OOM;
+    }
+    n = T->cnodes;
+    
+    n[slot].data = data;
+    n[slot].dead = 0;
+    n[slot].left = 0;
+    n[slot].right = 0;
+    n[slot].parent = parent;
+    n[slot].height = 1;
+    
+    if (parent == 0) {
+        T->croot = slot;
+    } else if (comparison < 0) {
+        n[parent].left = slot;
+    } else {
+        n[parent].right = slot;
+    }
+    cnode_rebalance(T, parent);
+    
+    ds_stats_count_compares(&T->stats, compares);
+    T->size++;
+    
+    ds_stats_resize(&T->stats, T->size);
+    return DS_OK;
+}
+
+/**
+ * @brief Find in a compact tree
+ * 
+ * @param T Pointer to compact tree
+ * @param target Pointer to data to find
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return Pointer to matching data, or NULL if not found
+ */
+static void *cnode_find(ds_tree_t *T, void *target, int (*cmp)(const void *, const void *)) {
+    const struct ds_tree_cnode *n = T->cnodes;
+    uint32_t current = T->croot;
+    size_t depth = 0;
+    
+    while (current != 0) {
+        int comparison = cmp(target, n[current].data);
+        
+        depth++;
+        if (comparison < 0) {
+            current = n[current].left;
+        } else if (comparison > 0) {
+            current = n[current].right;
+        } else {
+            // A tombstone means the key was removed
+            ds_stats_count_find(&T->stats, 1, depth, depth);
+            return n[current].dead ? NULL : n[current].data;
+        }
+    }
+    
+    ds_stats_count_find(&T->stats, 1, depth, depth);
+    return NULL;
+}
+
+/**
+ * @brief Remove from a compact tree
+ * 
+ * @param T Pointer to compact tree
+ * @param target Pointer to data to remove
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return DS_OK on success, DS_ERR_NOTFOUND if not found
+ */
+static ds_error_t cnode_remove(ds_tree_t *T, void *target, int (*cmp)(const void *, const void *)) {
+    struct ds_tree_cnode *n = T->cnodes;
+    uint32_t current = T->croot, parent = 0;
+    size_t compares = 0;
+    
+    while (current != 0) {
+        int comparison = cmp(target, n[current].data);
+        
+        compares++;
+        if (comparison == 0) {
+            break;
+        }
+        parent = current;
+        current = (comparison < 0) ? n[current].left : n[current].right;
+    }
+    
+    ds_stats_count_compares(&T->stats, compares);
+    if (current == 0 || n[current].dead) {
+        return DS_ERR_NOTFOUND;
+    }
+    
+    // Lazy removal only marks the node
+    if (T->max_dead > 0) {
+        n[current].dead = 1;
+        return bury(T);
+    }
+    
+    if (n[current].left == 0 || n[current].right == 0) {
+        // At most one child takes the node's place
+        cnode_replace_child(T, parent, current, (n[current].left != 0) ? n[current].left : n[current].right);
+        cnode_release(T, current);
+    } else {
+        // Two children: take over the successor's data and unlink it instead
+        uint32_t successor = n[current].right;
+        
+        parent = current;
+        while (n[successor].left != 0) {
+            parent = successor;
+            successor = n[successor].left;
+        }
+        n[current].data = n[successor].data;
+        cnode_replace_child(T, parent, successor, n[successor].right);
+        cnode_release(T, successor);
+    }
+    cnode_rebalance(T, parent);
+    
+    T->size--;
+    
+    ds_stats_resize(&T->stats, T->size);
+    return DS_OK;
+}
+
+/**
+ * @brief Untraced implementation of ds_tree_insert
+ */
+static ds_error_t tree_insert(ds_tree_t *T, void *data, int (*cmp)(const void *, const void *)) {
+    struct ds_tree_node *new_node, *current, *parent;
+    size_t compares = 0;
+    int comparison;
+    
+    // Validate input parameters
+    if (T == NULL || data == NULL || cmp == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    if (T->cnodes != NULL) {
+        return cnode_insert(T, data, cmp);
+    }
+    
+    // Allocate memory for new node
+    new_node = (struct ds_tree_node *)ds_node_alloc(&T->alloc, &T->stats, sizeof(struct ds_tree_node));
+    if (new_node == NULL) {
+        return DS_ERR_OOM;
+    }
+    
+    // Initialize new node
+    new_node->data = data;
+    new_node->left = NULL;
+    new_node->right = NULL;
+    new_node->parent = NULL;
+    new_node->height = 1;
+    new_node->dead = 0;
+    
+    // If tree is empty, make new node the root
+    if (T->root == NULL) {
+        T->root = new_node;
+        T->size++;
+        ds_stats_resize(&T->stats, T->size);
+        return DS_OK;
+    }
+    
+    // Find insertion point, remembering the last comparison
+    current = T->root;
+    parent = NULL;
+    comparison = 0;
+    
+    while (current != NULL) {
+        parent = current;
+        comparison = cmp(data, current->data);
+        compares++;
+        
+        if (comparison < 0) {
+            current = current->left;
+        } else if (comparison > 0) {
+            current = current->right;
+        } else {
+            // Element already exists, free new node and return
+            ds_node_free(&T->alloc, &T->stats, new_node, sizeof(struct ds_tree_node));
+            ds_stats_count_compares(&T->stats, compares);
+            if (current->dead) {
+                // Reuse the tombstone for the reinserted key
+                revive(T, current->data, data);
+                current->data = data;
+                current->dead = 0;
+            }
+            return DS_OK;  // Consider this success (no duplicates)
+        }
+    }
+    
+    // Insert new node on the side the last comparison chose
+    if (comparison < 0) {
+        parent->left = new_node;
+    } else {
+        parent->right = new_node;
+    }
+    new_node->parent = parent;
+    
+    if (T->balanced) {
+        rebalance(T, parent);
+    }
+    
+    ds_stats_count_compares(&T->stats, compares);
+    T->size++;
+    
+    ds_stats_resize(&T->stats, T->size);
+    return DS_OK;
+}
+
+/**
+ * @brief Insert element into the tree
+ * 
+ * Inserts a new element into the tree using the comparison function
+ * to determine the correct position following binary search tree rules.
+ * 
+ * @param T Pointer to tree
+ * @param data Pointer to data to insert
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return DS_OK on success, DS_ERR_NULLARG if T, data, or cmp is NULL, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_tree_insert(ds_tree_t *T, void *data, int (*cmp)(const void *, const void *)) {
+    ds_error_t result;
+    
+    DS_TRACE_BEGIN();
+    result = tree_insert(T, data, cmp);
+    DS_TRACE_END(DS_TRACE_TREE_INSERT, T);
+    
+    return result;
+}
+
+/**
+ * @brief Untraced implementation of ds_tree_find
+ */
+static void *tree_find(ds_tree_t *T, void *target, int (*cmp)(const void *, const void *)) {
+    struct ds_tree_node *current;
+    size_t depth = 0;
+    
+    // Validate input parameters
+    if (T == NULL || target == NULL || cmp == NULL) {
+        return NULL;
+    }
+    if (T->cnodes != NULL) {
+        return cnode_find(T, target, cmp);
+    }
+    
+    // Search for element
+    current = T->root;
+    while (current != NULL) {
+        int comparison = cmp(target, current->data);
+        
+        depth++;
+        if (comparison < 0) {
+            current = current->left;
+        } else if (comparison > 0) {
+            current = current->right;
+        } else {
+            // Found match; a tombstone means the key was removed
+            ds_stats_count_find(&T->stats, 1, depth, depth);
+            return current->dead ? NULL : current->data;
+        }
+    }
+    
+    // Not found
+    ds_stats_count_find(&T->stats, 1, depth, depth);
+    return NULL;
+}
+
+/**
+ * @brief Find element in the tree
+ * 
+ * Searches for an element in the tree using the comparison function
+ * following binary search tree rules.
+ * 
+ * @param T Pointer to tree
+ * @param target Pointer to data to find
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return Pointer to matching data, or NULL if not found or T/cmp/target is NULL
+ */
+void *ds_tree_find(ds_tree_t *T, void *target, int (*cmp)(const void *, const void *)) {
+    void *result;
+    
+    DS_TRACE_BEGIN();
+    result = tree_find(T, target, cmp);
+    DS_TRACE_END(DS_TRACE_TREE_FIND, T);
+    
+    return result;
+}
+
+/**
+ * @brief Untraced implementation of ds_tree_remove
+ */
+static ds_error_t tree_remove(ds_tree_t *T, void *target, int (*cmp)(const void *, const void *)) {
+    struct ds_tree_node *current, *parent, *successor, *successor_parent;
+    size_t compares = 0;
+    
+    // Validate input parameters
+    if (T == NULL || target == NULL || cmp == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    if (T->cnodes != NULL) {
+        return cnode_remove(T, target, cmp);
+    }
+    
+    // Find node to remove
+    current = T->root;
     parent = NULL;
     
     while (current != NULL) {
-        int comparison = cmp(target, current->data);
+        int comparison = cmp(target, current->data);
+        
+        compares++;
+        if (comparison < 0) {
+            parent = current;
+            current = current->left;
+        } else if (comparison > 0) {
+            parent = current;
+            current = current->right;
+        } else {
+            // Found node to remove
+            break;
+        }
+    }
+    
+    ds_stats_count_compares(&T->stats, compares);
+    if (current == NULL || current->dead) {
+        return DS_ERR_NOTFOUND;
+    }
+    
+    // Lazy removal only marks the node
+    if (T->max_dead > 0) {
+        current->dead = 1;
+        return bury(T);
+    }
+    
+    // Case 1: Node has no children (leaf node)
+    if (current->left == NULL && current->right == NULL) {
+        replace_child(T, parent, current, NULL);
+        ds_node_free(&T->alloc, &T->stats, current, sizeof(struct ds_tree_node));
+    }
+    // Case 2: Node has one child
+    else if (current->left == NULL || current->right == NULL) {
+        struct ds_tree_node *child = (current->left != NULL) ? current->left : current->right;
+        
+        replace_child(T, parent, current, child);
+        ds_node_free(&T->alloc, &T->stats, current, sizeof(struct ds_tree_node));
+    }
+    // Case 3: Node has two children
+    else {
+        // Find successor (minimum in right subtree)
+        successor = current->right;
+        successor_parent = current;
+        
+        while (successor->left != NULL) {
+            successor_parent = successor;
+            successor = successor->left;
+        }
+        
+        // Replace current data with successor data
+        current->data = successor->data;
+        
+        // Remove successor
+        replace_child(T, successor_parent, successor, successor->right);
+        ds_node_free(&T->alloc, &T->stats, successor, sizeof(struct ds_tree_node));
+        
+        // Rebalancing starts where the successor was unlinked
+        parent = successor_parent;
+    }
+    
+    if (T->balanced) {
+        rebalance(T, parent);
+    }
+    
+    T->size--;
+    
+    ds_stats_resize(&T->stats, T->size);
+    return DS_OK;
+}
+
+/**
+ * @brief Remove element from the tree
+ * 
+ * Removes an element from the tree using the comparison function.
+ * Handles three cases: leaf node, node with one child, node with two children.
+ * 
+ * @param T Pointer to tree
+ * @param target Pointer to data to remove
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return DS_OK on success, DS_ERR_NULLARG if T, target, or cmp is NULL, DS_ERR_NOTFOUND if not found
+ */
+ds_error_t ds_tree_remove(ds_tree_t *T, void *target, int (*cmp)(const void *, const void *)) {
+    ds_error_t result;
+    
+    DS_TRACE_BEGIN();
+    result = tree_remove(T, target, cmp);
+    DS_TRACE_END(DS_TRACE_TREE_REMOVE, T);
+    
+    return result;
+}
+
+/**
+ * @brief Switch a tree between eager and lazy removal
+ * 
+ * Existing tombstones are swept out right away when removal turns eager
+ * or when they already exceed the new limit.
+ * 
+ * @param T Pointer to tree
+ * @param max_dead Tombstone fraction of all nodes that triggers compaction,
+ *                 in (0, 1]; 0 restores eager removal
+ * @param release Receives the data of every purged tombstone (may be NULL)
+ * @return DS_OK on success, DS_ERR_NULLARG if T is NULL, DS_ERR_INVALID if max_dead is out of range
+ */
+ds_error_t ds_tree_set_lazy_remove(ds_tree_t *T, double max_dead, void (*release)(void *data)) {
+    // Validate input parameters
+    if (T == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    if (!(max_dead >= 0.0 && max_dead <= 1.0)) {
+        return DS_ERR_INVALID;
+    }
+    
+    T->max_dead = max_dead;
+    T->release = release;
+    if (T->dead > 0 && tombstones_over_limit(T)) {
+        tree_compact(T);
+    }
+    
+    return DS_OK;
+}
+
+/**
+ * @brief Sweep out tombstones and rebuild the tree
+ * 
+ * Flattens the tree into a sorted chain in place, unlinking tombstones
+ * on the way, and relinks the remaining nodes into a perfectly balanced
+ * shape. O(n) time, no allocation and no comparator calls.
+ * 
+ * @param T Pointer to tree
+ * @return DS_OK on success, DS_ERR_NULLARG if T is NULL
+ */
+ds_error_t ds_tree_compact(ds_tree_t *T) {
+    if (T == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    tree_compact(T);
+    return DS_OK;
+}
+
+/**
+ * @brief Get the number of tombstones awaiting compaction
+ * 
+ * @param T Pointer to tree
+ * @return Number of lazily removed nodes still linked, or 0 if T is NULL
+ */
+size_t ds_tree_tombstones(const ds_tree_t *T) {
+    return (T != NULL) ? T->dead : 0;
+}
+
+/**
+ * @brief Get the number of elements in the tree
+ * 
+ * Returns the current size (number of elements) of the tree.
+ * This is an O(1) operation since size is cached.
+ * 
+ * @param T Pointer to tree
+ * @return Number of elements in tree, or 0 if T is NULL
+ */
+size_t ds_tree_size(const ds_tree_t *T) {
+    if (T == NULL) {
+        return 0;
+    }
+    
+    return T->size;
+}
+
+/**
+ * @brief Get the height of the tree
+ * 
+ * Balanced trees report the cached root height in O(1). Other trees are
+ * measured with a parent-pointer walk that needs no extra space.
+ * 
+ * @param T Pointer to tree
+ * @return Number of nodes on the longest root-to-leaf path, or 0 if T is NULL or empty
+ */
+size_t ds_tree_height(const ds_tree_t *T) {
+    struct ds_tree_node *node, *prev = NULL;
+    size_t depth = 0, height = 0;
+    
+    if (T == NULL) {
+        return 0;
+    }
+    
+    // The sentinel makes an empty compact tree report 0
+    if (T->cnodes != NULL) {
+        return (size_t)T->cnodes[T->croot].height;
+    }
+    if (T->root == NULL) {
+        return 0;
+    }
+    if (T->balanced) {
+        return (size_t)T->root->height;
+    }
+    
+    // Depth-first walk, descending left then right, climbing via parent
+    node = T->root;
+    depth = 1;
+    while (node != NULL) {
+        struct ds_tree_node *next;
+        
+        if (prev == node->parent) {
+            // Arrived from above
+            if (depth > height) {
+                height = depth;
+            }
+            next = (node->left != NULL) ? node->left : (node->right != NULL) ? node->right : node->parent;
+        } else if (prev == node->left && node->right != NULL) {
+            // Finished left subtree, descend right
+            next = node->right;
+        } else {
+            // Finished all children, climb
+            next = node->parent;
+        }
+        
+        if (next == node->parent) {
+            depth--;
+        } else {
+            depth++;
+        }
+        prev = node;
+        node = next;
+    }
+    
+    return height;
+}
+
+/**
+ * @brief Check if tree is empty
+ * 
+ * Returns 1 if the tree is empty, 0 if it contains elements.
+ * 
+ * @param T Pointer to tree
+ * @return 1 if empty, 0 if not empty, 0 if T is NULL
+ */
+int ds_tree_is_empty(const ds_tree_t *T) {
+    if (T == NULL) {
+        return 1;  // Consider NULL as empty
+    }
+    
+    return (T->size == 0) ? 1 : 0;
+}
+
+/**
+ * @brief Find many elements in a compact tree at once
+ * 
+ * Same lane scheme as ds_tree_find_batch(), on slot numbers.
+ * 
+ * @param T Pointer to compact tree
+ * @param keys Array of n keys to find
+ * @param n Number of keys
+ * @param out Array receiving n results (matching data or NULL)
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return Number of keys found
+ */
+static size_t cnode_find_batch(ds_tree_t *T, void *const *keys, size_t n, void **out,
+                               int (*cmp)(const void *, const void *)) {
+    const struct ds_tree_cnode *nodes = T->cnodes;
+    uint32_t cur[DS_BATCH_LANES];
+    size_t idx[DS_BATCH_LANES];
+    size_t next = 0, found = 0, depth = 0;
+    int lane, active = 0, comparison;
+    
+    // Start a search in every lane
+    for (lane = 0; lane < DS_BATCH_LANES; lane++) {
+        cur[lane] = 0;
+        while (next < n && cur[lane] == 0) {
+            out[next] = NULL;
+            if (keys[next] != NULL && T->croot != 0) {
+                cur[lane] = T->croot;
+                idx[lane] = next;
+                active++;
+            }
+            next++;
+        }
+    }
+    
+    while (active > 0) {
+        for (lane = 0; lane < DS_BATCH_LANES; lane++) {
+            if (cur[lane] == 0) {
+                continue;
+            }
+            
+            // Advance this search by one level
+            comparison = cmp(keys[idx[lane]], nodes[cur[lane]].data);
+            depth++;
+            if (comparison == 0) {
+                if (!nodes[cur[lane]].dead) {
+                    out[idx[lane]] = nodes[cur[lane]].data;
+                    found++;
+                }
+                cur[lane] = 0;
+            } else {
+                cur[lane] = (comparison < 0) ? nodes[cur[lane]].left : nodes[cur[lane]].right;
+            }
+            
+            if (cur[lane] != 0) {
+                DS_PREFETCH(&nodes[cur[lane]]);
+                continue;
+            }
+            
+            // Search finished: hand the lane the next pending key
+            active--;
+            while (next < n && cur[lane] == 0) {
+                out[next] = NULL;
+                if (keys[next] != NULL) {
+                    cur[lane] = T->croot;
+                    idx[lane] = next;
+                    active++;
+                }
+                next++;
+            }
+        }
+    }
+    
+    ds_stats_count_find(&T->stats, n, depth, depth);
+    return found;
+}
+
+/**
+ * @brief Find many elements in the tree at once
+ * 
+ * Up to DS_BATCH_LANES searches descend the tree together, one level per
+ * round, and each lane prefetches the child it will visit next. While
+ * one lane waits for its node to arrive from memory the others make
+ * progress, so independent lookups overlap their cache misses.
+ * 
+ * @param T Pointer to tree
+ * @param keys Array of n keys to find
+ * @param n Number of keys
+ * @param out Array receiving n results (matching data or NULL)
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return Number of keys found, 0 if T, keys, out, or cmp is NULL
+ */
+size_t ds_tree_find_batch(ds_tree_t *T, void *const *keys, size_t n, void **out,
+                          int (*cmp)(const void *, const void *)) {
+    struct ds_tree_node *cur[DS_BATCH_LANES];
+    size_t idx[DS_BATCH_LANES];
+    size_t next = 0, found = 0, depth = 0;
+    int lane, active = 0, comparison;
+    
+    // Validate input parameters
+    if (T == NULL || keys == NULL || out == NULL || cmp == NULL) {
+        return 0;
+    }
+    if (T->cnodes != NULL) {
+        return cnode_find_batch(T, keys, n, out, cmp);
+    }
+    
+    // Start a search in every lane
+    for (lane = 0; lane < DS_BATCH_LANES; lane++) {
+        cur[lane] = NULL;
+        while (next < n && cur[lane] == NULL) {
+            out[next] = NULL;
+            if (keys[next] != NULL && T->root != NULL) {
+                cur[lane] = T->root;
+                idx[lane] = next;
+                active++;
+            }
+            next++;
+        }
+    }
+    
+    while (active > 0) {
+        for (lane = 0; lane < DS_BATCH_LANES; lane++) {
+            if (cur[lane] == NULL) {
+                continue;
+            }
+            
+            // Advance this search by one level
+            comparison = cmp(keys[idx[lane]], cur[lane]->data);
+            depth++;
+            if (comparison == 0) {
+                if (!cur[lane]->dead) {
+                    out[idx[lane]] = cur[lane]->data;
+                    found++;
+                }
+                cur[lane] = NULL;
+            } else {
+                cur[lane] = (comparison < 0) ? cur[lane]->left : cur[lane]->right;
+            }
+            
+            if (cur[lane] != NULL) {
+                DS_PREFETCH(cur[lane]);
+                continue;
+            }
+            
+            // Search finished: hand the lane the next pending key
+            active--;
+            while (next < n && cur[lane] == NULL) {
+                out[next] = NULL;
+                if (keys[next] != NULL) {
+                    cur[lane] = T->root;
+                    idx[lane] = next;
+                    active++;
+                }
+                next++;
+            }
+        }
+    }
+    
+    ds_stats_count_find(&T->stats, n, depth, depth);
+    return found;
+}
+
+/**
+ * @brief Find the in-order successor of a node
+ * 
+ * @param node Pointer to node
+ * @return Pointer to successor, or NULL if node is the largest
+ */
+static struct ds_tree_node *node_next(struct ds_tree_node *node) {
+    if (node->right != NULL) {
+        return find_min(node->right);
+    }
+    
+    // Climb until we arrive from a left child
+    while (node->parent != NULL && node == node->parent->right) {
+        node = node->parent;
+    }
+    return node->parent;
+}
+
+/**
+ * @brief Skip tombstones, in order
+ * 
+ * @param node Starting node (may be NULL)
+ * @return First node at or after node that is not a tombstone, NULL if none
+ */
+static struct ds_tree_node *node_live(struct ds_tree_node *node) {
+    while (node != NULL && node->dead) {
+        node = node_next(node);
+    }
+    return node;
+}
+
+/**
+ * @brief Position an iterator at the smallest element
+ * 
+ * @param it Iterator to initialize
+ * @param T Pointer to tree
+ * @return Pointer to smallest element's data, or NULL if T is empty or it/T is NULL
+ */
+void *ds_tree_iter_first(ds_tree_iter_t *it, const ds_tree_t *T) {
+    if (it == NULL) {
+        return NULL;
+    }
+    
+    it->tree = T;
+    if (T != NULL && T->cnodes != NULL) {
+        uint32_t first = cnode_live(T->cnodes, cnode_min(T->cnodes, T->croot));
+        
+        it->node = (first != 0) ? &T->cnodes[first] : NULL;
+    } else {
+        it->node = (T != NULL) ? node_live(find_min(T->root)) : NULL;
+    }
+    return ds_tree_iter_get(it);
+}
+
+/**
+ * @brief Position an iterator at the first element not less than key
+ * 
+ * Descends once from the root, remembering the last node where the
+ * search turned left, then skips any tombstones.
+ * 
+ * @param it Iterator to initialize
+ * @param T Pointer to tree
+ * @param key Pointer to key to seek to
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return Pointer to data of first element >= key, or NULL if none or any argument is NULL
+ */
+void *ds_tree_iter_seek(ds_tree_iter_t *it, const ds_tree_t *T, const void *key,
+                        int (*cmp)(const void *, const void *)) {
+    struct ds_tree_node *current, *candidate = NULL;
+    
+    if (it == NULL) {
+        return NULL;
+    }
+    
+    it->tree = T;
+    it->node = NULL;
+    if (T == NULL || key == NULL || cmp == NULL) {
+        return NULL;
+    }
+    
+    if (T->cnodes != NULL) {
+        uint32_t slot = T->croot, found = 0;
+        
+        while (slot != 0) {
+            int comparison = cmp(key, T->cnodes[slot].data);
+            
+            if (comparison <= 0) {
+                found = slot;
+                if (comparison == 0) {
+                    break;
+                }
+                slot = T->cnodes[slot].left;
+            } else {
+                slot = T->cnodes[slot].right;
+            }
+        }
+        found = cnode_live(T->cnodes, found);
+        it->node = (found != 0) ? &T->cnodes[found] : NULL;
+        return ds_tree_iter_get(it);
+    }
+    
+    current = T->root;
+    while (current != NULL) {
+        int comparison = cmp(key, current->data);
         
-        if (comparison < 0) {
-            parent = current;
+        if (comparison <= 0) {
+            candidate = current;
+            if (comparison == 0) {
+                break;
+            }
             current = current->left;
-        } else if (comparison > 0) {
-            parent = current;
-            current = current->right;
         } else {
-            // Found node to remove
+            current = current->right;
+        }
+    }
+    
+    it->node = node_live(candidate);
+    return ds_tree_iter_get(it);
+}
+
+/**
+ * @brief Advance an iterator to the next element in order
+ * 
+ * @param it Pointer to iterator
+ * @return Pointer to next element's data, or NULL when the iteration is over
+ */
+void *ds_tree_iter_next(ds_tree_iter_t *it) {
+    if (it == NULL || it->node == NULL) {
+        return NULL;
+    }
+    
+    if (it->tree->cnodes != NULL) {
+        const struct ds_tree_cnode *n = it->tree->cnodes;
+        uint32_t next = cnode_live(n, cnode_next(n, (uint32_t)((const struct ds_tree_cnode *)it->node - n)));
+        
+        it->node = (next != 0) ? &it->tree->cnodes[next] : NULL;
+        return ds_tree_iter_get(it);
+    }
+    
+    it->node = node_live(node_next((struct ds_tree_node *)it->node));
+    return ds_tree_iter_get(it);
+}
+
+/**
+ * @brief Get the element an iterator is positioned at
+ * 
+ * @param it Pointer to iterator
+ * @return Pointer to current element's data, or NULL if exhausted or it is NULL
+ */
+void *ds_tree_iter_get(const ds_tree_iter_t *it) {
+    if (it == NULL || it->node == NULL) {
+        return NULL;
+    }
+    
+    if (it->tree->cnodes != NULL) {
+        return ((struct ds_tree_cnode *)it->node)->data;
+    }
+    return ((struct ds_tree_node *)it->node)->data;
+}
+
+/**
+ * @brief Visit all elements in the closed range [lo, hi] in order
+ * 
+ * Seeks to lo and walks successors until an element exceeds hi.
+ * 
+ * @param T Pointer to tree
+ * @param lo Lower bound (NULL for no lower bound)
+ * @param hi Upper bound (NULL for no upper bound)
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @param cb Callback invoked with each element and ctx
+ * @param ctx User context passed to cb
+ * @return DS_OK on success, DS_ERR_NULLARG if T, cmp, or cb is NULL
+ */
+ds_error_t ds_tree_range(const ds_tree_t *T, const void *lo, const void *hi,
+                         int (*cmp)(const void *, const void *),
+                         int (*cb)(void *data, void *ctx), void *ctx) {
+    ds_tree_iter_t it;
+    void *data;
+    
+    // Validate input parameters
+    if (T == NULL || cmp == NULL || cb == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    data = (lo != NULL) ? ds_tree_iter_seek(&it, T, lo, cmp) : ds_tree_iter_first(&it, T);
+    while (data != NULL) {
+        if (hi != NULL && cmp(data, hi) > 0) {
+            break;
+        }
+        if (cb(data, ctx)) {
             break;
         }
+        data = ds_tree_iter_next(&it);
     }
     
-    if (current == NULL) {
-        return DS_ERR_NOTFOUND;
+    return DS_OK;
+}
+
+#ifdef DS_ENABLE_CONCURRENT
+
+/**
+ * @brief Build a balanced tree from items in any order
+ * 
+ * Only the sort runs in parallel; the duplicate pass and the O(n)
+ * layout by ds_tree_build_sorted run on the calling thread.
+ * 
+ * @param P Pointer to pool
+ * @param items Array of n data pointers
+ * @param n Number of items
+ * @param cmp Comparison function for ordering (returns <0, 0, >0)
+ * @return Pointer to new tree on success, NULL on invalid input or memory failure
+ */
+ds_tree_t *ds_tree_build_parallel(ds_pool_t *P, void *const *items, size_t n,
+                                  int (*cmp)(const void *, const void *)) {
+    ds_tree_t *tree;
+    void **sorted;
+    size_t i, m = 0;
+    
+    if (P == NULL || cmp == NULL || (items == NULL && n > 0)) {
+        return NULL;
+    }
+    for (i = 0; i < n; i++) {
+        if (items[i] == NULL) {
+            return NULL;
+        }
+    }
+    if (n == 0) {
+        return ds_tree_build_sorted(items, 0);
     }
     
-    // Case 1: Node has no children (leaf node)
-    if (current->left == NULL && current->right == NULL) {
-        if (parent == NULL) {
-            T->root = NULL;
-        } else if (parent->left == current) {
-            parent->left = NULL;
-        } else {
-            parent->right = NULL;
+    sorted = (void **)ds_alloc(n * sizeof(void *));
+    if (sorted == NULL) {
+        return NULL;
+    }
+    memcpy(sorted, items, n * sizeof(void *));
+    if (ds_pool_sort(P, sorted, n, cmp) != DS_OK) {
+        ds_free(sorted);
+        return NULL;
+    }
+    
+    // The sort is stable, so the first of each run of equals came first
+    for (i = 0; i < n; i++) {
+        if (m == 0 || cmp(sorted[m - 1], sorted[i]) != 0) {
+            sorted[m++] = sorted[i];
         }
-        ds_free(current);
     }
-    // Case 2: Node has one child
-    else if (current->left == NULL || current->right == NULL) {
-        struct ds_tree_node *child = (current->left != NULL) ? current->left : current->right;
-        
-        if (parent == NULL) {
-            T->root = child;
-        } else if (parent->left == current) {
-            parent->left = child;
-        } else {
-            parent->right = child;
+    
+    tree = ds_tree_build_sorted(sorted, m);
+    ds_free(sorted);
+    return tree;
+}
+
+/**
+ * @brief Parameters shared by every piece of a parallel reduction
+ */
+struct reduce_job {
+    const void *lo;                /**< Lower bound, or NULL */
+    const void *hi;                /**< Upper bound, or NULL */
+    int (*cmp)(const void *, const void *);  /**< Comparison function */
+    void (*step)(void *acc, void *data, void *ctx);  /**< Fold function */
+    void *ctx;                     /**< User context */
+};
+
+/**
+ * @brief Disjoint part of the tree folded by one task
+ */
+struct reduce_piece {
+    struct ds_tree_node *node;     /**< The node itself, or the root of the subtree */
+    int whole;                     /**< Non-zero if the piece is the whole subtree under node */
+    void *acc;                     /**< Private accumulator */
+    const struct reduce_job *job;  /**< Shared parameters */
+};
+
+/**
+ * @brief Cut the top of a subtree into reduction pieces, in key order
+ * 
+ * Nodes above depth cut become single-node pieces and subtrees rooted at
+ * depth cut become whole pieces. Subtrees that lie entirely outside the
+ * range and nodes outside it are skipped. Recursion depth is at most cut.
+ * 
+ * @param node Pointer to subtree root (may be NULL)
+ * @param depth Depth of node
+ * @param cut Depth at which subtrees are taken whole
+ * @param job Shared parameters holding the range
+ * @param pieces Array receiving the pieces
+ * @param count Number of pieces so far, advanced for each piece added
+ */
+static void collect_pieces(struct ds_tree_node *node, unsigned depth, unsigned cut,
+                           const struct reduce_job *job, struct reduce_piece *pieces, size_t *count) {
+    int below, above;
+    
+    if (node == NULL) {
+        return;
+    }
+    if (depth == cut) {
+        pieces[*count].node = node;
+        pieces[*count].whole = 1;
+        (*count)++;
+        return;
+    }
+    
+    below = (job->lo != NULL && job->cmp(node->data, job->lo) < 0);
+    above = (job->hi != NULL && job->cmp(node->data, job->hi) > 0);
+    if (!below) {
+        collect_pieces(node->left, depth + 1, cut, job, pieces, count);
+    }
+    if (!below && !above) {
+        pieces[*count].node = node;
+        pieces[*count].whole = 0;
+        (*count)++;
+    }
+    if (!above) {
+        collect_pieces(node->right, depth + 1, cut, job, pieces, count);
+    }
+}
+
+/**
+ * @brief Task body folding one piece into its accumulator
+ * 
+ * A whole piece seeks to the range start inside its subtree and follows
+ * successors until it passes the range end or the subtree's largest node.
+ * 
+ * @param arg Pointer to a reduce_piece
+ */
+static void reduce_task(void *arg) {
+    struct reduce_piece *piece = (struct reduce_piece *)arg;
+    const struct reduce_job *job = piece->job;
+    struct ds_tree_node *current, *last;
+    
+    if (!piece->whole) {
+        if (!piece->node->dead) {
+            job->step(piece->acc, piece->node->data, job->ctx);
         }
-        ds_free(current);
+        return;
     }
-    // Case 3: Node has two children
-    else {
-        // Find successor (minimum in right subtree)
-        successor = current->right;
-        successor_parent = current;
+    
+    last = piece->node;
+    while (last->right != NULL) {
+        last = last->right;
+    }
+    
+    if (job->lo != NULL) {
+        struct ds_tree_node *candidate = NULL;
         
-        while (successor->left != NULL) {
-            successor_parent = successor;
-            successor = successor->left;
+        current = piece->node;
+        while (current != NULL) {
+            if (job->cmp(job->lo, current->data) <= 0) {
+                candidate = current;
+                current = current->left;
+            } else {
+                current = current->right;
+            }
         }
+        current = candidate;
+    } else {
+        current = find_min(piece->node);
+    }
+    
+    while (current != NULL) {
+        if (job->hi != NULL && job->cmp(current->data, job->hi) > 0) {
+            break;
+        }
+        if (!current->dead) {
+            job->step(piece->acc, current->data, job->ctx);
+        }
+        if (current == last) {
+            break;
+        }
+        current = node_next(current);
+    }
+}
+
+/**
+ * @brief Fold the elements of a range in parallel
+ * 
+ * Cuts the tree at the depth that yields about
+ * DS_TREE_PIECES_PER_THREAD subtrees per worker, folds every piece as
+ * its own task and merges the partial accumulators in key order. Pieces
+ * that cannot be queued run on the calling thread, and so do compact trees.
+ * 
+ * @param T Pointer to tree
+ * @param P Pointer to pool
+ * @param lo Lower bound (NULL for no lower bound)
+ * @param hi Upper bound (NULL for no upper bound)
+ * @param cmp Comparison function, required when lo or hi is given
+ * @param acc Accumulator holding the identity on entry and the result on return
+ * @param acc_size Size of the accumulator in bytes
+ * @param step Folds one element into an accumulator
+ * @param merge Folds a partial accumulator into acc
+ * @param ctx User context passed to step and merge
+ * @return DS_OK on success, DS_ERR_NULLARG on a missing argument, DS_ERR_OOM on memory failure
+ */
+ds_error_t ds_tree_reduce_parallel(const ds_tree_t *T, ds_pool_t *P, const void *lo, const void *hi,
+                                   int (*cmp)(const void *, const void *),
+                                   void *acc, size_t acc_size,
+                                   void (*step)(void *acc, void *data, void *ctx),
+                                   void (*merge)(void *acc, const void *part, void *ctx), void *ctx) {
+    struct reduce_job job;
+    struct reduce_piece *pieces;
+    unsigned char *parts = NULL;
+    size_t target, count = 0, i;
+    unsigned cut = 0;
+    
+    // Validate input parameters
+    if (T == NULL || P == NULL || step == NULL || ((lo != NULL || hi != NULL) && cmp == NULL)) {
+        return DS_ERR_NULLARG;
+    }
+    if (acc_size > 0 && (acc == NULL || merge == NULL)) {
+        return DS_ERR_NULLARG;
+    }
+    
+    // Compact trees are folded in order on the calling thread
+    if (T->cnodes != NULL) {
+        ds_tree_iter_t it;
+        void *data = (lo != NULL) ? ds_tree_iter_seek(&it, T, lo, cmp) : ds_tree_iter_first(&it, T);
         
-        // Replace current data with successor data
-        current->data = successor->data;
-        
-        // Remove successor
-        if (successor_parent->left == successor) {
-            successor_parent->left = successor->right;
+        while (data != NULL && (hi == NULL || cmp(data, hi) <= 0)) {
+            step(acc, data, ctx);
+            data = ds_tree_iter_next(&it);
+        }
+        return DS_OK;
+    }
+    if (T->root == NULL) {
+        return DS_OK;
+    }
+    
+    // Small trees are not worth splitting
+    target = (T->size >= DS_TREE_PARALLEL_MIN) ? DS_TREE_PIECES_PER_THREAD * ds_pool_threads(P) : 1;
+    while (((size_t)1 << cut) < target && cut < DS_TREE_PARALLEL_MAX_CUT) {
+        cut++;
+    }
+    
+    pieces = (struct reduce_piece *)ds_alloc((((size_t)2 << cut) - 1) * sizeof(struct reduce_piece));
+    if (pieces == NULL) {
+        return DS_ERR_OOM;
+    }
+    
+    job.lo = lo;
+    job.hi = hi;
+    job.cmp = cmp;
+    job.step = step;
+    job.ctx = ctx;
+    collect_pieces(T->root, 0, cut, &job, pieces, &count);
+    
+    if (acc_size > 0 && count > 0) {
+        parts = (unsigned char *)ds_alloc(count * acc_size);
+        if (parts == NULL) {
+            ds_free(pieces);
+            return DS_ERR_OOM;
+        }
+    }
+    
+    for (i = 0; i < count; i++) {
+        pieces[i].job = &job;
+        if (parts != NULL) {
+            pieces[i].acc = parts + i * acc_size;
+            memcpy(pieces[i].acc, acc, acc_size);
         } else {
-            successor_parent->right = successor->right;
+            pieces[i].acc = acc;
+        }
+        if (count == 1 || ds_pool_submit(P, reduce_task, &pieces[i]) != DS_OK) {
+            reduce_task(&pieces[i]);
         }
-        ds_free(successor);
     }
+    ds_pool_wait(P);
     
-    T->size--;
+    if (parts != NULL) {
+        for (i = 0; i < count; i++) {
+            merge(acc, pieces[i].acc, ctx);
+        }
+    }
+    
+    ds_free(parts);
+    ds_free(pieces);
     return DS_OK;
 }
 
 /**
- * @brief Get the number of elements in the tree
+ * @brief Callback and context of a parallel visit
+ */
+struct foreach_ctx {
+    void (*cb)(void *data, void *ctx);  /**< User callback */
+    void *ctx;                     /**< User context */
+};
+
+/**
+ * @brief Reduction step calling the visit callback
  * 
- * Returns the current size (number of elements) of the tree.
- * This is an O(1) operation since size is cached.
+ * @param acc Unused accumulator
+ * @param data Element data
+ * @param ctx Pointer to a foreach_ctx
+ */
+static void foreach_step(void *acc, void *data, void *ctx) {
+    struct foreach_ctx *f = (struct foreach_ctx *)ctx;
+    
+    (void)acc;
+    f->cb(data, f->ctx);
+}
+
+/**
+ * @brief Visit every element of a tree in parallel
+ * 
+ * A reduction without an accumulator.
  * 
  * @param T Pointer to tree
- * @return Number of elements in tree, or 0 if T is NULL
+ * @param P Pointer to pool
+ * @param cb Callback invoked with each element and ctx
+ * @param ctx User context passed to cb
+ * @return DS_OK on success, DS_ERR_NULLARG if T, P, or cb is NULL, DS_ERR_OOM on memory failure
  */
-size_t ds_tree_size(const ds_tree_t *T) {
-    if (T == NULL) {
-        return 0;
+ds_error_t ds_tree_foreach_parallel(const ds_tree_t *T, ds_pool_t *P,
+                                    void (*cb)(void *data, void *ctx), void *ctx) {
+    struct foreach_ctx f;
+    
+    if (cb == NULL) {
+        return DS_ERR_NULLARG;
     }
     
-    return T->size;
+    f.cb = cb;
+    f.ctx = ctx;
+    return ds_tree_reduce_parallel(T, P, NULL, NULL, NULL, NULL, 0, foreach_step, NULL, &f);
 }
 
+#endif /* DS_ENABLE_CONCURRENT */
+
 /**
- * @brief Check if tree is empty
+ * @brief Yield the next element of an in-order snapshot walk
  * 
- * Returns 1 if the tree is empty, 0 if it contains elements.
+ * @param state Pointer to the tree iterator, advanced on each call
+ * @return Data of the current element
+ */
+static void *snapshot_next(void *state) {
+    ds_tree_iter_t *it = (ds_tree_iter_t *)state;
+    void *data = ds_tree_iter_get(it);
+    
+    ds_tree_iter_next(it);
+    return data;
+}
+
+/**
+ * @brief Save a tree as a memory-mappable snapshot
+ * 
+ * Elements are written in order, so the snapshot can be searched by
+ * binary search once mapped.
  * 
  * @param T Pointer to tree
- * @return 1 if empty, 0 if not empty, 0 if T is NULL
+ * @param path Destination file
+ * @param ser Serializer for element payloads
+ * @param ctx User context passed to ser
+ * @return DS_OK on success, DS_ERR_NULLARG if T, path, or ser is NULL,
+ *         DS_ERR_INVALID if ser fails, DS_ERR_OOM or DS_ERR_IO on failure
  */
-int ds_tree_is_empty(const ds_tree_t *T) {
+ds_error_t ds_tree_save(const ds_tree_t *T, const char *path,
+                        size_t (*ser)(const void *data, void *buf, size_t cap, void *ctx),
+                        void *ctx) {
+    ds_tree_iter_t it;
+    
+    // Validate input parameters
+    if (T == NULL || path == NULL || ser == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    ds_tree_iter_first(&it, T);
+    return ds_snapshot_write(path, DS_SNAPSHOT_TREE, T->size, snapshot_next, &it, ser, ctx);
+}
+
+/**
+ * @brief Get the runtime counters of a tree
+ * 
+ * @param T Pointer to tree
+ * @param out Receives the counters
+ * @return DS_OK on success, DS_ERR_NULLARG if T or out is NULL
+ */
+ds_error_t ds_tree_stats(const ds_tree_t *T, ds_stats_t *out) {
+    if (T == NULL || out == NULL) {
+        return DS_ERR_NULLARG;
+    }
+    
+    *out = T->stats;
+    return DS_OK;
+}
+
+/**
+ * @brief Get the number of bytes a tree holds
+ * 
+ * Counts the tree structure plus its node storage: the whole node array
+ * of a compact tree, every slab of a pooled tree, and the node bytes
+ * requested from the allocator otherwise.
+ * 
+ * @param T Pointer to tree
+ * @return Bytes held, or 0 if T is NULL
+ */
+size_t ds_tree_memory_usage(const ds_tree_t *T) {
     if (T == NULL) {
-        return 1;  // Consider NULL as empty
+        return 0;
     }
     
-    return (T->root == NULL) ? 1 : 0;
+    if (T->cnodes != NULL) {
+        return sizeof(struct ds_tree) + (size_t)T->ccap * sizeof(struct ds_tree_cnode);
+    }
+    if (T->pool != NULL) {
+        return sizeof(struct ds_tree) + ds_slab_bytes(T->pool);
+    }
+    return sizeof(struct ds_tree) + T->stats.bytes_live;
 }
 
 /**
@@ -487,7 +2601,7 @@ void ds_tree_visualize(const ds_tree_t *T, FILE *out) {
         return;
     }
     
-    if (T->root == NULL) {
+    if (T->size == 0) {
         fprintf(out, "Tree: [empty] (size: %zu)\n", T->size);
         return;
     }
@@ -497,7 +2611,11 @@ void ds_tree_visualize(const ds_tree_t *T, FILE *out) {
     fprintf(out, "Root at left, leaves at right:\n");
     
     // Print tree structure
-    print_subtree(T->root, out, 0);
+    if (T->cnodes != NULL) {
+        cnode_print(T, out);
+    } else {
+        print_subtree(T->root, out);
+    }
     
     fprintf(out, "\n");
 }
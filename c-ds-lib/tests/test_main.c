@@ -1,2 +1,2667 @@
-// TODO: Implement unit tests for data structures
+/**
+ * @file test_main.c
+ * @brief Unit tests for the data structures library
+ * @author Data Structures Library
+ * @version 1.0
+ * @date 2024
+ * 
+ * Each test_* function exercises one area of the library. Failed checks
+ * are reported on stderr and make the program exit with a non-zero status.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ds.h"
+#include "ds_list.h"
+#include "ds_queue.h"
+#include "ds_deque.h"
+#include "ds_pqueue.h"
+#include "ds_stack.h"
+#include "ds_tree.h"
+#include "ds_btree.h"
+#include "ds_skiplist.h"
+#include "ds_intrusive.h"
+#include "ds_hashmap.h"
+#include "ds_typed.h"
+#include "ds_snapshot.h"
+#ifdef DS_ENABLE_TRACE
+#include "ds_trace.h"
+#endif
+#ifdef DS_ENABLE_CONCURRENT
+#include "ds_mpmc.h"
+#include "ds_cstack.h"
+#include "ds_spsc.h"
+#include "ds_pool.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+static int checks_run = 0;
+static int checks_failed = 0;
+
+#define CHECK(cond) do { \
+        checks_run++; \
+        if (!(cond)) { \
+            checks_failed++; \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        } \
+    } while (0)
+
+#define N_VALUES 1000
+
+static int values[N_VALUES];
+
+DS_DEFINE_TREE(ltree, long, (a > b) - (a < b))
+DS_DEFINE_QUEUE(lqueue, long)
+DS_DEFINE_STACK(lstack, long)
+
+static int int_cmp(const void *a, const void *b) {
+    int x = *(const int *)a;
+    int y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+/* Counting allocator used to verify allocator plumbing */
+struct counting_ctx {
+    size_t allocs;
+    size_t frees;
+};
+
+static void *counting_alloc(void *ctx, size_t n) {
+    ((struct counting_ctx *)ctx)->allocs++;
+    return malloc(n);
+}
+
+static void counting_free(void *ctx, void *p) {
+    ((struct counting_ctx *)ctx)->frees++;
+    free(p);
+}
+
+static void test_list(void) {
+    ds_list_t *L = ds_list_create();
+    int i;
+    
+    CHECK(L != NULL);
+    CHECK(ds_list_push_back(L, &values[1]) == DS_OK);
+    CHECK(ds_list_push_back(L, &values[2]) == DS_OK);
+    CHECK(ds_list_push_front(L, &values[0]) == DS_OK);
+    CHECK(ds_list_push_back(L, NULL) == DS_ERR_NULLARG);
+    CHECK(ds_list_size(L) == 3);
+    
+    i = 2;
+    CHECK(ds_list_find(L, &i, int_cmp) == &values[2]);
+    CHECK(ds_list_remove(L, &i, int_cmp) == DS_OK);
+    CHECK(ds_list_remove(L, &i, int_cmp) == DS_ERR_NOTFOUND);
+    CHECK(ds_list_pop_front(L) == &values[0]);
+    CHECK(ds_list_pop_front(L) == &values[1]);
+    CHECK(ds_list_pop_front(L) == NULL);
+    CHECK(ds_list_free(L, NULL) == DS_OK);
+    CHECK(ds_list_free(NULL, NULL) == DS_ERR_NULLARG);
+}
+
+static void test_queue(void) {
+    ds_queue_t *Q = ds_queue_create();
+    int i;
+    
+    CHECK(Q != NULL);
+    CHECK(ds_queue_is_empty(Q));
+    for (i = 0; i < N_VALUES; i++) {
+        CHECK(ds_queue_enqueue(Q, &values[i]) == DS_OK);
+    }
+    CHECK(ds_queue_size(Q) == N_VALUES);
+    CHECK(ds_queue_peek(Q) == &values[0]);
+    for (i = 0; i < N_VALUES; i++) {
+        CHECK(ds_queue_dequeue(Q) == &values[i]);
+    }
+    CHECK(ds_queue_dequeue(Q) == NULL);
+    CHECK(ds_queue_free(Q, NULL) == DS_OK);
+}
+
+static void test_queue_ring(void) {
+    ds_queue_t *Q = ds_queue_create_ring(4);
+    int i, next_in = 0, next_out = 0;
+    
+    CHECK(Q != NULL);
+    CHECK(ds_queue_is_empty(Q));
+    CHECK(ds_queue_dequeue(Q) == NULL);
+    CHECK(ds_queue_peek(Q) == NULL);
+    
+    // Interleave so the head wraps around while the buffer grows
+    for (i = 0; i < 50; i++) {
+        int j;
+        for (j = 0; j < 7; j++) {
+            CHECK(ds_queue_enqueue(Q, &values[next_in++ % N_VALUES]) == DS_OK);
+        }
+        for (j = 0; j < 5; j++) {
+            CHECK(ds_queue_dequeue(Q) == &values[next_out++ % N_VALUES]);
+        }
+    }
+    CHECK(ds_queue_size(Q) == (size_t)(next_in - next_out));
+    CHECK(ds_queue_peek(Q) == &values[next_out % N_VALUES]);
+    CHECK(ds_queue_enqueue(Q, NULL) == DS_ERR_NULLARG);
+    
+    while (!ds_queue_is_empty(Q)) {
+        CHECK(ds_queue_dequeue(Q) == &values[next_out++ % N_VALUES]);
+    }
+    CHECK(next_out == next_in);
+    CHECK(ds_queue_free(Q, NULL) == DS_OK);
+}
+
+static void test_stack(void) {
+    ds_stack_t *S = ds_stack_create();
+    int i;
+    
+    CHECK(S != NULL);
+    CHECK(ds_stack_is_empty(S));
+    for (i = 0; i < N_VALUES; i++) {
+        CHECK(ds_stack_push(S, &values[i]) == DS_OK);
+    }
+    CHECK(ds_stack_size(S) == N_VALUES);
+    CHECK(ds_stack_peek(S) == &values[N_VALUES - 1]);
+    for (i = N_VALUES - 1; i >= 0; i--) {
+        CHECK(ds_stack_pop(S) == &values[i]);
+    }
+    CHECK(ds_stack_pop(S) == NULL);
+    CHECK(ds_stack_free(S, NULL) == DS_OK);
+}
+
+static void test_stack_array(void) {
+    ds_stack_t *S = ds_stack_create_array(0);
+    ds_stack_t *L = ds_stack_create();
+    void *span[N_VALUES];
+    void *items[4];
+    int i;
+    
+    CHECK(S != NULL && L != NULL);
+    CHECK(ds_stack_pop(S) == NULL);
+    CHECK(ds_stack_peek(S) == NULL);
+    for (i = 0; i < N_VALUES; i++) {
+        CHECK(ds_stack_push(S, &values[i]) == DS_OK);
+    }
+    CHECK(ds_stack_size(S) == N_VALUES);
+    CHECK(ds_stack_peek(S) == &values[N_VALUES - 1]);
+    CHECK(ds_stack_capacity(S) >= N_VALUES);
+    
+    // Bulk moves keep push order in both modes
+    CHECK(ds_stack_pop_n(S, span, N_VALUES) == N_VALUES);
+    CHECK(ds_stack_is_empty(S));
+    CHECK(span[0] == &values[0] && span[N_VALUES - 1] == &values[N_VALUES - 1]);
+    CHECK(ds_stack_push_n(L, span, N_VALUES) == DS_OK);
+    CHECK(ds_stack_peek(L) == &values[N_VALUES - 1]);
+    CHECK(ds_stack_pop_n(L, items, 4) == 4);
+    CHECK(items[3] == &values[N_VALUES - 1] && items[0] == &values[N_VALUES - 4]);
+    CHECK(ds_stack_push_n(S, items, 4) == DS_OK);
+    CHECK(ds_stack_pop(S) == &values[N_VALUES - 1]);
+    items[1] = NULL;
+    CHECK(ds_stack_push_n(S, items, 4) == DS_ERR_NULLARG);
+    CHECK(ds_stack_size(S) == 3);
+    
+    // Capacity control is only available on array-backed stacks
+    CHECK(ds_stack_shrink_to_fit(S) == DS_OK);
+    CHECK(ds_stack_capacity(S) == 3);
+    CHECK(ds_stack_reserve(S, 100) == DS_OK);
+    CHECK(ds_stack_capacity(S) == 100);
+    CHECK(ds_stack_peek(S) == &values[N_VALUES - 2]);
+    CHECK(ds_stack_reserve(L, 100) == DS_ERR_INVALID);
+    CHECK(ds_stack_shrink_to_fit(L) == DS_ERR_INVALID);
+    
+    CHECK(ds_stack_free(S, NULL) == DS_OK);
+    CHECK(ds_stack_free(L, NULL) == DS_OK);
+}
+
+static void test_transfer(void) {
+    ds_list_t *A = ds_list_create(), *B = ds_list_create(), *U = ds_list_create_unrolled();
+    ds_queue_t *Q = ds_queue_create(), *R = ds_queue_create(), *P = ds_queue_create_pooled();
+    ds_queue_t *X = ds_queue_create_ring(0), *Y = ds_queue_create_ring(0);
+    ds_stack_t *S = ds_stack_create(), *T = ds_stack_create(), *V = ds_stack_create_array(0);
+    ds_stack_t *W = ds_stack_create_array(0);
+    ds_stats_t sa, sb;
+    int i, ok;
+    
+    CHECK(A && B && U && Q && R && P && X && Y && S && T && V && W);
+    
+    // List concat relinks B behind A and leaves B usable
+    for (i = 0; i < N_VALUES; i++) {
+        ds_list_push_back((i < N_VALUES / 2) ? A : B, &values[i]);
+    }
+    CHECK(ds_list_concat(A, B) == DS_OK);
+    CHECK(ds_list_size(A) == N_VALUES && ds_list_size(B) == 0);
+    ds_list_stats(A, &sa);
+    ds_list_stats(B, &sb);
+    CHECK(sb.bytes_live == 0 && sa.allocs - sa.frees == N_VALUES);
+    CHECK(ds_list_concat(A, B) == DS_OK);
+    CHECK(ds_list_concat(B, A) == DS_OK);
+    CHECK(ds_list_push_back(B, &values[0]) == DS_OK);
+    ok = 1;
+    for (i = 0; i < N_VALUES; i++) {
+        ok &= (ds_list_pop_front(B) == &values[i]);
+    }
+    CHECK(ok);
+    CHECK(ds_list_pop_front(B) == &values[0] && ds_list_size(B) == 0);
+    CHECK(ds_list_concat(A, U) == DS_ERR_INVALID);
+    CHECK(ds_list_concat(A, A) == DS_ERR_INVALID);
+    CHECK(ds_list_concat(NULL, A) == DS_ERR_NULLARG);
+    
+    // Queue splice works for linked and ring queues alike
+    for (i = 0; i < N_VALUES; i++) {
+        ds_queue_enqueue((i < 10) ? Q : R, &values[i]);
+        ds_queue_enqueue((i < 10) ? X : Y, &values[i]);
+    }
+    CHECK(ds_queue_dequeue(X) == &values[0] && ds_queue_enqueue(X, &values[0]) == DS_OK);
+    CHECK(ds_queue_splice(Q, R) == DS_OK);
+    CHECK(ds_queue_splice(X, Y) == DS_OK);
+    CHECK(ds_queue_size(Q) == N_VALUES && ds_queue_is_empty(R));
+    CHECK(ds_queue_size(X) == N_VALUES && ds_queue_is_empty(Y));
+    CHECK(ds_queue_enqueue(R, &values[1]) == DS_OK && ds_queue_dequeue(R) == &values[1]);
+    CHECK(ds_queue_dequeue(X) == &values[1]);
+    CHECK(ds_queue_splice(Q, P) == DS_ERR_INVALID);
+    CHECK(ds_queue_splice(Q, X) == DS_ERR_INVALID);
+    CHECK(ds_queue_splice(Q, Q) == DS_ERR_INVALID);
+    
+    // Swap exchanges contents even across storage modes
+    CHECK(ds_queue_swap(Q, X) == DS_OK);
+    CHECK(ds_queue_size(Q) == N_VALUES - 1 && ds_queue_size(X) == N_VALUES);
+    ok = 1;
+    for (i = 0; i < N_VALUES; i++) {
+        ok &= (ds_queue_dequeue(X) == &values[i]);
+    }
+    CHECK(ok);
+    CHECK(ds_queue_peek(Q) == &values[2]);
+    CHECK(ds_queue_swap(Q, NULL) == DS_ERR_NULLARG);
+    
+    // Stack transfer puts T's elements on top in their order
+    for (i = 0; i < N_VALUES; i++) {
+        ds_stack_push((i < N_VALUES / 2) ? S : T, &values[i]);
+        ds_stack_push((i < N_VALUES / 2) ? V : W, &values[i]);
+    }
+    CHECK(ds_stack_transfer(S, T) == DS_OK);
+    CHECK(ds_stack_transfer(V, W) == DS_OK);
+    CHECK(ds_stack_size(S) == N_VALUES && ds_stack_is_empty(T));
+    CHECK(ds_stack_size(V) == N_VALUES && ds_stack_is_empty(W));
+    ok = 1;
+    for (i = N_VALUES; i > 0; i--) {
+        ok &= (ds_stack_pop(V) == &values[i - 1]);
+    }
+    CHECK(ok);
+    CHECK(ds_stack_transfer(T, S) == DS_OK);
+    CHECK(ds_stack_pop(T) == &values[N_VALUES - 1]);
+    for (i = 0; i < N_VALUES / 2; i++) {
+        ds_stack_pop(T);
+    }
+    
+    // The bottom link survives pops, so a second transfer lands correctly
+    CHECK(ds_stack_push(S, &values[7]) == DS_OK);
+    CHECK(ds_stack_transfer(S, T) == DS_OK);
+    CHECK(ds_stack_size(S) == N_VALUES / 2);
+    for (i = 0; i < N_VALUES / 2 - 1; i++) {
+        ds_stack_pop(S);
+    }
+    CHECK(ds_stack_pop(S) == &values[7] && ds_stack_is_empty(S));
+    CHECK(ds_stack_transfer(S, V) == DS_ERR_INVALID);
+    CHECK(ds_stack_transfer(S, S) == DS_ERR_INVALID);
+    
+    ds_list_free(A, NULL);
+    ds_list_free(B, NULL);
+    ds_list_free(U, NULL);
+    ds_queue_free(Q, NULL);
+    ds_queue_free(R, NULL);
+    ds_queue_free(P, NULL);
+    ds_queue_free(X, NULL);
+    ds_queue_free(Y, NULL);
+    ds_stack_free(S, NULL);
+    ds_stack_free(T, NULL);
+    ds_stack_free(V, NULL);
+    ds_stack_free(W, NULL);
+}
+
+static void test_tree(void) {
+    ds_tree_t *T = ds_tree_create();
+    int i, key;
+    
+    CHECK(T != NULL);
+    for (i = 0; i < N_VALUES; i++) {
+        CHECK(ds_tree_insert(T, &values[(i * 7) % N_VALUES], int_cmp) == DS_OK);
+    }
+    CHECK(ds_tree_insert(T, &values[3], int_cmp) == DS_OK);
+    CHECK(ds_tree_size(T) == N_VALUES);
+    
+    for (i = 0; i < N_VALUES; i += 2) {
+        CHECK(ds_tree_remove(T, &values[i], int_cmp) == DS_OK);
+    }
+    CHECK(ds_tree_size(T) == N_VALUES / 2);
+    for (i = 0; i < N_VALUES; i++) {
+        key = i;
+        CHECK(ds_tree_find(T, &key, int_cmp) == ((i % 2) ? &values[i] : NULL));
+    }
+    key = N_VALUES;
+    CHECK(ds_tree_remove(T, &key, int_cmp) == DS_ERR_NOTFOUND);
+    CHECK(ds_tree_free(T, NULL) == DS_OK);
+}
+
+static void test_tree_balanced(void) {
+    ds_tree_t *T = ds_tree_create_balanced();
+    ds_tree_t *U = ds_tree_create();
+    int i, key;
+    
+    CHECK(T != NULL && U != NULL);
+    CHECK(ds_tree_height(T) == 0);
+    
+    // Sorted input degenerates a plain tree but not a balanced one
+    for (i = 0; i < N_VALUES; i++) {
+        CHECK(ds_tree_insert(T, &values[i], int_cmp) == DS_OK);
+        CHECK(ds_tree_insert(U, &values[i], int_cmp) == DS_OK);
+    }
+    CHECK(ds_tree_size(T) == N_VALUES);
+    CHECK(ds_tree_height(T) <= 15);
+    CHECK(ds_tree_height(U) == N_VALUES);
+    
+    // Removal keeps the tree balanced and the contents intact
+    for (i = 0; i < N_VALUES; i++) {
+        if (i % 3 != 0) {
+            CHECK(ds_tree_remove(T, &values[i], int_cmp) == DS_OK);
+        }
+    }
+    CHECK(ds_tree_size(T) == (N_VALUES + 2) / 3);
+    CHECK(ds_tree_height(T) <= 13);
+    for (i = 0; i < N_VALUES; i++) {
+        key = i;
+        CHECK(ds_tree_find(T, &key, int_cmp) == ((i % 3 == 0) ? &values[i] : NULL));
+    }
+    for (i = N_VALUES - 1; i >= 0; i -= 3) {
+        ds_tree_remove(T, &values[i - i % 3], int_cmp);
+    }
+    CHECK(ds_tree_is_empty(T));
+    CHECK(ds_tree_height(T) == 0);
+    
+    CHECK(ds_tree_free(T, NULL) == DS_OK);
+    CHECK(ds_tree_free(U, NULL) == DS_OK);
+}
+
+/* Range callback collecting visited values into an int array */
+struct collect_ctx {
+    int seen[N_VALUES];
+    int count;
+    int limit;
+};
+
+static int collect_cb(void *data, void *ctx) {
+    struct collect_ctx *c = (struct collect_ctx *)ctx;
+    c->seen[c->count++] = *(int *)data;
+    return c->count == c->limit;
+}
+
+static void test_tree_build(void) {
+    static void *items[N_VALUES];
+    ds_tree_t *T, *E;
+    ds_tree_iter_t it;
+    void *data;
+    int i, extra = N_VALUES + 5, ok = 1;
+    
+    for (i = 0; i < N_VALUES; i++) {
+        items[i] = &values[i];
+    }
+    T = ds_tree_build_sorted(items, N_VALUES);
+    CHECK(T != NULL);
+    CHECK(ds_tree_size(T) == N_VALUES);
+    CHECK(ds_tree_height(T) == 10);
+    
+    // In-order walk returns the input order
+    i = 0;
+    for (data = ds_tree_iter_first(&it, T); data != NULL; data = ds_tree_iter_next(&it)) {
+        ok &= (data == items[i++]);
+    }
+    CHECK(ok && i == N_VALUES);
+    for (i = 0; i < N_VALUES; i++) {
+        ok &= (ds_tree_find(T, &values[i], int_cmp) == &values[i]);
+    }
+    CHECK(ok);
+    
+    // The built tree stays balanced under further updates
+    for (i = 0; i < N_VALUES / 2; i++) {
+        ok &= (ds_tree_remove(T, &values[i], int_cmp) == DS_OK);
+    }
+    CHECK(ok);
+    CHECK(ds_tree_insert(T, &extra, int_cmp) == DS_OK);
+    CHECK(ds_tree_size(T) == N_VALUES / 2 + 1);
+    CHECK(ds_tree_height(T) <= 10);
+    ds_tree_free(T, NULL);
+    
+    E = ds_tree_build_sorted(NULL, 0);
+    CHECK(E != NULL && ds_tree_is_empty(E));
+    CHECK(ds_tree_build_sorted(NULL, 3) == NULL);
+    ds_tree_free(E, NULL);
+}
+
+static void test_tree_iter(void) {
+    ds_tree_t *T = ds_tree_create_balanced();
+    ds_tree_t *E = ds_tree_create();
+    ds_tree_iter_t it;
+    struct collect_ctx c;
+    void *data;
+    int i, key, lo, hi, expect = 0;
+    
+    for (i = 0; i < N_VALUES; i += 2) {
+        ds_tree_insert(T, &values[(i * 7) % N_VALUES], int_cmp);
+    }
+    
+    // Full in-order walk visits the even values ascending
+    for (data = ds_tree_iter_first(&it, T); data != NULL; data = ds_tree_iter_next(&it)) {
+        CHECK(*(int *)data == expect);
+        expect += 2;
+    }
+    CHECK(expect == N_VALUES);
+    CHECK(ds_tree_iter_next(&it) == NULL);
+    CHECK(ds_tree_iter_first(&it, E) == NULL);
+    
+    // Seeking lands on the key or its successor
+    key = 501;
+    CHECK(ds_tree_iter_seek(&it, T, &key, int_cmp) == &values[502]);
+    CHECK(ds_tree_iter_next(&it) == &values[504]);
+    key = 500;
+    CHECK(ds_tree_iter_seek(&it, T, &key, int_cmp) == &values[500]);
+    CHECK(ds_tree_iter_get(&it) == &values[500]);
+    key = N_VALUES;
+    CHECK(ds_tree_iter_seek(&it, T, &key, int_cmp) == NULL);
+    
+    // Range scans with closed and open bounds
+    lo = 11;
+    hi = 21;
+    c.count = 0;
+    c.limit = -1;
+    CHECK(ds_tree_range(T, &lo, &hi, int_cmp, collect_cb, &c) == DS_OK);
+    CHECK(c.count == 5 && c.seen[0] == 12 && c.seen[4] == 20);
+    c.count = 0;
+    ds_tree_range(T, NULL, &lo, int_cmp, collect_cb, &c);
+    CHECK(c.count == 6 && c.seen[5] == 10);
+    c.count = 0;
+    c.limit = 3;
+    ds_tree_range(T, &hi, NULL, int_cmp, collect_cb, &c);
+    CHECK(c.count == 3 && c.seen[2] == 26);
+    CHECK(ds_tree_range(T, NULL, NULL, int_cmp, NULL, NULL) == DS_ERR_NULLARG);
+    
+    ds_tree_free(T, NULL);
+    ds_tree_free(E, NULL);
+}
+
+static int data_released = 0;
+
+static void release_data(void *data) {
+    (void)data;
+    data_released++;
+}
+
+static size_t int_size(const void *data) {
+    (void)data;
+    return sizeof(int);
+}
+
+static void test_queue_fd(void) {
+    ds_queue_t *Q = ds_queue_create_ring(0);
+    ds_queue_t *R = ds_queue_create();
+    FILE *f = tmpfile();
+    int fd = (f != NULL) ? fileno(f) : -1;
+    size_t n;
+    int i, *rec, ok = 1;
+    
+    CHECK(f != NULL);
+    for (i = 0; i < 200; i++) {
+        ds_queue_enqueue(Q, &values[i]);
+    }
+    CHECK(ds_queue_drain_to_fd(NULL, fd, int_size, 0, NULL, &n) == DS_ERR_NULLARG);
+    CHECK(ds_queue_drain_to_fd(Q, -1, int_size, 0, NULL, &n) == DS_ERR_IO);
+    CHECK(n == 0 && ds_queue_size(Q) == 200);
+    
+    // The byte budget stops the drain at an element boundary
+    CHECK(ds_queue_drain_to_fd(Q, fd, int_size, 100 * sizeof(int) + 1, NULL, &n) == DS_OK);
+    CHECK(n == 100 * sizeof(int));
+    CHECK(ds_queue_size(Q) == 100 && ds_queue_peek(Q) == &values[100]);
+    data_released = 0;
+    CHECK(ds_queue_drain_to_fd(Q, fd, int_size, 0, release_data, &n) == DS_OK);
+    CHECK(n == 100 * sizeof(int) && data_released == 100 && ds_queue_is_empty(Q));
+    
+    // Read the records back, first a bounded batch, then the rest
+    lseek(fd, 0, SEEK_SET);
+    CHECK(ds_queue_fill_from_fd(R, fd, sizeof(int), 150, &n) == DS_OK);
+    CHECK(n == 150 && ds_queue_size(R) == 150);
+    CHECK(ds_queue_fill_from_fd(R, fd, sizeof(int), 0, &n) == DS_OK);
+    CHECK(n == 50 && ds_queue_size(R) == 200);
+    for (i = 0; i < 200; i++) {
+        rec = (int *)ds_queue_dequeue(R);
+        ok &= (rec != NULL && *rec == i);
+        ds_free(rec);
+    }
+    CHECK(ok);
+    
+    // Input that ends inside a record
+    CHECK(write(fd, "xyz", 3) == 3);
+    lseek(fd, 198 * (off_t)sizeof(int), SEEK_SET);
+    CHECK(ds_queue_fill_from_fd(R, fd, sizeof(int), 0, &n) == DS_ERR_INVALID);
+    CHECK(n == 2 && ds_queue_size(R) == 2);
+    CHECK(ds_queue_fill_from_fd(R, fd, 0, 0, &n) == DS_ERR_INVALID);
+    CHECK(ds_queue_fill_from_fd(R, -1, sizeof(int), 0, &n) == DS_ERR_IO);
+    
+    if (f != NULL) {
+        fclose(f);
+    }
+    ds_queue_free(Q, NULL);
+    ds_queue_free(R, ds_free);
+}
+
+#define PIPE_CHUNK 40000
+#define PIPE_CHUNKS 8
+
+static unsigned char pipe_src[PIPE_CHUNK * PIPE_CHUNKS];
+static unsigned char pipe_dst[PIPE_CHUNK * PIPE_CHUNKS];
+
+/* size_cb for elements pointing into pipe_src */
+static size_t chunk_size(const void *data) {
+    (void)data;
+    return PIPE_CHUNK;
+}
+
+static void test_queue_fd_nonblock(void) {
+    ds_queue_t *Q = ds_queue_create();
+    ds_queue_t *R = ds_queue_create_ring(0);
+    size_t n, got = 0, i;
+    int fds[2], stalled = 0, calls = 0, ok = 1;
+    unsigned char rec[4];
+    ssize_t r;
+    
+    CHECK(pipe(fds) == 0);
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL) | O_NONBLOCK);
+    for (i = 0; i < sizeof(pipe_src); i++) {
+        pipe_src[i] = (unsigned char)(i % 251);
+    }
+    for (i = 0; i < PIPE_CHUNKS; i++) {
+        ds_queue_enqueue(Q, pipe_src + i * PIPE_CHUNK);
+    }
+    
+    // A full pipe ends each drain mid-element; the next drain must continue
+    // exactly where the previous one stopped
+    while (!ds_queue_is_empty(Q) && calls++ < 1000) {
+        ok &= (ds_queue_drain_to_fd(Q, fds[1], chunk_size, 0, NULL, &n) == DS_OK);
+        stalled |= !ds_queue_is_empty(Q);
+        while (got < sizeof(pipe_dst) &&
+               (r = read(fds[0], pipe_dst + got, sizeof(pipe_dst) - got)) > 0) {
+            got += (size_t)r;
+        }
+    }
+    CHECK(ok && stalled && ds_queue_is_empty(Q));
+    CHECK(got == sizeof(pipe_src) && memcmp(pipe_src, pipe_dst, got) == 0);
+    
+    // Records cut short by an empty pipe are finished by the next call
+    CHECK(write(fds[1], "\1\2\3\4\5\6", 6) == 6);
+    CHECK(ds_queue_fill_from_fd(R, fds[0], 4, 0, &n) == DS_OK);
+    CHECK(n == 1 && ds_queue_size(R) == 1);
+    CHECK(ds_queue_fill_from_fd(R, fds[0], 8, 0, &n) == DS_ERR_INVALID);
+    CHECK(write(fds[1], "\7\10\11\12\13\14", 6) == 6);
+    CHECK(ds_queue_fill_from_fd(R, fds[0], 4, 0, &n) == DS_OK);
+    CHECK(n == 2 && ds_queue_size(R) == 3);
+    for (i = 0; i < 3; i++) {
+        unsigned char *p = (unsigned char *)ds_queue_dequeue(R);
+        
+        rec[0] = (unsigned char)(4 * i + 1);
+        rec[1] = (unsigned char)(4 * i + 2);
+        rec[2] = (unsigned char)(4 * i + 3);
+        rec[3] = (unsigned char)(4 * i + 4);
+        ok &= (p != NULL && memcmp(p, rec, 4) == 0);
+        ds_free(p);
+    }
+    CHECK(ok);
+    
+    // A pending record is released with the queue, or dropped at end of input
+    CHECK(write(fds[1], "\1\2", 2) == 2);
+    CHECK(ds_queue_fill_from_fd(Q, fds[0], 4, 0, &n) == DS_OK && n == 0);
+    CHECK(write(fds[1], "\3", 1) == 1);
+    CHECK(ds_queue_fill_from_fd(R, fds[0], 4, 0, &n) == DS_OK && n == 0);
+    close(fds[1]);
+    CHECK(ds_queue_fill_from_fd(R, fds[0], 4, 0, &n) == DS_ERR_INVALID);
+    CHECK(n == 0 && ds_queue_is_empty(R));
+    CHECK(ds_queue_fill_from_fd(R, fds[0], 8, 0, &n) == DS_OK && n == 0);
+    close(fds[0]);
+    
+    ds_queue_free(Q, ds_free);
+    ds_queue_free(R, ds_free);
+}
+
+static void test_list_unrolled(void) {
+    ds_list_t *U = ds_list_create_unrolled();
+    ds_list_t *L = ds_list_create();
+    void *items[40], *out[3], *keys[3];
+    ds_stats_t su, sl;
+    unsigned seed = 12345;
+    int i, key, ok = 1;
+    
+    CHECK(U != NULL);
+    CHECK(ds_list_pop_front(U) == NULL);
+    CHECK(ds_list_remove(U, &values[0], int_cmp) == DS_ERR_NOTFOUND);
+    
+    // Random operations must leave both layouts with the same contents
+    for (i = 0; i < 40; i++) {
+        items[i] = &values[N_VALUES - 1 - i];
+    }
+    for (i = 0; i < 5000; i++) {
+        void *data = &values[i % 900];
+        
+        seed = seed * 1103515245u + 12345u;
+        switch ((seed >> 16) % 6) {
+        case 0:
+            ok &= (ds_list_push_front(U, data) == ds_list_push_front(L, data));
+            break;
+        case 1:
+        case 2:
+            ok &= (ds_list_push_back(U, data) == ds_list_push_back(L, data));
+            break;
+        case 3:
+            ok &= (ds_list_pop_front(U) == ds_list_pop_front(L));
+            break;
+        case 4:
+            key = (int)((seed >> 8) % 900);
+            ok &= (ds_list_remove(U, &key, int_cmp) == ds_list_remove(L, &key, int_cmp));
+            break;
+        default:
+            ok &= (ds_list_push_back_n(U, items, (seed >> 4) % 40) ==
+                   ds_list_push_back_n(L, items, (seed >> 4) % 40));
+            break;
+        }
+        ok &= (ds_list_size(U) == ds_list_size(L));
+    }
+    CHECK(ok);
+    
+    key = 901;
+    CHECK(ds_list_find(U, &key, int_cmp) == ds_list_find(L, &key, int_cmp));
+    keys[0] = &values[N_VALUES - 1];
+    keys[1] = &values[999 - 39];
+    keys[2] = &values[950];
+    CHECK(ds_list_find_batch(U, keys, 3, out, int_cmp) == ds_list_find_batch(L, keys, 3, items, int_cmp));
+    CHECK(out[0] == items[0] && out[1] == items[1] && out[2] == NULL);
+    
+    // Denser storage than one node per element
+    CHECK(ds_list_stats(U, &su) == DS_OK && ds_list_stats(L, &sl) == DS_OK);
+    CHECK(su.bytes_live < sl.bytes_live);
+    CHECK((su.allocs - su.frees) * 8 < sl.allocs - sl.frees);
+    
+    while (ds_list_size(L) > 0) {
+        ok &= (ds_list_pop_front(U) == ds_list_pop_front(L));
+    }
+    CHECK(ok && ds_list_size(U) == 0 && ds_list_pop_front(U) == NULL);
+    CHECK(ds_list_stats(U, &su) == DS_OK && su.bytes_live == 0);
+    
+    for (i = 0; i < 100; i++) {
+        ds_list_push_front(U, &values[i]);
+    }
+    data_released = 0;
+    CHECK(ds_list_free(U, release_data) == DS_OK);
+    CHECK(data_released == 100);
+    ds_list_free(L, NULL);
+}
+
+static int mod10_cmp(const void *a, const void *b) {
+    int x = *(const int *)a % 10;
+    int y = *(const int *)b % 10;
+    return (x > y) - (x < y);
+}
+
+static void test_list_sort(void) {
+    static int pos[N_VALUES];
+    ds_list_t *lists[2], *A, *B, *P;
+    ds_stats_t sa, sb;
+    int sentinel = N_VALUES, tie = 5;
+    int i, m, ok, prev;
+    void *data;
+    
+    lists[0] = ds_list_create();
+    lists[1] = ds_list_create_unrolled();
+    for (m = 0; m < 2; m++) {
+        ds_list_t *L = lists[m];
+        
+        CHECK(ds_list_sort(L, int_cmp) == DS_OK);
+        for (i = 0; i < N_VALUES; i++) {
+            int v = (i * 389) % N_VALUES;
+            
+            pos[v] = i;
+            ds_list_push_back(L, &values[v]);
+        }
+        
+        // Equal keys keep their insertion order
+        CHECK(ds_list_sort(L, mod10_cmp) == DS_OK);
+        CHECK(ds_list_size(L) == N_VALUES);
+        ok = 1;
+        prev = -1;
+        for (i = 0; i < N_VALUES; i++) {
+            int v = *(int *)ds_list_pop_front(L);
+            
+            ok &= (prev < 0 || v % 10 > prev % 10 || (v % 10 == prev % 10 && pos[v] > pos[prev]));
+            prev = v;
+            ds_list_push_back(L, &values[v]);
+        }
+        CHECK(ok);
+        
+        // The tail is correct after sorting
+        CHECK(ds_list_sort(L, int_cmp) == DS_OK);
+        CHECK(ds_list_push_back(L, &sentinel) == DS_OK);
+        ok = 1;
+        for (i = 0; i < N_VALUES; i++) {
+            ok &= (ds_list_pop_front(L) == &values[i]);
+        }
+        CHECK(ok);
+        CHECK(ds_list_pop_front(L) == &sentinel);
+        CHECK(ds_list_size(L) == 0);
+        
+        // Merge evens and odds
+        A = L;
+        B = (m == 0) ? ds_list_create() : ds_list_create_unrolled();
+        for (i = 0; i < N_VALUES; i++) {
+            ds_list_push_back((i % 2 == 0) ? A : B, &values[i]);
+        }
+        CHECK(ds_list_merge(A, B, int_cmp) == DS_OK);
+        CHECK(ds_list_size(A) == N_VALUES && ds_list_size(B) == 0);
+        ds_list_stats(A, &sa);
+        ds_list_stats(B, &sb);
+        CHECK(sb.bytes_live == 0 && sa.allocs - sa.frees > 0);
+        CHECK(ds_list_push_back(A, &sentinel) == DS_OK);
+        ok = 1;
+        for (i = 0; i < N_VALUES; i++) {
+            ok &= (ds_list_pop_front(A) == &values[i]);
+        }
+        CHECK(ok);
+        CHECK(ds_list_pop_front(A) == &sentinel);
+        
+        // Ties take A's element first; merging into an empty list works
+        ds_list_push_back(A, &values[5]);
+        ds_list_push_back(B, &tie);
+        CHECK(ds_list_merge(A, B, int_cmp) == DS_OK);
+        CHECK(ds_list_pop_front(A) == &values[5] && ds_list_pop_front(A) == &tie);
+        ds_list_push_back(B, &values[1]);
+        CHECK(ds_list_merge(A, B, int_cmp) == DS_OK);
+        CHECK(ds_list_push_back(A, &values[2]) == DS_OK);
+        CHECK(ds_list_pop_front(A) == &values[1] && ds_list_pop_front(A) == &values[2]);
+        CHECK(ds_list_push_back(B, &values[3]) == DS_OK && ds_list_pop_front(B) == &values[3]);
+        
+        CHECK(ds_list_merge(A, A, int_cmp) == DS_ERR_INVALID);
+        CHECK(ds_list_merge(A, NULL, int_cmp) == DS_ERR_NULLARG);
+        ds_list_free(B, NULL);
+    }
+    
+    // Lists with different layouts or private pools do not exchange nodes
+    P = ds_list_create_pooled();
+    CHECK(ds_list_merge(lists[0], lists[1], int_cmp) == DS_ERR_INVALID);
+    CHECK(ds_list_merge(lists[0], P, int_cmp) == DS_ERR_INVALID);
+    CHECK(ds_list_sort(NULL, int_cmp) == DS_ERR_NULLARG);
+    for (i = 0; i < 100; i++) {
+        ds_list_push_back(P, &values[99 - i]);
+    }
+    CHECK(ds_list_sort(P, int_cmp) == DS_OK);
+    data = ds_list_pop_front(P);
+    CHECK(data == &values[0]);
+    
+    ds_list_free(P, NULL);
+    ds_list_free(lists[0], NULL);
+    ds_list_free(lists[1], NULL);
+}
+
+static void test_deque(void) {
+    ds_deque_t *D = ds_deque_create();
+    ds_stats_t st;
+    int i, ok = 1;
+    
+    CHECK(D != NULL);
+    CHECK(ds_deque_is_empty(D));
+    CHECK(ds_deque_pop_front(D) == NULL && ds_deque_pop_back(D) == NULL);
+    CHECK(ds_deque_peek_front(D) == NULL && ds_deque_peek_back(D) == NULL);
+    CHECK(ds_deque_push_back(D, NULL) == DS_ERR_NULLARG);
+    
+    // Grow from both ends across many blocks: front holds 499..0, back 500..999
+    for (i = 0; i < N_VALUES / 2; i++) {
+        ok &= (ds_deque_push_front(D, &values[N_VALUES / 2 - 1 - i]) == DS_OK);
+        ok &= (ds_deque_push_back(D, &values[N_VALUES / 2 + i]) == DS_OK);
+    }
+    CHECK(ok);
+    CHECK(ds_deque_size(D) == N_VALUES);
+    for (i = 0; i < N_VALUES; i++) {
+        ok &= (ds_deque_get(D, (size_t)i) == &values[i]);
+    }
+    CHECK(ok);
+    CHECK(ds_deque_get(D, N_VALUES) == NULL);
+    CHECK(ds_deque_peek_front(D) == &values[0] && ds_deque_peek_back(D) == &values[N_VALUES - 1]);
+    CHECK(ds_deque_set(D, 10, &values[11]) == DS_OK && ds_deque_get(D, 10) == &values[11]);
+    CHECK(ds_deque_set(D, N_VALUES, &values[0]) == DS_ERR_INVALID);
+    ds_deque_set(D, 10, &values[10]);
+    
+    // Sliding window: push at the back, pop at the front, and the reverse
+    for (i = 0; i < 3 * N_VALUES; i++) {
+        ok &= (ds_deque_pop_front(D) == &values[i % N_VALUES]);
+        ds_deque_push_back(D, &values[i % N_VALUES]);
+    }
+    CHECK(ok && ds_deque_size(D) == N_VALUES);
+    for (i = 0; i < N_VALUES; i++) {
+        ok &= (ds_deque_pop_back(D) == &values[N_VALUES - 1 - i]);
+        ds_deque_push_front(D, &values[N_VALUES - 1 - i]);
+    }
+    CHECK(ok && ds_deque_get(D, 0) == &values[0]);
+    
+    // Draining from the back releases the blocks again
+    for (i = N_VALUES - 1; i >= 0; i--) {
+        ok &= (ds_deque_pop_back(D) == &values[i]);
+    }
+    CHECK(ok && ds_deque_is_empty(D) && ds_deque_pop_back(D) == NULL);
+    CHECK(ds_deque_stats(D, &st) == DS_OK);
+    CHECK(st.size == 0 && st.peak_size == N_VALUES);
+    CHECK(st.allocs - st.frees == 2);  // block map plus the spare block
+    
+    // Oscillating around a block boundary reuses the spare block
+    for (i = 0; i < 100; i++) {
+        ds_deque_push_back(D, &values[i]);
+        ds_deque_pop_front(D);
+    }
+    CHECK(ds_deque_stats(D, &st) == DS_OK && st.allocs - st.frees <= 3);
+    
+    for (i = 0; i < 100; i++) {
+        ds_deque_push_front(D, &values[i]);
+    }
+    data_released = 0;
+    CHECK(ds_deque_free(D, release_data) == DS_OK);
+    CHECK(data_released == 100);
+    CHECK(ds_deque_free(NULL, NULL) == DS_ERR_NULLARG);
+}
+
+static void test_pqueue(void) {
+    static void *items[N_VALUES];
+    ds_pqueue_t *P = ds_pqueue_create(int_cmp, 0);
+    int i, prev, ok = 1;
+    void *data;
+    
+    CHECK(P != NULL);
+    CHECK(ds_pqueue_create(NULL, 0) == NULL);
+    CHECK(ds_pqueue_pop(P) == NULL && ds_pqueue_peek(P) == NULL);
+    CHECK(ds_pqueue_push(P, NULL) == DS_ERR_NULLARG);
+    
+    // Scrambled pushes with duplicates come out in ascending order
+    for (i = 0; i < N_VALUES; i++) {
+        ok &= (ds_pqueue_push(P, &values[(i * 389) % N_VALUES / 2]) == DS_OK);
+    }
+    CHECK(ok && ds_pqueue_size(P) == N_VALUES);
+    CHECK(ds_pqueue_peek(P) == &values[0]);
+    prev = -1;
+    while ((data = ds_pqueue_pop(P)) != NULL) {
+        ok &= (*(int *)data >= prev);
+        prev = *(int *)data;
+    }
+    CHECK(ok && prev == N_VALUES / 2 - 1 && ds_pqueue_is_empty(P));
+    
+    // Interleaved pushes and pops, as a timer wheel would
+    for (i = 0; i < N_VALUES; i++) {
+        ds_pqueue_push(P, &values[(i * 7) % N_VALUES]);
+        if (i % 3 == 2) {
+            data = ds_pqueue_pop(P);
+            ok &= (data != NULL && ds_pqueue_peek(P) != NULL && *(int *)data <= *(int *)ds_pqueue_peek(P));
+        }
+    }
+    CHECK(ok && ds_pqueue_size(P) == N_VALUES - N_VALUES / 3);
+    CHECK(ds_pqueue_reserve(P, 4 * N_VALUES) == DS_OK);
+    data_released = 0;
+    CHECK(ds_pqueue_free(P, release_data) == DS_OK);
+    CHECK(data_released == N_VALUES - N_VALUES / 3);
+    
+    // Heapify from an array
+    for (i = 0; i < N_VALUES; i++) {
+        items[i] = &values[N_VALUES - 1 - i];
+    }
+    P = ds_pqueue_create_from_array(int_cmp, items, N_VALUES);
+    CHECK(P != NULL && ds_pqueue_size(P) == N_VALUES);
+    for (i = 0; i < N_VALUES; i++) {
+        ok &= (ds_pqueue_pop(P) == &values[i]);
+    }
+    CHECK(ok);
+    ds_pqueue_free(P, NULL);
+    items[5] = NULL;
+    CHECK(ds_pqueue_create_from_array(int_cmp, items, N_VALUES) == NULL);
+    P = ds_pqueue_create_from_array(int_cmp, NULL, 0);
+    CHECK(P != NULL && ds_pqueue_is_empty(P));
+    CHECK(ds_pqueue_free(P, NULL) == DS_OK);
+}
+
+static void test_tree_clear(void) {
+    struct counting_ctx ctx = {0, 0};
+    ds_allocator_t a = { counting_alloc, counting_free, NULL };
+    ds_tree_t *T, *P;
+    FILE *f = tmpfile();
+    char line[4096];
+    int i, first = -1, last = -1, rows = 0;
+    
+    a.ctx = &ctx;
+    T = ds_tree_create_with_allocator(&a);
+    P = ds_tree_create_pooled();
+    CHECK(T != NULL && P != NULL && f != NULL);
+    CHECK(ds_tree_clear(NULL, NULL) == DS_ERR_NULLARG);
+    CHECK(ds_tree_clear(T, NULL) == DS_OK);
+    
+    // Sorted inserts make a plain tree one long right spine
+    for (i = 0; i < N_VALUES; i++) {
+        ds_tree_insert(T, &values[i], int_cmp);
+        ds_tree_insert(P, &values[i], int_cmp);
+    }
+    CHECK(ds_tree_height(T) == N_VALUES);
+    
+    // The printout runs from the deepest (largest) node back to the root
+    ds_tree_visualize(T, f);
+    rewind(f);
+    while (fgets(line, sizeof(line), f) != NULL) {
+        int v;
+        if (sscanf(line, " %d", &v) == 1) {
+            if (first < 0) {
+                first = (int)(strspn(line, " ") / 2);
+            }
+            last = v;
+            rows++;
+        }
+    }
+    fclose(f);
+    CHECK(rows == N_VALUES && first == N_VALUES - 1 && last == 0);
+    
+    data_released = 0;
+    CHECK(ds_tree_clear(T, release_data) == DS_OK);
+    CHECK(data_released == N_VALUES);
+    CHECK(ds_tree_is_empty(T) && ds_tree_height(T) == 0);
+    CHECK(ctx.allocs == ctx.frees);
+    CHECK(ds_tree_insert(T, &values[7], int_cmp) == DS_OK);
+    CHECK(ds_tree_find(T, &values[7], int_cmp) == &values[7]);
+    CHECK(ds_tree_size(T) == 1);
+    
+    CHECK(ds_tree_clear(P, NULL) == DS_OK);
+    CHECK(ds_tree_size(P) == 0 && ds_tree_find(P, &values[3], int_cmp) == NULL);
+    for (i = 0; i < N_VALUES; i += 2) {
+        ds_tree_insert(P, &values[i], int_cmp);
+    }
+    CHECK(ds_tree_size(P) == N_VALUES / 2);
+    CHECK(ds_tree_find(P, &values[4], int_cmp) == &values[4]);
+    
+    data_released = 0;
+    CHECK(ds_tree_free(T, release_data) == DS_OK);
+    CHECK(data_released == 1);
+    CHECK(ctx.allocs == ctx.frees);
+    ds_tree_free(P, NULL);
+}
+
+static void test_tree_compact(void) {
+    static void *keys[N_VALUES], *out[N_VALUES];
+    ds_tree_t *C = ds_tree_create_compact(0);
+    ds_tree_t *T = ds_tree_create_balanced();
+    ds_tree_t *P = ds_tree_create_pooled();
+    ds_tree_iter_t it;
+    struct collect_ctx c;
+    size_t bytes;
+    void *data;
+    int i, key, lo, hi, expect = 0, ok = 1;
+    
+    CHECK(C != NULL && T != NULL && P != NULL);
+    CHECK(ds_tree_is_empty(C) && ds_tree_height(C) == 0);
+    CHECK(ds_tree_iter_first(&it, C) == NULL);
+    for (i = 0; i < N_VALUES; i++) {
+        ok &= (ds_tree_insert(C, &values[(i * 7) % N_VALUES], int_cmp) == DS_OK);
+        ds_tree_insert(T, &values[i], int_cmp);
+        ds_tree_insert(P, &values[i], int_cmp);
+    }
+    CHECK(ok);
+    CHECK(ds_tree_insert(C, &values[3], int_cmp) == DS_OK);
+    CHECK(ds_tree_size(C) == N_VALUES && ds_tree_height(C) <= 15);
+    
+    // Slots are half the size of pointer nodes
+    bytes = ds_tree_memory_usage(C);
+    CHECK(bytes < ds_tree_memory_usage(T) && bytes < ds_tree_memory_usage(P));
+    CHECK(ds_tree_memory_usage(T) >= N_VALUES * 4 * sizeof(void *));
+    CHECK(ds_tree_memory_usage(NULL) == 0);
+    
+    for (data = ds_tree_iter_first(&it, C); data != NULL; data = ds_tree_iter_next(&it)) {
+        ok &= (*(int *)data == expect++);
+    }
+    CHECK(ok && expect == N_VALUES);
+    key = 501;
+    CHECK(ds_tree_iter_seek(&it, C, &key, int_cmp) == &values[501]);
+    CHECK(ds_tree_iter_next(&it) == &values[502]);
+    
+    // Removed slots are reused without growing the array
+    for (i = 0; i < N_VALUES; i += 2) {
+        ok &= (ds_tree_remove(C, &values[i], int_cmp) == DS_OK);
+    }
+    CHECK(ok && ds_tree_size(C) == N_VALUES / 2 && ds_tree_height(C) <= 14);
+    key = N_VALUES;
+    CHECK(ds_tree_remove(C, &key, int_cmp) == DS_ERR_NOTFOUND);
+    for (i = 0; i < N_VALUES; i++) {
+        keys[i] = &values[i];
+        ok &= (ds_tree_find(C, &values[i], int_cmp) == ((i % 2) ? &values[i] : NULL));
+    }
+    CHECK(ok);
+    CHECK(ds_tree_find_batch(C, keys, N_VALUES, out, int_cmp) == N_VALUES / 2);
+    CHECK(out[1] == &values[1] && out[2] == NULL);
+    for (i = 0; i < N_VALUES; i += 2) {
+        ds_tree_insert(C, &values[i], int_cmp);
+    }
+    CHECK(ds_tree_memory_usage(C) == bytes);
+    
+    lo = 11;
+    hi = 21;
+    c.count = 0;
+    c.limit = -1;
+    CHECK(ds_tree_range(C, &lo, &hi, int_cmp, collect_cb, &c) == DS_OK);
+    CHECK(c.count == 11 && c.seen[0] == 11 && c.seen[10] == 21);
+    
+    data_released = 0;
+    CHECK(ds_tree_clear(C, release_data) == DS_OK);
+    CHECK(data_released == N_VALUES && ds_tree_is_empty(C));
+    CHECK(ds_tree_insert(C, &values[7], int_cmp) == DS_OK);
+    CHECK(ds_tree_find(C, &values[7], int_cmp) == &values[7]);
+    CHECK(ds_tree_memory_usage(C) == bytes);
+    
+    data_released = 0;
+    CHECK(ds_tree_free(C, release_data) == DS_OK);
+    CHECK(data_released == 1);
+    ds_tree_free(T, NULL);
+    ds_tree_free(P, NULL);
+}
+
+/* Allocate an int holding v */
+static int *heap_int(int v) {
+    int *p = (int *)ds_alloc(sizeof(int));
+    
+    if (p != NULL) {
+        *p = v;
+    }
+    return p;
+}
+
+static void test_tree_lazy(void) {
+    static void *keys[N_VALUES], *out[N_VALUES];
+    ds_tree_t *trees[2], *U;
+    ds_tree_iter_t it;
+    ds_stats_t st;
+    size_t frees, bytes;
+    void *data;
+    int t, i, key, expect, ok, *p;
+    
+    trees[0] = ds_tree_create_balanced();
+    trees[1] = ds_tree_create_compact(N_VALUES);
+    CHECK(ds_tree_set_lazy_remove(NULL, 0.5, NULL) == DS_ERR_NULLARG);
+    CHECK(ds_tree_set_lazy_remove(trees[0], -0.1, NULL) == DS_ERR_INVALID);
+    CHECK(ds_tree_set_lazy_remove(trees[0], 1.5, NULL) == DS_ERR_INVALID);
+    CHECK(ds_tree_compact(NULL) == DS_ERR_NULLARG && ds_tree_tombstones(NULL) == 0);
+    
+    for (t = 0; t < 2; t++) {
+        ds_tree_t *T = trees[t];
+        
+        ok = 1;
+        CHECK(ds_tree_set_lazy_remove(T, 1.0, release_data) == DS_OK);
+        for (i = 0; i < N_VALUES; i++) {
+            ds_tree_insert(T, &values[(i * 7) % N_VALUES], int_cmp);
+            keys[i] = &values[i];
+        }
+        bytes = ds_tree_memory_usage(T);
+        
+        // Removes only mark nodes; nothing is freed or restructured
+        ds_tree_stats(T, &st);
+        frees = st.frees;
+        for (i = 0; i < N_VALUES; i += 2) {
+            ok &= (ds_tree_remove(T, &values[i], int_cmp) == DS_OK);
+        }
+        CHECK(ok && ds_tree_size(T) == N_VALUES / 2 && ds_tree_tombstones(T) == N_VALUES / 2);
+        ds_tree_stats(T, &st);
+        CHECK(st.frees == frees && st.size == N_VALUES / 2);
+        CHECK(ds_tree_remove(T, &values[2], int_cmp) == DS_ERR_NOTFOUND);
+        for (i = 0; i < N_VALUES; i++) {
+            ok &= (ds_tree_find(T, &values[i], int_cmp) == ((i % 2) ? &values[i] : NULL));
+        }
+        CHECK(ok);
+        CHECK(ds_tree_find_batch(T, keys, N_VALUES, out, int_cmp) == N_VALUES / 2);
+        CHECK(out[0] == NULL && out[1] == &values[1]);
+        
+        // Iteration skips tombstones
+        expect = 1;
+        for (data = ds_tree_iter_first(&it, T); data != NULL; data = ds_tree_iter_next(&it)) {
+            ok &= (*(int *)data == expect);
+            expect += 2;
+        }
+        CHECK(ok && expect == N_VALUES + 1);
+        key = 500;
+        CHECK(ds_tree_iter_seek(&it, T, &key, int_cmp) == &values[501]);
+        
+        // Reinserting a removed key reuses its tombstone and purges the old element
+        key = 4;
+        data_released = 0;
+        CHECK(ds_tree_insert(T, &key, int_cmp) == DS_OK);
+        CHECK(data_released == 1 && ds_tree_find(T, &values[4], int_cmp) == &key);
+        data_released = 0;
+        CHECK(ds_tree_insert(T, &values[4], int_cmp) == DS_OK);
+        CHECK(data_released == 0 && ds_tree_remove(T, &values[4], int_cmp) == DS_OK);
+        CHECK(ds_tree_insert(T, &values[4], int_cmp) == DS_OK);
+        CHECK(data_released == 1 && ds_tree_find(T, &values[4], int_cmp) == &values[4]);
+        CHECK(ds_tree_tombstones(T) == N_VALUES / 2 - 1 && ds_tree_size(T) == N_VALUES / 2 + 1);
+        
+        // Reinserting the very object a tombstone holds must not release it
+        data_released = 0;
+        CHECK(ds_tree_remove(T, &values[5], int_cmp) == DS_OK);
+        CHECK(ds_tree_insert(T, &values[5], int_cmp) == DS_OK);
+        CHECK(data_released == 0 && ds_tree_find(T, &values[5], int_cmp) == &values[5]);
+        
+        // Duplicates and revived tombstones never need a new node
+        CHECK(ds_tree_memory_usage(T) == bytes);
+        
+        // Compaction purges every tombstone and rebuilds a balanced tree
+        data_released = 0;
+        CHECK(ds_tree_compact(T) == DS_OK);
+        CHECK(data_released == N_VALUES / 2 - 1 && ds_tree_tombstones(T) == 0);
+        CHECK(ds_tree_size(T) == N_VALUES / 2 + 1 && ds_tree_height(T) == 9);
+        for (i = 0; i < N_VALUES; i++) {
+            ok &= (ds_tree_find(T, &values[i], int_cmp) == ((i % 2 || i == 4) ? &values[i] : NULL));
+        }
+        CHECK(ok);
+        
+        // Crossing the limit compacts automatically
+        CHECK(ds_tree_set_lazy_remove(T, 0.25, NULL) == DS_OK);
+        for (i = 1; i < N_VALUES; i += 2) {
+            ds_tree_remove(T, &values[i], int_cmp);
+            ok &= (ds_tree_tombstones(T) * 4 <= ds_tree_size(T) + ds_tree_tombstones(T));
+        }
+        CHECK(ok && ds_tree_size(T) == 1 && ds_tree_find(T, &values[4], int_cmp) == &values[4]);
+        
+        // Tombstones left at teardown go to release
+        CHECK(ds_tree_set_lazy_remove(T, 1.0, release_data) == DS_OK);
+        ds_tree_remove(T, &values[4], int_cmp);
+        CHECK(ds_tree_is_empty(T) && ds_tree_iter_first(&it, T) == NULL);
+        data_released = 0;
+        CHECK(ds_tree_free(T, NULL) == DS_OK);
+        CHECK(data_released == 1);
+    }
+    
+    // A tree that frees its elements survives expiring and re-adding one
+    for (t = 0; t < 2; t++) {
+        U = (t == 0) ? ds_tree_create_balanced() : ds_tree_create_compact(0);
+        CHECK(ds_tree_set_lazy_remove(U, 1.0, ds_free) == DS_OK);
+        p = heap_int(N_VALUES);
+        CHECK(ds_tree_insert(U, p, int_cmp) == DS_OK);
+        for (i = 0; i < 10; i++) {
+            ds_tree_insert(U, &values[i], int_cmp);
+        }
+        CHECK(ds_tree_remove(U, p, int_cmp) == DS_OK);
+        CHECK(ds_tree_insert(U, p, int_cmp) == DS_OK);
+        CHECK(ds_tree_find(U, p, int_cmp) == p && *p == N_VALUES);
+        CHECK(ds_tree_tombstones(U) == 0 && ds_tree_size(U) == 11);
+        ds_tree_remove(U, p, int_cmp);
+        ds_tree_free(U, NULL);
+    }
+    
+    // Compaction also rebalances a degenerate plain tree
+    U = ds_tree_create();
+    for (i = 0; i < N_VALUES; i++) {
+        ds_tree_insert(U, &values[i], int_cmp);
+    }
+    CHECK(ds_tree_set_lazy_remove(U, 1.0, NULL) == DS_OK);
+    ds_tree_remove(U, &values[0], int_cmp);
+    CHECK(ds_tree_height(U) == N_VALUES);
+    CHECK(ds_tree_set_lazy_remove(U, 0.0, NULL) == DS_OK);
+    CHECK(ds_tree_tombstones(U) == 0 && ds_tree_height(U) == 10);
+    CHECK(ds_tree_remove(U, &values[1], int_cmp) == DS_OK && ds_tree_tombstones(U) == 0);
+    CHECK(ds_tree_size(U) == N_VALUES - 2 && ds_tree_find(U, &values[2], int_cmp) == &values[2]);
+    ds_tree_free(U, NULL);
+}
+
+static void test_btree(void) {
+    ds_btree_t *B = ds_btree_create();
+    struct collect_ctx c;
+    int i, key, lo, hi, ordered = 1;
+    
+    CHECK(B != NULL);
+    CHECK(ds_btree_is_empty(B));
+    CHECK(ds_btree_remove(B, &values[0], int_cmp) == DS_ERR_NOTFOUND);
+    
+    // Scrambled inserts, including duplicates
+    for (i = 0; i < N_VALUES; i++) {
+        CHECK(ds_btree_insert(B, &values[(i * 389) % N_VALUES], int_cmp) == DS_OK);
+    }
+    CHECK(ds_btree_insert(B, &values[17], int_cmp) == DS_OK);
+    CHECK(ds_btree_size(B) == N_VALUES);
+    CHECK(ds_btree_height(B) <= 3);
+    for (i = 0; i < N_VALUES; i++) {
+        key = i;
+        CHECK(ds_btree_find(B, &key, int_cmp) == &values[i]);
+    }
+    
+    // Closed ranges, open bounds and early stop
+    lo = 100;
+    hi = 199;
+    c.count = 0;
+    c.limit = -1;
+    CHECK(ds_btree_range(B, &lo, &hi, int_cmp, collect_cb, &c) == DS_OK);
+    CHECK(c.count == 100 && c.seen[0] == 100 && c.seen[99] == 199);
+    c.count = 0;
+    CHECK(ds_btree_range(B, NULL, NULL, int_cmp, collect_cb, &c) == DS_OK);
+    for (i = 0; i < c.count; i++) {
+        ordered &= (c.seen[i] == i);
+    }
+    CHECK(c.count == N_VALUES && ordered);
+    c.count = 0;
+    c.limit = 5;
+    ds_btree_range(B, &hi, NULL, int_cmp, collect_cb, &c);
+    CHECK(c.count == 5 && c.seen[4] == 203);
+    
+    // Remove in a different scrambled order to hit borrow and merge paths
+    for (i = 0; i < N_VALUES; i++) {
+        key = (i * 701) % N_VALUES;
+        if (key % 4 != 0) {
+            CHECK(ds_btree_remove(B, &key, int_cmp) == DS_OK);
+        }
+    }
+    CHECK(ds_btree_size(B) == N_VALUES / 4);
+    for (i = 0; i < N_VALUES; i++) {
+        key = i;
+        CHECK(ds_btree_find(B, &key, int_cmp) == ((i % 4 == 0) ? &values[i] : NULL));
+    }
+    for (i = 0; i < N_VALUES; i += 4) {
+        CHECK(ds_btree_remove(B, &values[i], int_cmp) == DS_OK);
+    }
+    CHECK(ds_btree_is_empty(B) && ds_btree_height(B) == 0);
+    CHECK(ds_btree_free(B, NULL) == DS_OK);
+}
+
+static void test_skiplist(void) {
+    ds_skiplist_t *S = ds_skiplist_create();
+    ds_skiplist_iter_t it;
+    struct collect_ctx c;
+    ds_stats_t st;
+    void *data;
+    int i, key, lo, hi, expect = 0, ok = 1;
+    
+    CHECK(S != NULL);
+    CHECK(ds_skiplist_is_empty(S));
+    CHECK(ds_skiplist_find(S, &values[0], int_cmp) == NULL);
+    CHECK(ds_skiplist_iter_first(&it, S) == NULL);
+    CHECK(ds_skiplist_remove(S, &values[0], int_cmp) == DS_ERR_NOTFOUND);
+    
+    // Scrambled inserts, including a duplicate
+    for (i = 0; i < N_VALUES; i++) {
+        ok &= (ds_skiplist_insert(S, &values[(i * 389) % N_VALUES], int_cmp) == DS_OK);
+    }
+    CHECK(ok);
+    CHECK(ds_skiplist_insert(S, &values[17], int_cmp) == DS_OK);
+    CHECK(ds_skiplist_insert(S, NULL, int_cmp) == DS_ERR_NULLARG);
+    CHECK(ds_skiplist_size(S) == N_VALUES);
+    for (i = 0; i < N_VALUES; i++) {
+        key = i;
+        ok &= (ds_skiplist_find(S, &key, int_cmp) == &values[i]);
+    }
+    CHECK(ok);
+    
+    // Ordered iteration, seek and ranges
+    for (data = ds_skiplist_iter_first(&it, S); data != NULL; data = ds_skiplist_iter_next(&it)) {
+        ok &= (*(int *)data == expect++);
+    }
+    CHECK(ok && expect == N_VALUES);
+    key = 500;
+    CHECK(ds_skiplist_iter_seek(&it, S, &key, int_cmp) == &values[500]);
+    CHECK(ds_skiplist_iter_next(&it) == &values[501]);
+    key = N_VALUES;
+    CHECK(ds_skiplist_iter_seek(&it, S, &key, int_cmp) == NULL);
+    lo = 100;
+    hi = 199;
+    c.count = 0;
+    c.limit = -1;
+    CHECK(ds_skiplist_range(S, &lo, &hi, int_cmp, collect_cb, &c) == DS_OK);
+    CHECK(c.count == 100 && c.seen[0] == 100 && c.seen[99] == 199);
+    c.count = 0;
+    c.limit = 5;
+    ds_skiplist_range(S, &hi, NULL, int_cmp, collect_cb, &c);
+    CHECK(c.count == 5 && c.seen[4] == 203);
+    CHECK(ds_skiplist_range(S, NULL, NULL, int_cmp, NULL, NULL) == DS_ERR_NULLARG);
+    
+    // Remove three quarters, then the rest
+    for (i = 0; i < N_VALUES; i++) {
+        key = (i * 701) % N_VALUES;
+        if (key % 4 != 0) {
+            ok &= (ds_skiplist_remove(S, &key, int_cmp) == DS_OK);
+        }
+    }
+    CHECK(ok);
+    CHECK(ds_skiplist_size(S) == N_VALUES / 4);
+    for (i = 0; i < N_VALUES; i++) {
+        key = i;
+        ok &= (ds_skiplist_find(S, &key, int_cmp) == ((i % 4 == 0) ? &values[i] : NULL));
+    }
+    CHECK(ok);
+    CHECK(ds_skiplist_stats(S, &st) == DS_OK);
+    CHECK(st.allocs == N_VALUES && st.frees == N_VALUES - N_VALUES / 4);
+    CHECK(st.size == N_VALUES / 4 && st.peak_size == N_VALUES);
+    for (i = 0; i < N_VALUES; i += 4) {
+        ok &= (ds_skiplist_remove(S, &values[i], int_cmp) == DS_OK);
+    }
+    CHECK(ok && ds_skiplist_is_empty(S));
+    CHECK(ds_skiplist_stats(S, &st) == DS_OK && st.bytes_live == 0);
+    
+    ds_skiplist_insert(S, &values[1], int_cmp);
+    CHECK(ds_skiplist_free(S, NULL) == DS_OK);
+}
+
+static size_t int_hash(const void *key) {
+    return (size_t)*(const int *)key;
+}
+
+static int int_eq(const void *a, const void *b) {
+    return *(const int *)a == *(const int *)b;
+}
+
+static int count_pair(void *key, void *value, void *ctx) {
+    (void)value;
+    *(long *)ctx += *(int *)key;
+    return 0;
+}
+
+static void test_hashmap(void) {
+    ds_hashmap_t *H = ds_hashmap_create(int_hash, int_eq);
+    void *key, *value;
+    long sum = 0;
+    int i, probe, dup = 7, ok = 1;
+    
+    CHECK(ds_hashmap_create(NULL, int_eq) == NULL);
+    CHECK(ds_hashmap_is_empty(H));
+    CHECK(ds_hashmap_find(H, &values[3]) == NULL);
+    
+    for (i = 0; i < N_VALUES; i++) {
+        ok &= (ds_hashmap_insert(H, &values[i], &values[N_VALUES - 1 - i], NULL, NULL) == DS_OK);
+    }
+    CHECK(ok);
+    CHECK(ds_hashmap_size(H) == N_VALUES);
+    CHECK(ds_hashmap_load_factor(H) <= DS_HASHMAP_DEFAULT_LOAD);
+    
+    // Lookups use equal keys, not the stored pointers
+    for (i = 0; i < N_VALUES; i++) {
+        probe = i;
+        ok &= (ds_hashmap_find(H, &probe) == &values[N_VALUES - 1 - i]);
+    }
+    CHECK(ok);
+    probe = N_VALUES;
+    CHECK(ds_hashmap_find(H, &probe) == NULL);
+    
+    // Updating keeps the size, stores the new pair and returns the old one
+    CHECK(ds_hashmap_insert(H, &dup, &values[0], &key, &value) == DS_OK);
+    CHECK(key == &values[7] && value == &values[N_VALUES - 8]);
+    CHECK(ds_hashmap_size(H) == N_VALUES && ds_hashmap_find(H, &values[7]) == &values[0]);
+    CHECK(ds_hashmap_insert(H, NULL, &values[0], &key, &value) == DS_ERR_NULLARG);
+    CHECK(key == NULL && value == NULL);
+    
+    // Remove the even keys; the odd ones must survive the backward shifts
+    for (i = 0; i < N_VALUES; i += 2) {
+        probe = i;
+        ok &= (ds_hashmap_remove(H, &probe, &key, &value) == DS_OK && key == &values[i]);
+    }
+    CHECK(ok);
+    CHECK(ds_hashmap_remove(H, &values[0], NULL, NULL) == DS_ERR_NOTFOUND);
+    for (i = 1; i < N_VALUES; i += 2) {
+        ok &= (ds_hashmap_find(H, &values[i]) != NULL);
+    }
+    CHECK(ok);
+    CHECK(ds_hashmap_size(H) == N_VALUES / 2);
+    
+    // Capacity control
+    CHECK(ds_hashmap_rehash(H, 0) == DS_OK);
+    CHECK(ds_hashmap_capacity(H) == 1024);
+    CHECK(ds_hashmap_reserve(H, 10000) == DS_OK);
+    CHECK(ds_hashmap_capacity(H) == 16384);
+    CHECK(ds_hashmap_set_max_load(H, 1.5) == DS_ERR_INVALID);
+    CHECK(ds_hashmap_set_max_load(H, 0.5) == DS_OK);
+    CHECK(ds_hashmap_rehash(H, 0) == DS_OK && ds_hashmap_capacity(H) == 1024);
+    CHECK(ds_hashmap_find(H, &values[999]) == &values[0]);
+    
+    CHECK(ds_hashmap_foreach(H, count_pair, &sum) == DS_OK);
+    CHECK(sum == (long)(N_VALUES / 2) * (N_VALUES / 2));
+    CHECK(ds_hashmap_insert(H, &values[1], NULL, NULL, NULL) == DS_ERR_NULLARG);
+    
+    ds_hashmap_free(H, NULL, NULL);
+}
+
+static void test_hashmap_owned(void) {
+    ds_hashmap_t *H = ds_hashmap_create(int_hash, int_eq);
+    void *key, *value;
+    int i, *k, *v, ok = 1;
+    
+    // With a map that owns its pairs, every displaced pair comes back to be freed
+    for (i = 0; i < 10; i++) {
+        ok &= (ds_hashmap_insert(H, heap_int(i), heap_int(i), &key, &value) == DS_OK);
+        ok &= (key == NULL && value == NULL);
+    }
+    for (i = 0; i < 10; i += 2) {
+        k = heap_int(i);
+        v = heap_int(100 + i);
+        ok &= (ds_hashmap_insert(H, k, v, &key, &value) == DS_OK);
+        ok &= (key != NULL && key != k && *(int *)key == i && *(int *)value == i);
+        ds_free(key);
+        ds_free(value);
+        ok &= (ds_hashmap_find(H, &i) == v);
+    }
+    CHECK(ok);
+    CHECK(ds_hashmap_size(H) == 10);
+    
+    // The new key is the one stored, so removal hands it back
+    i = 4;
+    CHECK(ds_hashmap_remove(H, &i, &key, &value) == DS_OK);
+    CHECK(*(int *)key == 4 && *(int *)value == 104);
+    ds_free(key);
+    ds_free(value);
+    
+    ds_hashmap_free(H, ds_free, ds_free);
+}
+
+static void test_batch(void) {
+    static void *items[N_VALUES];
+    static void *keys[N_VALUES];
+    static void *out[N_VALUES];
+    ds_tree_t *T = ds_tree_create_balanced();
+    ds_list_t *L = ds_list_create();
+    ds_hashmap_t *H = ds_hashmap_create(int_hash, int_eq);
+    int missing = -1, ok = 1;
+    size_t i;
+    
+    // Every third key is absent, and one key slot is NULL
+    for (i = 0; i < N_VALUES; i++) {
+        items[i] = &values[i];
+        keys[i] = (i % 3 == 0) ? (void *)&missing : (void *)&values[N_VALUES - 1 - i];
+    }
+    keys[1] = NULL;
+    
+    for (i = 0; i < N_VALUES; i++) {
+        ds_tree_insert(T, &values[(i * 7) % N_VALUES], int_cmp);
+        ds_hashmap_insert(H, &values[i], &values[i], NULL, NULL);
+    }
+    CHECK(ds_tree_find_batch(T, keys, N_VALUES, out, int_cmp) == N_VALUES - 334 - 1);
+    for (i = 0; i < N_VALUES; i++) {
+        ok &= (out[i] == ((i % 3 == 0 || i == 1) ? NULL : keys[i]));
+    }
+    CHECK(ok);
+    CHECK(ds_hashmap_find_batch(H, (const void *const *)keys, N_VALUES, out) == N_VALUES - 334 - 1);
+    for (i = 0; i < N_VALUES; i++) {
+        ok &= (out[i] == ((i % 3 == 0 || i == 1) ? NULL : keys[i]));
+    }
+    CHECK(ok);
+    
+    // Bulk append is all-or-nothing and keeps order
+    CHECK(ds_list_push_back_n(L, items, 200) == DS_OK);
+    CHECK(ds_list_size(L) == 200);
+    CHECK(ds_list_push_back_n(L, keys, 3) == DS_ERR_NULLARG);
+    CHECK(ds_list_size(L) == 200);
+    CHECK(ds_list_find_batch(L, keys + 800, 150, out, int_cmp) == 100);
+    for (i = 0; i < 150; i++) {
+        size_t k = 800 + i;
+        
+        ok &= (out[i] == ((k % 3 == 0) ? NULL : items[N_VALUES - 1 - k]));
+    }
+    CHECK(ok);
+    CHECK(ds_list_pop_front(L) == &values[0]);
+    
+    ds_tree_free(T, NULL);
+    ds_list_free(L, NULL);
+    ds_hashmap_free(H, NULL, NULL);
+}
+
+static int check_ascending(long *key, void *ctx) {
+    long *prev = (long *)ctx;
+    if (*key <= *prev) {
+        *prev = N_VALUES;
+        return 1;
+    }
+    *prev = *key;
+    return 0;
+}
+
+static void test_typed(void) {
+    ltree *t = ltree_create();
+    lqueue *q = lqueue_create(0);
+    lstack *s = lstack_create(0);
+    long i, v, prev = -1;
+    int ok = 1;
+    
+    CHECK(t != NULL && q != NULL && s != NULL);
+    CHECK(ltree_is_empty(t));
+    CHECK(ltree_find(t, 1) == NULL);
+    CHECK(ltree_remove(t, 1) == DS_ERR_NOTFOUND);
+    
+    // Sorted inserts must still produce an AVL-shaped tree
+    for (i = 0; i < N_VALUES; i++) {
+        ok &= (ltree_insert(t, i) == DS_OK);
+    }
+    CHECK(ok);
+    CHECK(ltree_insert(t, 5) == DS_OK);
+    CHECK(ltree_size(t) == N_VALUES);
+    CHECK(t->root->height <= 14);
+    CHECK(ltree_find(t, 500) != NULL && *ltree_find(t, 500) == 500);
+    CHECK(ltree_find(t, N_VALUES) == NULL);
+    CHECK(ltree_foreach(t, check_ascending, &prev) == DS_OK);
+    CHECK(prev == N_VALUES - 1);
+    
+    for (i = 0; i < N_VALUES; i += 2) {
+        ok &= (ltree_remove(t, i) == DS_OK);
+    }
+    CHECK(ok);
+    CHECK(ltree_size(t) == N_VALUES / 2);
+    CHECK(ltree_find(t, 2) == NULL && ltree_find(t, 3) != NULL);
+    CHECK(t->root->height <= 13);
+    prev = -1;
+    ltree_foreach(t, check_ascending, &prev);
+    CHECK(prev == N_VALUES - 1);
+    CHECK(ltree_insert(NULL, 1) == DS_ERR_NULLARG);
+    CHECK(ltree_free(t) == DS_OK);
+    
+    // Interleave so the ring wraps before it has to grow
+    CHECK(lqueue_dequeue(q, &v) == DS_ERR_EMPTY);
+    for (i = 0; i < 10; i++) {
+        lqueue_enqueue(q, i);
+    }
+    for (i = 0; i < 5; i++) {
+        lqueue_dequeue(q, &v);
+    }
+    for (i = 10; i < N_VALUES; i++) {
+        ok &= (lqueue_enqueue(q, i) == DS_OK);
+    }
+    CHECK(ok);
+    CHECK(lqueue_size(q) == N_VALUES - 5);
+    CHECK(lqueue_peek(q, &v) == DS_OK && v == 5);
+    for (i = 5; i < N_VALUES; i++) {
+        ok &= (lqueue_dequeue(q, &v) == DS_OK && v == i);
+    }
+    CHECK(ok);
+    CHECK(lqueue_is_empty(q));
+    CHECK(lqueue_free(q) == DS_OK);
+    
+    for (i = 0; i < N_VALUES; i++) {
+        ok &= (lstack_push(s, i) == DS_OK);
+    }
+    CHECK(ok);
+    CHECK(lstack_peek(s, &v) == DS_OK && v == N_VALUES - 1);
+    for (i = N_VALUES - 1; i >= 0; i--) {
+        ok &= (lstack_pop(s, &v) == DS_OK && v == i);
+    }
+    CHECK(ok);
+    CHECK(lstack_pop(s, &v) == DS_ERR_EMPTY);
+    CHECK(lstack_pop(s, NULL) == DS_ERR_NULLARG);
+    CHECK(lstack_free(s) == DS_OK);
+}
+
+static size_t ser_int(const void *data, void *buf, size_t cap, void *ctx) {
+    (void)ctx;
+    if (cap >= sizeof(int)) {
+        memcpy(buf, data, sizeof(int));
+    }
+    return sizeof(int);
+}
+
+/* Payload of *data + 1 bytes, all equal to *data % 256 */
+static size_t ser_run(const void *data, void *buf, size_t cap, void *ctx) {
+    size_t n = (size_t)*(const int *)data + 1;
+    (void)ctx;
+    if (cap >= n) {
+        memset(buf, *(const int *)data % 256, n);
+    }
+    return n;
+}
+
+static size_t ser_fail(const void *data, void *buf, size_t cap, void *ctx) {
+    (void)data;
+    (void)buf;
+    (void)cap;
+    (void)ctx;
+    return (size_t)-1;
+}
+
+static int payload_cmp(const void *key, const void *payload) {
+    return int_cmp(key, payload);
+}
+
+static int run_cmp(const void *key, const void *payload) {
+    return *(const int *)key % 256 - *(const unsigned char *)payload;
+}
+
+static void test_snapshot(void) {
+    const char *path = "test_snapshot.tmp";
+    ds_tree_t *T = ds_tree_create_balanced();
+    ds_list_t *L = ds_list_create();
+    ds_snapshot_t *S;
+    const void *p;
+    size_t len;
+    int i, key, ok = 1;
+    FILE *f;
+    
+    for (i = 0; i < N_VALUES; i += 2) {
+        ds_tree_insert(T, &values[(i * 7) % N_VALUES], int_cmp);
+    }
+    CHECK(ds_tree_save(NULL, path, ser_int, NULL) == DS_ERR_NULLARG);
+    CHECK(ds_tree_save(T, path, ser_fail, NULL) == DS_ERR_INVALID);
+    CHECK(ds_tree_open_mapped(path) == NULL);
+    CHECK(ds_tree_save(T, path, ser_int, NULL) == DS_OK);
+    
+    // Lookups run directly against the mapped file
+    S = ds_tree_open_mapped(path);
+    CHECK(S != NULL);
+    CHECK(ds_snapshot_size(S) == ds_tree_size(T));
+    for (i = 0; i < N_VALUES; i++) {
+        p = ds_snapshot_find(S, &values[i], payload_cmp, &len);
+        ok &= (i % 2 == 0) ? (p != NULL && len == sizeof(int) && *(const int *)p == i) : (p == NULL);
+    }
+    CHECK(ok);
+    for (i = 0; i < (int)ds_snapshot_size(S); i++) {
+        p = ds_snapshot_get(S, (size_t)i, NULL);
+        ok &= (p != NULL && *(const int *)p == 2 * i);
+    }
+    CHECK(ok);
+    CHECK(ds_snapshot_get(S, ds_snapshot_size(S), NULL) == NULL);
+    CHECK(ds_list_open_mapped(path) == NULL);
+    CHECK(ds_snapshot_close(S) == DS_OK);
+    
+    // Variable-length payloads, some larger than the initial scratch buffer
+    for (i = 0; i < 600; i += 3) {
+        ds_list_push_back(L, &values[i]);
+    }
+    CHECK(ds_list_save(L, path, ser_run, NULL) == DS_OK);
+    S = ds_list_open_mapped(path);
+    CHECK(S != NULL && ds_snapshot_size(S) == 200);
+    p = ds_snapshot_get(S, 199, &len);
+    CHECK(p != NULL && len == 598 && ((const unsigned char *)p)[597] == 597 % 256);
+    CHECK(((size_t)p & 7) == 0);
+    key = 300;
+    p = ds_snapshot_find(S, &key, run_cmp, &len);
+    CHECK(p != NULL && len == 301);
+    ds_snapshot_close(S);
+    
+    // Files that are not snapshots are rejected
+    f = fopen(path, "wb");
+    CHECK(f != NULL);
+    for (i = 0; i < 100; i++) {
+        fputc('x', f);
+    }
+    fclose(f);
+    CHECK(ds_tree_open_mapped(path) == NULL);
+    CHECK(ds_tree_open_mapped("no/such/snapshot") == NULL);
+    CHECK(ds_snapshot_close(NULL) == DS_ERR_NULLARG);
+    remove(path);
+    
+    ds_tree_free(T, NULL);
+    ds_list_free(L, NULL);
+}
+
+struct item {
+    int value;
+    ds_link_t link;
+};
+
+static int items_released = 0;
+
+static void release_item(ds_link_t *link) {
+    (void)DS_CONTAINER_OF(link, struct item, link);
+    items_released++;
+}
+
+static void test_intrusive(void) {
+    static struct item items[N_VALUES];
+    ds_ilist_t *L = ds_ilist_create();
+    ds_iqueue_t *Q = ds_iqueue_create();
+    ds_istack_t *S = ds_istack_create();
+    static const int order[] = {9, 7, 5, 3, 1, 2, 4, 6, 8};
+    ds_link_t *link;
+    int i, ok = 1;
+    
+    for (i = 0; i < N_VALUES; i++) {
+        items[i].value = i;
+    }
+    
+    // List: alternate ends, then remove from the middle
+    for (i = 0; i < 10; i++) {
+        if (i % 2 == 0) {
+            ds_ilist_push_back(L, &items[i].link);
+        } else {
+            ds_ilist_push_front(L, &items[i].link);
+        }
+    }
+    CHECK(ds_ilist_size(L) == 10);
+    CHECK(DS_CONTAINER_OF(ds_ilist_first(L), struct item, link)->value == 9);
+    ds_ilist_remove(L, &items[0].link);
+    i = 0;
+    for (link = ds_ilist_first(L); link != NULL; link = ds_ilist_next(L, link)) {
+        ok &= (DS_CONTAINER_OF(link, struct item, link)->value == order[i++]);
+    }
+    CHECK(ok && i == 9);
+    CHECK(DS_CONTAINER_OF(ds_ilist_pop_back(L), struct item, link)->value == 8);
+    CHECK(DS_CONTAINER_OF(ds_ilist_pop_front(L), struct item, link)->value == 9);
+    CHECK(ds_ilist_size(L) == 7);
+    
+    // Queue keeps FIFO order
+    for (i = 10; i < N_VALUES; i++) {
+        ds_iqueue_enqueue(Q, &items[i].link);
+    }
+    CHECK(ds_iqueue_size(Q) == N_VALUES - 10);
+    CHECK(ds_iqueue_peek(Q) == &items[10].link);
+    for (i = 10; i < 20; i++) {
+        ok &= (ds_iqueue_dequeue(Q) == &items[i].link);
+    }
+    CHECK(ok);
+    
+    // Stack keeps LIFO order
+    for (i = 10; i < 20; i++) {
+        ds_istack_push(S, &items[i].link);
+    }
+    CHECK(ds_istack_peek(S) == &items[19].link);
+    for (i = 19; i >= 10; i--) {
+        ok &= (ds_istack_pop(S) == &items[i].link);
+    }
+    CHECK(ok);
+    CHECK(ds_istack_is_empty(S) && ds_istack_pop(S) == NULL);
+    CHECK(ds_ilist_push_back(NULL, &items[0].link) == DS_ERR_NULLARG);
+    
+    // Free callbacks see every remaining element
+    items_released = 0;
+    ds_ilist_free(L, release_item);
+    ds_iqueue_free(Q, release_item);
+    ds_istack_free(S, NULL);
+    CHECK(items_released == 7 + N_VALUES - 20);
+}
+
+#ifdef DS_ENABLE_CONCURRENT
+#define MPMC_THREADS 4
+
+struct mpmc_ctx {
+    ds_mpmc_queue_t *Q;
+    int base;
+    long sum;
+};
+
+static void *mpmc_producer(void *arg) {
+    struct mpmc_ctx *c = (struct mpmc_ctx *)arg;
+    int i;
+    
+    for (i = c->base; i < N_VALUES; i += MPMC_THREADS) {
+        ds_mpmc_queue_enqueue(c->Q, &values[i]);
+    }
+    return NULL;
+}
+
+static void *mpmc_consumer(void *arg) {
+    struct mpmc_ctx *c = (struct mpmc_ctx *)arg;
+    int i;
+    
+    for (i = c->base; i < N_VALUES; i += MPMC_THREADS) {
+        c->sum += *(int *)ds_mpmc_queue_dequeue(c->Q);
+    }
+    return NULL;
+}
+
+static void test_mpmc(void) {
+    ds_mpmc_queue_t *Q = ds_mpmc_queue_create(10);
+    pthread_t threads[2 * MPMC_THREADS];
+    struct mpmc_ctx prod[MPMC_THREADS], cons[MPMC_THREADS];
+    void *out[32];
+    void *data;
+    long sum = 0;
+    int i, ok = 1;
+    
+    CHECK(ds_mpmc_queue_create(0) == NULL);
+    CHECK(ds_mpmc_queue_capacity(Q) == 16);
+    CHECK(ds_mpmc_queue_try_dequeue(Q, &data) == DS_ERR_EMPTY);
+    
+    // Single-threaded: fill, overflow, batch drain in FIFO order
+    for (i = 0; i < 16; i++) {
+        ok &= (ds_mpmc_queue_try_enqueue(Q, &values[i]) == DS_OK);
+    }
+    CHECK(ok);
+    CHECK(ds_mpmc_queue_try_enqueue(Q, &values[16]) == DS_ERR_FULL);
+    CHECK(ds_mpmc_queue_size(Q) == 16);
+    CHECK(ds_mpmc_queue_try_dequeue(Q, &data) == DS_OK && data == &values[0]);
+    CHECK(ds_mpmc_queue_dequeue_n(Q, out, 5) == 5 && out[0] == &values[1] && out[4] == &values[5]);
+    CHECK(ds_mpmc_queue_dequeue_n(Q, out, 32) == 10 && out[9] == &values[15]);
+    CHECK(ds_mpmc_queue_is_empty(Q));
+    CHECK(ds_mpmc_queue_try_enqueue(Q, NULL) == DS_ERR_NULLARG);
+    
+    // Concurrent producers and consumers through a small queue
+    for (i = 0; i < MPMC_THREADS; i++) {
+        prod[i].Q = cons[i].Q = Q;
+        prod[i].base = cons[i].base = i;
+        cons[i].sum = 0;
+        pthread_create(&threads[i], NULL, mpmc_consumer, &cons[i]);
+        pthread_create(&threads[MPMC_THREADS + i], NULL, mpmc_producer, &prod[i]);
+    }
+    for (i = 0; i < 2 * MPMC_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    for (i = 0; i < MPMC_THREADS; i++) {
+        sum += cons[i].sum;
+    }
+    CHECK(sum == (long)N_VALUES * (N_VALUES - 1) / 2);
+    CHECK(ds_mpmc_queue_is_empty(Q));
+    
+    ds_mpmc_queue_free(Q, NULL);
+}
+
+#define SPSC_ROUNDS 100
+
+static void *spsc_producer(void *arg) {
+    ds_spsc_ring_t *R = (ds_spsc_ring_t *)arg;
+    void *batch[7];
+    int round, i, j;
+    
+    // Alternate single and batched enqueues
+    for (round = 0; round < SPSC_ROUNDS; round++) {
+        for (i = 0; i < N_VALUES; ) {
+            if (round % 2 == 0) {
+                ds_spsc_ring_enqueue(R, &values[i++]);
+                continue;
+            }
+            for (j = 0; j < 7 && i + j < N_VALUES; j++) {
+                batch[j] = &values[i + j];
+            }
+            i += (int)ds_spsc_ring_enqueue_n(R, batch, (size_t)j);
+        }
+    }
+    return NULL;
+}
+
+static void test_spsc(void) {
+    ds_spsc_ring_t *R = ds_spsc_ring_create(10);
+    pthread_t producer;
+    void *items[20], *out[32];
+    void *data;
+    size_t got;
+    int i, ok = 1, expect = 0, received = 0;
+    
+    CHECK(ds_spsc_ring_create(0) == NULL);
+    CHECK(ds_spsc_ring_capacity(R) == 16);
+    CHECK(ds_spsc_ring_try_dequeue(R, &data) == DS_ERR_EMPTY);
+    CHECK(ds_spsc_ring_dequeue_n(R, out, 4) == 0);
+    
+    // Single-threaded: fill, overflow, batch drain in FIFO order
+    for (i = 0; i < 16; i++) {
+        ok &= (ds_spsc_ring_try_enqueue(R, &values[i]) == DS_OK);
+    }
+    CHECK(ok);
+    CHECK(ds_spsc_ring_try_enqueue(R, &values[16]) == DS_ERR_FULL);
+    CHECK(ds_spsc_ring_size(R) == 16);
+    CHECK(ds_spsc_ring_try_dequeue(R, &data) == DS_OK && data == &values[0]);
+    CHECK(ds_spsc_ring_dequeue_n(R, out, 5) == 5 && out[0] == &values[1] && out[4] == &values[5]);
+    
+    // Batches wrap around the end of the slot array and stop at NULL
+    for (i = 0; i < 20; i++) {
+        items[i] = &values[16 + i];
+    }
+    CHECK(ds_spsc_ring_enqueue_n(R, items, 20) == 6);
+    CHECK(ds_spsc_ring_size(R) == 16);
+    CHECK(ds_spsc_ring_dequeue_n(R, out, 32) == 16 && out[0] == &values[6] && out[15] == &values[21]);
+    items[2] = NULL;
+    CHECK(ds_spsc_ring_enqueue_n(R, items, 5) == 2);
+    CHECK(ds_spsc_ring_dequeue_n(R, out, 32) == 2 && out[1] == &values[17]);
+    CHECK(ds_spsc_ring_is_empty(R));
+    CHECK(ds_spsc_ring_try_enqueue(R, NULL) == DS_ERR_NULLARG);
+    CHECK(ds_spsc_ring_enqueue_n(NULL, items, 5) == 0);
+    
+    // One producer and one consumer keep FIFO order through a small ring
+    pthread_create(&producer, NULL, spsc_producer, R);
+    while (received < SPSC_ROUNDS * N_VALUES) {
+        if (received % 3 == 0) {
+            ok &= (ds_spsc_ring_dequeue(R) == &values[expect]);
+            expect = (expect + 1) % N_VALUES;
+            received++;
+            continue;
+        }
+        got = ds_spsc_ring_dequeue_n(R, out, 32);
+        for (i = 0; i < (int)got; i++) {
+            ok &= (out[i] == &values[expect]);
+            expect = (expect + 1) % N_VALUES;
+        }
+        received += (int)got;
+    }
+    pthread_join(producer, NULL);
+    CHECK(ok);
+    CHECK(ds_spsc_ring_is_empty(R));
+    
+    CHECK(ds_spsc_ring_try_enqueue(R, &values[1]) == DS_OK);
+    CHECK(ds_spsc_ring_free(R, NULL) == DS_OK);
+    CHECK(ds_spsc_ring_free(NULL, NULL) == DS_ERR_NULLARG);
+}
+
+struct cstack_ctx {
+    ds_cstack_t *S;
+    int base;
+    long sum;
+    int failures;
+};
+
+static void *cstack_worker(void *arg) {
+    struct cstack_ctx *c = (struct cstack_ctx *)arg;
+    void *data;
+    int i;
+    
+    // Each pop follows one of our own pushes, so the stack is never empty
+    for (i = c->base; i < N_VALUES; i += MPMC_THREADS) {
+        c->failures += (ds_cstack_push(c->S, &values[i]) != DS_OK);
+        if (ds_cstack_pop(c->S, &data) == DS_OK) {
+            c->sum += *(int *)data;
+        } else {
+            c->failures++;
+        }
+    }
+    return NULL;
+}
+
+static void test_cstack(void) {
+    ds_cstack_t *S = ds_cstack_create();
+    pthread_t threads[MPMC_THREADS];
+    struct cstack_ctx ctx[MPMC_THREADS];
+    void *data;
+    long sum = 0;
+    int i, failures = 0, ok = 1;
+    
+    CHECK(ds_cstack_pop(S, &data) == DS_ERR_EMPTY);
+    CHECK(ds_cstack_push(S, NULL) == DS_ERR_NULLARG);
+    
+    // Single-threaded LIFO order
+    for (i = 0; i < 100; i++) {
+        ds_cstack_push(S, &values[i]);
+    }
+    CHECK(ds_cstack_size(S) == 100);
+    for (i = 99; i >= 0; i--) {
+        ok &= (ds_cstack_pop(S, &data) == DS_OK && data == &values[i]);
+    }
+    CHECK(ok);
+    CHECK(ds_cstack_is_empty(S));
+    
+    // Concurrent push/pop pairs with node reclamation
+    for (i = 0; i < MPMC_THREADS; i++) {
+        ctx[i].S = S;
+        ctx[i].base = i;
+        ctx[i].sum = 0;
+        ctx[i].failures = 0;
+        pthread_create(&threads[i], NULL, cstack_worker, &ctx[i]);
+    }
+    for (i = 0; i < MPMC_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+        sum += ctx[i].sum;
+        failures += ctx[i].failures;
+    }
+    CHECK(failures == 0);
+    CHECK(sum == (long)N_VALUES * (N_VALUES - 1) / 2);
+    CHECK(ds_cstack_size(S) == 0);
+    
+    ds_cstack_push(S, &values[1]);
+    ds_cstack_reclaim();
+    ds_cstack_free(S, NULL);
+}
+
+struct skiplist_reader_ctx {
+    ds_skiplist_t *S;
+    int disorder;
+};
+
+static void *skiplist_reader(void *arg) {
+    struct skiplist_reader_ctx *c = (struct skiplist_reader_ctx *)arg;
+    ds_skiplist_iter_t it;
+    void *data;
+    int pass, prev;
+    
+    // Scans must always see strictly ascending elements
+    for (pass = 0; pass < 200; pass++) {
+        prev = -1;
+        for (data = ds_skiplist_iter_first(&it, c->S); data != NULL; data = ds_skiplist_iter_next(&it)) {
+            c->disorder += (*(int *)data <= prev);
+            prev = *(int *)data;
+        }
+        c->disorder += (ds_skiplist_find(c->S, &values[0], int_cmp) != &values[0]);
+    }
+    return NULL;
+}
+
+static void test_skiplist_readers(void) {
+    ds_skiplist_t *S = ds_skiplist_create();
+    pthread_t threads[MPMC_THREADS];
+    struct skiplist_reader_ctx ctx[MPMC_THREADS];
+    int i, disorder = 0;
+    
+    // One writer inserts while readers scan
+    ds_skiplist_insert(S, &values[0], int_cmp);
+    for (i = 0; i < MPMC_THREADS; i++) {
+        ctx[i].S = S;
+        ctx[i].disorder = 0;
+        pthread_create(&threads[i], NULL, skiplist_reader, &ctx[i]);
+    }
+    for (i = 1; i < N_VALUES; i++) {
+        ds_skiplist_insert(S, &values[(i * 389) % N_VALUES], int_cmp);
+    }
+    for (i = 0; i < MPMC_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+        disorder += ctx[i].disorder;
+    }
+    CHECK(disorder == 0);
+    CHECK(ds_skiplist_size(S) == N_VALUES);
+    
+    ds_skiplist_free(S, NULL);
+}
+
+#define POOL_N 20000
+
+static int pool_values[POOL_N];
+
+static void pool_count(void *arg) {
+    atomic_fetch_add((atomic_int *)arg, 1);
+}
+
+struct pool_spawn_ctx {
+    ds_pool_t *P;
+    atomic_int *counter;
+};
+
+static void pool_spawn(void *arg) {
+    struct pool_spawn_ctx *c = (struct pool_spawn_ctx *)arg;
+    int i;
+    
+    // Nested submits land on this worker's own deque
+    for (i = 0; i < 10; i++) {
+        ds_pool_submit(c->P, pool_count, c->counter);
+    }
+}
+
+static void sum_step(void *acc, void *data, void *ctx) {
+    (void)ctx;
+    *(long *)acc += *(int *)data;
+}
+
+static void sum_merge(void *acc, const void *part, void *ctx) {
+    (void)ctx;
+    *(long *)acc += *(const long *)part;
+}
+
+struct order_acc {
+    int first, last, count, ordered;
+};
+
+static void order_step(void *acc, void *data, void *ctx) {
+    struct order_acc *a = (struct order_acc *)acc;
+    
+    (void)ctx;
+    if (a->count == 0) {
+        a->first = *(int *)data;
+    } else if (*(int *)data <= a->last) {
+        a->ordered = 0;
+    }
+    a->last = *(int *)data;
+    a->count++;
+}
+
+static void order_merge(void *acc, const void *part, void *ctx) {
+    struct order_acc *a = (struct order_acc *)acc;
+    const struct order_acc *b = (const struct order_acc *)part;
+    
+    (void)ctx;
+    if (b->count == 0) {
+        return;
+    }
+    if (a->count == 0) {
+        *a = *b;
+        return;
+    }
+    a->ordered = a->ordered && b->ordered && a->last < b->first;
+    a->last = b->last;
+    a->count += b->count;
+}
+
+static void foreach_count(void *data, void *ctx) {
+    (void)data;
+    atomic_fetch_add((atomic_int *)ctx, 1);
+}
+
+static void test_pool(void) {
+    ds_pool_t *P = ds_pool_create(MPMC_THREADS);
+    struct pool_spawn_ctx spawn;
+    struct order_acc order;
+    atomic_int counter;
+    void **items;
+    ds_tree_t *T, *C;
+    long sum;
+    int i, sorted;
+    
+    CHECK(P != NULL);
+    CHECK(ds_pool_threads(P) == MPMC_THREADS);
+    CHECK(ds_pool_submit(NULL, pool_count, NULL) == DS_ERR_NULLARG);
+    CHECK(ds_pool_submit(P, NULL, NULL) == DS_ERR_NULLARG);
+    CHECK(ds_pool_wait(P) == DS_OK);
+    
+    // Tasks and the tasks they spawn are all waited for
+    atomic_init(&counter, 0);
+    spawn.P = P;
+    spawn.counter = &counter;
+    for (i = 0; i < 100; i++) {
+        CHECK(ds_pool_submit(P, pool_spawn, &spawn) == DS_OK);
+    }
+    CHECK(ds_pool_wait(P) == DS_OK);
+    CHECK(atomic_load(&counter) == 1000);
+    
+    // Shuffled input with every key twice
+    for (i = 0; i < POOL_N; i++) {
+        pool_values[i] = i;
+    }
+    items = (void **)malloc(2 * POOL_N * sizeof(void *));
+    for (i = 0; i < 2 * POOL_N; i++) {
+        items[i] = &pool_values[((long)i * 7919) % POOL_N];
+    }
+    CHECK(ds_pool_sort(P, items, 2 * POOL_N, int_cmp) == DS_OK);
+    sorted = 1;
+    for (i = 0; i < 2 * POOL_N; i++) {
+        sorted = sorted && (*(int *)items[i] == i / 2);
+    }
+    CHECK(sorted);
+    
+    for (i = 0; i < 2 * POOL_N; i++) {
+        items[i] = &pool_values[((long)i * 7919) % POOL_N];
+    }
+    T = ds_tree_build_parallel(P, items, 2 * POOL_N, int_cmp);
+    CHECK(T != NULL);
+    CHECK(ds_tree_size(T) == POOL_N);
+    CHECK(ds_tree_find(T, &pool_values[POOL_N - 1], int_cmp) == &pool_values[POOL_N - 1]);
+    CHECK(ds_tree_build_parallel(NULL, items, 2, int_cmp) == NULL);
+    
+    sum = 0;
+    CHECK(ds_tree_reduce_parallel(T, P, NULL, NULL, NULL, &sum, sizeof(sum), sum_step, sum_merge, NULL) == DS_OK);
+    CHECK(sum == (long)POOL_N * (POOL_N - 1) / 2);
+    
+    // Partials are merged in key order
+    memset(&order, 0, sizeof(order));
+    order.ordered = 1;
+    CHECK(ds_tree_reduce_parallel(T, P, &pool_values[100], &pool_values[15099], int_cmp,
+                                  &order, sizeof(order), order_step, order_merge, NULL) == DS_OK);
+    CHECK(order.count == 15000);
+    CHECK(order.first == 100 && order.last == 15099);
+    CHECK(order.ordered);
+    CHECK(ds_tree_reduce_parallel(T, P, &pool_values[1], NULL, NULL, &sum, sizeof(sum), sum_step, sum_merge, NULL) == DS_ERR_NULLARG);
+    
+    atomic_init(&counter, 0);
+    CHECK(ds_tree_foreach_parallel(T, P, foreach_count, &counter) == DS_OK);
+    CHECK(atomic_load(&counter) == POOL_N);
+    
+    // Parallel visits skip tombstones
+    ds_tree_set_lazy_remove(T, 1.0, NULL);
+    for (i = 0; i < POOL_N; i += 3) {
+        ds_tree_remove(T, &pool_values[i], int_cmp);
+    }
+    atomic_init(&counter, 0);
+    CHECK(ds_tree_foreach_parallel(T, P, foreach_count, &counter) == DS_OK);
+    CHECK(atomic_load(&counter) == POOL_N - (POOL_N + 2) / 3);
+    
+    // Compact trees fold on the caller, in key order
+    C = ds_tree_create_compact(POOL_N);
+    for (i = 0; i < POOL_N; i++) {
+        ds_tree_insert(C, &pool_values[((long)i * 7919) % POOL_N], int_cmp);
+    }
+    memset(&order, 0, sizeof(order));
+    order.ordered = 1;
+    CHECK(ds_tree_reduce_parallel(C, P, &pool_values[100], &pool_values[15099], int_cmp,
+                                  &order, sizeof(order), order_step, order_merge, NULL) == DS_OK);
+    CHECK(order.count == 15000 && order.first == 100 && order.last == 15099 && order.ordered);
+    ds_tree_free(C, NULL);
+    
+    free(items);
+    ds_tree_free(T, NULL);
+    CHECK(ds_pool_free(P) == DS_OK);
+    CHECK(ds_pool_free(NULL) == DS_ERR_NULLARG);
+}
+
+#define STATS_THREADS 4
+#define STATS_ROUNDS 2000
+
+/* Thread body churning a private queue and tree */
+static void *stats_worker(void *arg) {
+    ds_queue_t *Q = ds_queue_create();
+    ds_tree_t *T = ds_tree_create();
+    int i;
+    
+    (void)arg;
+    for (i = 0; i < STATS_ROUNDS; i++) {
+        ds_queue_enqueue(Q, &values[i % N_VALUES]);
+        ds_tree_insert(T, &values[(i * 7) % N_VALUES], int_cmp);
+        ds_tree_find(T, &values[i % N_VALUES], int_cmp);
+    }
+    for (i = 0; i < STATS_ROUNDS; i++) {
+        ds_queue_dequeue(Q);
+    }
+    ds_queue_free(Q, NULL);
+    ds_tree_free(T, NULL);
+    return NULL;
+}
+
+static void test_stats_threads(void) {
+    pthread_t threads[STATS_THREADS];
+    ds_stats_t before, after;
+    int i;
+    
+    // Separate containers on separate threads share only the library-wide counters
+    ds_stats_get(&before);
+    for (i = 0; i < STATS_THREADS; i++) {
+        pthread_create(&threads[i], NULL, stats_worker, NULL);
+    }
+    for (i = 0; i < STATS_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    ds_stats_get(&after);
+    
+    CHECK(after.allocs - before.allocs == (size_t)STATS_THREADS * 2 * STATS_ROUNDS);
+    CHECK(after.frees - before.frees == after.allocs - before.allocs);
+    CHECK(after.finds - before.finds == (size_t)STATS_THREADS * STATS_ROUNDS);
+    CHECK(after.bytes_live == before.bytes_live && after.size == before.size);
+    CHECK(after.bytes_peak >= before.bytes_live + STATS_ROUNDS * sizeof(void *));
+}
+#endif
+
+static void test_stats(void) {
+    ds_stats_t before, st, after;
+    ds_tree_t *T;
+    ds_hashmap_t *H;
+    ds_stack_t *S;
+    ds_list_t *L;
+    char json[512];
+    size_t len;
+    int i, key;
+    
+    CHECK(ds_stats_get(NULL) == DS_ERR_NULLARG);
+    ds_stats_reset();
+    CHECK(ds_stats_get(&before) == DS_OK);
+    CHECK(before.finds == 0 && before.compares == 0 && before.allocs == 0);
+    
+    T = ds_tree_create_balanced();
+    H = ds_hashmap_create(int_hash, int_eq);
+    S = ds_stack_create_array(0);
+    L = ds_list_create();
+    CHECK(ds_tree_stats(T, NULL) == DS_ERR_NULLARG);
+    
+    for (i = 0; i < N_VALUES; i++) {
+        ds_tree_insert(T, &values[i], int_cmp);
+        ds_hashmap_insert(H, &values[i], &values[i], NULL, NULL);
+        ds_stack_push(S, &values[i]);
+    }
+    for (i = 0; i < 10; i++) {
+        ds_list_push_back(L, &values[i]);
+    }
+    for (i = 0; i < N_VALUES; i++) {
+        ds_tree_find(T, &values[i], int_cmp);
+        ds_hashmap_find(H, &values[i]);
+    }
+    key = 9;
+    ds_list_find(L, &key, int_cmp);
+    for (i = 0; i < N_VALUES / 2; i++) {
+        ds_tree_remove(T, &values[i], int_cmp);
+    }
+    
+    // Balanced lookups stay within the AVL height bound
+    CHECK(ds_tree_stats(T, &st) == DS_OK);
+    CHECK(st.finds == N_VALUES);
+    CHECK(st.find_depth >= N_VALUES && st.find_depth <= 14 * N_VALUES);
+    CHECK(st.compares > st.find_depth);
+    CHECK(st.allocs == N_VALUES && st.frees == N_VALUES / 2);
+    CHECK(st.size == N_VALUES / 2 && st.peak_size == N_VALUES);
+    CHECK(st.bytes_live > 0 && st.bytes_peak == 2 * st.bytes_live);
+    
+    CHECK(ds_hashmap_stats(H, &st) == DS_OK);
+    CHECK(st.finds == N_VALUES && st.compares >= N_VALUES);
+    CHECK(st.find_depth >= N_VALUES && st.find_depth < 3 * N_VALUES);
+    CHECK(st.size == N_VALUES && st.bytes_live > 0);
+    
+    CHECK(ds_list_stats(L, &st) == DS_OK);
+    CHECK(st.finds == 1 && st.find_depth == 10 && st.size == 10 && st.allocs == 10);
+    CHECK(ds_stack_stats(S, &st) == DS_OK);
+    CHECK(st.size == N_VALUES && st.bytes_live >= N_VALUES * sizeof(void *));
+    
+    // Library-wide totals cover every container
+    ds_stats_get(&st);
+    CHECK(st.finds == 2 * N_VALUES + 1);
+    CHECK(st.size == before.size + N_VALUES / 2 + N_VALUES + N_VALUES + 10);
+    
+    len = ds_stats_to_json(&st, NULL, 0);
+    CHECK(len > 0 && ds_stats_to_json(&st, json, sizeof(json)) == len);
+    CHECK(strlen(json) == len && json[0] == '{' && json[len - 1] == '}');
+    CHECK(strstr(json, "\"finds\":2001,") != NULL);
+    CHECK(ds_stats_to_json(NULL, json, sizeof(json)) == 0);
+    
+    ds_tree_free(T, NULL);
+    ds_hashmap_free(H, NULL, NULL);
+    ds_stack_free(S, NULL);
+    ds_list_free(L, NULL);
+    ds_stats_get(&after);
+    CHECK(after.bytes_live == before.bytes_live && after.size == before.size);
+    CHECK(after.allocs == after.frees);
+}
+
+static void test_allocators(void) {
+    struct counting_ctx counts = { 0, 0 };
+    ds_allocator_t a = { counting_alloc, counting_free, NULL };
+    ds_allocator_t bad = { NULL, NULL, NULL };
+    ds_queue_t *Q;
+    ds_stack_t *S;
+    ds_tree_t *T;
+    ds_list_t *L;
+    ds_slab_t *P;
+    ds_arena_t *A;
+    void *p, *q;
+    int i, round;
+    
+    a.ctx = &counts;
+    
+    // Per-container allocator only sees node traffic
+    Q = ds_queue_create_with_allocator(&a);
+    CHECK(Q != NULL);
+    for (i = 0; i < 10; i++) {
+        ds_queue_enqueue(Q, &values[i]);
+    }
+    ds_queue_dequeue(Q);
+    CHECK(counts.allocs == 10 && counts.frees == 1);
+    ds_queue_free(Q, NULL);
+    CHECK(counts.frees == 10);
+    CHECK(ds_queue_create_with_allocator(&bad) == NULL);
+    
+    // Library-level allocator covers ds_alloc/ds_free
+    counts.allocs = counts.frees = 0;
+    CHECK(ds_set_allocator(&bad) == DS_ERR_INVALID);
+    CHECK(ds_set_allocator(&a) == DS_OK);
+    L = ds_list_create();
+    ds_list_push_back(L, &values[0]);
+    ds_list_free(L, NULL);
+    CHECK(ds_set_allocator(NULL) == DS_OK);
+    CHECK(counts.allocs == 2 && counts.frees == 2);
+    
+    // Slab pool recycles released objects
+    P = ds_slab_create(24, 4);
+    CHECK(P != NULL);
+    a = ds_slab_allocator(P);
+    p = a.alloc(a.ctx, 24);
+    CHECK(p != NULL);
+    CHECK(a.alloc(a.ctx, 4096) == NULL);
+    a.free(a.ctx, p);
+    q = a.alloc(a.ctx, 16);
+    CHECK(q == p);
+    for (i = 0; i < 100; i++) {
+        CHECK(a.alloc(a.ctx, 24) != NULL);
+    }
+    CHECK(ds_slab_free(P) == DS_OK);
+    
+    // Slab sizes that wrap size_t are refused up front
+    CHECK(ds_slab_create(0, 4) == NULL);
+    CHECK(ds_slab_create((size_t)-1, 1) == NULL);
+    CHECK(ds_slab_create(24, (size_t)-1 / 24) == NULL);
+    CHECK(ds_slab_create(4096, (size_t)-1 / 4096 + 1) == NULL);
+    P = ds_slab_create(24, (size_t)-1 / 64);
+    CHECK(P != NULL);
+    CHECK(ds_slab_free(P) == DS_OK);
+    
+    // Pooled containers behave exactly like the default ones
+    S = ds_stack_create_pooled();
+    T = ds_tree_create_pooled();
+    CHECK(S != NULL && T != NULL);
+    for (i = 0; i < N_VALUES; i++) {
+        ds_stack_push(S, &values[i]);
+        ds_tree_insert(T, &values[(i * 13) % N_VALUES], int_cmp);
+    }
+    for (i = 0; i < N_VALUES / 2; i++) {
+        CHECK(ds_stack_pop(S) == &values[N_VALUES - 1 - i]);
+        CHECK(ds_tree_remove(T, &values[i], int_cmp) == DS_OK);
+    }
+    CHECK(ds_stack_size(S) == N_VALUES / 2);
+    CHECK(ds_tree_size(T) == N_VALUES / 2);
+    CHECK(ds_tree_find(T, &values[N_VALUES - 1], int_cmp) == &values[N_VALUES - 1]);
+    CHECK(ds_stack_free(S, NULL) == DS_OK);
+    CHECK(ds_tree_free(T, NULL) == DS_OK);
+    
+    // Arena-backed containers free without visiting their nodes
+    A = ds_arena_create(1024);
+    CHECK(A != NULL);
+    a = ds_arena_allocator(A);
+    CHECK(a.free == NULL);
+    p = a.alloc(a.ctx, 3);
+    q = a.alloc(a.ctx, 5000);
+    CHECK(p != NULL && q != NULL && ((size_t)p % sizeof(void *)) == 0);
+    CHECK(ds_arena_reset(A) == DS_OK && ds_arena_used(A) == 0);
+    CHECK(a.alloc(a.ctx, 3) == p);
+    
+    for (round = 0; round < 3; round++) {
+        L = ds_list_create_with_allocator(&a);
+        Q = ds_queue_create_with_allocator(&a);
+        S = ds_stack_create_with_allocator(&a);
+        T = ds_tree_create_with_allocator(&a);
+        CHECK(L != NULL && Q != NULL && S != NULL && T != NULL);
+        for (i = 0; i < N_VALUES; i++) {
+            ds_list_push_back(L, &values[i]);
+            ds_queue_enqueue(Q, &values[i]);
+            ds_stack_push(S, &values[i]);
+            ds_tree_insert(T, &values[(i * 13) % N_VALUES], int_cmp);
+        }
+        for (i = 0; i < N_VALUES / 2; i++) {
+            CHECK(ds_tree_remove(T, &values[i], int_cmp) == DS_OK);
+        }
+        CHECK(ds_queue_dequeue(Q) == &values[0]);
+        CHECK(ds_stack_pop(S) == &values[N_VALUES - 1]);
+        CHECK(ds_tree_size(T) == N_VALUES / 2);
+        CHECK(ds_tree_find(T, &values[N_VALUES - 1], int_cmp) == &values[N_VALUES - 1]);
+        CHECK(ds_arena_used(A) > 0);
+        
+        // free_data still sees every remaining element
+        data_released = 0;
+        CHECK(ds_list_free(L, release_data) == DS_OK);
+        CHECK(data_released == N_VALUES);
+        CHECK(ds_queue_free(Q, NULL) == DS_OK);
+        CHECK(ds_stack_free(S, NULL) == DS_OK);
+        CHECK(ds_tree_free(T, NULL) == DS_OK);
+        CHECK(ds_arena_reset(A) == DS_OK);
+    }
+    
+    CHECK(ds_list_create_with_allocator(&bad) == NULL);
+    a = ds_arena_allocator(NULL);
+    CHECK(ds_tree_create_with_allocator(&a) == NULL);
+    CHECK(ds_set_allocator(&a) == DS_ERR_INVALID);
+    CHECK(ds_arena_reset(NULL) == DS_ERR_NULLARG);
+    CHECK(ds_arena_free(A) == DS_OK);
+    CHECK(ds_arena_free(NULL) == DS_ERR_NULLARG);
+}
+
+#ifdef DS_ENABLE_TRACE
+struct trace_probe {
+    size_t calls;
+    ds_trace_op_t last_op;
+    const void *last_obj;
+};
+
+static void trace_probe_hook(ds_trace_op_t op, const void *obj, uint64_t ns, void *ctx) {
+    struct trace_probe *probe = (struct trace_probe *)ctx;
+    
+    (void)ns;
+    probe->calls++;
+    probe->last_op = op;
+    probe->last_obj = obj;
+}
+
+#ifdef DS_ENABLE_CONCURRENT
+#define TRACE_THREADS 4
+
+static void *trace_worker(void *arg) {
+    ds_stack_t *S = ds_stack_create();
+    
+    (void)arg;
+    for (int i = 0; i < N_VALUES; i++) {
+        ds_stack_push(S, &values[i]);
+    }
+    ds_stack_free(S, NULL);
+    return NULL;
+}
+#endif
+
+static void test_trace(void) {
+    ds_tree_t *T = ds_tree_create_balanced();
+    ds_queue_t *Q = ds_queue_create();
+    struct trace_probe probe = {0, DS_TRACE_OP_COUNT, NULL};
+    ds_trace_hist_t h, th;
+    uint64_t sum;
+    FILE *out;
+    int i, ok;
+    
+    CHECK(T != NULL && Q != NULL);
+    
+    // Bucket bounds are contiguous and log-linear
+    CHECK(ds_trace_bucket_floor(0) == 0 && ds_trace_bucket_floor(7) == 7);
+    CHECK(ds_trace_bucket_floor(8) == 8 && ds_trace_bucket_floor(16) == 16);
+    CHECK(ds_trace_bucket_floor(17) == 18 && ds_trace_bucket_floor(24) == 32);
+    CHECK(ds_trace_bucket_floor(DS_TRACE_BUCKETS) == (uint64_t)1 << DS_TRACE_MAX_BITS);
+    ok = 1;
+    for (i = 1; i <= DS_TRACE_BUCKETS; i++) {
+        ok &= (ds_trace_bucket_floor((size_t)i) > ds_trace_bucket_floor((size_t)i - 1));
+    }
+    CHECK(ok);
+    
+    // Nothing is recorded while sampling is off
+    ds_trace_reset();
+    CHECK(ds_trace_sampling() == 0);
+    ds_tree_insert(T, &values[0], int_cmp);
+    CHECK(ds_trace_histogram(DS_TRACE_TREE_INSERT, &h) == DS_OK && h.count == 0);
+    
+    // Every call is timed with period 1 and reaches the hook
+    CHECK(ds_trace_set_sampling(1) == DS_OK);
+    CHECK(ds_trace_set_hook(trace_probe_hook, &probe) == DS_OK);
+    for (i = 1; i < N_VALUES; i++) {
+        ds_tree_insert(T, &values[i], int_cmp);
+    }
+    for (i = 0; i < N_VALUES; i++) {
+        ds_tree_find(T, &values[i], int_cmp);
+    }
+    CHECK(probe.calls == 2 * N_VALUES - 1);
+    CHECK(probe.last_op == DS_TRACE_TREE_FIND && probe.last_obj == T);
+    CHECK(ds_trace_histogram(DS_TRACE_TREE_FIND, &h) == DS_OK);
+    CHECK(h.count == N_VALUES);
+    sum = 0;
+    for (i = 0; i < DS_TRACE_BUCKETS; i++) {
+        sum += h.buckets[i];
+    }
+    CHECK(sum == h.count && h.total_ns >= h.max_ns);
+    CHECK(ds_trace_percentile(&h, 50.0) <= ds_trace_percentile(&h, 99.0));
+    CHECK(ds_trace_percentile(&h, 99.0) <= ds_trace_percentile(&h, 100.0));
+    CHECK(ds_trace_percentile(&h, 100.0) == h.max_ns);
+    CHECK(ds_trace_thread_histogram(DS_TRACE_TREE_FIND, &th) == DS_OK && th.count == N_VALUES);
+    CHECK(ds_trace_histogram(DS_TRACE_TREE_INSERT, &h) == DS_OK && h.count == N_VALUES - 1);
+    
+    // A period of 4 times one call in four
+    CHECK(ds_trace_set_hook(NULL, NULL) == DS_OK);
+    ds_trace_reset();
+    CHECK(ds_trace_set_sampling(4) == DS_OK);
+    for (i = 0; i < N_VALUES; i++) {
+        ds_queue_enqueue(Q, &values[i]);
+    }
+    CHECK(ds_trace_histogram(DS_TRACE_QUEUE_ENQUEUE, &h) == DS_OK && h.count == N_VALUES / 4);
+    CHECK(probe.calls == 2 * N_VALUES - 1);
+    
+    // Percentiles of a known distribution
+    memset(&h, 0, sizeof(h));
+    h.buckets[5] = 90;
+    h.buckets[16] = 10;
+    h.count = 100;
+    h.max_ns = 17;
+    CHECK(ds_trace_percentile(&h, 50.0) == 5 && ds_trace_percentile(&h, 90.0) == 5);
+    CHECK(ds_trace_percentile(&h, 91.0) == 17 && ds_trace_percentile(&h, 0.0) == 5);
+    CHECK(ds_trace_percentile(NULL, 50.0) == 0);
+    
+#ifdef DS_ENABLE_CONCURRENT
+    // Histograms of all threads are merged, including exited ones whose
+    // blocks were handed on (the plain containers share library counters,
+    // so the workers run one after another)
+    {
+        pthread_t thread;
+        
+        ds_trace_set_sampling(1);
+        for (i = 0; i < TRACE_THREADS; i++) {
+            pthread_create(&thread, NULL, trace_worker, NULL);
+            pthread_join(thread, NULL);
+        }
+        CHECK(ds_trace_histogram(DS_TRACE_STACK_PUSH, &h) == DS_OK);
+        CHECK(h.count == TRACE_THREADS * N_VALUES);
+        CHECK(ds_trace_thread_histogram(DS_TRACE_STACK_PUSH, &th) == DS_OK && th.count == 0);
+    }
+#endif
+    
+    // The summary lists operations that have samples
+    out = tmpfile();
+    CHECK(out != NULL);
+    if (out != NULL) {
+        char line[256];
+        
+        ds_trace_print(out);
+        rewind(out);
+        ok = 0;
+        while (fgets(line, sizeof(line), out) != NULL) {
+            ok |= (strncmp(line, "ds_queue_enqueue ", 17) == 0);
+        }
+        CHECK(ok);
+        fclose(out);
+    }
+    ds_trace_print(NULL);
+    
+    CHECK(strcmp(ds_trace_op_name(DS_TRACE_TREE_FIND), "ds_tree_find") == 0);
+    CHECK(strcmp(ds_trace_op_name(DS_TRACE_OP_COUNT), "unknown") == 0);
+    CHECK(ds_trace_histogram(DS_TRACE_OP_COUNT, &h) == DS_ERR_INVALID);
+    CHECK(ds_trace_histogram(DS_TRACE_TREE_FIND, NULL) == DS_ERR_NULLARG);
+    
+    ds_trace_set_sampling(0);
+    ds_trace_reset();
+    ds_tree_free(T, NULL);
+    ds_queue_free(Q, NULL);
+}
+#endif
+
+int main(void) {
+    int i;
+    
+    for (i = 0; i < N_VALUES; i++) {
+        values[i] = i;
+    }
+    
+    test_list();
+    test_list_unrolled();
+    test_list_sort();
+    test_queue();
+    test_queue_ring();
+    test_queue_fd();
+    test_queue_fd_nonblock();
+    test_deque();
+    test_pqueue();
+    test_stack();
+    test_stack_array();
+    test_transfer();
+    test_tree();
+    test_tree_balanced();
+    test_tree_build();
+    test_tree_iter();
+    test_tree_clear();
+    test_tree_compact();
+    test_tree_lazy();
+    test_btree();
+    test_skiplist();
+    test_batch();
+    test_typed();
+    test_snapshot();
+    test_intrusive();
+    test_hashmap();
+    test_hashmap_owned();
+#ifdef DS_ENABLE_CONCURRENT
+    test_mpmc();
+    test_spsc();
+    test_cstack();
+    test_skiplist_readers();
+    test_pool();
+    test_stats_threads();
+#endif
+    test_stats();
+    test_allocators();
+#ifdef DS_ENABLE_TRACE
+    test_trace();
+#endif
+    
+    printf("%d checks, %d failed\n", checks_run, checks_failed);
+    return (checks_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
 